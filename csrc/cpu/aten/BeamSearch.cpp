@@ -0,0 +1,136 @@
+#include "BeamSearch.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(beam_search_step_kernel_stub);
+
+/**
+ * One step of beam search with the semantics of the HuggingFace
+ * BeamSearchScorer: selects the top 2 * num_beams candidates of every batch
+ * over its num_beams * vocab scores, adds the candidates ending with an eos
+ * token to the finished hypotheses of the batch, keeps the best num_beams
+ * other candidates as the next beams and updates the done flags.
+ *
+ * The finished hypotheses of a batch are kept in num_beams slots, a slot is
+ * empty while its length is 0.
+ *
+ * @param scores [batch * num_beams, vocab] processed log probabilities of
+ * the next token, in float, bfloat16 or half.
+ * @param beam_scores [batch * num_beams] float running beam scores, added to
+ * scores and replaced by the scores of the next beams.
+ * @param input_ids [batch * num_beams, >= cur_len] sequences of the beams.
+ * @param output_ids [batch * num_beams, > cur_len] receives the sequences of
+ * the next beams, i.e. the rows of input_ids reordered by the returned beam
+ * indices followed by the next tokens. Must not overlap input_ids.
+ * @param cur_len length of the sequences in input_ids.
+ * @param hyp_scores [batch, num_beams] double normalized hypothesis scores.
+ * @param hyp_tokens [batch, num_beams, >= cur_len] long hypothesis tokens.
+ * @param hyp_lens [batch, num_beams] long hypothesis lengths.
+ * @param worst_scores [batch] double worst kept hypothesis score.
+ * @param done [batch] bool, batches which are done are padded.
+ * @param early_stopping "true", "false" or "never".
+ * @param max_length only used when early_stopping is "never".
+ * @return the [batch * num_beams] next tokens and beam indices, the latter
+ * to reorder the KV cache with.
+ */
+std::tuple<at::Tensor, at::Tensor> beam_search_step(
+    const at::Tensor& scores,
+    at::Tensor& beam_scores,
+    const at::Tensor& input_ids,
+    at::Tensor& output_ids,
+    int64_t cur_len,
+    at::Tensor& hyp_scores,
+    at::Tensor& hyp_tokens,
+    at::Tensor& hyp_lens,
+    at::Tensor& worst_scores,
+    at::Tensor& done,
+    at::IntArrayRef eos_token_id,
+    int64_t pad_token_id,
+    double length_penalty,
+    c10::string_view early_stopping,
+    int64_t max_length) {
+  RECORD_FUNCTION("ipex::beam_search_step", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      scores.dim() == 2 && hyp_scores.dim() == 2,
+      "beam_search_step: expect scores [batch * num_beams, vocab] and ",
+      "hyp_scores [batch, num_beams]");
+  auto batch = hyp_scores.size(0);
+  auto num_beams = hyp_scores.size(1);
+  auto batch_beam = scores.size(0);
+  TORCH_CHECK(
+      batch * num_beams == batch_beam && beam_scores.numel() == batch_beam &&
+          input_ids.size(0) == batch_beam && output_ids.size(0) == batch_beam,
+      "beam_search_step: expect batch * num_beams rows");
+  TORCH_CHECK(
+      input_ids.size(1) >= cur_len && output_ids.size(1) > cur_len &&
+          hyp_tokens.size(2) >= cur_len,
+      "beam_search_step: the sequences do not fit the buffers");
+  TORCH_CHECK(
+      !input_ids.is_alias_of(output_ids),
+      "beam_search_step: output_ids must not overlap input_ids");
+  TORCH_CHECK(
+      beam_scores.scalar_type() == at::kFloat && beam_scores.is_contiguous(),
+      "beam_search_step: expect contiguous float beam_scores");
+  TORCH_CHECK(
+      input_ids.scalar_type() == at::kLong &&
+          output_ids.scalar_type() == at::kLong &&
+          hyp_tokens.scalar_type() == at::kLong &&
+          hyp_lens.scalar_type() == at::kLong && hyp_lens.is_contiguous() &&
+          hyp_tokens.is_contiguous(),
+      "beam_search_step: expect long tokens and contiguous hypotheses");
+  TORCH_CHECK(
+      hyp_scores.scalar_type() == at::kDouble && hyp_scores.is_contiguous() &&
+          worst_scores.scalar_type() == at::kDouble &&
+          worst_scores.is_contiguous() && worst_scores.numel() == batch,
+      "beam_search_step: expect contiguous double hypothesis scores");
+  TORCH_CHECK(
+      done.scalar_type() == at::kBool && done.is_contiguous() &&
+          done.numel() == batch,
+      "beam_search_step: expect contiguous bool done flags");
+  BeamEarlyStopping mode;
+  if (early_stopping == "true") {
+    mode = BeamEarlyStopping::kTrue;
+  } else if (early_stopping == "false") {
+    mode = BeamEarlyStopping::kFalse;
+  } else {
+    TORCH_CHECK(
+        early_stopping == "never",
+        "beam_search_step: early_stopping should be true, false or never");
+    mode = BeamEarlyStopping::kNever;
+  }
+  return beam_search_step_kernel_stub(
+      kCPU,
+      scores.contiguous(),
+      beam_scores,
+      input_ids,
+      output_ids,
+      cur_len,
+      hyp_scores,
+      hyp_tokens,
+      hyp_lens,
+      worst_scores,
+      done,
+      eos_token_id.vec(),
+      pad_token_id,
+      length_penalty,
+      mode,
+      max_length);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "beam_search_step(Tensor scores, Tensor(a!) beam_scores, Tensor input_ids, Tensor(b!) output_ids, int cur_len, Tensor(c!) hyp_scores, Tensor(d!) hyp_tokens, Tensor(e!) hyp_lens, Tensor(f!) worst_scores, Tensor(g!) done, int[] eos_token_id, int pad_token_id, float length_penalty, str early_stopping, int max_length) -> (Tensor, Tensor)");
+  m.impl(
+      "beam_search_step",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::beam_search_step);
+}
+} // namespace
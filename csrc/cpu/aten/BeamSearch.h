@@ -0,0 +1,70 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+std::tuple<at::Tensor, at::Tensor> beam_search_step(
+    const at::Tensor& scores,
+    at::Tensor& beam_scores,
+    const at::Tensor& input_ids,
+    at::Tensor& output_ids,
+    int64_t cur_len,
+    at::Tensor& hyp_scores,
+    at::Tensor& hyp_tokens,
+    at::Tensor& hyp_lens,
+    at::Tensor& worst_scores,
+    at::Tensor& done,
+    at::IntArrayRef eos_token_id,
+    int64_t pad_token_id,
+    double length_penalty,
+    c10::string_view early_stopping,
+    int64_t max_length);
+
+// When the finished hypotheses of a batch are checked against the best
+// running score, as the early_stopping argument of HuggingFace generate.
+enum class BeamEarlyStopping { kTrue, kFalse, kNever };
+
+namespace {
+
+std::tuple<at::Tensor, at::Tensor> beam_search_step_kernel_impl(
+    const at::Tensor& scores,
+    at::Tensor& beam_scores,
+    const at::Tensor& input_ids,
+    at::Tensor& output_ids,
+    int64_t cur_len,
+    at::Tensor& hyp_scores,
+    at::Tensor& hyp_tokens,
+    at::Tensor& hyp_lens,
+    at::Tensor& worst_scores,
+    at::Tensor& done,
+    const std::vector<int64_t>& eos_token_id,
+    int64_t pad_token_id,
+    double length_penalty,
+    BeamEarlyStopping early_stopping,
+    int64_t max_length);
+} // namespace
+
+using beam_search_step_kernel_fn = std::tuple<at::Tensor, at::Tensor> (*)(
+    const at::Tensor&,
+    at::Tensor&,
+    const at::Tensor&,
+    at::Tensor&,
+    int64_t,
+    at::Tensor&,
+    at::Tensor&,
+    at::Tensor&,
+    at::Tensor&,
+    at::Tensor&,
+    const std::vector<int64_t>&,
+    int64_t,
+    double,
+    BeamEarlyStopping,
+    int64_t);
+
+IPEX_DECLARE_DISPATCH(beam_search_step_kernel_fn, beam_search_step_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
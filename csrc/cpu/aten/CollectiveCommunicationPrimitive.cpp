@@ -9,6 +9,7 @@ namespace cpu {
 
 IPEX_DEFINE_DISPATCH(all_reduce_add_kernel_stub);
 IPEX_DEFINE_DISPATCH(allgather_kernel_stub);
+IPEX_DEFINE_DISPATCH(allgather_out_kernel_stub);
 
 at::Tensor all_reduce_add(at::Tensor t_in) {
   RECORD_FUNCTION("ipex::all_reduce_add", c10::ArrayRef<c10::IValue>({}));
@@ -23,6 +24,15 @@ at::Tensor allgather(
   return allgather_kernel_stub(kCPU, t_in, cols_per_rank, world_size);
 }
 
+at::Tensor& allgather_out(
+    at::Tensor t_in,
+    std::vector<int64_t> cols_per_rank,
+    int64_t world_size,
+    at::Tensor& out) {
+  RECORD_FUNCTION("ipex::allgather_out", c10::ArrayRef<c10::IValue>({}));
+  return allgather_out_kernel_stub(kCPU, t_in, cols_per_rank, world_size, out);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 
@@ -34,6 +44,11 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
       "all_reduce_add", c10::DispatchKey::CPU, torch_ipex::cpu::all_reduce_add);
   m.def("allgather(Tensor input, int[] output, int world_size) -> (Tensor)");
   m.impl("allgather", c10::DispatchKey::CPU, torch_ipex::cpu::allgather);
+  m.def(
+      "allgather.out(Tensor input, int[] output, int world_size, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.impl(
+      "allgather.out", c10::DispatchKey::CPU, torch_ipex::cpu::allgather_out);
 }
 } // namespace
 #endif
\ No newline at end of file
@@ -13,6 +13,11 @@ at::Tensor allgather(
     at::Tensor t_in,
     std::vector<int64_t> cols_per_rank,
     int64_t world_size);
+at::Tensor& allgather_out(
+    at::Tensor t_in,
+    std::vector<int64_t> cols_per_rank,
+    int64_t world_size,
+    at::Tensor& out);
 int64_t get_world_size(const at::Tensor dummy_input);
 int64_t get_rank(const at::Tensor dummy_input);
 } // namespace
@@ -22,9 +27,15 @@ using allgather_fn = at::Tensor (*)(
     at::Tensor t_in,
     std::vector<int64_t> cols_per_rank,
     int64_t world_size);
+using allgather_out_fn = at::Tensor& (*)(
+    at::Tensor t_in,
+    std::vector<int64_t> cols_per_rank,
+    int64_t world_size,
+    at::Tensor& out);
 
 IPEX_DECLARE_DISPATCH(all_reduce_add_fn, all_reduce_add_kernel_stub);
 IPEX_DECLARE_DISPATCH(allgather_fn, allgather_kernel_stub);
+IPEX_DECLARE_DISPATCH(allgather_out_fn, allgather_out_kernel_stub);
 
 } // namespace cpu
 } // namespace torch_ipex
@@ -0,0 +1,82 @@
+#include "FusedSample.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+#include <limits>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(fused_sample_kernel_stub);
+
+/**
+ * Draws the next token of every row from the logits of the last position,
+ * applying in order: the repetition and presence penalties on the tokens of
+ * input_ids, temperature, top-k and top-p, as the HuggingFace logits
+ * processors and warpers do, followed by a multinomial draw. No intermediate
+ * [batch, vocab] tensor is created.
+ *
+ * @param logits [batch, vocab] logits of the last position.
+ * @param input_ids [batch, seq_len] tokens generated so far.
+ * @param temperature values <= 0 select the token greedily.
+ * @param repetition_penalty 1.0 disables it.
+ * @param presence_penalty subtracted once from the score of every token
+ * present in input_ids, 0.0 disables it.
+ * @param top_k values <= 0 disable it.
+ * @param top_p values >= 1.0 disable it.
+ * @param seeds optional [batch] per-request seeds. The draw of a row depends
+ * only on its seed and seq_len, so a request is reproducible regardless of
+ * the batch it is scheduled in. Drawn from the default generator if absent.
+ * @return [batch] next tokens.
+ */
+at::Tensor fused_sample(
+    const at::Tensor& logits,
+    const at::Tensor& input_ids,
+    double temperature,
+    double repetition_penalty,
+    double presence_penalty,
+    int64_t top_k,
+    double top_p,
+    const c10::optional<at::Tensor>& seeds) {
+  RECORD_FUNCTION("ipex::fused_sample", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      logits.dim() == 2 && input_ids.dim() == 2 &&
+          logits.size(0) == input_ids.size(0),
+      "fused_sample: expect logits [batch, vocab] and input_ids [batch, seq_len]");
+  TORCH_CHECK(
+      repetition_penalty > 0, "fused_sample: repetition_penalty should be > 0");
+  at::Tensor row_seeds;
+  if (seeds.has_value() && seeds.value().defined()) {
+    row_seeds = seeds.value().to(at::kLong).contiguous();
+    TORCH_CHECK(
+        row_seeds.numel() == logits.size(0),
+        "fused_sample: expect one seed per row");
+  } else {
+    row_seeds = at::randint(
+        std::numeric_limits<int64_t>::max(),
+        {logits.size(0)},
+        at::TensorOptions().dtype(at::kLong));
+  }
+  return fused_sample_kernel_stub(
+      kCPU,
+      logits.contiguous(),
+      input_ids.contiguous(),
+      temperature,
+      repetition_penalty,
+      presence_penalty,
+      top_k,
+      top_p,
+      row_seeds);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "fused_sample(Tensor logits, Tensor input_ids, float temperature, float repetition_penalty, float presence_penalty, int top_k, float top_p, Tensor? seeds=None) -> Tensor");
+  m.impl(
+      "fused_sample", c10::DispatchKey::CPU, torch_ipex::cpu::fused_sample);
+}
+} // namespace
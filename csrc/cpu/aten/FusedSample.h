@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+at::Tensor fused_sample(
+    const at::Tensor& logits,
+    const at::Tensor& input_ids,
+    double temperature,
+    double repetition_penalty,
+    double presence_penalty,
+    int64_t top_k,
+    double top_p,
+    const c10::optional<at::Tensor>& seeds);
+
+namespace {
+
+at::Tensor fused_sample_kernel_impl(
+    const at::Tensor& logits,
+    const at::Tensor& input_ids,
+    double temperature,
+    double repetition_penalty,
+    double presence_penalty,
+    int64_t top_k,
+    double top_p,
+    const at::Tensor& seeds);
+} // namespace
+
+using fused_sample_kernel_fn = at::Tensor (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    double,
+    double,
+    double,
+    int64_t,
+    double,
+    const at::Tensor&);
+
+IPEX_DECLARE_DISPATCH(fused_sample_kernel_fn, fused_sample_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,93 @@
+#include "GPTQ.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(gptq_quantize_kernel_stub);
+
+/**
+ * Quantizes a weight with GPTQ: its columns are quantized one by one and the
+ * quantization error of each column is propagated to the columns not yet
+ * quantized through the inverse Hessian. The error is applied lazily, column
+ * by column within a block of columns and with one GEMM to the rest of the
+ * weight after each block. Matches GPTQ.fasterquant with a per-channel
+ * quantizer.
+ *
+ * @param weight [N, K] weight of the linear.
+ * @param hessian [K, K] Hessian of the layer, 2 X X^T over the calibration
+ * inputs X.
+ * @param bits number of bits of the quantized weight.
+ * @param group_size number of input channels sharing a scale and a zero
+ * point, -1 for one per output channel.
+ * @param sym whether to quantize symmetrically.
+ * @param act_order whether to quantize the columns in decreasing order of
+ * the Hessian diagonal.
+ * @param static_groups whether to compute the scales and zero points of the
+ * groups before quantizing, instead of when reaching each group.
+ * @param block_size number of columns of a block.
+ * @param percdamp damping added to the Hessian diagonal, relative to its
+ * mean.
+ * @param mse whether to search the clipping range minimizing the
+ * quantization error, with the norm, grid and maxshrink of the search.
+ * @return the [N, K] quantized and dequantized weight, in the dtype of
+ * weight, the [N, #groups] scales and zero points, the [K] permutation of
+ * act_order (empty otherwise) and the quantization loss.
+ */
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+gptq_quantize(
+    const at::Tensor& weight,
+    const at::Tensor& hessian,
+    int64_t bits,
+    int64_t group_size,
+    bool sym,
+    bool act_order,
+    bool static_groups,
+    int64_t block_size,
+    double percdamp,
+    bool mse,
+    double norm,
+    int64_t grid,
+    double maxshrink) {
+  RECORD_FUNCTION("ipex::gptq_quantize", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      weight.dim() == 2 && hessian.dim() == 2 &&
+          hessian.size(0) == weight.size(1) &&
+          hessian.size(1) == weight.size(1),
+      "gptq_quantize: expect weight [N, K] and hessian [K, K]");
+  TORCH_CHECK(
+      bits > 0 && bits <= 8, "gptq_quantize: bits should be in [1, 8]");
+  TORCH_CHECK(
+      group_size == -1 || group_size > 0,
+      "gptq_quantize: group_size should be -1 or positive");
+  TORCH_CHECK(block_size > 0, "gptq_quantize: block_size should be positive");
+  return gptq_quantize_kernel_stub(
+      kCPU,
+      weight,
+      hessian,
+      bits,
+      group_size,
+      sym,
+      act_order,
+      static_groups,
+      block_size,
+      percdamp,
+      mse,
+      norm,
+      grid,
+      maxshrink);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "gptq_quantize(Tensor weight, Tensor hessian, int bits, int group_size, bool sym, bool act_order, bool static_groups, int block_size, float percdamp, bool mse, float norm, int grid, float maxshrink) -> (Tensor, Tensor, Tensor, Tensor, Tensor)");
+  m.impl(
+      "gptq_quantize", c10::DispatchKey::CPU, torch_ipex::cpu::gptq_quantize);
+}
+} // namespace
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+gptq_quantize(
+    const at::Tensor& weight,
+    const at::Tensor& hessian,
+    int64_t bits,
+    int64_t group_size,
+    bool sym,
+    bool act_order,
+    bool static_groups,
+    int64_t block_size,
+    double percdamp,
+    bool mse,
+    double norm,
+    int64_t grid,
+    double maxshrink);
+
+namespace {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+gptq_quantize_kernel_impl(
+    const at::Tensor& weight,
+    const at::Tensor& hessian,
+    int64_t bits,
+    int64_t group_size,
+    bool sym,
+    bool act_order,
+    bool static_groups,
+    int64_t block_size,
+    double percdamp,
+    bool mse,
+    double norm,
+    int64_t grid,
+    double maxshrink);
+} // namespace
+
+using gptq_quantize_kernel_fn =
+    std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor> (*)(
+        const at::Tensor&,
+        const at::Tensor&,
+        int64_t,
+        int64_t,
+        bool,
+        bool,
+        bool,
+        int64_t,
+        double,
+        bool,
+        double,
+        int64_t,
+        double);
+
+IPEX_DECLARE_DISPATCH(gptq_quantize_kernel_fn, gptq_quantize_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -21,6 +21,7 @@ namespace torch_ipex {
 namespace cpu {
 
 IPEX_DEFINE_DISPATCH(GroupNormKernel);
+IPEX_DEFINE_DISPATCH(GroupNormActKernel);
 IPEX_DEFINE_DISPATCH(GroupNormBackwardKernel);
 
 void check_group_norm_inputs(
@@ -235,6 +236,122 @@ at::Tensor group_norm(
       at::native_group_norm(X, gamma, beta, N, C, HxW, num_groups, eps));
 }
 
+/**
+ * group_norm followed by an optional activation and residual add, fused in
+ * the sweep applying the scale and bias, so that the large activations of
+ * e.g. the diffusion UNet ResNet blocks are read and written once:
+ *   y = act(group_norm(input, num_groups, weight, bias, eps)) + other
+ *
+ * @param act "none", "silu" or "gelu".
+ * @param approximate approximation of gelu, "none" or "tanh".
+ * @param other_opt optional residual. The sum falls back to at::add when it
+ * has another shape or dtype than input.
+ */
+at::Tensor group_norm_act(
+    const at::Tensor& input,
+    int64_t num_groups,
+    const c10::optional<at::Tensor>& weight_opt,
+    const c10::optional<at::Tensor>& bias_opt,
+    double eps,
+    c10::string_view act,
+    c10::string_view approximate,
+    const c10::optional<at::Tensor>& other_opt) {
+#if defined(IPEX_DISP_OP)
+  printf("torch_ipex::group_norm_act\n");
+#endif
+  RECORD_FUNCTION("torch_ipex::group_norm_act", c10::ArrayRef<c10::IValue>({}));
+
+  GroupNormAct act_type;
+  if (act == "none") {
+    act_type = GroupNormAct::None;
+  } else if (act == "silu") {
+    act_type = GroupNormAct::SiLU;
+  } else if (act == "gelu") {
+    TORCH_CHECK(
+        approximate == "none" || approximate == "tanh",
+        "group_norm_act: unsupported gelu approximate ",
+        approximate);
+    act_type =
+        approximate == "tanh" ? GroupNormAct::GELUTanh : GroupNormAct::GELU;
+  } else {
+    TORCH_CHECK(false, "group_norm_act: unsupported activation ", act);
+  }
+  TORCH_CHECK(
+      input.device().is_cpu(), "group_norm_act: expects a CPU input tensor");
+
+  if (other_opt.has_value() &&
+      (other_opt->sizes() != input.sizes() ||
+       other_opt->scalar_type() != input.scalar_type())) {
+    return at::add(
+        group_norm_act(
+            input,
+            num_groups,
+            weight_opt,
+            bias_opt,
+            eps,
+            act,
+            approximate,
+            c10::nullopt),
+        *other_opt);
+  }
+
+  c10::MaybeOwned<at::Tensor> weight_maybe_owned =
+      at::borrow_from_optional_tensor(weight_opt);
+  const at::Tensor& weight = *weight_maybe_owned;
+  const at::Tensor& bias =
+      c10::value_or_else(bias_opt, [] { return at::Tensor(); });
+
+  const int64_t N = input.size(0);
+  const int64_t C = input.size(1);
+  check_group_norm_inputs(input, weight, bias, C, num_groups);
+
+  const auto input_shape = input.sizes();
+  const int64_t HxW =
+      c10::multiply_integers(input_shape.cbegin() + 2, input_shape.cend());
+
+  const at::Tensor kEmpty;
+  auto memory_format = input.suggest_memory_format();
+  const auto& X =
+      is_channels_last_1d(input) ? input : input.contiguous(memory_format);
+  const auto& gamma = weight.defined() ? weight.contiguous() : kEmpty;
+  const auto& beta = bias.defined() ? bias.contiguous() : kEmpty;
+
+  bool mixed_type = at::native::is_mixed_type(X, gamma, beta);
+  if (mixed_type) {
+    at::native::check_mixed_data_type(X, gamma, beta);
+  }
+
+  // Y and other are walked with the offsets of X
+  at::Tensor Y = at::empty_like(X);
+  at::Tensor other;
+  if (other_opt.has_value()) {
+    other = *other_opt;
+    if (other.strides() != X.strides()) {
+      other = at::empty_like(X).copy_(other);
+    }
+  }
+
+  const auto dtype = at::native::param_scalar_type(X, mixed_type);
+  at::Tensor mean = at::empty({N, num_groups}, X.options().dtype(dtype));
+  at::Tensor rstd = at::empty({N, num_groups}, X.options().dtype(dtype));
+  GroupNormActKernel(
+      kCPU,
+      X,
+      gamma,
+      beta,
+      N,
+      C,
+      HxW,
+      num_groups,
+      eps,
+      act_type,
+      other,
+      Y,
+      mean,
+      rstd);
+  return Y;
+}
+
 IPEX_TORCH_LIBRARY_IMPL(aten, CPU, m) {
   m.impl(
       TORCH_SELECTIVE_NAME("aten::group_norm"),
@@ -249,3 +366,18 @@ IPEX_TORCH_LIBRARY_IMPL(aten, CPU, m) {
 
 } // namespace cpu
 } // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "group_norm_act(Tensor input, int num_groups, Tensor? weight, \
+        Tensor? bias, float eps, str act=\"silu\", str approximate=\"none\", \
+        Tensor? other=None) -> Tensor");
+  m.impl(
+      "group_norm_act",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::group_norm_act);
+}
+
+} // namespace
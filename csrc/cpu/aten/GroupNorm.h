@@ -8,6 +8,23 @@ namespace torch_ipex {
 
 namespace cpu {
 
+// Activation applied by the fused GroupNorm after the scale and bias.
+enum class GroupNormAct { None, SiLU, GELU, GELUTanh };
+
+// group_norm followed by an optional activation and an optional residual
+// add, all applied in the sweep writing the output:
+//   y = act(group_norm(input)) + other
+// act is "none", "silu" or "gelu", approximate being that of gelu.
+at::Tensor group_norm_act(
+    const at::Tensor& input,
+    int64_t num_groups,
+    const c10::optional<at::Tensor>& weight_opt,
+    const c10::optional<at::Tensor>& bias_opt,
+    double eps,
+    c10::string_view act,
+    c10::string_view approximate,
+    const c10::optional<at::Tensor>& other_opt);
+
 using forward_fn = void (*)(
     const at::Tensor& /* X */,
     const at::Tensor& /* gamma */,
@@ -35,7 +52,23 @@ using backward_fn = void (*)(
     at::Tensor& /* dgamma */,
     at::Tensor& /* dbeta */);
 
+using forward_act_fn = void (*)(
+    const at::Tensor& /* X */,
+    const at::Tensor& /* gamma */,
+    const at::Tensor& /* beta */,
+    int64_t /* N */,
+    int64_t /* C */,
+    int64_t /* HxW */,
+    int64_t /* group */,
+    double /* eps */,
+    GroupNormAct /* act */,
+    const at::Tensor& /* other */,
+    at::Tensor& /* Y */,
+    at::Tensor& /* mean */,
+    at::Tensor& /* rstd */);
+
 IPEX_DECLARE_DISPATCH(forward_fn, GroupNormKernel);
+IPEX_DECLARE_DISPATCH(forward_act_fn, GroupNormActKernel);
 IPEX_DECLARE_DISPATCH(backward_fn, GroupNormBackwardKernel);
 
 } // namespace cpu
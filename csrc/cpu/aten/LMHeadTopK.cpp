@@ -0,0 +1,52 @@
+#include "LMHeadTopK.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(lm_head_topk_kernel_stub);
+
+/**
+ * Computes the top-k of hidden @ weight.t() + bias for every row without
+ * materializing the [batch, vocab] logits.
+ *
+ * @param hidden [batch, hidden_size] hidden states of the last token.
+ * @param weight [vocab, hidden_size] weight of the LM head, or the shard of
+ * it owned by this rank.
+ * @param bias optional [vocab] bias of the LM head.
+ * @param k number of candidates kept per row, 1 for argmax.
+ * @param compute_lse whether to also compute the log-sum-exp of the logits
+ * of every row, which turns the top-k logits into log-probs.
+ * @return the [batch, k] top-k logits in descending order, their [batch, k]
+ * indices into weight and the [batch] log-sum-exp (zeros if not computed).
+ */
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lm_head_topk(
+    const at::Tensor& hidden,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    int64_t k,
+    bool compute_lse) {
+  RECORD_FUNCTION("ipex::lm_head_topk", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      hidden.dim() == 2 && weight.dim() == 2 &&
+          hidden.size(1) == weight.size(1),
+      "lm_head_topk: expect hidden [batch, hidden_size] and weight [vocab, hidden_size]");
+  TORCH_CHECK(
+      k > 0 && k <= weight.size(0),
+      "lm_head_topk: k should be in [1, vocab]");
+  return lm_head_topk_kernel_stub(kCPU, hidden, weight, bias, k, compute_lse);
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "lm_head_topk(Tensor hidden, Tensor weight, Tensor? bias, int k, bool compute_lse) -> (Tensor, Tensor, Tensor)");
+  m.impl(
+      "lm_head_topk", c10::DispatchKey::CPU, torch_ipex::cpu::lm_head_topk);
+}
+} // namespace
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lm_head_topk(
+    const at::Tensor& hidden,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    int64_t k,
+    bool compute_lse);
+
+namespace {
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lm_head_topk_kernel_impl(
+    const at::Tensor& hidden,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    int64_t k,
+    bool compute_lse);
+} // namespace
+
+using lm_head_topk_kernel_fn =
+    std::tuple<at::Tensor, at::Tensor, at::Tensor> (*)(
+        const at::Tensor&,
+        const at::Tensor&,
+        const c10::optional<at::Tensor>&,
+        int64_t,
+        bool);
+
+IPEX_DECLARE_DISPATCH(lm_head_topk_kernel_fn, lm_head_topk_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
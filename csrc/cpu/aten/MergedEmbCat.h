@@ -17,6 +17,15 @@ Tensor dil_qmerged_embeddingbag_cat(
     int64_t o_zp,
     at::ScalarType odtype);
 
+Tensor dil_qmerged_embeddingbag_interaction(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& qdense,
+    double o_scale,
+    int64_t o_zp,
+    at::ScalarType odtype);
+
 namespace {
 
 Tensor merged_embedding_cat_fw_impl(
@@ -32,6 +41,19 @@ Tensor qmerged_embedding_cat_fw_impl(
     const Tensor& qdense,
     double o_scale);
 
+Tensor merged_embedding_interaction_fw_impl(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense);
+
+Tensor qmerged_embedding_interaction_fw_impl(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& qdense,
+    double o_scale);
+
 } // namespace
 
 using merged_embeddingbag_cat_fw_fn = Tensor (*)(
@@ -55,5 +77,15 @@ IPEX_DECLARE_DISPATCH(
     qmerged_embeddingbag_cat_fw_fn,
     qmerged_embeddingbag_cat_fw_stub);
 
+// Pools the embedding bags and computes their interaction with the dense
+// feature in one pass, the output being that of interaction_forward
+IPEX_DECLARE_DISPATCH(
+    merged_embeddingbag_cat_fw_fn,
+    merged_embeddingbag_interaction_fw_stub);
+
+IPEX_DECLARE_DISPATCH(
+    qmerged_embeddingbag_cat_fw_fn,
+    qmerged_embeddingbag_interaction_fw_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
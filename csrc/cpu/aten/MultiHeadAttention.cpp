@@ -5,6 +5,7 @@ namespace torch_ipex {
 namespace cpu {
 
 IPEX_DEFINE_DISPATCH(bert_mha_kernel_stub);
+IPEX_DEFINE_DISPATCH(bert_mha_varlen_kernel_stub);
 IPEX_DEFINE_DISPATCH(sd_mha_kernel_v1_stub);
 IPEX_DEFINE_DISPATCH(sd_mha_kernel_v2_stub);
 
@@ -18,6 +19,44 @@ at::Tensor bert_flash_mha(
       kCPU, qkv, rel_kv, head_num, headSize, dim_per_head);
 }
 
+at::Tensor bert_mha_varlen(
+    const at::Tensor& qkv,
+    const at::Tensor& cu_seqlens,
+    int64_t head_num,
+    int64_t headSize,
+    double scale) {
+  RECORD_FUNCTION("bert_mha_varlen", c10::ArrayRef<c10::IValue>({}));
+  const auto dtype = qkv.scalar_type();
+  TORCH_CHECK(
+      dtype == at::kFloat || dtype == at::kBFloat16 || dtype == at::kHalf,
+      "bert_mha_varlen: expected qkv in FP32, BF16 or FP16, but got ",
+      dtype);
+  TORCH_CHECK(
+      qkv.dim() == 2 && qkv.size(1) == 3 * head_num * headSize &&
+          qkv.stride(1) == 1,
+      "bert_mha_varlen: expected qkv of shape [total_tokens, ",
+      3 * head_num * headSize,
+      "] contiguous on the last dim, but got ",
+      qkv.sizes());
+  TORCH_CHECK(
+      cu_seqlens.dim() == 1 && cu_seqlens.size(0) >= 1,
+      "bert_mha_varlen: expected cu_seqlens of shape [num_seqs + 1]");
+  TORCH_CHECK(
+      cu_seqlens[0].item<int64_t>() == 0 &&
+          cu_seqlens[-1].item<int64_t>() == qkv.size(0),
+      "bert_mha_varlen: expected cu_seqlens to span the ",
+      qkv.size(0),
+      " tokens of qkv");
+  const int64_t num_seqs = cu_seqlens.size(0) - 1;
+  TORCH_CHECK(
+      at::ge(cu_seqlens.slice(0, 1), cu_seqlens.slice(0, 0, num_seqs))
+          .all()
+          .item<bool>(),
+      "bert_mha_varlen: expected cu_seqlens to be non-decreasing");
+  return bert_mha_varlen_kernel_stub(
+      kCPU, qkv, cu_seqlens, head_num, headSize, scale);
+}
+
 at::Tensor sd_flash_mha(
     const at::Tensor& qkv,
     const int64_t& head_num,
@@ -39,3 +78,17 @@ at::Tensor sd_flash_mha(
 
 } // namespace cpu
 } // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "bert_mha_varlen(Tensor qkv, Tensor cu_seqlens, int head_num, \
+       int head_size, float scale) -> Tensor");
+  m.impl(
+      "bert_mha_varlen",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::bert_mha_varlen);
+}
+
+} // namespace
@@ -20,6 +20,17 @@ at::Tensor bert_flash_mha(
     const int64_t& headSize,
     const double& dim_per_head);
 
+// Variable-length form of bert_flash_mha: the sequences are concatenated in
+// qkv, [total_tokens, 3 * head_num * headSize], cu_seqlens holds their start
+// offsets followed by total_tokens, and each token only attends to the
+// tokens of its own sequence, so that there is no padding to mask.
+at::Tensor bert_mha_varlen(
+    const at::Tensor& qkv,
+    const at::Tensor& cu_seqlens,
+    int64_t head_num,
+    int64_t headSize,
+    double scale);
+
 at::Tensor sd_flash_mha(
     const at::Tensor& qkv,
     const int64_t& head_num,
@@ -42,6 +53,13 @@ at::Tensor bert_mha_kernel_impl(
     const int64_t& headSize,
     const double& dim_per_head);
 
+at::Tensor bert_mha_varlen_kernel_impl(
+    const at::Tensor& qkv,
+    const at::Tensor& cu_seqlens,
+    const int64_t& head_num,
+    const int64_t& headSize,
+    const double& scale);
+
 at::Tensor sd_mha_kernel_v1_impl(
     const at::Tensor& qkv,
     const int64_t& head_num,
@@ -64,6 +82,13 @@ using bert_mha_kernel_fn = at::Tensor (*)(
     const int64_t&,
     const double&);
 
+using bert_mha_varlen_kernel_fn = at::Tensor (*)(
+    const at::Tensor&,
+    const at::Tensor&,
+    const int64_t&,
+    const int64_t&,
+    const double&);
+
 using sd_mha_kernel_v1_fn = at::Tensor (*)(
     const at::Tensor&,
     const int64_t&,
@@ -79,6 +104,7 @@ using sd_mha_kernel_v2_fn = at::Tensor (*)(
     const double&);
 
 IPEX_DECLARE_DISPATCH(bert_mha_kernel_fn, bert_mha_kernel_stub);
+IPEX_DECLARE_DISPATCH(bert_mha_varlen_kernel_fn, bert_mha_varlen_kernel_stub);
 IPEX_DECLARE_DISPATCH(sd_mha_kernel_v1_fn, sd_mha_kernel_v1_stub);
 IPEX_DECLARE_DISPATCH(sd_mha_kernel_v2_fn, sd_mha_kernel_v2_stub);
 } // namespace cpu
@@ -139,7 +139,7 @@ inline void roi_align_single_framework_backward(
     int64_t pooled_width,
     int64_t roi_bin_grid_h,
     int64_t roi_bin_grid_w,
-    const std::vector<PreCalc<ACC_T>>& pre_calc,
+    const PreCalc<ACC_T>* pre_calc,
     T* grad_input);
 
 template <typename T, typename ACC_T>
@@ -147,13 +147,15 @@ inline void roi_align_single_framework_channels_last_backward(
     const T* grad_output,
     const ACC_T count,
     int64_t channels,
+    int64_t channel_begin,
+    int64_t channel_end,
     int64_t height,
     int64_t width,
     int64_t pooled_height,
     int64_t pooled_width,
     int64_t roi_bin_grid_h,
     int64_t roi_bin_grid_w,
-    const std::vector<PreCalc<ACC_T>>& pre_calc,
+    const PreCalc<ACC_T>* pre_calc,
     T* grad_input);
 
 template <typename T, typename ACC_T>
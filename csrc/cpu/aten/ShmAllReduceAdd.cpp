@@ -8,6 +8,8 @@ namespace torch_ipex {
 namespace cpu {
 
 IPEX_DEFINE_DISPATCH(shm_all_reduce_add_kernel_stub);
+IPEX_DEFINE_DISPATCH(shm_allgather_shards_kernel_stub);
+IPEX_DEFINE_DISPATCH(shm_allgather_cols_kernel_stub);
 
 at::Tensor shm_all_reduce_add_forward_cpu(
     at::Tensor& t_in,
@@ -28,6 +30,48 @@ at::Tensor shm_all_reduce_add_forward_cpu(
       world_size);
 }
 
+at::Tensor shm_allgather_shards_forward_cpu(
+    at::Tensor& t_in,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    int64_t shard_begin,
+    int64_t shard_end,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size) {
+  return shm_allgather_shards_kernel_stub(
+      kCPU,
+      t_in,
+      t_address,
+      t_state,
+      shard_begin,
+      shard_end,
+      generation,
+      rank,
+      world_size);
+}
+
+at::Tensor& shm_allgather_cols_forward_cpu(
+    at::Tensor& t_in,
+    at::Tensor& t_out,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    std::vector<int64_t> cols_per_rank,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size) {
+  return shm_allgather_cols_kernel_stub(
+      kCPU,
+      t_in,
+      t_out,
+      t_address,
+      t_state,
+      cols_per_rank,
+      generation,
+      rank,
+      world_size);
+}
+
 } // namespace cpu
 } // namespace torch_ipex
 #endif
\ No newline at end of file
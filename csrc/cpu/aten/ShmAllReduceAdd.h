@@ -17,6 +17,26 @@ at::Tensor shm_all_reduce_add(
     int64_t shm_block_size,
     int64_t rank,
     int64_t world_size);
+
+at::Tensor shm_allgather_shards(
+    at::Tensor& t_in,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    int64_t shard_begin,
+    int64_t shard_end,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size);
+
+at::Tensor& shm_allgather_cols(
+    at::Tensor& t_in,
+    at::Tensor& t_out,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    std::vector<int64_t> cols_per_rank,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size);
 }
 
 using shm_all_reduce_add_kernel_fn = at::Tensor (*)(
@@ -28,10 +48,38 @@ using shm_all_reduce_add_kernel_fn = at::Tensor (*)(
     int64_t rank,
     int64_t world_size);
 
+using shm_allgather_shards_kernel_fn = at::Tensor (*)(
+    at::Tensor& t_in,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    int64_t shard_begin,
+    int64_t shard_end,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size);
+
+using shm_allgather_cols_kernel_fn = at::Tensor& (*)(
+    at::Tensor& t_in,
+    at::Tensor& t_out,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    std::vector<int64_t> cols_per_rank,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size);
+
 IPEX_DECLARE_DISPATCH(
     shm_all_reduce_add_kernel_fn,
     shm_all_reduce_add_kernel_stub);
 
+IPEX_DECLARE_DISPATCH(
+    shm_allgather_shards_kernel_fn,
+    shm_allgather_shards_kernel_stub);
+
+IPEX_DECLARE_DISPATCH(
+    shm_allgather_cols_kernel_fn,
+    shm_allgather_cols_kernel_stub);
+
 } // namespace cpu
 } // namespace torch_ipex
 #endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "SmoothQuant.h"
+#include <torch/all.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+IPEX_DEFINE_DISPATCH(smooth_quant_observe_kernel_stub);
+IPEX_DEFINE_DISPATCH(smooth_quant_scaling_factors_kernel_stub);
+
+/**
+ * Updates the running min and max of every input channel of a SmoothQuant
+ * calibration batch in a single pass, without permuting the input.
+ *
+ * @param input [..., IC] float, bfloat16 or half calibration batch.
+ * @param min_val [IC] float running min, updated in place.
+ * @param max_val [IC] float running max, updated in place.
+ */
+void smooth_quant_observe(
+    const at::Tensor& input,
+    at::Tensor& min_val,
+    at::Tensor& max_val) {
+  RECORD_FUNCTION("ipex::smooth_quant_observe", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(input.dim() >= 1, "smooth_quant_observe: expect input channels");
+  auto channels = input.size(-1);
+  TORCH_CHECK(
+      min_val.scalar_type() == at::kFloat &&
+          max_val.scalar_type() == at::kFloat && min_val.is_contiguous() &&
+          max_val.is_contiguous(),
+      "smooth_quant_observe: expect contiguous float min_val and max_val");
+  TORCH_CHECK(
+      min_val.numel() == channels && max_val.numel() == channels,
+      "smooth_quant_observe: expect one min and max per input channel");
+  if (input.numel() == 0) {
+    return;
+  }
+  smooth_quant_observe_kernel_stub(kCPU, input.contiguous(), min_val, max_val);
+}
+
+/**
+ * Computes the SmoothQuant scaling factors of a linear layer from the per
+ * input channel ranges of its activation and weight. With several
+ * candidate alphas, the alpha minimizing the estimated quantization error
+ * of the layer output is selected, see the kernel.
+ *
+ * @param act_min, act_max [IC] activation range of every input channel.
+ * @param wei_min, wei_max [IC] weight range of every input channel.
+ * @param alphas candidate alphas, in order of preference on ties.
+ * @return the [IC] scaling factors of the activation and of the weight,
+ * max(|W_j|) ** (1 - alpha) / max(|X_j|) ** alpha and its reciprocal, and
+ * the selected alpha.
+ */
+std::tuple<at::Tensor, at::Tensor, double> smooth_quant_scaling_factors(
+    const at::Tensor& act_min,
+    const at::Tensor& act_max,
+    const at::Tensor& wei_min,
+    const at::Tensor& wei_max,
+    at::ArrayRef<double> alphas) {
+  RECORD_FUNCTION(
+      "ipex::smooth_quant_scaling_factors", c10::ArrayRef<c10::IValue>({}));
+  auto channels = act_min.numel();
+  TORCH_CHECK(
+      act_max.numel() == channels && wei_min.numel() == channels &&
+          wei_max.numel() == channels,
+      "smooth_quant_scaling_factors: expect the ranges of the same channels");
+  TORCH_CHECK(
+      !alphas.empty(), "smooth_quant_scaling_factors: expect an alpha");
+  for (auto alpha : alphas) {
+    TORCH_CHECK(
+        alpha >= 0 && alpha <= 1,
+        "smooth_quant_scaling_factors: expect alpha in [0, 1], got ",
+        alpha);
+  }
+  auto contiguous_float = [](const at::Tensor& t) {
+    return t.to(at::kFloat).contiguous().view({-1});
+  };
+  return smooth_quant_scaling_factors_kernel_stub(
+      kCPU,
+      contiguous_float(act_min),
+      contiguous_float(act_max),
+      contiguous_float(wei_min),
+      contiguous_float(wei_max),
+      alphas.vec());
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+
+namespace {
+
+TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
+  m.def(
+      "smooth_quant_observe(Tensor input, Tensor(a!) min_val, Tensor(b!) max_val) -> ()");
+  m.impl(
+      "smooth_quant_observe",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::smooth_quant_observe);
+  m.def(
+      "smooth_quant_scaling_factors(Tensor act_min, Tensor act_max, Tensor wei_min, Tensor wei_max, float[] alphas) -> (Tensor, Tensor, float)");
+  m.impl(
+      "smooth_quant_scaling_factors",
+      c10::DispatchKey::CPU,
+      torch_ipex::cpu::smooth_quant_scaling_factors);
+}
+} // namespace
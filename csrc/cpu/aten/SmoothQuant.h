@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <dyndisp/DispatchStub.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+void smooth_quant_observe(
+    const at::Tensor& input,
+    at::Tensor& min_val,
+    at::Tensor& max_val);
+
+std::tuple<at::Tensor, at::Tensor, double> smooth_quant_scaling_factors(
+    const at::Tensor& act_min,
+    const at::Tensor& act_max,
+    const at::Tensor& wei_min,
+    const at::Tensor& wei_max,
+    at::ArrayRef<double> alphas);
+
+namespace {
+
+void smooth_quant_observe_kernel_impl(
+    const at::Tensor& input,
+    at::Tensor& min_val,
+    at::Tensor& max_val);
+
+std::tuple<at::Tensor, at::Tensor, double>
+smooth_quant_scaling_factors_kernel_impl(
+    const at::Tensor& act_min,
+    const at::Tensor& act_max,
+    const at::Tensor& wei_min,
+    const at::Tensor& wei_max,
+    const std::vector<double>& alphas);
+} // namespace
+
+using smooth_quant_observe_kernel_fn =
+    void (*)(const at::Tensor&, at::Tensor&, at::Tensor&);
+
+using smooth_quant_scaling_factors_kernel_fn =
+    std::tuple<at::Tensor, at::Tensor, double> (*)(
+        const at::Tensor&,
+        const at::Tensor&,
+        const at::Tensor&,
+        const at::Tensor&,
+        const std::vector<double>&);
+
+IPEX_DECLARE_DISPATCH(
+    smooth_quant_observe_kernel_fn,
+    smooth_quant_observe_kernel_stub);
+IPEX_DECLARE_DISPATCH(
+    smooth_quant_scaling_factors_kernel_fn,
+    smooth_quant_scaling_factors_kernel_stub);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,324 @@
+#include <ATen/Parallel.h>
+#include <aten/BeamSearch.h>
+#include <aten/utils/topk.h>
+#include <torch/csrc/autograd/function.h>
+#include <algorithm>
+#include <cmath>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Number of vocab entries of a beam scanned by a task, so that small
+// batches still spread over the threads.
+constexpr int64_t kVocabChunk = 4096;
+
+struct BeamSearchParams {
+  int64_t batch;
+  int64_t num_beams;
+  int64_t vocab;
+  int64_t cur_len;
+  int64_t pad_token_id;
+  double length_penalty;
+  BeamEarlyStopping early_stopping;
+  int64_t max_length;
+};
+
+// Finished hypotheses of a batch, as BeamHypotheses of HuggingFace.
+struct Hypotheses {
+  int64_t num_beams;
+  double* scores;
+  int64_t* tokens;
+  int64_t* lens;
+  int64_t max_tokens;
+  double* worst_score;
+
+  int64_t size() const {
+    return std::count_if(
+        lens, lens + num_beams, [](int64_t len) { return len > 0; });
+  }
+
+  void add(const int64_t* seq, int64_t len, double score) {
+    auto n = size();
+    if (n >= num_beams && score <= *worst_score) {
+      return;
+    }
+    int64_t slot = n;
+    if (n == num_beams) {
+      // Replaces the worst hypothesis, the first one on ties.
+      slot = std::min_element(scores, scores + num_beams) - scores;
+    }
+    scores[slot] = score;
+    lens[slot] = len;
+    std::copy(seq, seq + len, tokens + slot * max_tokens);
+    if (n == num_beams) {
+      *worst_score = *std::min_element(scores, scores + num_beams);
+    } else {
+      *worst_score = std::min(score, *worst_score);
+    }
+  }
+
+  // Whether no running beam can beat the worst hypothesis anymore.
+  bool is_done(double best_sum_logprobs, const BeamSearchParams& params)
+      const {
+    if (size() < num_beams) {
+      return false;
+    }
+    double len = params.cur_len + 1;
+    switch (params.early_stopping) {
+      case BeamEarlyStopping::kTrue:
+        return true;
+      case BeamEarlyStopping::kNever:
+        if (params.length_penalty > 0.0) {
+          TORCH_CHECK(
+              params.max_length > 0,
+              "beam_search_step: max_length is required to never stop early");
+          len = params.max_length;
+        }
+        break;
+      default:
+        break;
+    }
+    return *worst_score >=
+        best_sum_logprobs / std::pow(len, params.length_penalty);
+  }
+};
+
+// Top 2 * num_beams candidates of every batch, index is beam * vocab + token.
+template <typename T>
+std::vector<std::vector<std::pair<float, int64_t>>> beam_candidates(
+    const T* scores,
+    const float* beam_scores,
+    const BeamSearchParams& params) {
+  const int64_t k = 2 * params.num_beams;
+  const int64_t num_chunks = (params.vocab + kVocabChunk - 1) / kVocabChunk;
+  const int64_t num_rows = params.batch * params.num_beams;
+  std::vector<RunningTopK> partial(num_rows * num_chunks, RunningTopK(k));
+  at::parallel_for(
+      0, num_rows * num_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; task++) {
+          int64_t row = task / num_chunks;
+          int64_t start = (task % num_chunks) * kVocabChunk;
+          int64_t stop = std::min(start + kVocabChunk, params.vocab);
+          int64_t offset = (row % params.num_beams) * params.vocab;
+          const T* in = scores + row * params.vocab;
+          float beam_score = beam_scores[row];
+          auto& topk = partial[task];
+          for (int64_t v = start; v < stop; v++) {
+            float value = static_cast<float>(in[v]) + beam_score;
+            if (value >= topk.threshold()) {
+              topk.push(value, offset + v);
+            }
+          }
+        }
+      });
+  std::vector<std::vector<std::pair<float, int64_t>>> candidates(params.batch);
+  at::parallel_for(0, params.batch, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      RunningTopK topk(k);
+      int64_t first = b * params.num_beams * num_chunks;
+      int64_t last = first + params.num_beams * num_chunks;
+      for (int64_t task = first; task < last; task++) {
+        topk.merge(partial[task]);
+      }
+      candidates[b] = topk.sorted();
+    }
+  });
+  return candidates;
+}
+
+template <typename T>
+void beam_search_step_impl(
+    const at::Tensor& scores,
+    at::Tensor& beam_scores,
+    const at::Tensor& input_ids,
+    at::Tensor& output_ids,
+    at::Tensor& hyp_scores,
+    at::Tensor& hyp_tokens,
+    at::Tensor& hyp_lens,
+    at::Tensor& worst_scores,
+    at::Tensor& done,
+    const std::vector<int64_t>& eos_token_id,
+    const BeamSearchParams& params,
+    at::Tensor& next_tokens,
+    at::Tensor& beam_idx) {
+  float* beam_scores_ptr = beam_scores.data_ptr<float>();
+  auto candidates =
+      beam_candidates(scores.data_ptr<T>(), beam_scores_ptr, params);
+
+  const int64_t num_beams = params.num_beams;
+  const int64_t* in_ids = input_ids.data_ptr<int64_t>();
+  const int64_t in_stride = input_ids.stride(0);
+  const int64_t in_col_stride = input_ids.stride(1);
+  int64_t* next_tokens_ptr = next_tokens.data_ptr<int64_t>();
+  int64_t* beam_idx_ptr = beam_idx.data_ptr<int64_t>();
+  bool* done_ptr = done.data_ptr<bool>();
+  at::parallel_for(0, params.batch, 1, [&](int64_t begin, int64_t end) {
+    std::vector<int64_t> seq(params.cur_len);
+    for (int64_t b = begin; b < end; b++) {
+      int64_t first_row = b * num_beams;
+      if (done_ptr[b]) {
+        // Finished batches are padded, beam index 0 as HuggingFace does.
+        for (int64_t j = 0; j < num_beams; j++) {
+          beam_scores_ptr[first_row + j] = 0.f;
+          next_tokens_ptr[first_row + j] = params.pad_token_id;
+          beam_idx_ptr[first_row + j] = 0;
+        }
+        continue;
+      }
+      Hypotheses hyps{
+          num_beams,
+          hyp_scores.data_ptr<double>() + b * num_beams,
+          hyp_tokens.data_ptr<int64_t>() + b * num_beams * hyp_tokens.size(2),
+          hyp_lens.data_ptr<int64_t>() + b * num_beams,
+          hyp_tokens.size(2),
+          worst_scores.data_ptr<double>() + b};
+      int64_t next_beam = 0;
+      auto& batch_candidates = candidates[b];
+      for (int64_t rank = 0; rank < (int64_t)batch_candidates.size(); rank++) {
+        float score = batch_candidates[rank].first;
+        int64_t row = first_row + batch_candidates[rank].second / params.vocab;
+        int64_t token = batch_candidates[rank].second % params.vocab;
+        bool is_eos =
+            std::find(eos_token_id.begin(), eos_token_id.end(), token) !=
+            eos_token_id.end();
+        if (is_eos) {
+          // Only an eos among the top num_beams candidates ends a beam.
+          if (rank >= num_beams) {
+            continue;
+          }
+          const int64_t* src = in_ids + row * in_stride;
+          for (int64_t i = 0; i < params.cur_len; i++) {
+            seq[i] = src[i * in_col_stride];
+          }
+          hyps.add(
+              seq.data(),
+              params.cur_len,
+              score / std::pow(params.cur_len + 1.0, params.length_penalty));
+        } else {
+          beam_scores_ptr[first_row + next_beam] = score;
+          next_tokens_ptr[first_row + next_beam] = token;
+          beam_idx_ptr[first_row + next_beam] = row;
+          next_beam++;
+        }
+        if (next_beam == num_beams) {
+          break;
+        }
+      }
+      TORCH_CHECK(
+          next_beam == num_beams,
+          "beam_search_step: at most ",
+          num_beams,
+          " eos tokens can be among the top ",
+          2 * num_beams,
+          " candidates");
+      done_ptr[b] = hyps.is_done(batch_candidates[0].first, params);
+    }
+  });
+
+  // The sequences of the next beams.
+  int64_t* out_ids = output_ids.data_ptr<int64_t>();
+  const int64_t out_stride = output_ids.stride(0);
+  const int64_t out_col_stride = output_ids.stride(1);
+  at::parallel_for(
+      0, params.batch * num_beams, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; row++) {
+          const int64_t* src = in_ids + beam_idx_ptr[row] * in_stride;
+          int64_t* dst = out_ids + row * out_stride;
+          for (int64_t i = 0; i < params.cur_len; i++) {
+            dst[i * out_col_stride] = src[i * in_col_stride];
+          }
+          dst[params.cur_len * out_col_stride] = next_tokens_ptr[row];
+        }
+      });
+}
+
+std::tuple<at::Tensor, at::Tensor> beam_search_step_kernel_impl(
+    const at::Tensor& scores,
+    at::Tensor& beam_scores,
+    const at::Tensor& input_ids,
+    at::Tensor& output_ids,
+    int64_t cur_len,
+    at::Tensor& hyp_scores,
+    at::Tensor& hyp_tokens,
+    at::Tensor& hyp_lens,
+    at::Tensor& worst_scores,
+    at::Tensor& done,
+    const std::vector<int64_t>& eos_token_id,
+    int64_t pad_token_id,
+    double length_penalty,
+    BeamEarlyStopping early_stopping,
+    int64_t max_length) {
+  BeamSearchParams params{
+      hyp_scores.size(0),
+      hyp_scores.size(1),
+      scores.size(1),
+      cur_len,
+      pad_token_id,
+      length_penalty,
+      early_stopping,
+      max_length};
+  TORCH_CHECK(params.vocab >= 2, "beam_search_step: expect at least 2 tokens");
+  auto options = at::TensorOptions().dtype(at::kLong);
+  auto next_tokens = at::empty({scores.size(0)}, options);
+  auto beam_idx = at::empty({scores.size(0)}, options);
+  if (scores.scalar_type() == at::kFloat) {
+    beam_search_step_impl<float>(
+        scores,
+        beam_scores,
+        input_ids,
+        output_ids,
+        hyp_scores,
+        hyp_tokens,
+        hyp_lens,
+        worst_scores,
+        done,
+        eos_token_id,
+        params,
+        next_tokens,
+        beam_idx);
+  } else if (scores.scalar_type() == at::kBFloat16) {
+    beam_search_step_impl<at::BFloat16>(
+        scores,
+        beam_scores,
+        input_ids,
+        output_ids,
+        hyp_scores,
+        hyp_tokens,
+        hyp_lens,
+        worst_scores,
+        done,
+        eos_token_id,
+        params,
+        next_tokens,
+        beam_idx);
+  } else if (scores.scalar_type() == at::kHalf) {
+    beam_search_step_impl<at::Half>(
+        scores,
+        beam_scores,
+        input_ids,
+        output_ids,
+        hyp_scores,
+        hyp_tokens,
+        hyp_lens,
+        worst_scores,
+        done,
+        eos_token_id,
+        params,
+        next_tokens,
+        beam_idx);
+  } else {
+    TORCH_CHECK(false, "beam_search_step: unsupported scores dtype");
+  }
+  return std::make_tuple(next_tokens, beam_idx);
+}
+
+} // namespace
+
+IPEX_REGISTER_DISPATCH(
+    beam_search_step_kernel_stub,
+    &beam_search_step_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -2,6 +2,7 @@
 #include <ATen/ATen.h>
 #include <ATen/Tensor.h>
 #include <aten/CollectiveCommunicationPrimitive.h>
+#include <comm/comm_worker.h>
 #include <comm/messager.h>
 #include <torch/csrc/autograd/function.h>
 
@@ -10,23 +11,44 @@ namespace cpu {
 
 namespace {
 at::Tensor all_reduce_add_kernel_impl(at::Tensor& t_in) {
+  CommWorker::getInstance().drain();
   Messenger::getInstance().reduceAdd(t_in);
   return t_in;
 }
 
+at::Tensor& allgather_out_kernel_impl(
+    at::Tensor t_in,
+    std::vector<int64_t> cols_per_rank,
+    int64_t world_size,
+    at::Tensor& out) {
+  CommWorker::getInstance().drain();
+  TORCH_CHECK(
+      (int64_t)cols_per_rank.size() == world_size + 1,
+      "allgather: cols_per_rank should have world_size + 1 entries");
+  TORCH_CHECK(
+      out.is_contiguous() && out.scalar_type() == t_in.scalar_type(),
+      "allgather: out should be contiguous and have the dtype of input");
+  std::vector<int64_t> out_shape(t_in.sizes().begin(), t_in.sizes().end() - 1);
+  out_shape.push_back(cols_per_rank[world_size]);
+  TORCH_CHECK(
+      out.sizes() == at::IntArrayRef(out_shape),
+      "allgather: out has shape ",
+      out.sizes(),
+      " while ",
+      at::IntArrayRef(out_shape),
+      " is expected");
+  return Messenger::getInstance().allgather(t_in, out, cols_per_rank);
+}
+
 at::Tensor allgather_kernel_impl(
     at::Tensor t_in,
     std::vector<int64_t> cols_per_rank,
     int64_t world_size) {
-  std::vector<at::Tensor> output_tensors;
-  auto shape = t_in.contiguous().sizes();
-  for (int64_t rank = 0; rank < world_size; rank++) {
-    std::vector<int64_t> t_out_shape(shape.begin(), shape.end() - 1);
-    t_out_shape.push_back(cols_per_rank[rank + 1] - cols_per_rank[rank]);
-    output_tensors.push_back(at::empty(t_out_shape, t_in.options()));
-  }
-
-  return Messenger::getInstance().allgather(t_in, output_tensors);
+  std::vector<int64_t> out_shape(t_in.sizes().begin(), t_in.sizes().end() - 1);
+  out_shape.push_back(cols_per_rank[world_size]);
+  auto out = at::empty(out_shape, t_in.options());
+  allgather_out_kernel_impl(t_in, cols_per_rank, world_size, out);
+  return out;
 }
 
 } // anonymous namespace
@@ -35,6 +57,8 @@ IPEX_REGISTER_DISPATCH(all_reduce_add_kernel_stub, &all_reduce_add_kernel_impl);
 
 IPEX_REGISTER_DISPATCH(allgather_kernel_stub, &allgather_kernel_impl);
 
+IPEX_REGISTER_DISPATCH(allgather_out_kernel_stub, &allgather_out_kernel_impl);
+
 } // namespace cpu
 } // namespace torch_ipex
 #endif
\ No newline at end of file
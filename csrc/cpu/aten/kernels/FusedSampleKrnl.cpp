@@ -0,0 +1,424 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <aten/FusedSample.h>
+#include <aten/utils/topk.h>
+#include <torch/csrc/autograd/function.h>
+#include <numeric>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Number of vocab entries processed by a thread at a time, the processed
+// scores of a chunk stay in a thread local buffer.
+constexpr int64_t kVocabChunk = 4096;
+// Candidates kept per row for top-p when top-k is disabled. Rows whose top-p
+// set does not fit are collected again with a larger limit.
+constexpr int64_t kTopPCandidates = 1024;
+
+struct SampleParams {
+  float inv_temperature;
+  float repetition_penalty;
+  float presence_penalty;
+};
+
+// splitmix64, the draw of a row only depends on its seed and step.
+inline double uniform_from_seed(uint64_t seed, uint64_t step) {
+  uint64_t z = seed + (step + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z = z ^ (z >> 31);
+  return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Writes the processed scores of logits[begin, end) to out. tokens is the
+// sorted unique list of the tokens of the row in input_ids.
+template <typename T>
+inline void load_scores(
+    const T* logits,
+    int64_t begin,
+    int64_t end,
+    const std::vector<int64_t>& tokens,
+    const SampleParams& params,
+    float* out) {
+  using fVec = at::vec::Vectorized<float>;
+  using bVec = at::vec::Vectorized<T>;
+  int64_t n = end - begin;
+  const T* in = logits + begin;
+  const fVec scale(params.inv_temperature);
+  int64_t i = 0;
+  if constexpr (std::is_same<T, float>::value) {
+    for (; i + fVec::size() <= n; i += fVec::size()) {
+      (fVec::loadu(in + i) * scale).store(out + i);
+    }
+  } else {
+    for (; i + bVec::size() <= n; i += bVec::size()) {
+      fVec x0, x1;
+      std::tie(x0, x1) = at::vec::convert_to_float<T>(bVec::loadu(in + i));
+      (x0 * scale).store(out + i);
+      (x1 * scale).store(out + i + fVec::size());
+    }
+  }
+  for (; i < n; i++) {
+    out[i] = static_cast<float>(in[i]) * params.inv_temperature;
+  }
+
+  // Penalties are applied on the raw logits, before temperature.
+  auto it = std::lower_bound(tokens.begin(), tokens.end(), begin);
+  for (; it != tokens.end() && *it < end; ++it) {
+    float score = static_cast<float>(in[*it - begin]);
+    score = score < 0 ? score * params.repetition_penalty
+                      : score / params.repetition_penalty;
+    score -= params.presence_penalty;
+    out[*it - begin] = score * params.inv_temperature;
+  }
+}
+
+// Max and sum of exp(x - max) of a chunk of scores.
+inline RunningLogSumExp chunk_log_sum_exp(const float* scores, int64_t n) {
+  using fVec = at::vec::Vectorized<float>;
+  RunningLogSumExp stats;
+  stats.max = at::vec::reduce_all<float>(
+      [](fVec& x, fVec& y) { return at::vec::maximum(x, y); }, scores, n);
+  if (stats.max == -std::numeric_limits<float>::infinity()) {
+    return stats;
+  }
+  const float max = stats.max;
+  stats.sum = at::vec::map_reduce_all<float>(
+      [max](fVec x) { return (x - fVec(max)).exp(); },
+      [](fVec& x, fVec& y) { return x + y; },
+      scores,
+      n);
+  return stats;
+}
+
+template <typename T>
+class FusedSampler {
+ public:
+  FusedSampler(
+      const at::Tensor& logits,
+      const at::Tensor& input_ids,
+      const SampleParams& params)
+      : logits_(logits.data_ptr<T>()),
+        batch_(logits.size(0)),
+        vocab_(logits.size(1)),
+        num_chunks_((vocab_ + kVocabChunk - 1) / kVocabChunk),
+        params_(params),
+        tokens_(batch_),
+        chunk_stats_(batch_ * num_chunks_),
+        topks_(at::get_num_threads() * batch_) {
+    bool penalize =
+        params.repetition_penalty != 1.f || params.presence_penalty != 0.f;
+    if (penalize) {
+      auto ids = input_ids.to(at::kLong).contiguous();
+      const int64_t* ids_ptr = ids.data_ptr<int64_t>();
+      int64_t seq_len = ids.size(1);
+      at::parallel_for(0, batch_, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; row++) {
+          auto& row_tokens = tokens_[row];
+          const int64_t* row_ids = ids_ptr + row * seq_len;
+          for (int64_t i = 0; i < seq_len; i++) {
+            if (row_ids[i] >= 0 && row_ids[i] < vocab_) {
+              row_tokens.push_back(row_ids[i]);
+            }
+          }
+          std::sort(row_tokens.begin(), row_tokens.end());
+          row_tokens.erase(
+              std::unique(row_tokens.begin(), row_tokens.end()),
+              row_tokens.end());
+        }
+      });
+    }
+  }
+
+  // One pass over the logits of rows: keeps the top k processed scores of
+  // every row (if k > 0) and, if needed, the log-sum-exp stats of every chunk.
+  void collect(const std::vector<int64_t>& rows, int64_t k, bool need_stats) {
+    int64_t num_threads = at::get_num_threads();
+    for (int64_t t = 0; t < num_threads; t++) {
+      for (auto row : rows) {
+        topks_[t * batch_ + row].reset(std::max<int64_t>(k, 1));
+      }
+    }
+    int64_t num_rows = rows.size();
+    at::parallel_for(
+        0, num_rows * num_chunks_, 1, [&](int64_t begin, int64_t end) {
+          int64_t tid = at::get_thread_num();
+          std::vector<float> scores(kVocabChunk);
+          for (int64_t work = begin; work < end; work++) {
+            int64_t row = rows[work / num_chunks_];
+            int64_t chunk = work % num_chunks_;
+            int64_t v_begin = chunk * kVocabChunk;
+            int64_t v_end = std::min(vocab_, v_begin + kVocabChunk);
+            load_scores<T>(
+                logits_ + row * vocab_,
+                v_begin,
+                v_end,
+                tokens_[row],
+                params_,
+                scores.data());
+            if (need_stats) {
+              chunk_stats_[row * num_chunks_ + chunk] =
+                  chunk_log_sum_exp(scores.data(), v_end - v_begin);
+            }
+            if (k > 0) {
+              auto& topk = topks_[tid * batch_ + row];
+              for (int64_t v = v_begin; v < v_end; v++) {
+                float score = scores[v - v_begin];
+                if (score >= topk.threshold()) {
+                  topk.push(score, v);
+                }
+              }
+            }
+          }
+        });
+  }
+
+  std::vector<std::pair<float, int64_t>> candidates(int64_t row) {
+    RunningTopK& result = topks_[row];
+    for (int64_t t = 1; t < at::get_num_threads(); t++) {
+      result.merge(topks_[t * batch_ + row]);
+    }
+    return result.sorted();
+  }
+
+  RunningLogSumExp row_stats(int64_t row) const {
+    RunningLogSumExp stats;
+    for (int64_t chunk = 0; chunk < num_chunks_; chunk++) {
+      stats.merge(chunk_stats_[row * num_chunks_ + chunk]);
+    }
+    return stats;
+  }
+
+  // Inverse CDF over the whole vocab: finds the chunk holding u of the mass
+  // from the chunk stats, then scans that chunk only.
+  int64_t sample_full(int64_t row, double u) {
+    RunningLogSumExp stats = row_stats(row);
+    if (stats.max == -std::numeric_limits<float>::infinity()) {
+      return 0;
+    }
+    double target = u * stats.sum;
+    int64_t chunk = 0;
+    for (; chunk < num_chunks_ - 1; chunk++) {
+      auto& c = chunk_stats_[row * num_chunks_ + chunk];
+      double mass = c.sum * std::exp(c.max - stats.max);
+      if (target < mass) {
+        break;
+      }
+      target -= mass;
+    }
+    int64_t v_begin = chunk * kVocabChunk;
+    int64_t v_end = std::min(vocab_, v_begin + kVocabChunk);
+    std::vector<float> scores(v_end - v_begin);
+    load_scores<T>(
+        logits_ + row * vocab_,
+        v_begin,
+        v_end,
+        tokens_[row],
+        params_,
+        scores.data());
+    int64_t last = -1;
+    for (int64_t v = v_begin; v < v_end; v++) {
+      double p = std::exp(scores[v - v_begin] - stats.max);
+      if (p > 0) {
+        last = v;
+        if (target < p) {
+          return v;
+        }
+        target -= p;
+      }
+    }
+    // Rounding left some mass behind, take the last token with any mass.
+    return last >= 0 ? last : v_begin;
+  }
+
+ private:
+  const T* logits_;
+  int64_t batch_;
+  int64_t vocab_;
+  int64_t num_chunks_;
+  SampleParams params_;
+  std::vector<std::vector<int64_t>> tokens_;
+  std::vector<RunningLogSumExp> chunk_stats_;
+  std::vector<RunningTopK> topks_;
+};
+
+// Probabilities of the sorted candidates kept by top-p, normalized over the
+// candidates (the top-k set) or over the whole vocab (vocab_stats). Returns
+// false if top-p needs more candidates than given.
+bool top_p_filter(
+    const std::vector<std::pair<float, int64_t>>& candidates,
+    double top_p,
+    bool over_vocab,
+    const RunningLogSumExp& vocab_stats,
+    std::vector<double>& probs) {
+  probs.clear();
+  if (candidates.empty()) {
+    return true;
+  }
+  double norm_max = over_vocab ? vocab_stats.max : candidates[0].first;
+  double norm_sum = over_vocab ? vocab_stats.sum : 0.0;
+  if (!over_vocab) {
+    for (auto& c : candidates) {
+      norm_sum += std::exp(c.first - norm_max);
+    }
+  }
+  double prefix = 0.0;
+  for (auto& c : candidates) {
+    // A token is kept while the mass of the tokens before it is below
+    // top_p, the first token is always kept.
+    if (!probs.empty() && prefix >= top_p) {
+      return true;
+    }
+    double p = std::exp(c.first - norm_max) / norm_sum;
+    probs.push_back(p);
+    prefix += p;
+  }
+  return !over_vocab || prefix >= top_p;
+}
+
+template <typename T>
+void fused_sample_impl(
+    const at::Tensor& logits,
+    const at::Tensor& input_ids,
+    double temperature,
+    double repetition_penalty,
+    double presence_penalty,
+    int64_t top_k,
+    double top_p,
+    const at::Tensor& seeds,
+    at::Tensor& next_tokens) {
+  int64_t batch = logits.size(0);
+  int64_t vocab = logits.size(1);
+  bool greedy = temperature <= 0;
+  SampleParams params{
+      greedy ? 1.f : static_cast<float>(1.0 / temperature),
+      static_cast<float>(repetition_penalty),
+      static_cast<float>(presence_penalty)};
+  FusedSampler<T> sampler(logits, input_ids, params);
+  auto out = next_tokens.data_ptr<int64_t>();
+  const int64_t* seeds_ptr = seeds.data_ptr<int64_t>();
+  uint64_t step = input_ids.size(1);
+
+  std::vector<int64_t> rows(batch);
+  std::iota(rows.begin(), rows.end(), 0);
+  bool use_top_k = top_k > 0;
+  bool use_top_p = top_p < 1.0;
+  // k == 0: plain multinomial over the vocab, no candidates are needed.
+  int64_t k = 0;
+  if (greedy) {
+    k = 1;
+  } else if (use_top_k) {
+    k = std::min(top_k, vocab);
+  } else if (use_top_p) {
+    k = std::min(kTopPCandidates, vocab);
+  }
+  bool need_stats = !greedy && !use_top_k;
+  while (!rows.empty()) {
+    sampler.collect(rows, k, need_stats);
+    std::vector<int64_t> retry;
+    for (auto row : rows) {
+      if (k == 0) {
+        out[row] = sampler.sample_full(
+            row, uniform_from_seed(seeds_ptr[row], step));
+        continue;
+      }
+      auto candidates = sampler.candidates(row);
+      if (candidates.empty()) {
+        out[row] = 0;
+        continue;
+      }
+      if (greedy) {
+        out[row] = candidates[0].second;
+        continue;
+      }
+      std::vector<double> probs;
+      if (use_top_p) {
+        if (!top_p_filter(
+                candidates,
+                top_p,
+                !use_top_k,
+                sampler.row_stats(row),
+                probs) &&
+            k < vocab) {
+          retry.push_back(row);
+          continue;
+        }
+      } else {
+        top_p_filter(candidates, 1.0, false, RunningLogSumExp(), probs);
+      }
+      double total = std::accumulate(probs.begin(), probs.end(), 0.0);
+      double target = uniform_from_seed(seeds_ptr[row], step) * total;
+      int64_t pick = probs.size() - 1;
+      for (int64_t i = 0; i < (int64_t)probs.size(); i++) {
+        if (target < probs[i]) {
+          pick = i;
+          break;
+        }
+        target -= probs[i];
+      }
+      out[row] = candidates[pick].second;
+    }
+    rows.swap(retry);
+    k = std::min(k * 4, vocab);
+  }
+}
+
+at::Tensor fused_sample_kernel_impl(
+    const at::Tensor& logits,
+    const at::Tensor& input_ids,
+    double temperature,
+    double repetition_penalty,
+    double presence_penalty,
+    int64_t top_k,
+    double top_p,
+    const at::Tensor& seeds) {
+  auto next_tokens =
+      at::empty({logits.size(0)}, logits.options().dtype(at::kLong));
+  if (logits.scalar_type() == at::kFloat) {
+    fused_sample_impl<float>(
+        logits,
+        input_ids,
+        temperature,
+        repetition_penalty,
+        presence_penalty,
+        top_k,
+        top_p,
+        seeds,
+        next_tokens);
+  } else if (logits.scalar_type() == at::kBFloat16) {
+    fused_sample_impl<at::BFloat16>(
+        logits,
+        input_ids,
+        temperature,
+        repetition_penalty,
+        presence_penalty,
+        top_k,
+        top_p,
+        seeds,
+        next_tokens);
+  } else if (logits.scalar_type() == at::kHalf) {
+    fused_sample_impl<at::Half>(
+        logits,
+        input_ids,
+        temperature,
+        repetition_penalty,
+        presence_penalty,
+        top_k,
+        top_p,
+        seeds,
+        next_tokens);
+  } else {
+    TORCH_CHECK(false, "fused_sample: unsupported logits dtype");
+  }
+  return next_tokens;
+}
+
+} // namespace
+
+IPEX_REGISTER_DISPATCH(fused_sample_kernel_stub, &fused_sample_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -0,0 +1,247 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <aten/GPTQ.h>
+#include <torch/csrc/autograd/function.h>
+
+#include <cmath>
+#include <limits>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Per-channel quantizer of GPTQ, the same as Quantizer of
+// quantization/_GPTQ/gptq/gptq.py for one row of the weight.
+struct RowQuantizer {
+  float maxq;
+  bool sym;
+  bool mse;
+  float norm;
+  int64_t grid;
+  double maxshrink;
+
+  inline float quantize(float x, float scale, float zero) const {
+    // nearbyint rounds half to even, like torch.round
+    float q = std::nearbyint(x / scale) + zero;
+    q = std::min(std::max(q, 0.f), maxq);
+    return scale * (q - zero);
+  }
+
+  void find_params(const float* x, int64_t n, float& scale, float& zero)
+      const {
+    float xmin = 0.f;
+    float xmax = 0.f;
+    for (int64_t i = 0; i < n; i++) {
+      xmin = std::min(xmin, x[i]);
+      xmax = std::max(xmax, x[i]);
+    }
+    if (sym) {
+      xmax = std::max(std::abs(xmin), xmax);
+      if (xmin < 0) {
+        xmin = -xmax;
+      }
+    }
+    if (xmin == 0 && xmax == 0) {
+      xmin = -1;
+      xmax = 1;
+    }
+    scale = (xmax - xmin) / maxq;
+    zero = sym ? (maxq + 1) / 2 : std::nearbyint(-xmin / scale);
+    if (!mse) {
+      return;
+    }
+    // Shrink the range while it lowers the norm of the quantization error
+    float best = std::numeric_limits<float>::infinity();
+    int64_t steps = static_cast<int64_t>(maxshrink * grid);
+    for (int64_t i = 0; i < steps; i++) {
+      float p = static_cast<float>(1 - static_cast<double>(i) / grid);
+      float xmin1 = p * xmin;
+      float xmax1 = p * xmax;
+      float scale1 = (xmax1 - xmin1) / maxq;
+      float zero1 = sym ? zero : std::nearbyint(-xmin1 / scale1);
+      float err = 0.f;
+      for (int64_t j = 0; j < n; j++) {
+        err += std::pow(std::abs(quantize(x[j], scale1, zero1) - x[j]), norm);
+      }
+      if (err < best) {
+        best = err;
+        scale = scale1;
+        zero = zero1;
+      }
+    }
+  }
+};
+
+// w[i] -= a * h[i]
+inline void sub_scaled(float* w, const float* h, float a, int64_t n) {
+  using fVec = at::vec::Vectorized<float>;
+  const fVec va(a);
+  int64_t i = 0;
+  for (; i + fVec::size() <= n; i += fVec::size()) {
+    auto vw = fVec::loadu(w + i) - va * fVec::loadu(h + i);
+    vw.store(w + i);
+  }
+  for (; i < n; i++) {
+    w[i] -= a * h[i];
+  }
+}
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor, at::Tensor, at::Tensor>
+gptq_quantize_kernel_impl(
+    const at::Tensor& weight,
+    const at::Tensor& hessian,
+    int64_t bits,
+    int64_t group_size,
+    bool sym,
+    bool act_order,
+    bool static_groups,
+    int64_t block_size,
+    double percdamp,
+    bool mse,
+    double norm,
+    int64_t grid,
+    double maxshrink) {
+  const int64_t N = weight.size(0);
+  const int64_t K = weight.size(1);
+  const RowQuantizer quantizer{
+      static_cast<float>((1 << bits) - 1),
+      sym,
+      mse,
+      static_cast<float>(norm),
+      grid,
+      maxshrink};
+  const bool grouped = group_size != -1;
+  const int64_t num_groups = grouped ? (K + group_size - 1) / group_size : 1;
+
+  auto W = weight.to(at::kFloat).contiguous().clone();
+  auto H = hessian.to(at::kFloat).contiguous().clone();
+  auto scale = at::empty({N, num_groups}, W.options());
+  auto zero = at::empty({N, num_groups}, W.options());
+  auto* w_ptr = W.data_ptr<float>();
+  auto* scale_ptr = scale.data_ptr<float>();
+  auto* zero_ptr = zero.data_ptr<float>();
+  // Parameters of the rows, or of the groups when they are static, from the
+  // weight before any error is propagated.
+  auto find_params_all = [&](bool per_group) {
+    at::parallel_for(0, N, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; r++) {
+        for (int64_t g = 0; g < num_groups; g++) {
+          int64_t start = per_group ? g * group_size : 0;
+          int64_t len = per_group ? std::min(group_size, K - start) : K;
+          quantizer.find_params(
+              w_ptr + r * K + start,
+              len,
+              scale_ptr[r * num_groups + g],
+              zero_ptr[r * num_groups + g]);
+        }
+      }
+    });
+  };
+  if (!grouped) {
+    find_params_all(false);
+  }
+
+  // Dead input channels make no contribution
+  auto dead = H.diagonal() == 0;
+  H.diagonal().masked_fill_(dead, 1);
+  W.masked_fill_(dead.unsqueeze(0), 0);
+
+  if (grouped && static_groups) {
+    find_params_all(true);
+  }
+
+  at::Tensor perm = at::empty({0}, at::kLong);
+  if (act_order) {
+    perm = at::argsort(H.diagonal(), 0, true);
+    W = W.index_select(1, perm).contiguous();
+    H = H.index_select(0, perm).index_select(1, perm);
+    w_ptr = W.data_ptr<float>();
+  }
+  auto* perm_ptr = act_order ? perm.data_ptr<int64_t>() : nullptr;
+
+  H.diagonal().add_(percdamp * H.diagonal().mean());
+  auto Hinv = at::linalg_cholesky(
+                  at::cholesky_inverse(at::linalg_cholesky(H)), /*upper=*/true)
+                  .contiguous();
+  auto* hinv_ptr = Hinv.data_ptr<float>();
+
+  auto Q = at::empty({N, K}, W.options());
+  auto* q_ptr = Q.data_ptr<float>();
+  std::vector<double> row_loss(N, 0.);
+
+  for (int64_t i1 = 0; i1 < K; i1 += block_size) {
+    const int64_t i2 = std::min(i1 + block_size, K);
+    const int64_t count = i2 - i1;
+    auto Err = at::empty({N, count}, W.options());
+    auto* err_ptr = Err.data_ptr<float>();
+    // The rows are independent within a block: each one quantizes its
+    // columns and propagates the errors to the rest of the block.
+    at::parallel_for(0, N, 1, [&](int64_t begin, int64_t end) {
+      std::vector<float> w1(count);
+      for (int64_t r = begin; r < end; r++) {
+        const float* w_row = w_ptr + r * K;
+        std::copy(w_row + i1, w_row + i2, w1.begin());
+        double loss = 0.;
+        for (int64_t i = 0; i < count; i++) {
+          const int64_t col = i1 + i;
+          int64_t g = 0;
+          if (grouped) {
+            if (static_groups) {
+              g = (act_order ? perm_ptr[col] : col) / group_size;
+            } else {
+              g = col / group_size;
+              if (col % group_size == 0) {
+                // From the columns as updated by the previous blocks, as the
+                // Python implementation does
+                quantizer.find_params(
+                    w_row + col,
+                    std::min(group_size, K - col),
+                    scale_ptr[r * num_groups + g],
+                    zero_ptr[r * num_groups + g]);
+              }
+            }
+          }
+          const float w = w1[i];
+          const float q = quantizer.quantize(
+              w, scale_ptr[r * num_groups + g], zero_ptr[r * num_groups + g]);
+          const float* hinv_row = hinv_ptr + col * K;
+          const float d = hinv_row[col];
+          const float err = (w - q) / d;
+          q_ptr[r * K + col] = q;
+          loss += static_cast<double>(err) * err;
+          sub_scaled(
+              w1.data() + i + 1, hinv_row + col + 1, err, count - i - 1);
+          err_ptr[r * count + i] = err;
+        }
+        row_loss[r] += loss;
+      }
+    });
+    if (i2 < K) {
+      W.narrow(1, i2, K - i2)
+          .addmm_(Err, Hinv.slice(0, i1, i2).slice(1, i2, K), 1, -1);
+    }
+  }
+
+  if (act_order) {
+    Q = Q.index_select(1, at::argsort(perm));
+  }
+  double loss = 0.;
+  for (auto l : row_loss) {
+    loss += l;
+  }
+  return std::make_tuple(
+      Q.to(weight.scalar_type()),
+      scale,
+      zero,
+      perm,
+      at::scalar_tensor(loss / 2, at::kFloat));
+}
+
+} // namespace
+
+IPEX_REGISTER_DISPATCH(gptq_quantize_kernel_stub, &gptq_quantize_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
@@ -29,6 +29,84 @@ namespace cpu {
 
 namespace {
 
+template <typename Vec, typename T>
+inline Vec LoadPartial(const T* ptr, int64_t count) {
+  return count == Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, count);
+}
+
+template <typename opmath_t>
+inline at::vec::Vectorized<opmath_t> ApplyAct(
+    at::vec::Vectorized<opmath_t> x,
+    GroupNormAct act) {
+  using fVec = at::vec::Vectorized<opmath_t>;
+  switch (act) {
+    case GroupNormAct::SiLU:
+      return x / (fVec(1) + x.neg().exp());
+    case GroupNormAct::GELU:
+      return fVec(0.5) * x * (fVec(1) + (x * fVec(M_SQRT1_2)).erf());
+    case GroupNormAct::GELUTanh: {
+      const fVec kBeta(M_SQRT2 * M_2_SQRTPI * 0.5);
+      const fVec kKappa(0.044715);
+      auto inner = kBeta * (x + kKappa * x * x * x);
+      return fVec(0.5) * x * (fVec(1) + inner.tanh());
+    }
+    default:
+      return x;
+  }
+}
+
+// Fused epilogue of ApplyScaleBias: Y = act(X * scale + bias) + other over
+// len elements, other being optional. scale and bias are per element, or a
+// single value for the whole row when broadcast.
+template <typename T, typename opmath_t>
+inline void ApplyScaleBiasAct(
+    T* Y_ptr,
+    const T* X_ptr,
+    const T* other_ptr,
+    const opmath_t* scale_ptr,
+    const opmath_t* bias_ptr,
+    bool broadcast,
+    GroupNormAct act,
+    int64_t len) {
+  using fVec = at::vec::Vectorized<opmath_t>;
+  using Vec = at::vec::Vectorized<T>;
+  auto scale_bias = [&](fVec x, int64_t d, int64_t count) {
+    if (broadcast) {
+      return ApplyAct<opmath_t>(x * fVec(*scale_ptr) + fVec(*bias_ptr), act);
+    }
+    return ApplyAct<opmath_t>(
+        x * LoadPartial<fVec>(scale_ptr + d, count) +
+            LoadPartial<fVec>(bias_ptr + d, count),
+        act);
+  };
+  for (int64_t d = 0; d < len; d += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), len - d);
+    if constexpr (std::is_same<T, opmath_t>::value) {
+      fVec out = scale_bias(LoadPartial<Vec>(X_ptr + d, count), d, count);
+      if (other_ptr != nullptr) {
+        out = out + LoadPartial<Vec>(other_ptr + d, count);
+      }
+      out.store(Y_ptr + d, count);
+    } else {
+      const int64_t count0 = std::min<int64_t>(fVec::size(), count);
+      const int64_t count1 = count - count0;
+      fVec data_fvec0, data_fvec1;
+      std::tie(data_fvec0, data_fvec1) =
+          convert_to_float<T>(LoadPartial<Vec>(X_ptr + d, count));
+      fVec out0 = scale_bias(data_fvec0, d, count0);
+      fVec out1 = scale_bias(data_fvec1, d + fVec::size(), count1);
+      if (other_ptr != nullptr) {
+        fVec other_fvec0, other_fvec1;
+        std::tie(other_fvec0, other_fvec1) =
+            convert_to_float<T>(LoadPartial<Vec>(other_ptr + d, count));
+        out0 = out0 + other_fvec0;
+        out1 = out1 + other_fvec1;
+      }
+      convert_from_float<T>(out0, out1).store(Y_ptr + d, count);
+    }
+  }
+}
+
 template <typename T, typename PT>
 void GroupNormKernelImplInternal(
     const at::Tensor& X,
@@ -39,6 +117,8 @@ void GroupNormKernelImplInternal(
     int64_t HxW,
     int64_t group,
     double eps,
+    GroupNormAct act,
+    const at::Tensor& other,
     at::Tensor& Y,
     at::Tensor& mean,
     at::Tensor& rstd) {
@@ -53,8 +133,10 @@ void GroupNormKernelImplInternal(
   T* Y_data = Y.data_ptr<T>();
   PT* mean_data = mean.data_ptr<PT>();
   PT* rstd_data = rstd.data_ptr<PT>();
+  const T* other_data = other.defined() ? other.data_ptr<T>() : nullptr;
   const bool gamma_null = (gamma_data == nullptr);
   const bool beta_null = beta_data == nullptr;
+  const bool fused = act != GroupNormAct::None || other_data != nullptr;
   const int64_t inner_size = D * HxW;
 
   using opmath_t = at::opmath_type<T>;
@@ -67,7 +149,7 @@ void GroupNormKernelImplInternal(
       std::tie(mean_val, rstd_val) =
           at::native::RowwiseMoments(X_ptr, inner_size);
       rstd_val = opmath_t(1) / std::sqrt(std::max(rstd_val, opmath_t(0)) + eps);
-      if (gamma_null && beta_null) {
+      if (gamma_null && beta_null && !fused) {
         T* Y_ptr = Y_data + i * inner_size;
         for (const auto j : c10::irange(inner_size)) {
           Y_ptr[j] = (X_ptr[j] - mean_val) * rstd_val;
@@ -82,6 +164,13 @@ void GroupNormKernelImplInternal(
               (beta_null ? opmath_t(0) : opmath_t(beta_data[c]));
           X_ptr = X_data + (i * D + j) * HxW;
           T* Y_ptr = Y_data + (i * D + j) * HxW;
+          if (fused) {
+            const T* other_ptr =
+                other_data ? other_data + (i * D + j) * HxW : nullptr;
+            ApplyScaleBiasAct<T, opmath_t>(
+                Y_ptr, X_ptr, other_ptr, &scale, &bias, true, act, HxW);
+            continue;
+          }
           for (const auto k : c10::irange(HxW)) {
             Y_ptr[k] = scale * X_ptr[k] + bias;
           }
@@ -304,6 +393,8 @@ void GroupNormKernelImplChannelsLastInternal(
     int64_t HxW,
     int64_t group,
     double eps,
+    GroupNormAct act,
+    const at::Tensor& other,
     at::Tensor& Y,
     at::Tensor& mean,
     at::Tensor& rstd) {
@@ -318,6 +409,8 @@ void GroupNormKernelImplChannelsLastInternal(
   T* Y_data = Y.data_ptr<T>();
   PT* mean_data = mean.data_ptr<PT>();
   PT* rstd_data = rstd.data_ptr<PT>();
+  const T* other_data = other.defined() ? other.data_ptr<T>() : nullptr;
+  const bool fused = act != GroupNormAct::None || other_data != nullptr;
 
   using opmath_t = at::opmath_type<T>;
 
@@ -385,9 +478,16 @@ void GroupNormKernelImplChannelsLastInternal(
 
         // step-3: apply scale and bias
         for (const auto m : c10::irange(HxW)) {
-          const T* X_ptr = X_data + n * HxW * C + m * C + g * D;
-          T* Y_ptr = Y_data + n * HxW * C + m * C + g * D;
-          ApplyScaleBias<T, opmath_t>(Y_ptr, X_ptr, scale_ptr, bias_ptr, D);
+          const int64_t offset = n * HxW * C + m * C + g * D;
+          const T* X_ptr = X_data + offset;
+          T* Y_ptr = Y_data + offset;
+          if (fused) {
+            const T* other_ptr = other_data ? other_data + offset : nullptr;
+            ApplyScaleBiasAct<T, opmath_t>(
+                Y_ptr, X_ptr, other_ptr, scale_ptr, bias_ptr, false, act, D);
+          } else {
+            ApplyScaleBias<T, opmath_t>(Y_ptr, X_ptr, scale_ptr, bias_ptr, D);
+          }
         }
         at::native::data_index_step(n, N, g, G);
       }
@@ -497,14 +597,20 @@ void GroupNormKernelImplChannelsLastInternal(
         T* Y_ptr = Y_data + i * C;
         opmath_t* scale_ptr = buffer_data + n * 2 * C;
         opmath_t* bias_ptr = scale_ptr + C;
-        ApplyScaleBias<T, opmath_t>(Y_ptr, X_ptr, scale_ptr, bias_ptr, C);
+        if (fused) {
+          const T* other_ptr = other_data ? other_data + i * C : nullptr;
+          ApplyScaleBiasAct<T, opmath_t>(
+              Y_ptr, X_ptr, other_ptr, scale_ptr, bias_ptr, false, act, C);
+        } else {
+          ApplyScaleBias<T, opmath_t>(Y_ptr, X_ptr, scale_ptr, bias_ptr, C);
+        }
         at::native::data_index_step(n, N, m, HxW);
       }
     });
   }
 }
 
-void GroupNormKernelImpl(
+void GroupNormActKernelImpl(
     const at::Tensor& X,
     const at::Tensor& gamma,
     const at::Tensor& beta,
@@ -513,6 +619,8 @@ void GroupNormKernelImpl(
     int64_t HxW,
     int64_t group,
     double eps,
+    GroupNormAct act,
+    const at::Tensor& other,
     at::Tensor& Y,
     at::Tensor& mean,
     at::Tensor& rstd) {
@@ -523,24 +631,72 @@ void GroupNormKernelImpl(
           at::ScalarType::BFloat16,
           at::ScalarType::Half,
           X.scalar_type(),
-          "GroupNormKernelImpl",
+          "GroupNormActKernelImpl",
           [&]() {
             using param_t = at::opmath_type<scalar_t>;
             if (!is_channels_last_1d(X)) {
               if (mixed_type) {
                 GroupNormKernelImplInternal<scalar_t, param_t>(
-                    X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                    X,
+                    gamma,
+                    beta,
+                    N,
+                    C,
+                    HxW,
+                    group,
+                    eps,
+                    act,
+                    other,
+                    Y,
+                    mean,
+                    rstd);
               } else {
                 GroupNormKernelImplInternal<scalar_t, scalar_t>(
-                    X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                    X,
+                    gamma,
+                    beta,
+                    N,
+                    C,
+                    HxW,
+                    group,
+                    eps,
+                    act,
+                    other,
+                    Y,
+                    mean,
+                    rstd);
               }
             } else {
               if (mixed_type) {
                 GroupNormKernelImplChannelsLastInternal<scalar_t, param_t>(
-                    X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                    X,
+                    gamma,
+                    beta,
+                    N,
+                    C,
+                    HxW,
+                    group,
+                    eps,
+                    act,
+                    other,
+                    Y,
+                    mean,
+                    rstd);
               } else {
                 GroupNormKernelImplChannelsLastInternal<scalar_t, scalar_t>(
-                    X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                    X,
+                    gamma,
+                    beta,
+                    N,
+                    C,
+                    HxW,
+                    group,
+                    eps,
+                    act,
+                    other,
+                    Y,
+                    mean,
+                    rstd);
               }
             }
           });
@@ -552,15 +708,39 @@ void GroupNormKernelImpl(
           at::ScalarType::BFloat16,
           at::ScalarType::Half,
           X.scalar_type(),
-          "GroupNormKernelImpl",
+          "GroupNormActKernelImpl",
           [&]() {
             using param_t = at::opmath_type<scalar_t>;
             if (mixed_type) {
               GroupNormKernelImplChannelsLastInternal<scalar_t, param_t>(
-                  X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                  X,
+                  gamma,
+                  beta,
+                  N,
+                  C,
+                  HxW,
+                  group,
+                  eps,
+                  act,
+                  other,
+                  Y,
+                  mean,
+                  rstd);
             } else {
               GroupNormKernelImplChannelsLastInternal<scalar_t, scalar_t>(
-                  X, gamma, beta, N, C, HxW, group, eps, Y, mean, rstd);
+                  X,
+                  gamma,
+                  beta,
+                  N,
+                  C,
+                  HxW,
+                  group,
+                  eps,
+                  act,
+                  other,
+                  Y,
+                  mean,
+                  rstd);
             }
           });
       break;
@@ -572,6 +752,34 @@ void GroupNormKernelImpl(
   }
 }
 
+void GroupNormKernelImpl(
+    const at::Tensor& X,
+    const at::Tensor& gamma,
+    const at::Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    at::Tensor& Y,
+    at::Tensor& mean,
+    at::Tensor& rstd) {
+  GroupNormActKernelImpl(
+      X,
+      gamma,
+      beta,
+      N,
+      C,
+      HxW,
+      group,
+      eps,
+      GroupNormAct::None,
+      at::Tensor(),
+      Y,
+      mean,
+      rstd);
+}
+
 template <typename T, typename opmath_t>
 typename std::enable_if<std::is_same<T, opmath_t>::value, void>::type
 ComputeInternalGradients(
@@ -1737,6 +1945,7 @@ void GroupNormBackwardKernelImpl(
 } // namespace
 
 IPEX_REGISTER_DISPATCH(GroupNormKernel, &GroupNormKernelImpl);
+IPEX_REGISTER_DISPATCH(GroupNormActKernel, &GroupNormActKernelImpl);
 IPEX_REGISTER_DISPATCH(GroupNormBackwardKernel, &GroupNormBackwardKernelImpl);
 
 } // namespace cpu
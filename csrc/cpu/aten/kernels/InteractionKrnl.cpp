@@ -1,5 +1,6 @@
 // Copyright (c) Facebook, Inc. and its affiliates. All Rights Reserved.
 #include "aten/Interaction.h"
+#include "aten/MergedEmbCat.h"
 #include "autocast/autocast_mode.h"
 #include "cpu/kernels/Interaction.h"
 #include "ideep/IDeepConversions.h"
@@ -11,6 +12,9 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/function.h>
 #include <algorithm>
+#ifdef USE_LIBXSMM
+#include "tpp/xsmm_functors.h"
+#endif
 /*
  Custom op to optimize DLRM interaction part
 */
@@ -442,323 +446,260 @@ inline std::vector<at::Tensor> _interaction_backward(
   return output;
 }
 
-#if defined(CPU_CAPABILITY_AMX)
-typedef struct tileconfig_t {
-  uint8_t palette_id;
-  uint8_t startRow;
-  uint8_t reserved[14];
-  uint16_t colb[16];
-  uint8_t rows[16];
-} tileconfig_t;
-
-const uint8_t TILE_M = 16;
-const uint8_t TILE_N = 16;
-const uint8_t TILE_IK = 64;
-const uint8_t TILE_BK = 32;
+#ifdef USE_LIBXSMM
+// Shape-generic interaction on the libxsmm BRGEMM, which generates AMX,
+// AVX512 (VNNI/BF16) or AVX2 code for the running CPU. The features of a
+// sample A [feature_nums, feature_size] go through one GEMM per sample with
+// the B operand in the VNNI layout [K / V][N][V], V being 1 for fp32, 2 for
+// bf16 and 4 for int8. The kernel is JIT-ed once per shape, and each thread
+// sets the tile config up once for its block of samples.
 
-static tileconfig_t tc = {0};
-template <typename res_type, typename src_type>
-inline void set_tile_config(
-    const uint8_t TILE_M,
-    const uint8_t TILE_N,
-    const uint8_t TILE_K,
-    const uint8_t KPACK) {
-  tc.palette_id = 1;
-  // tc.startRow = 0;
-  // Configure C tiles
-  for (int t = 0; t < 4; ++t) {
-    tc.rows[t] = (uint8_t)TILE_M;
-    tc.colb[t] = (uint16_t)(TILE_N * sizeof(res_type));
+// A' of the features A [feature_nums, feature_size] in the VNNI layout
+// [feature_size_pad / vnni][feature_nums][vnni], the padding is left as is.
+template <typename T>
+static inline void transpose_to_vnni(
+    T* out,
+    const std::vector<T*>& in_ptr,
+    int64_t feature_size,
+    int64_t vnni) {
+  int64_t feature_nums = in_ptr.size();
+  for (int64_t f = 0; f < feature_nums; f++) {
+    T* outp = out + f * vnni;
+    for (int64_t k = 0; k < feature_size; k += vnni) {
+      move_ker(outp, in_ptr[f] + k, std::min(vnni, feature_size - k));
+      outp += feature_nums * vnni;
+    }
   }
-  // Configure A tiles
-  for (int t = 4; t < 6; ++t) {
-    tc.rows[t] = (uint8_t)TILE_M;
-    tc.colb[t] = (uint16_t)(TILE_K * sizeof(src_type));
+}
+
+// The features A [feature_nums, feature_size] in the VNNI layout
+// [feature_nums_pad / vnni][feature_size][vnni], the padding is left as is.
+template <typename T>
+static inline void cat_to_vnni(
+    T* out,
+    const std::vector<T*>& in_ptr,
+    int64_t feature_size,
+    int64_t vnni) {
+  int64_t feature_nums = in_ptr.size();
+  for (int64_t f = 0; f < feature_nums; f++) {
+    T* outp = out + (f / vnni) * feature_size * vnni + f % vnni;
+    const T* in = in_ptr[f];
+    for (int64_t k = 0; k < feature_size; k++) {
+      outp[k * vnni] = in[k];
+    }
   }
-  // Configure B tile. B effectively has 64 rows and 16 columns.
-  for (int t = 6; t < 8; ++t) {
-    tc.rows[t] = (uint8_t)(TILE_K / KPACK);
-    tc.colb[t] = (uint16_t)(TILE_N * KPACK * sizeof(src_type));
+}
+#endif
+
+// Computes A A' of each sample into a [feature_nums, feature_nums] Tacc
+// buffer. load(sample, a, lda) writes the features of the sample to the rows
+// of a, store(sample, a, buffer) consumes the product.
+template <typename T, typename Tacc, typename Load, typename Store>
+static inline void _interaction_gemm(
+    int64_t batch_size,
+    int64_t feature_nums,
+    int64_t feature_size,
+    const Load& load,
+    const Store& store) {
+#ifdef USE_LIBXSMM
+  int64_t vnni = tpp::get_vnni_block_size<T>();
+  int64_t feature_size_pad = (feature_size + vnni - 1) / vnni * vnni;
+  auto gemm = tpp::BrgemmTPP<T, Tacc>(
+      feature_nums,
+      feature_nums,
+      feature_size_pad,
+      0,
+      0,
+      feature_size_pad,
+      feature_nums,
+      feature_nums,
+      /*beta*/ 0.0,
+      /*a_trans*/ 0,
+      /*unroll_hint*/ 1,
+      /*b_vnni*/ vnni > 1,
+      /*is_s8s8*/ true);
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    auto a_elems = feature_nums * feature_size_pad;
+    T a_buf[a_elems] __attribute__((aligned(64)));
+    zero_ker(a_buf, a_elems);
+    T a_t_buf[a_elems] __attribute__((aligned(64)));
+    zero_ker(a_t_buf, a_elems);
+    Tacc mm_buf[feature_nums * feature_nums] __attribute__((aligned(64)));
+    std::vector<T*> a_ptr(feature_nums);
+    for (int64_t n = 0; n < feature_nums; n++) {
+      a_ptr[n] = &a_buf[n * feature_size_pad];
+    }
+    gemm.config();
+    for (int64_t i = start; i < end; i++) {
+      load(i, a_buf, feature_size_pad);
+      transpose_to_vnni<T>(a_t_buf, a_ptr, feature_size, vnni);
+      gemm(a_buf, a_t_buf, mm_buf, 1, true);
+      store(i, a_buf, mm_buf);
+    }
+    gemm.release();
+  });
+#else
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    T a_buf[feature_nums * feature_size] __attribute__((aligned(64)));
+    Tacc mm_buf[feature_nums * feature_nums] __attribute__((aligned(64)));
+    for (int64_t i = start; i < end; i++) {
+      load(i, a_buf, feature_size);
+      // Only the lower triangle is consumed
+      for (int64_t f1 = 1; f1 < feature_nums; f1++) {
+        const T* v1 = &a_buf[f1 * feature_size];
+        for (int64_t f2 = 0; f2 < f1; f2++) {
+          const T* v2 = &a_buf[f2 * feature_size];
+          Tacc acc = 0;
+#pragma omp simd reduction(+ : acc)
+          for (int64_t k = 0; k < feature_size; k++) {
+            acc += (Tacc)v1[k] * (Tacc)v2[k];
+          }
+          mm_buf[f1 * feature_nums + f2] = acc;
+        }
+      }
+      store(i, a_buf, mm_buf);
+    }
+  });
+#endif
+}
+
+// Writes the dense feature and the lower triangle of A A' of a sample
+template <typename T>
+static inline void store_interaction(
+    T* out,
+    const T* dense,
+    const float* mm_buf,
+    int64_t feature_nums,
+    int64_t feature_size) {
+  move_ker(out, dense, feature_size);
+  T* flat_buf = out + feature_size;
+  int64_t offset = 0;
+  for (int64_t f = 1; f < feature_nums; f++) {
+    move_ker(&flat_buf[offset], &mm_buf[f * feature_nums], f);
+    offset += f;
   }
 }
 
-template <>
-inline at::Tensor _interaction_forward<at::BFloat16>(
+#ifdef USE_LIBXSMM
+template <typename T>
+inline at::Tensor _interaction_forward_brgemm(
     const std::vector<at::Tensor>& input) {
   RECORD_FUNCTION(
-      "_interaction_forward_bfloat16", c10::ArrayRef<c10::IValue>({}));
-  uint32_t total_feature_size = 0;
+      "_interaction_forward_brgemm", c10::ArrayRef<c10::IValue>({}));
   int64_t batch_size = input[0].sizes()[0];
-  int32_t feature_size = input[0].sizes()[1];
-  int32_t feature_nums = input.size();
-  std::vector<at::BFloat16*> input_data(feature_nums);
+  int64_t feature_size = input[0].sizes()[1];
+  int64_t feature_nums = input.size();
+  std::vector<T*> input_data(feature_nums);
   for (int i = 0; i < feature_nums; i++) {
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(input[i].is_contiguous());
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(input[i].dim() == 2);
     TORCH_CHECK(
         input[i].sizes()[1] == feature_size,
         "expect all inputs have same feature size");
-    input_data[i] = input[i].data_ptr<at::BFloat16>();
+    input_data[i] = input[i].data_ptr<T>();
   }
   auto interact_feature_size = feature_nums * (feature_nums - 1) / 2;
   auto out_data_line_len = interact_feature_size + feature_size;
   auto out = at::empty({batch_size, out_data_line_len}, input[0].options());
-  auto out_data = out.data_ptr<at::BFloat16>();
-
-  set_tile_config<float, at::BFloat16>(TILE_M, TILE_N, TILE_BK, 2);
-
-  int32_t _AM = ((feature_nums + 31) >> 5) << 5;
-  int32_t _AK = ((feature_size + 63) >> 6) << 6; // align to 64
-  int32_t A_Stride = _AK * sizeof(at::BFloat16);
-  int32_t B_Stride = _AM * sizeof(at::BFloat16) * 2;
-  int32_t C_Stride = _AM * sizeof(float);
-
-  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
-    const int32_t vector_len = feature_size * sizeof(at::BFloat16);
-    float Cmem[_AM][_AM] __attribute__((aligned(64)));
-    at::BFloat16 Amem[_AM][_AK] __attribute__((aligned(64)));
-    zero_ker(&Amem[0][0], _AM * _AK);
-    at::BFloat16 Bmem[_AK >> 1][_AM][2] __attribute__((aligned(64)));
-
-    _tile_loadconfig((const void*)&tc);
-
-    std::vector<at::BFloat16*> input_ptr(feature_nums);
-    for (uint32_t n = 0; n < feature_nums; n++) {
-      input_ptr[n] = &input_data[n][start * feature_size];
-      unsigned char* inp = (unsigned char*)(input_ptr[n]);
-      for (int cache_line = 0; cache_line < vector_len; cache_line += 64) {
-        _mm_prefetch(inp + cache_line, _MM_HINT_T0);
-      }
-    }
-    for (int64_t i = start; i < end; i++) {
-      move_ker(&out_data[i * out_data_line_len], input_ptr[0], feature_size);
-      cat<at::BFloat16>(&Amem[0][0], input_ptr, feature_size, _AK);
-      for (int k = 0; k < (_AK >> 1); k++) {
-        int32_t ak = (k << 1);
-        for (int n = 0; n < _AM - 15; n += 16) {
-          (*(uint32_t*)Bmem[k][n]) = (*(uint32_t*)(&Amem[n][ak]));
-          (*(uint32_t*)Bmem[k][n + 1]) = (*(uint32_t*)(&Amem[n + 1][ak]));
-          (*(uint32_t*)Bmem[k][n + 2]) = (*(uint32_t*)(&Amem[n + 2][ak]));
-          (*(uint32_t*)Bmem[k][n + 3]) = (*(uint32_t*)(&Amem[n + 3][ak]));
-          (*(uint32_t*)Bmem[k][n + 4]) = (*(uint32_t*)(&Amem[n + 4][ak]));
-          (*(uint32_t*)Bmem[k][n + 5]) = (*(uint32_t*)(&Amem[n + 5][ak]));
-          (*(uint32_t*)Bmem[k][n + 6]) = (*(uint32_t*)(&Amem[n + 6][ak]));
-          (*(uint32_t*)Bmem[k][n + 7]) = (*(uint32_t*)(&Amem[n + 7][ak]));
-          (*(uint32_t*)Bmem[k][n + 8]) = (*(uint32_t*)(&Amem[n + 8][ak]));
-          (*(uint32_t*)Bmem[k][n + 9]) = (*(uint32_t*)(&Amem[n + 9][ak]));
-          (*(uint32_t*)Bmem[k][n + 10]) = (*(uint32_t*)(&Amem[n + 10][ak]));
-          (*(uint32_t*)Bmem[k][n + 11]) = (*(uint32_t*)(&Amem[n + 11][ak]));
-          (*(uint32_t*)Bmem[k][n + 12]) = (*(uint32_t*)(&Amem[n + 12][ak]));
-          (*(uint32_t*)Bmem[k][n + 13]) = (*(uint32_t*)(&Amem[n + 13][ak]));
-          (*(uint32_t*)Bmem[k][n + 14]) = (*(uint32_t*)(&Amem[n + 14][ak]));
-          (*(uint32_t*)Bmem[k][n + 15]) = (*(uint32_t*)(&Amem[n + 15][ak]));
-        }
-      }
-      for (int n = 0; n < _AM; n += 2 * TILE_N) {
-        for (int m = 0; m < _AM; m += 2 * TILE_M) {
-          _tile_zero(0);
-          _tile_zero(2);
-          //_tile_zero(1);
-          _tile_zero(3);
-          for (int k = 0; k < _AK; k += 2 * TILE_BK) {
-            int32_t bk = k >> 1;
-            int32_t bk1 = (k + TILE_BK) >> 1;
-            _tile_loadd(6, Bmem[bk][n], B_Stride);
-            _tile_loadd(7, Bmem[bk1][n], B_Stride);
-            _tile_loadd(4, &Amem[m][k], A_Stride);
-            _tile_dpbf16ps(0, 4, 6);
-            _tile_loadd(4, &Amem[m][k + TILE_BK], A_Stride);
-            _tile_dpbf16ps(0, 4, 7);
-            _tile_loadd(5, &Amem[m + TILE_M][k], A_Stride);
-            _tile_loadd(4, &Amem[m + TILE_M][k + TILE_BK], A_Stride);
-            _tile_dpbf16ps(2, 5, 6);
-            _tile_dpbf16ps(2, 4, 7);
-            _tile_loadd(6, Bmem[bk][n + TILE_N], B_Stride);
-            _tile_dpbf16ps(3, 5, 6);
-            _tile_loadd(7, Bmem[bk1][n + TILE_N], B_Stride);
-            _tile_dpbf16ps(3, 4, 7);
-            if (k == (_AK - 2 * TILE_BK)) {
-              _tile_stored(0, &Cmem[m][n], C_Stride);
-              _tile_stored(2, &Cmem[m + TILE_M][n], C_Stride);
-              _tile_stored(3, &Cmem[m + TILE_M][n + TILE_N], C_Stride);
-            }
-          }
-        }
-      }
+  auto out_data = out.data_ptr<T>();
 
-      for (uint32_t n = 0; n < feature_nums; n++) {
-        input_ptr[n] += feature_size;
-        unsigned char* inp = (unsigned char*)(input_ptr[n]);
-        for (int cache_line = 0; cache_line < vector_len; cache_line += 64) {
-          _mm_prefetch(inp + cache_line, _MM_HINT_T0);
+  _interaction_gemm<T, float>(
+      batch_size,
+      feature_nums,
+      feature_size,
+      [&](int64_t i, T* a, int64_t lda) {
+        for (int64_t f = 0; f < feature_nums; f++) {
+          move_ker(&a[f * lda], &input_data[f][i * feature_size], feature_size);
         }
-      }
-
-      at::BFloat16* flat_buf =
-          (at::BFloat16*)(&out_data[i * out_data_line_len] + feature_size);
-      size_t offset = 0;
-      for (int i = 1; i < feature_nums; i++) {
-        move_ker_load_aligned(&flat_buf[offset], Cmem[i], i);
-        offset += i;
-      }
-    }
-  });
+      },
+      [&](int64_t i, const T* a, const float* mm_buf) {
+        store_interaction(
+            &out_data[i * out_data_line_len],
+            a,
+            mm_buf,
+            feature_nums,
+            feature_size);
+      });
   return out;
 }
 
-template <>
-inline std::vector<at::Tensor> _interaction_backward<at::BFloat16>(
+template <typename T>
+inline std::vector<at::Tensor> _interaction_backward_brgemm(
     const at::Tensor& grad_out,
     const std::vector<at::Tensor>& input) {
   TORCH_INTERNAL_ASSERT_DEBUG_ONLY(grad_out.is_contiguous());
   RECORD_FUNCTION(
-      "_interaction_backward_bfloat16", c10::ArrayRef<c10::IValue>({}));
-  int32_t total_feature_size = 0;
+      "_interaction_backward_brgemm", c10::ArrayRef<c10::IValue>({}));
   int64_t batch_size = input[0].sizes()[0];
-  int32_t feature_size = input[0].sizes()[1];
-  int32_t feature_nums = input.size();
+  int64_t feature_size = input[0].sizes()[1];
+  int64_t feature_nums = input.size();
   std::vector<at::Tensor> output(feature_nums);
-  std::vector<at::BFloat16*> input_data(feature_nums);
-  std::vector<at::BFloat16*> output_data(feature_nums);
+  std::vector<T*> input_data(feature_nums);
+  std::vector<T*> output_data(feature_nums);
   for (int i = 0; i < feature_nums; i++) {
     output[i] = at::empty({batch_size, feature_size}, input[i].options());
-    input_data[i] = input[i].data_ptr<at::BFloat16>();
-    output_data[i] = output[i].data_ptr<at::BFloat16>();
+    input_data[i] = input[i].data_ptr<T>();
+    output_data[i] = output[i].data_ptr<T>();
   }
   auto interact_feature_size = feature_nums * (feature_nums - 1) / 2;
   auto grad_out_data_line_len = interact_feature_size + feature_size;
-  auto grad_out_data = grad_out.data_ptr<at::BFloat16>();
+  auto grad_out_data = grad_out.data_ptr<T>();
+
+  // gA = {gy + gy', A}, see _interaction_backward, with the K dim of the GEMM
+  // being feature_nums padded to the VNNI block
+  int64_t vnni = tpp::get_vnni_block_size<T>();
+  int64_t feature_nums_pad = (feature_nums + vnni - 1) / vnni * vnni;
+  auto gemm = tpp::BrgemmTPP<T, float>(
+      feature_nums,
+      feature_size,
+      feature_nums_pad,
+      0,
+      0,
+      feature_nums_pad,
+      feature_size,
+      feature_size,
+      /*beta*/ 0.0,
+      /*a_trans*/ 0,
+      /*unroll_hint*/ 1,
+      /*b_vnni*/ vnni > 1);
 
-  int32_t _AM = ((feature_nums + 31) >> 5) << 5; // align to 32
-  int32_t _AN = ((feature_size + 31) >> 5) << 5; // align to 32
-  int32_t _AK = _AM;
-  int32_t A_Stride = _AK * sizeof(at::BFloat16);
-  int32_t B_Stride = _AN * sizeof(at::BFloat16) * 2;
-  int32_t C_Stride = _AN * sizeof(float);
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
-    const int32_t vector_len = feature_size * sizeof(at::BFloat16);
     auto mm_elems = feature_nums * feature_nums;
-    at::BFloat16 grad_mm_buf[mm_elems] __attribute__((aligned(64)));
+    T grad_mm_buf[mm_elems] __attribute__((aligned(64)));
     zero_ker(grad_mm_buf, mm_elems);
-    at::BFloat16 sum_buf[_AM][_AK] __attribute__((aligned(64)));
-    zero_ker(&sum_buf[0][0], _AM * _AK);
-    at::BFloat16 cat_buf[_AK][_AN] __attribute__((aligned(64)));
-    zero_ker(&cat_buf[0][0], _AK * _AN);
-    at::BFloat16 Bmem[_AK / 2][_AN][2] __attribute__((aligned(64)));
-    float Cmem[_AM][_AN] __attribute__((aligned(64)));
-
-    _tile_loadconfig((const void*)&tc);
-
-    std::vector<at::BFloat16*> input_ptr(feature_nums);
-    std::vector<at::BFloat16*> output_ptr(feature_nums);
-    for (uint32_t n = 0; n < feature_nums; n++) {
+    auto sum_elems = feature_nums * feature_nums_pad;
+    T sum_buf[sum_elems] __attribute__((aligned(64)));
+    zero_ker(sum_buf, sum_elems);
+    auto cat_elems = feature_nums_pad * feature_size;
+    T cat_buf[cat_elems] __attribute__((aligned(64)));
+    zero_ker(cat_buf, cat_elems);
+    auto grad_cat_elems = feature_nums * feature_size;
+    float grad_cat_buf[grad_cat_elems] __attribute__((aligned(64)));
+    std::vector<T*> input_ptr(feature_nums);
+    std::vector<T*> output_ptr(feature_nums);
+    T* grad_out_ptr = &grad_out_data[start * grad_out_data_line_len];
+    for (int64_t n = 0; n < feature_nums; n++) {
       input_ptr[n] = &input_data[n][start * feature_size];
       output_ptr[n] = &output_data[n][start * feature_size];
-      unsigned char* inp = (unsigned char*)(input_ptr[n]);
-      for (uint32_t cache_line = 0; cache_line < vector_len; cache_line += 64) {
-        _mm_prefetch(inp + cache_line, _MM_HINT_T0);
-      }
     }
-
-    at::BFloat16* grad_out_ptr = &grad_out_data[start * grad_out_data_line_len];
+    gemm.config();
     for (int64_t i = start; i < end; i++) {
-      flat_triangle_backward<at::BFloat16>(
+      flat_triangle_backward<T>(
           grad_out_ptr + feature_size, grad_mm_buf, feature_nums);
-      transpose_add(&sum_buf[0][0], grad_mm_buf, feature_nums, _AK);
-      cat<at::BFloat16>(&cat_buf[0][0], input_ptr, feature_size, _AN);
-      for (int k = 0; k < (_AK >> 1); ++k) {
-        int32_t ak = (k << 1);
-        for (int n = 0; n < (_AN - 31); n += 32) {
-          auto akx16 = _mm256_load_si256((__m256i const*)(&cat_buf[ak][n]));
-          auto ak1x16 =
-              _mm256_load_si256((__m256i const*)(&cat_buf[ak + 1][n]));
-          auto akx16_1 =
-              _mm256_load_si256((__m256i const*)(&cat_buf[ak][n + 16]));
-          auto ak1x16_1 =
-              _mm256_load_si256((__m256i const*)(&cat_buf[ak + 1][n + 16]));
-          auto low_part = _mm256_unpacklo_epi16(akx16, ak1x16);
-          auto low_part1 = _mm256_unpacklo_epi16(akx16_1, ak1x16_1);
-          auto high_part = _mm256_unpackhi_epi16(akx16, ak1x16);
-          auto high_part1 = _mm256_unpackhi_epi16(akx16_1, ak1x16_1);
-          auto out0 = _mm256_shuffle_i64x2(low_part, high_part, 0x0);
-          auto out1 = _mm256_shuffle_i64x2(low_part, high_part, 0x3);
-          auto out2 = _mm256_shuffle_i64x2(low_part1, high_part1, 0x0);
-          auto out3 = _mm256_shuffle_i64x2(low_part1, high_part1, 0x3);
-          _mm256_store_si256((__m256i*)(&Bmem[k][n][0]), out0);
-          _mm256_store_si256((__m256i*)(&Bmem[k][n + 8][0]), out1);
-          _mm256_store_si256((__m256i*)(&Bmem[k][n + 16][0]), out2);
-          _mm256_store_si256((__m256i*)(&Bmem[k][n + 24][0]), out3);
-        }
-      }
-
-      for (uint32_t n = 0; n < feature_nums; n++) {
-        unsigned char* outp = (unsigned char*)(output_ptr[n]);
-        for (uint32_t cache_line = 0; cache_line < vector_len;
-             cache_line += 64) {
-          _mm_prefetch(outp + cache_line, _MM_HINT_T0);
-        }
-      }
-      for (uint32_t cache_line = 0; cache_line < vector_len; cache_line += 64) {
-        _mm_prefetch(grad_out_ptr + cache_line, _MM_HINT_T0);
-      }
-
-      for (int n = 0; n < _AN; n += 2 * TILE_N) {
-        for (int m = 0; m < _AM; m += 2 * TILE_M) {
-          _tile_zero(0);
-          _tile_zero(1);
-          _tile_zero(2);
-          _tile_zero(3);
-          if (_AK == TILE_BK) {
-            _tile_loadd(6, Bmem[0][n], B_Stride);
-            _tile_loadd(4, &sum_buf[m][0], A_Stride);
-            _tile_dpbf16ps(0, 4, 6);
-            _tile_stored(0, &Cmem[m][n], C_Stride);
-            _tile_loadd(5, &sum_buf[m + TILE_M][0], A_Stride);
-            _tile_dpbf16ps(2, 5, 6);
-            _tile_stored(2, &Cmem[m + TILE_M][n], C_Stride);
-            _tile_loadd(7, Bmem[0][n + TILE_N], B_Stride);
-            _tile_dpbf16ps(1, 4, 7);
-            _tile_stored(1, &Cmem[m][n + TILE_N], C_Stride);
-            _tile_dpbf16ps(3, 5, 7);
-            _tile_stored(3, &Cmem[m + TILE_M][n + TILE_N], C_Stride);
-          } else {
-            for (int k = 0; k < _AK; k += TILE_BK) {
-              int32_t bk = k >> 1;
-              _tile_loadd(6, Bmem[bk][n], B_Stride);
-              _tile_loadd(4, &sum_buf[m][k], A_Stride);
-              _tile_dpbf16ps(0, 4, 6);
-              _tile_loadd(5, &sum_buf[m + TILE_M][k], A_Stride);
-              _tile_dpbf16ps(2, 5, 6);
-              _tile_loadd(7, Bmem[bk][n + TILE_N], B_Stride);
-              _tile_dpbf16ps(1, 4, 7);
-              _tile_dpbf16ps(3, 5, 7);
-              if (k == _AK - TILE_BK) {
-                _tile_stored(0, &Cmem[m][n], C_Stride);
-                _tile_stored(2, &Cmem[m + TILE_M][n], C_Stride);
-                _tile_stored(1, &Cmem[m][n + TILE_N], C_Stride);
-                _tile_stored(3, &Cmem[m + TILE_M][n + TILE_N], C_Stride);
-              }
-            }
-          }
-        }
-      }
-
-      for (uint32_t n = 0; n < feature_nums; n++) {
-        input_ptr[n] += feature_size;
-        unsigned char* inp = (unsigned char*)(input_ptr[n]);
-        for (int cache_line = 0; cache_line < vector_len; cache_line += 64) {
-          _mm_prefetch(inp + cache_line, _MM_HINT_T0);
-        }
-      }
-
-      cat_backward<at::BFloat16, float>(
-          &Cmem[0][0], output_ptr, feature_size, _AN);
+      transpose_add(sum_buf, grad_mm_buf, feature_nums, feature_nums_pad);
+      cat_to_vnni<T>(cat_buf, input_ptr, feature_size, vnni);
+      gemm(sum_buf, cat_buf, grad_cat_buf, 1, true);
+      cat_backward<T, float>(
+          grad_cat_buf, output_ptr, feature_size, feature_size);
       add_ker(output_ptr[0], grad_out_ptr, feature_size);
       grad_out_ptr += grad_out_data_line_len;
-      for (uint32_t n = 0; n < feature_nums; n++) {
+      for (int64_t n = 0; n < feature_nums; n++) {
+        input_ptr[n] += feature_size;
         output_ptr[n] += feature_size;
       }
     }
+    gemm.release();
   });
   return output;
 }
@@ -770,13 +711,21 @@ at::Tensor interaction_forward_kernel_impl(
     for (auto& in : input) {
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(in.scalar_type() == at::kFloat);
     }
+#ifdef USE_LIBXSMM
+    return _interaction_forward_brgemm<float>(input);
+#else
     return _interaction_forward<float>(input);
+#endif
   } else {
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(input[0].scalar_type() == at::kBFloat16);
     for (const auto& in : input) {
       TORCH_INTERNAL_ASSERT_DEBUG_ONLY(in.scalar_type() == at::kBFloat16);
     }
+#ifdef USE_LIBXSMM
+    return _interaction_forward_brgemm<at::BFloat16>(input);
+#else
     return _interaction_forward<at::BFloat16>(input);
+#endif
   }
 }
 
@@ -784,182 +733,29 @@ std::vector<at::Tensor> interaction_backward_kernel_impl(
     const at::Tensor& grad_out,
     const std::vector<at::Tensor>& input) {
   if (grad_out.scalar_type() == at::kFloat) {
+#ifdef USE_LIBXSMM
+    return _interaction_backward_brgemm<float>(
+        grad_out, torch_ipex::autocast::cpu_cached_cast(at::kFloat, input));
+#else
     return _interaction_backward<float>(
         grad_out, torch_ipex::autocast::cpu_cached_cast(at::kFloat, input));
+#endif
   } else {
     TORCH_INTERNAL_ASSERT_DEBUG_ONLY(grad_out.scalar_type() == at::kBFloat16);
     // todo: move the autograd registion from python into C++.
     // Performance overhead in training here if you use autocast.
     // Because we save the ctx.arg in python before autocast, we have duplicated
     // cast for the input: here and in autocast of the forward path.
+#ifdef USE_LIBXSMM
+    return _interaction_backward_brgemm<at::BFloat16>(
+        grad_out, torch_ipex::autocast::cpu_cached_cast(at::kBFloat16, input));
+#else
     return _interaction_backward<at::BFloat16>(
         grad_out, torch_ipex::autocast::cpu_cached_cast(at::kBFloat16, input));
+#endif
   }
 }
 
-#if defined(CPU_CAPABILITY_AMX)
-/**
- *  A fast path if feature_nums == 27 and feature_size == 128 while AMX is
- * enabled (require gcc >=11.2) This function: (1) Assume feature num = 27 and
- * padding it to 32 to align memory unit. (2) Assume feature size = 128, using
- * "<< 7" insteadt of "/128" for performance consideration
- *  TODO: generalize this function to work on feature_nums != 27 and
- * feature_size != 128
- */
-void interaction_int8_128_27_amx(
-    const at::Tensor& output,
-    const std::vector<int8_t*> input_data,
-    float* out_in_scales,
-    const float dense_scale) {
-  const uint8_t _S = 26;
-  const uint8_t _S1 = 27;
-  const uint8_t _M = 28;
-  const uint8_t TILE_M = 14;
-  const uint8_t TILE_N = TILE_M;
-  const uint8_t TILE_K = 64;
-  const uint8_t TILE_BROWS = 16;
-  const uint8_t _K = 128;
-  const uint8_t LOG2_K = 7;
-  // setup size and create output
-  const int32_t flat_nums = _S1 * _S / 2;
-  const size_t ROW = _K + flat_nums; // 128 + 27 * 26/2
-  TORCH_INTERNAL_ASSERT(input_data.size() == _S1);
-  TORCH_INTERNAL_ASSERT(output.size(1) == ROW);
-  tileconfig_t tc = {0};
-  tc.palette_id = 1;
-  // tc.startRow = 0;
-  //  Configure C tiles
-  for (int t = 0; t < 4; ++t) {
-    tc.rows[t] = (uint8_t)TILE_M;
-    tc.colb[t] = (uint16_t)(TILE_N * sizeof(int32_t));
-  }
-  // Configure A tiles
-  for (int t = 4; t < 6; ++t) {
-    tc.rows[t] = (uint8_t)TILE_M;
-    tc.colb[t] = (uint16_t)(TILE_K * sizeof(int8_t));
-  }
-  // Configure B tile. B effectively has 64 rows and 16 columns.
-  for (int t = 6; t < 8; ++t) {
-    tc.rows[t] = (uint8_t)TILE_BROWS;
-    tc.colb[t] = (uint16_t)(TILE_N * 4 * sizeof(int8_t));
-  }
-
-  int8_t* res = static_cast<int8_t*>(output.data_ptr());
-  bool do_dense_scale = (std::abs(dense_scale - 1.0) > 0.0005);
-  auto batch_size = output.size(0);
-  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
-    int32_t Cmem[_M][_M] __attribute__((aligned(64)));
-    int32_t flat_buf[351] __attribute__((aligned(64)));
-    int8_t Amem[_M][_K] __attribute__((aligned(64)));
-    int8_t Bmem[_K / 4][_M][4] __attribute__((aligned(64)));
-    _tile_loadconfig((const void*)&tc);
-    int8_t* local_input_data[_S1];
-    int64_t bs_offset = start << LOG2_K;
-    for (int i = 0; i < _S1; i++) {
-      local_input_data[i] = input_data[i] + bs_offset;
-    }
-
-    int8_t* output0_ptr = res + start * ROW;
-    for (int i = start; i < end; ++i) {
-      if (do_dense_scale) {
-        scale_and_move_ker_128(output0_ptr, local_input_data[0], dense_scale);
-      } else {
-        move_ker(output0_ptr, local_input_data[0], _K);
-      }
-      load_s8x128_store_aligned_ker(Amem[0], local_input_data[0]);
-      int8_t *p0, *p1;
-      int j = 1;
-      for (; j < (_S1 - 1); j += 2) {
-        p0 = local_input_data[j];
-        p1 = local_input_data[j + 1];
-        load_double_s8x128_store_aligned_ker(Amem[j], p0, Amem[j + 1], p1);
-      }
-
-#pragma unroll
-      for (int k = 0; k < 32; k++) {
-        int32_t ak = (k << 2);
-        int n;
-#pragma unroll
-        for (n = 0; n < _M - 7; n += 8) {
-          (*(int32_t*)Bmem[k][n]) = (*(int32_t*)(&Amem[n][ak]));
-          (*(int32_t*)Bmem[k][n + 1]) = (*(int32_t*)(&Amem[n + 1][ak]));
-          (*(int32_t*)Bmem[k][n + 2]) = (*(int32_t*)(&Amem[n + 2][ak]));
-          (*(int32_t*)Bmem[k][n + 3]) = (*(int32_t*)(&Amem[n + 3][ak]));
-          (*(int32_t*)Bmem[k][n + 4]) = (*(int32_t*)(&Amem[n + 4][ak]));
-          (*(int32_t*)Bmem[k][n + 5]) = (*(int32_t*)(&Amem[n + 5][ak]));
-          (*(int32_t*)Bmem[k][n + 6]) = (*(int32_t*)(&Amem[n + 6][ak]));
-          (*(int32_t*)Bmem[k][n + 7]) = (*(int32_t*)(&Amem[n + 7][ak]));
-        }
-#pragma unroll
-        for (; n < _M; n++) {
-          (*(int32_t*)Bmem[k][n]) = (*(int32_t*)(&Amem[n][ak]));
-        }
-      }
-
-      _tile_zero(0);
-      _tile_zero(2);
-      _tile_zero(3);
-
-      _tile_loadd(6, Bmem[0][0], _M * 4 * sizeof(int8_t));
-
-      _tile_loadd(4, &Amem[0][0], _K * sizeof(int8_t));
-      _tile_dpbssd(0, 4, 6);
-
-      _tile_loadd(5, &Amem[TILE_M][0], _K * sizeof(int8_t));
-      _tile_dpbssd(2, 5, 6);
-
-      _tile_loadd(7, Bmem[0][TILE_N], _M * 4 * sizeof(int8_t));
-      _tile_dpbssd(3, 5, 7);
-
-      _tile_loadd(6, Bmem[TILE_BROWS][0], _M * 4 * sizeof(int8_t));
-
-      _tile_loadd(4, &Amem[0][TILE_K], _K * sizeof(int8_t));
-      _tile_dpbssd(0, 4, 6);
-      _tile_stored(0, &Cmem[0][0], _M * sizeof(int32_t));
-
-      _tile_loadd(5, &Amem[TILE_M][TILE_K], _K * sizeof(int8_t));
-      _tile_dpbssd(2, 5, 6);
-      _tile_stored(2, &Cmem[TILE_M][0], _M * sizeof(int32_t));
-
-      _tile_loadd(7, Bmem[TILE_BROWS][TILE_N], _M * 4 * sizeof(int8_t));
-      _tile_dpbssd(3, 5, 7);
-      _tile_stored(3, &Cmem[TILE_M][TILE_N], _M * sizeof(int32_t));
-
-      flat_buf[0] = Cmem[1][0];
-      flat_buf[1] = Cmem[2][0];
-      flat_buf[2] = Cmem[2][1];
-      int32_t offset = 3;
-#pragma unroll
-      for (int i = 3; i < _S1; i++) {
-        move_ker((int32_t*)(&flat_buf[offset]), Cmem[i], i);
-        offset += i;
-      }
-
-      int8_t* outp = output0_ptr + _K;
-      int off;
-#pragma unroll
-      for (off = 0; off < flat_nums - 63; off += 64) {
-        scale_int32_and_store_int8_16x4(
-            (outp + off), (flat_buf + off), (out_in_scales + off));
-      }
-      __m512 scale_m512 = _mm512_load_ps((const void*)(out_in_scales + off));
-      scale_int32_and_store_int8_16((outp + off), (flat_buf + off), scale_m512);
-      off += 16;
-      scale_m512 = _mm512_load_ps((const void*)(out_in_scales + off));
-      scale_int32_and_store_int8_maskz_16(
-          (outp + off), (flat_buf + off), scale_m512, 0x7fff);
-
-      for (int i = 0; i < _S1; i++) {
-        local_input_data[i] += _K;
-      }
-      output0_ptr += ROW;
-    }
-  });
-  return;
-}
-
-#endif
-
 #if defined(CPU_CAPABILITY_AVX512)
 static inline void _interaction_s8s8_scale_s32s8_128(
     int8_t* out,
@@ -1072,14 +868,32 @@ at::Tensor dil_qinteraction_kernel_impl(
 
   float dense_scale = in_scales[0] / output_scale;
 
-#if defined(CPU_CAPABILITY_AMX)
-  if (feature_nums == 27 && feature_size == 128) {
-    // A fast path if feature_nums == 27 and feature_size == 128 while AMX is
-    // enabled (require gcc >=11.2)
-    interaction_int8_128_27_amx(output, input_data, out_in_scales, dense_scale);
-    return output;
-  }
-#endif
+#ifdef USE_LIBXSMM
+  // Requantizes the int32 A A' of each sample straight into the output
+  _interaction_gemm<int8_t, int32_t>(
+      batch_size,
+      feature_nums,
+      feature_size,
+      [&](int64_t i, int8_t* a, int64_t lda) {
+        for (int f = 0; f < feature_nums; f++) {
+          move_ker(&a[f * lda], &input_data[f][i * feature_size], feature_size);
+        }
+      },
+      [&](int64_t i, const int8_t* dense, const int32_t* mm_buf) {
+        int8_t* out_ptr = &out_data[i * out_data_line_len];
+        scale_and_move_ker(out_ptr, dense, dense_scale, feature_size);
+        int8_t* flat_buf = out_ptr + feature_size;
+        size_t offset = 0;
+        for (int f = 1; f < feature_nums; f++) {
+          const int32_t* mm_row = &mm_buf[f * feature_nums];
+          for (int j = 0; j < f; j++) {
+            flat_buf[offset] =
+                (int8_t)_scale_int32(mm_row[j], out_in_scales[offset]);
+            offset++;
+          }
+        }
+      });
+#else
 
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
     //__m512i cat_buf[aligned_off] __attribute__((aligned(64)));
@@ -1123,8 +937,8 @@ at::Tensor dil_qinteraction_kernel_impl(
             feature_size);
         _interaction_s8s8_scale_s32s8_128(
             flat_buf, feature_nums, out_in_scales, convert_to_s16_buf, cat_buf);
+        continue;
       }
-      continue;
 #endif
       for (int k = 0; k < feature_nums; k++) {
         input_addr[k] = &input_data[k][row_len];
@@ -1135,10 +949,246 @@ at::Tensor dil_qinteraction_kernel_impl(
           flat_buf, input_addr, feature_nums, feature_size, out_in_scales);
     }
   });
+#endif
 
   return output;
 }
 
+// Sum-pools bag i of each table into the rows 1.. of a, scaled by the scale
+// of the table. The pooled embeddings stay in the cache until the
+// interaction consumes them instead of going through memory.
+template <typename T, typename Tw, typename index_t>
+static inline void pool_embeddingbags(
+    T* a,
+    int64_t lda,
+    int64_t i,
+    int64_t batch_size,
+    int64_t emb_dim,
+    const std::vector<Tw*>& weights,
+    const std::vector<index_t*>& indices,
+    const std::vector<index_t*>& offsets,
+    const std::vector<int64_t>& last_offsets,
+    const std::vector<float>& scales) {
+  float acc[emb_dim] __attribute__((aligned(64)));
+  for (size_t m = 0; m < weights.size(); m++) {
+    int64_t start_idx = offsets[m][i];
+    int64_t end_idx =
+        (i + 1) == batch_size ? last_offsets[m] : offsets[m][i + 1];
+    zero_ker(acc, emb_dim);
+    for (int64_t j = start_idx; j < end_idx; j++) {
+      add_ker(acc, &weights[m][indices[m][j] * emb_dim], emb_dim);
+    }
+    if (scales[m] != 1.f) {
+      for (int64_t k = 0; k < emb_dim; k++) {
+        acc[k] *= scales[m];
+      }
+    }
+    move_ker(&a[(m + 1) * lda], acc, emb_dim);
+  }
+}
+
+template <typename T>
+inline Tensor _merged_embeddingbag_interaction(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense) {
+  int64_t batch_size = dense.size(0);
+  int64_t emb_dim = dense.size(1);
+  int64_t num_emb = weights.size();
+  int64_t feature_nums = num_emb + 1;
+  auto interact_feature_size = feature_nums * (feature_nums - 1) / 2;
+  auto out_data_line_len = interact_feature_size + emb_dim;
+  auto out = at::empty({batch_size, out_data_line_len}, dense.options());
+  auto out_data = out.data_ptr<T>();
+  const T* dense_data = dense.data_ptr<T>();
+
+  std::vector<T*> weights_data(num_emb);
+  std::vector<int64_t> last_offsets(num_emb);
+  std::vector<float> scales(num_emb, 1.f);
+  for (int64_t m = 0; m < num_emb; m++) {
+    weights_data[m] = weights[m].data_ptr<T>();
+    last_offsets[m] = indices[m].numel();
+  }
+  AT_DISPATCH_INDEX_TYPES(
+      indices[0].scalar_type(), "merged_embeddingbag_interaction", [&] {
+        std::vector<index_t*> indices_data(num_emb);
+        std::vector<index_t*> offsets_data(num_emb);
+        for (int64_t m = 0; m < num_emb; m++) {
+          indices_data[m] = indices[m].data_ptr<index_t>();
+          offsets_data[m] = offsets[m].data_ptr<index_t>();
+        }
+        _interaction_gemm<T, float>(
+            batch_size,
+            feature_nums,
+            emb_dim,
+            [&](int64_t i, T* a, int64_t lda) {
+              move_ker(a, &dense_data[i * emb_dim], emb_dim);
+              pool_embeddingbags(
+                  a,
+                  lda,
+                  i,
+                  batch_size,
+                  emb_dim,
+                  weights_data,
+                  indices_data,
+                  offsets_data,
+                  last_offsets,
+                  scales);
+            },
+            [&](int64_t i, const T* a, const float* mm_buf) {
+              store_interaction(
+                  &out_data[i * out_data_line_len],
+                  a,
+                  mm_buf,
+                  feature_nums,
+                  emb_dim);
+            });
+      });
+  return out;
+}
+
+Tensor merged_embedding_interaction_fw_impl(
+    const TensorList& weights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& dense) {
+  RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
+  int64_t emb_dim = dense.size(1);
+  int64_t num_emb = weights.size();
+
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb > 0);
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == indices.size());
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == offsets.size());
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(dense.dim() == 2 && dense.is_contiguous());
+
+  auto index_type = indices[0].scalar_type();
+  auto data_type = dense.scalar_type();
+  for (int i = 0; i < num_emb; i++) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        indices[i].is_contiguous() && indices[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        offsets[i].is_contiguous() && offsets[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].is_contiguous() && weights[i].scalar_type() == data_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        weights[i].dim() == 2 && weights[i].size(1) == emb_dim);
+  }
+
+  if (data_type == at::kFloat) {
+    return _merged_embeddingbag_interaction<float>(
+        weights, indices, offsets, dense);
+  }
+  TORCH_CHECK(
+      data_type == at::kBFloat16,
+      "merged_embeddingbag_interaction_forward only supports float and "
+      "bfloat16, but got ",
+      data_type);
+  return _merged_embeddingbag_interaction<at::BFloat16>(
+      weights, indices, offsets, dense);
+}
+
+// The int8 embeddings are pooled and interacted in fp32, only the output is
+// requantized, as the int32 products of pooled bags may overflow.
+Tensor qmerged_embedding_interaction_fw_impl(
+    const TensorList& qweights,
+    const TensorList& indices,
+    const TensorList& offsets,
+    const Tensor& qdense,
+    double o_scale) {
+  RECORD_FUNCTION(__FUNCTION__, c10::ArrayRef<c10::IValue>({}));
+  int64_t batch_size = qdense.size(0);
+  int64_t emb_dim = qdense.size(1);
+  int64_t num_emb = qweights.size();
+  int64_t feature_nums = num_emb + 1;
+
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb > 0);
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == indices.size());
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(num_emb == offsets.size());
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(qdense.dim() == 2 && qdense.is_contiguous());
+
+  auto index_type = indices[0].scalar_type();
+  std::vector<int8_t*> weights_data(num_emb);
+  std::vector<int64_t> last_offsets(num_emb);
+  std::vector<float> w_scales(num_emb);
+  for (int i = 0; i < num_emb; i++) {
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        indices[i].is_contiguous() && indices[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        offsets[i].is_contiguous() && offsets[i].scalar_type() == index_type);
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        qweights[i].is_contiguous() &&
+        qweights[i].scalar_type() == qdense.scalar_type());
+    TORCH_INTERNAL_ASSERT_DEBUG_ONLY(
+        qweights[i].dim() == 2 && qweights[i].size(1) == emb_dim);
+    weights_data[i] =
+        reinterpret_cast<int8_t*>(qweights[i].data_ptr<at::qint8>());
+    last_offsets[i] = indices[i].numel();
+    w_scales[i] = at::native::q_scale_quant(qweights[i]);
+  }
+  const int8_t* dense_data =
+      reinterpret_cast<int8_t*>(qdense.data_ptr<at::qint8>());
+  float d_scale = at::native::q_scale_quant(qdense);
+  float dense_scale = d_scale / o_scale;
+  float inv_o_scale = 1.0 / o_scale;
+
+  auto interact_feature_size = feature_nums * (feature_nums - 1) / 2;
+  auto out_data_line_len = interact_feature_size + emb_dim;
+  at::QuantizerPtr output_quantizer =
+      at::make_per_tensor_affine_quantizer(o_scale, /*zp=*/0, at::kQInt8);
+  at::Tensor output = at::new_qtensor(
+      /*sizes=*/{batch_size, out_data_line_len},
+      qweights[0].options(),
+      output_quantizer);
+  int8_t* out_data = reinterpret_cast<int8_t*>(output.data_ptr<at::qint8>());
+
+  AT_DISPATCH_INDEX_TYPES(index_type, "qmerged_embeddingbag_interaction", [&] {
+    std::vector<index_t*> indices_data(num_emb);
+    std::vector<index_t*> offsets_data(num_emb);
+    for (int64_t m = 0; m < num_emb; m++) {
+      indices_data[m] = indices[m].data_ptr<index_t>();
+      offsets_data[m] = offsets[m].data_ptr<index_t>();
+    }
+    _interaction_gemm<float, float>(
+        batch_size,
+        feature_nums,
+        emb_dim,
+        [&](int64_t i, float* a, int64_t lda) {
+          const int8_t* dense_ptr = &dense_data[i * emb_dim];
+          for (int64_t k = 0; k < emb_dim; k++) {
+            a[k] = dense_ptr[k] * d_scale;
+          }
+          pool_embeddingbags(
+              a,
+              lda,
+              i,
+              batch_size,
+              emb_dim,
+              weights_data,
+              indices_data,
+              offsets_data,
+              last_offsets,
+              w_scales);
+        },
+        [&](int64_t i, const float* a, const float* mm_buf) {
+          int8_t* out_ptr = &out_data[i * out_data_line_len];
+          scale_and_move_ker(
+              out_ptr, &dense_data[i * emb_dim], dense_scale, emb_dim);
+          int8_t* flat_buf = out_ptr + emb_dim;
+          int64_t offset = 0;
+          for (int64_t f = 1; f < feature_nums; f++) {
+            for (int64_t j = 0; j < f; j++) {
+              float value = mm_buf[f * feature_nums + j] * inv_o_scale;
+              value = std::nearbyint(value);
+              flat_buf[offset++] =
+                  (int8_t)std::min(std::max(value, -128.f), 127.f);
+            }
+          }
+        });
+  });
+  return output;
+}
+
 } // anonymous namespace
 
 IPEX_REGISTER_DISPATCH(
@@ -1150,6 +1200,12 @@ IPEX_REGISTER_DISPATCH(
 IPEX_REGISTER_DISPATCH(
     dil_qinteraction_kernel_stub,
     &dil_qinteraction_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    merged_embeddingbag_interaction_fw_stub,
+    &merged_embedding_interaction_fw_impl);
+IPEX_REGISTER_DISPATCH(
+    qmerged_embeddingbag_interaction_fw_stub,
+    &qmerged_embedding_interaction_fw_impl);
 
 } // namespace cpu
 } // namespace torch_ipex
@@ -0,0 +1,142 @@
+#include <ATen/Parallel.h>
+#include <aten/LMHeadTopK.h>
+#include <aten/utils/mkl_gemm.h>
+#include <aten/utils/topk.h>
+#include <torch/csrc/autograd/function.h>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Number of vocab rows handed to a thread at a time. The logits of a block
+// are computed as one [batch, kVocabBlock] GEMM, so the block of weight rows
+// is streamed once for all the rows of hidden.
+constexpr int64_t kVocabBlock = 256;
+
+template <typename T>
+void lm_head_topk_impl(
+    const at::Tensor& hidden,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    int64_t k,
+    bool compute_lse,
+    at::Tensor& values,
+    at::Tensor& indices,
+    at::Tensor& lse) {
+  int64_t batch = hidden.size(0);
+  int64_t hidden_size = hidden.size(1);
+  int64_t vocab = weight.size(0);
+  auto hidden_c = hidden.to(weight.scalar_type()).contiguous();
+  auto weight_c = weight.contiguous();
+  const T* h = hidden_c.data_ptr<T>();
+  const T* w = weight_c.data_ptr<T>();
+  at::Tensor bias_fp32;
+  const float* b = nullptr;
+  if (bias.has_value() && bias.value().defined()) {
+    bias_fp32 = bias.value().to(at::kFloat).contiguous();
+    b = bias_fp32.data_ptr<float>();
+  }
+
+  // One running top-k and log-sum-exp per (thread, row), merged at the end.
+  int64_t num_threads = at::get_num_threads();
+  std::vector<RunningTopK> topks(num_threads * batch, RunningTopK(k));
+  std::vector<RunningLogSumExp> lses(num_threads * batch);
+  int64_t num_blocks = (vocab + kVocabBlock - 1) / kVocabBlock;
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    int64_t tid = at::get_thread_num();
+    auto* thread_topks = &topks[tid * batch];
+    auto* thread_lses = &lses[tid * batch];
+    std::vector<float> logits(batch * kVocabBlock);
+    for (int64_t blk = begin; blk < end; blk++) {
+      int64_t v_begin = blk * kVocabBlock;
+      int64_t n = std::min(kVocabBlock, vocab - v_begin);
+      // logits[batch, n] = hidden @ weight[v_begin : v_begin + n].t()
+      _mkl_gemm(
+          CblasRowMajor,
+          CblasNoTrans,
+          CblasTrans,
+          batch,
+          n,
+          hidden_size,
+          1.f,
+          h,
+          hidden_size,
+          w + v_begin * hidden_size,
+          hidden_size,
+          0.f,
+          logits.data(),
+          n);
+      for (int64_t row = 0; row < batch; row++) {
+        const float* row_logits = logits.data() + row * n;
+        for (int64_t j = 0; j < n; j++) {
+          int64_t v = v_begin + j;
+          float logit = row_logits[j];
+          if (b != nullptr) {
+            logit += b[v];
+          }
+          if (compute_lse) {
+            thread_lses[row].push(logit);
+          }
+          if (logit >= thread_topks[row].threshold()) {
+            thread_topks[row].push(logit, v);
+          }
+        }
+      }
+    }
+  });
+
+  auto values_ptr = values.data_ptr<float>();
+  auto indices_ptr = indices.data_ptr<int64_t>();
+  auto lse_ptr = lse.data_ptr<float>();
+  for (int64_t row = 0; row < batch; row++) {
+    RunningTopK& result = topks[row];
+    RunningLogSumExp& row_lse = lses[row];
+    for (int64_t t = 1; t < num_threads; t++) {
+      result.merge(topks[t * batch + row]);
+      row_lse.merge(lses[t * batch + row]);
+    }
+    auto sorted = result.sorted();
+    for (int64_t i = 0; i < k; i++) {
+      bool valid = i < (int64_t)sorted.size();
+      values_ptr[row * k + i] = valid
+          ? sorted[i].first
+          : -std::numeric_limits<float>::infinity();
+      indices_ptr[row * k + i] = valid ? sorted[i].second : 0;
+    }
+    lse_ptr[row] = compute_lse ? row_lse.value() : 0.f;
+  }
+}
+
+std::tuple<at::Tensor, at::Tensor, at::Tensor> lm_head_topk_kernel_impl(
+    const at::Tensor& hidden,
+    const at::Tensor& weight,
+    const c10::optional<at::Tensor>& bias,
+    int64_t k,
+    bool compute_lse) {
+  int64_t batch = hidden.size(0);
+  auto values = at::empty({batch, k}, hidden.options().dtype(at::kFloat));
+  auto indices = at::empty({batch, k}, hidden.options().dtype(at::kLong));
+  auto lse = at::empty({batch}, hidden.options().dtype(at::kFloat));
+  if (weight.scalar_type() == at::kFloat) {
+    lm_head_topk_impl<float>(
+        hidden, weight, bias, k, compute_lse, values, indices, lse);
+  } else if (weight.scalar_type() == at::kBFloat16) {
+    lm_head_topk_impl<at::BFloat16>(
+        hidden, weight, bias, k, compute_lse, values, indices, lse);
+  } else if (weight.scalar_type() == at::kHalf) {
+    // Needs the FP16 _mkl_gemm, which runs on the ATen CPU BLAS.
+    lm_head_topk_impl<at::Half>(
+        hidden, weight, bias, k, compute_lse, values, indices, lse);
+  } else {
+    TORCH_CHECK(false, "lm_head_topk: unsupported weight dtype");
+  }
+  return std::make_tuple(values, indices, lse);
+}
+
+} // namespace
+
+IPEX_REGISTER_DISPATCH(lm_head_topk_kernel_stub, &lm_head_topk_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
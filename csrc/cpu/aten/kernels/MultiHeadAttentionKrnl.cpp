@@ -1,4 +1,10 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <ATen/native/cpu/utils.h>
 #include <aten/MultiHeadAttention.h>
+#include <aten/utils/mkl_gemm.h>
+#include <limits>
 #include "csrc/cpu/tpp/woq/tla.h"
 #include "mkl.h"
 #include "vec/vec.h"
@@ -22,52 +28,6 @@ const int64_t kvsplit_size = 512;
 #if defined(CPU_CAPABILITY_AVX512)
 using namespace torch_ipex::cpu::kernel;
 
-// Div_Add_SoftMax kernel for BERT MHA Fusion based on the Flash Attention
-template <typename scalar_t>
-void _mha_div_add_softmax_bf16_kernel(
-    float* a,
-    scalar_t* b,
-    float* dst,
-    const scalar_t* rel_kv,
-    float* max,
-    float* sum,
-    const float& scale,
-    const int& qsize,
-    const int& kvsize,
-    const int& headsize,
-    const int& idx) {
-  auto alpha = _mm512_set1_ps(scale);
-  float tmp_max = 0.f, tmp_sum = 0.f, sum_old = 0.f, exp_tmp = 0.f;
-
-  for (int i = 0; i < qsize; ++i) {
-    sum_old = sum[i];
-
-    _dil_div_add_reduce_max_fusion_kernel<float, scalar_t>(
-        a + i * kvsize, rel_kv, scale, kvsize, a + i * kvsize, tmp_max);
-    tmp_max = max[i] > tmp_max ? max[i] : tmp_max;
-
-    tmp_sum = tmp_max;
-    _dil_exp_reduce_sum_fusion_kernel(
-        a + i * kvsize, kvsize, a + i * kvsize, tmp_sum);
-    exp_tmp = exp(max[i] - tmp_max);
-    sum[i] = tmp_sum + exp_tmp * sum[i];
-    max[i] = tmp_max;
-
-    _dil_normalization_kernel<scalar_t>(
-        a + i * kvsize, sum[i], kvsize, b + i * kvsize);
-
-    if (idx) {
-      _mha_update_sum_max_kernel(
-          dst + i * headsize,
-          sum_old,
-          sum[i],
-          exp_tmp,
-          headsize,
-          dst + i * headsize);
-    }
-  }
-}
-
 // Mul_SoftMax kernel for Stable-Diffusion MHA Fusion based on
 // the Flash Attention
 template <typename scalar_t>
@@ -478,138 +438,304 @@ at::Tensor sd_mha_base_kernel(
 }
 #endif
 
-at::Tensor bert_mha_kernel_impl(
+// qk <- qk * scale + mask, returns the max of qk
+template <typename accum_t>
+inline accum_t _scale_mask_reduce_max_kernel(
+    accum_t* qk,
+    const accum_t* mask,
+    const accum_t& scale,
+    const int64_t& size) {
+  using Vec = at::vec::Vectorized<accum_t>;
+  auto vec_scale = Vec(scale);
+  auto vec_max = Vec(-std::numeric_limits<accum_t>::infinity());
+  int64_t i = 0;
+  for (; i <= size - Vec::size(); i += Vec::size()) {
+    auto x = Vec::loadu(qk + i) * vec_scale;
+    if (mask != nullptr) {
+      x = x + Vec::loadu(mask + i);
+    }
+    x.store(qk + i);
+    vec_max = at::vec::maximum(vec_max, x);
+  }
+  accum_t max = at::vec::vec_reduce_all<accum_t>(
+      [](Vec& x, Vec& y) { return at::vec::maximum(x, y); }, vec_max);
+  for (; i < size; ++i) {
+    qk[i] = qk[i] * scale + (mask != nullptr ? mask[i] : accum_t(0));
+    max = std::max(max, qk[i]);
+  }
+  return max;
+}
+
+// qk <- exp(qk - max), returns the sum of qk
+template <typename accum_t>
+inline accum_t _exp_reduce_sum_kernel(
+    accum_t* qk,
+    const accum_t& max,
+    const int64_t& size) {
+  using Vec = at::vec::Vectorized<accum_t>;
+  auto vec_max = Vec(max);
+  auto vec_sum = Vec(accum_t(0));
+  int64_t i = 0;
+  for (; i <= size - Vec::size(); i += Vec::size()) {
+    auto x = (Vec::loadu(qk + i) - vec_max).exp();
+    x.store(qk + i);
+    vec_sum = vec_sum + x;
+  }
+  accum_t sum = at::vec::vec_reduce_all<accum_t>(
+      [](Vec& x, Vec& y) { return x + y; }, vec_sum);
+  for (; i < size; ++i) {
+    qk[i] = std::exp(qk[i] - max);
+    sum += qk[i];
+  }
+  return sum;
+}
+
+// Flash attention over the sequences packed in qkv, [tokens, 3 * hidden],
+// the i-th one spanning the tokens [seq_offsets[i], seq_offsets[i + 1]).
+// Each token only attends to the tokens of its own sequence, so that no
+// padding token nor full score matrix is ever computed. mask optionally
+// holds additive scores per key, maskStride apart for each sequence.
+template <typename scalar_t>
+void bert_mha_varlen_kernel(
+    const at::Tensor& output,
     const at::Tensor& qkv,
-    const at::Tensor& rel_kv,
+    const int64_t* seq_offsets,
+    const int64_t& num_seq,
+    const at::opmath_type<scalar_t>* mask,
+    const int64_t& maskStride,
     const int64_t& num_head,
     const int64_t& headSize,
-    const double& dim_per_head) {
-  TORCH_CHECK(
-      qkv.dtype() == at::kBFloat16,
-      "Currently the BERT MHA fusion only supports BF16 data type.");
-
-  int64_t batchSize = qkv.dim() > 2 ? qkv.size(0) : 1;
-  int64_t sequenceSize = qkv.dim() > 2 ? qkv.size(1) : qkv.size(0);
+    const double& scale) {
+  using accum_t = at::opmath_type<scalar_t>;
+  using Vec = at::vec::Vectorized<accum_t>;
+  constexpr bool is_reduced = !std::is_same<scalar_t, accum_t>::value;
+  const auto accumulate_dtype = at::toOpMathType(qkv.scalar_type());
+  const accum_t scaling_factor = scale;
   int64_t hiddenSize = num_head * headSize;
-  int64_t qkvColSize = hiddenSize * 3;
-  at::Tensor output =
-      at::empty({batchSize, sequenceSize, num_head, headSize}, at::kBFloat16);
+  int64_t qkvStride = qkv.stride(0);
+  int64_t oStride = output.stride(0);
 
-#if defined(CPU_CAPABILITY_AVX512)
-  int64_t qSplitSize = sequenceSize;
+  int64_t maxSeqSize = 0;
+  for (int64_t s = 0; s < num_seq; ++s) {
+    maxSeqSize = std::max(maxSeqSize, seq_offsets[s + 1] - seq_offsets[s]);
+  }
+  if (maxSeqSize == 0) {
+    return;
+  }
+  int64_t qSplitSize = maxSeqSize;
   for (int i = 0; i < qsplit_ranges.size(); ++i) {
-    if (sequenceSize > qsplit_ranges[i]) {
+    if (maxSeqSize > qsplit_ranges[i]) {
       qSplitSize = qsplit_sizes[i];
       break;
     }
   }
-  int64_t kvSplitSize =
-      sequenceSize >= kvsplit_size ? kvsplit_size : sequenceSize;
-
-  int64_t qSlice = (sequenceSize - 1) / qSplitSize + 1;
-  int64_t qTail = (sequenceSize - 1) % qSplitSize + 1;
-  int64_t kvSlice = (sequenceSize - 1) / kvSplitSize + 1;
-  int64_t kvTail = (sequenceSize - 1) % kvSplitSize + 1;
-
-  int64_t num_thread = omp_get_max_threads();
-
-  at::Tensor qk_fp32 =
-      at::empty({num_thread, qSplitSize, kvSplitSize}, at::kFloat);
-  at::Tensor qk_bf16 =
-      at::empty({num_thread, qSplitSize, kvSplitSize}, at::kBFloat16);
-  at::Tensor qk_max = at::empty({num_thread, qSplitSize}, at::kFloat);
-  at::Tensor qk_sum = at::empty({num_thread, qSplitSize}, at::kFloat);
-  at::Tensor dst_fp32 =
-      at::empty({num_thread, qSplitSize, headSize}, at::kFloat);
-
-#pragma omp parallel for collapse(3)
-  for (int i = 0; i < batchSize; ++i) {
-    for (int j = 0; j < num_head; ++j) {
-      for (int k = 0; k < qSlice; ++k) {
-        int qBlockSize = (k == qSlice - 1) ? qTail : qSplitSize;
-        int ompIdx = omp_get_thread_num();
-        _init_mha_buffer_kernel(
-            qk_max.data_ptr<float>() + ompIdx * qSplitSize,
-            qk_sum.data_ptr<float>() + ompIdx * qSplitSize,
-            qBlockSize);
-
-        for (int l = 0; l < kvSlice; ++l) {
-          int kvBlockSize = (l == kvSlice - 1) ? kvTail : kvSplitSize;
-          cblas_gemm_bf16bf16f32(
-              CblasRowMajor,
-              CblasNoTrans,
-              CblasTrans,
-              qBlockSize,
-              kvBlockSize,
-              headSize,
-              1.f,
-              (const MKL_BF16*)(qkv.data_ptr<at::BFloat16>() + i * sequenceSize * qkvColSize + headSize * j + k * qSplitSize * qkvColSize),
-              qkvColSize,
-              (const MKL_BF16*)(qkv.data_ptr<at::BFloat16>() + i * sequenceSize * qkvColSize + hiddenSize + headSize * j + l * kvSplitSize * qkvColSize),
-              qkvColSize,
-              0.f,
-              qk_fp32.data_ptr<float>() + ompIdx * qSplitSize * kvSplitSize,
-              kvBlockSize);
-
-          _mha_div_add_softmax_bf16_kernel<at::BFloat16>(
-              qk_fp32.data_ptr<float>() + ompIdx * qSplitSize * kvSplitSize,
-              qk_bf16.data_ptr<at::BFloat16>() +
-                  ompIdx * qSplitSize * kvSplitSize,
-              dst_fp32.data_ptr<float>() + ompIdx * qSplitSize * headSize,
-              rel_kv.data_ptr<at::BFloat16>() + i * sequenceSize +
-                  l * qSplitSize,
-              qk_max.data_ptr<float>() + ompIdx * qSplitSize,
-              qk_sum.data_ptr<float>() + ompIdx * qSplitSize,
-              dim_per_head,
-              qBlockSize,
-              kvBlockSize,
-              headSize,
-              l);
+  int64_t kvSplitSize = std::min(maxSeqSize, kvsplit_size);
 
-          cblas_gemm_bf16bf16f32(
-              CblasRowMajor,
-              CblasNoTrans,
-              CblasNoTrans,
+  // The q blocks of all the sequences, as (sequence, first token)
+  std::vector<std::pair<int64_t, int64_t>> qBlocks;
+  for (int64_t s = 0; s < num_seq; ++s) {
+    for (int64_t m = seq_offsets[s]; m < seq_offsets[s + 1]; m += qSplitSize) {
+      qBlocks.emplace_back(s, m);
+    }
+  }
+  int64_t numBlocks = qBlocks.size();
+
+  int64_t num_thread = at::get_num_threads();
+  int64_t size_per_thread =
+      /* qk     */ qSplitSize * kvSplitSize +
+      /* qk_max */ qSplitSize +
+      /* qk_sum */ qSplitSize +
+      /* dst    */ qSplitSize * headSize;
+  at::Tensor buf = at::empty(
+      {num_thread, size_per_thread}, qkv.options().dtype(accumulate_dtype));
+  at::Tensor buf_reduced = at::empty(
+      {num_thread, is_reduced ? qSplitSize * kvSplitSize : 0}, qkv.options());
+
+  const scalar_t* q_data = qkv.data_ptr<scalar_t>();
+  const scalar_t* k_data = q_data + hiddenSize;
+  const scalar_t* v_data = q_data + hiddenSize * 2;
+  scalar_t* out_data = output.data_ptr<scalar_t>();
+  accum_t* buf_data = buf.data_ptr<accum_t>();
+  scalar_t* buf_reduced_data = buf_reduced.data_ptr<scalar_t>();
+
+  at::parallel_for(
+      0, numBlocks * num_head, 1, [&](int64_t begin, int64_t end) {
+        int64_t b = 0, j = 0;
+        at::native::data_index_init(begin, b, numBlocks, j, num_head);
+        int ompIdx = at::get_thread_num();
+        accum_t* qk_data = buf_data + ompIdx * size_per_thread;
+        accum_t* qk_max_data = qk_data + qSplitSize * kvSplitSize;
+        accum_t* qk_sum_data = qk_max_data + qSplitSize;
+        accum_t* dst_data = qk_sum_data + qSplitSize;
+        scalar_t* qk_reduced_data =
+            buf_reduced_data + ompIdx * qSplitSize * kvSplitSize;
+
+        for (int64_t z = begin; z < end; ++z) {
+          int64_t s = qBlocks[b].first;
+          int64_t m = qBlocks[b].second;
+          int64_t seqStart = seq_offsets[s];
+          int64_t seqEnd = seq_offsets[s + 1];
+          int64_t qBlockSize = std::min(qSplitSize, seqEnd - m);
+          const accum_t* seq_mask =
+              mask != nullptr ? mask + s * maskStride : nullptr;
+          std::fill_n(
+              qk_max_data,
               qBlockSize,
-              headSize,
-              kvBlockSize,
-              1.f,
-              (const MKL_BF16*)(qk_bf16.data_ptr<at::BFloat16>() + ompIdx * qSplitSize * kvSplitSize),
-              kvBlockSize,
-              (const MKL_BF16*)(qkv.data_ptr<at::BFloat16>() + i * sequenceSize * qkvColSize + hiddenSize * 2 + headSize * j + l * kvSplitSize * qkvColSize),
-              qkvColSize,
-              l == 0 ? 0.f : 1.f,
-              dst_fp32.data_ptr<float>() + ompIdx * qSplitSize * headSize,
-              headSize);
+              -std::numeric_limits<accum_t>::infinity());
+          std::fill_n(qk_sum_data, qBlockSize, accum_t(0));
+
+          for (int64_t n = seqStart; n < seqEnd; n += kvSplitSize) {
+            int64_t kvBlockSize = std::min(kvSplitSize, seqEnd - n);
+            // qk <- q @ k.T
+            _mkl_gemm(
+                CblasColMajor,
+                CblasTrans,
+                CblasNoTrans,
+                kvBlockSize,
+                qBlockSize,
+                headSize,
+                static_cast<accum_t>(1),
+                k_data + n * qkvStride + j * headSize,
+                qkvStride,
+                q_data + m * qkvStride + j * headSize,
+                qkvStride,
+                static_cast<accum_t>(0),
+                qk_data,
+                kvBlockSize);
+            // Online softmax of the block, rescaling the partial results of
+            // the previous ones
+            for (int64_t row = 0; row < qBlockSize; ++row) {
+              accum_t* qk_row = qk_data + row * kvBlockSize;
+              accum_t tmp_max = _scale_mask_reduce_max_kernel<accum_t>(
+                  qk_row,
+                  seq_mask != nullptr ? seq_mask + n - seqStart : nullptr,
+                  scaling_factor,
+                  kvBlockSize);
+              tmp_max = std::max(qk_max_data[row], tmp_max);
+              // Rows masked with -inf so far keep exp(qk - max) at 0
+              accum_t safe_max =
+                  tmp_max == -std::numeric_limits<accum_t>::infinity()
+                  ? accum_t(0)
+                  : tmp_max;
+              accum_t tmp_sum = _exp_reduce_sum_kernel<accum_t>(
+                  qk_row, safe_max, kvBlockSize);
+              accum_t exp_tmp = std::exp(qk_max_data[row] - safe_max);
+              qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
+              qk_max_data[row] = tmp_max;
+              if (n > seqStart) {
+                at::vec::map<accum_t>(
+                    [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+                    dst_data + row * headSize,
+                    dst_data + row * headSize,
+                    headSize);
+              }
+              if constexpr (is_reduced) {
+                at::vec::convert(
+                    qk_row, qk_reduced_data + row * kvBlockSize, kvBlockSize);
+              }
+            }
+            // dst <- dst + softmax(qk) @ v
+            const scalar_t* p_data;
+            if constexpr (is_reduced) {
+              p_data = qk_reduced_data;
+            } else {
+              p_data = qk_data;
+            }
+            _mkl_gemm(
+                CblasColMajor,
+                CblasNoTrans,
+                CblasNoTrans,
+                headSize,
+                qBlockSize,
+                kvBlockSize,
+                static_cast<accum_t>(1),
+                v_data + n * qkvStride + j * headSize,
+                qkvStride,
+                p_data,
+                kvBlockSize,
+                static_cast<accum_t>(n == seqStart ? 0 : 1),
+                dst_data,
+                headSize);
+          }
+          // out <- dst / sum
+          for (int64_t row = 0; row < qBlockSize; ++row) {
+            accum_t sum_reciprocal = 1 / qk_sum_data[row];
+            at::vec::map<scalar_t>(
+                [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
+                out_data + (m + row) * oStride + j * headSize,
+                dst_data + row * headSize,
+                headSize);
+          }
+          at::native::data_index_step(b, numBlocks, j, num_head);
         }
-        _reorder_mha_output_kernel<at::BFloat16>(
-            dst_fp32.data_ptr<float>() + ompIdx * qSplitSize * headSize,
-            output.data_ptr<at::BFloat16>() + i * sequenceSize * hiddenSize +
-                headSize * j + k * qSplitSize * hiddenSize,
-            qBlockSize,
+      });
+}
+
+at::Tensor bert_mha_kernel_impl(
+    const at::Tensor& qkv,
+    const at::Tensor& rel_kv,
+    const int64_t& num_head,
+    const int64_t& headSize,
+    const double& dim_per_head) {
+  int64_t batchSize = qkv.dim() > 2 ? qkv.size(0) : 1;
+  int64_t sequenceSize = qkv.dim() > 2 ? qkv.size(1) : qkv.size(0);
+  at::Tensor output =
+      at::empty({batchSize, sequenceSize, num_head, headSize}, qkv.options());
+
+  // The padded batch is a packed one with sequences of the same length
+  at::Tensor seq_offsets =
+      at::arange(0, (batchSize + 1) * sequenceSize, sequenceSize, at::kLong);
+  // rel_kv, broadcast to [batchSize, 1, 1, sequenceSize]
+  at::Tensor mask = rel_kv.to(at::toOpMathType(qkv.scalar_type()))
+                        .contiguous()
+                        .view({-1, sequenceSize});
+  TORCH_CHECK(
+      mask.size(0) == 1 || mask.size(0) == batchSize,
+      "BERT MHA: expected the relative scores to be broadcastable to [",
+      batchSize,
+      ", 1, 1, ",
+      sequenceSize,
+      "]");
+  int64_t maskStride = mask.size(0) == 1 ? 0 : sequenceSize;
+
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16, at::kHalf, qkv.scalar_type(), "bert_mha", [&] {
+        bert_mha_varlen_kernel<scalar_t>(
+            output.view({-1, num_head * headSize}),
+            qkv.contiguous().view({-1, qkv.size(-1)}),
+            seq_offsets.data_ptr<int64_t>(),
+            batchSize,
+            mask.data_ptr<at::opmath_type<scalar_t>>(),
+            maskStride,
+            num_head,
             headSize,
-            hiddenSize);
-      }
-    }
-  }
+            1 / dim_per_head);
+      });
   return output;
-#endif
-  auto qkv_mat = dil_mat_split<at::BFloat16>(
-      qkv, at::IntArrayRef({hiddenSize, hiddenSize, hiddenSize}));
-  auto query = qkv_mat[0];
-  auto key = qkv_mat[1];
-  auto value = qkv_mat[2];
-  query.resize_({batchSize, sequenceSize, num_head, headSize}).transpose_(1, 2);
-  key.resize_({batchSize, sequenceSize, num_head, headSize})
-      .transpose_(1, 2)
-      .transpose_(2, 3);
-  value.resize_({batchSize, sequenceSize, num_head, headSize}).transpose_(1, 2);
-
-  auto qk = at::div(at::matmul(query, key), dim_per_head);
-  auto qk_sm = at::softmax(at::add(qk, rel_kv, 1.f), -1);
-  output = at::matmul(qk_sm, value);
+}
 
-  output = output.transpose_(1, 2).contiguous();
+at::Tensor bert_mha_varlen_kernel_impl(
+    const at::Tensor& qkv,
+    const at::Tensor& cu_seqlens,
+    const int64_t& num_head,
+    const int64_t& headSize,
+    const double& scale) {
+  at::Tensor output =
+      at::empty({qkv.size(0), num_head, headSize}, qkv.options());
+  at::Tensor seq_offsets = cu_seqlens.to(at::kLong).contiguous();
+  AT_DISPATCH_FLOATING_TYPES_AND2(
+      at::kBFloat16, at::kHalf, qkv.scalar_type(), "bert_mha_varlen", [&] {
+        bert_mha_varlen_kernel<scalar_t>(
+            output.view({-1, num_head * headSize}),
+            qkv,
+            seq_offsets.data_ptr<int64_t>(),
+            seq_offsets.size(0) - 1,
+            nullptr,
+            0,
+            num_head,
+            headSize,
+            scale);
+      });
   return output;
 }
 
@@ -719,6 +845,9 @@ at::Tensor sd_mha_kernel_v2_impl(
 } // anonymous namespace
 
 IPEX_REGISTER_DISPATCH(bert_mha_kernel_stub, &bert_mha_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    bert_mha_varlen_kernel_stub,
+    &bert_mha_varlen_kernel_impl);
 IPEX_REGISTER_DISPATCH(sd_mha_kernel_v1_stub, &sd_mha_kernel_v1_impl);
 IPEX_REGISTER_DISPATCH(sd_mha_kernel_v2_stub, &sd_mha_kernel_v2_impl);
 
@@ -45,7 +45,7 @@ void pre_calc_for_bilinear_interpolate(
     T bin_size_w,
     int64_t roi_bin_grid_h,
     int64_t roi_bin_grid_w,
-    std::vector<PreCalc<T>>& pre_calc) {
+    PreCalc<T>* pre_calc) {
   int64_t pre_calc_index = 0;
   for (int64_t ph = 0; ph < pooled_height; ph++) {
     for (int64_t pw = 0; pw < pooled_width; pw++) {
@@ -422,7 +422,7 @@ void roi_align_forward_kernel_body(
           bin_size_w,
           roi_bin_grid_h,
           roi_bin_grid_w,
-          pre_calc);
+          pre_calc.data());
 
       if (is_channels_last) {
         roi_align_single_framework_channels_last_forward<T, ACC_T>(
@@ -471,7 +471,7 @@ inline void roi_align_single_framework_backward(
     int64_t pooled_width,
     int64_t roi_bin_grid_h,
     int64_t roi_bin_grid_w,
-    const std::vector<PreCalc<ACC_T>>& pre_calc,
+    const PreCalc<ACC_T>* pre_calc,
     T* grad_input) {
   for (int64_t c = 0; c < channels; c++) {
     T* offset_grad_input = grad_input + c * height * width;
@@ -504,18 +504,21 @@ inline void roi_align_single_framework_backward(
   } // c
 }
 
+// Only accumulates the channels [channel_begin, channel_end)
 template <typename T, typename ACC_T>
 inline void roi_align_single_framework_channels_last_backward(
     const T* grad_output,
     const ACC_T count,
     int64_t channels,
+    int64_t channel_begin,
+    int64_t channel_end,
     int64_t height,
     int64_t width,
     int64_t pooled_height,
     int64_t pooled_width,
     int64_t roi_bin_grid_h,
     int64_t roi_bin_grid_w,
-    const std::vector<PreCalc<ACC_T>>& pre_calc,
+    const PreCalc<ACC_T>* pre_calc,
     T* grad_input) {
   // for 'normal' size of channels, should be L1 fit;
   // otherwise consider blocking on channels.
@@ -538,8 +541,8 @@ inline void roi_align_single_framework_channels_last_backward(
           Vec w2_vec = Vec(static_cast<T>(pc.w2 / count));
           Vec w3_vec = Vec(static_cast<T>(pc.w3 / count));
           Vec w4_vec = Vec(static_cast<T>(pc.w4 / count));
-          int64_t d2 = 0;
-          for (; d2 < channels - (channels % Vec::size()); d2 += Vec::size()) {
+          int64_t d2 = channel_begin;
+          for (; d2 <= channel_end - Vec::size(); d2 += Vec::size()) {
             Vec g_in1_vec =
                 Vec::loadu(g_in1 + d2) + Vec::loadu(g_out + d2) * w1_vec;
             g_in1_vec.store(g_in1 + d2);
@@ -553,7 +556,7 @@ inline void roi_align_single_framework_channels_last_backward(
                 Vec::loadu(g_in4 + d2) + Vec::loadu(g_out + d2) * w4_vec;
             g_in4_vec.store(g_in4 + d2);
           }
-          for (; d2 < channels; d2++) {
+          for (; d2 < channel_end; d2++) {
             g_in1[d2] += g_out[d2] * pc.w1 / count;
             g_in2[d2] += g_out[d2] * pc.w2 / count;
             g_in3[d2] += g_out[d2] * pc.w3 / count;
@@ -566,6 +569,21 @@ inline void roi_align_single_framework_channels_last_backward(
   } // ph
 }
 
+// Sampling grid of a ROI
+template <typename T>
+struct ROIBins {
+  int64_t batch_ind;
+  T start_h;
+  T start_w;
+  T bin_size_h;
+  T bin_size_w;
+  int64_t grid_h;
+  int64_t grid_w;
+};
+
+// Upper bound of the sampling points pre-calculated at once in the backward
+constexpr int64_t max_pre_calc_size = 1 << 18;
+
 template <typename T, typename ACC_T>
 void roi_align_backward_kernel_body(
     int64_t n_rois,
@@ -581,12 +599,13 @@ void roi_align_backward_kernel_body(
     T* grad_input,
     const ACC_T* rois,
     bool is_channels_last) {
-  // (n, c, ph, pw) is an element in the pooled output
-  // can be parallelized using omp
-  // at::parallel_for(0, n_rois, 1, [&](int64_t begin, int64_t end) {
+  // The bilinear scatter-adds of the ROIs overlap in grad_input, but those
+  // of a channel only touch that channel. Each thread owns a range of the
+  // channels and accumulates all the ROIs into it in order, which is
+  // conflict free and gives the same result as the serial loop.
+  std::vector<ROIBins<ACC_T>> roi_bins(n_rois);
   for (int64_t n = 0; n < n_rois; n++) {
     const ACC_T* offset_rois = rois + n * 5;
-    int64_t roi_batch_ind = offset_rois[0];
 
     // Do not using rounding; this implementation detail is critical
     ACC_T offset = aligned ? (ACC_T)0.5 : (ACC_T)0.0;
@@ -603,67 +622,113 @@ void roi_align_backward_kernel_body(
       roi_height = std::max(roi_height, (ACC_T)1.);
     }
 
-    ACC_T bin_size_h =
+    ROIBins<ACC_T>& bins = roi_bins[n];
+    bins.batch_ind = offset_rois[0];
+    bins.start_h = roi_start_h;
+    bins.start_w = roi_start_w;
+    bins.bin_size_h =
         static_cast<ACC_T>(roi_height) / static_cast<ACC_T>(pooled_height);
-    ACC_T bin_size_w =
+    bins.bin_size_w =
         static_cast<ACC_T>(roi_width) / static_cast<ACC_T>(pooled_width);
 
     // We use roi_bin_grid to sample the grid and mimic integral
-    int64_t roi_bin_grid_h = (sampling_ratio > 0)
-        ? sampling_ratio
-        : ceil(roi_height / pooled_height); // e.g., = 2
-    int64_t roi_bin_grid_w =
-        (sampling_ratio > 0) ? sampling_ratio : ceil(roi_width / pooled_width);
-
-    // We do average (integral) pooling inside a bin
-    const ACC_T count = roi_bin_grid_h * roi_bin_grid_w; // e.g. = 4
-
-    // we want to precalculate indices and weights shared by all channels,
-    // this is the key point of optimization
-    std::vector<PreCalc<ACC_T>> pre_calc(
-        roi_bin_grid_h * roi_bin_grid_w * pooled_width * pooled_height);
-    pre_calc_for_bilinear_interpolate(
-        height,
-        width,
-        pooled_height,
-        pooled_width,
-        roi_start_h,
-        roi_start_w,
-        bin_size_h,
-        bin_size_w,
-        roi_bin_grid_h,
-        roi_bin_grid_w,
-        pre_calc);
+    bins.grid_h = (sampling_ratio > 0) ? sampling_ratio
+                                       : ceil(roi_height / pooled_height);
+    bins.grid_w = (sampling_ratio > 0) ? sampling_ratio
+                                       : ceil(roi_width / pooled_width);
+  }
+
+  // The indices and weights shared by all channels are pre-calculated for
+  // chunks of ROIs, bounding the buffer for large sampling grids.
+  std::vector<PreCalc<ACC_T>> pre_calc;
+  std::vector<int64_t> pre_calc_offsets;
+  int64_t chunk_begin = 0;
+  while (chunk_begin < n_rois) {
+    int64_t chunk_end = chunk_begin;
+    pre_calc_offsets.assign(1, 0);
+    while (chunk_end < n_rois) {
+      const auto& bins = roi_bins[chunk_end];
+      int64_t size = bins.grid_h * bins.grid_w * pooled_height * pooled_width;
+      if (chunk_end > chunk_begin &&
+          pre_calc_offsets.back() + size > max_pre_calc_size) {
+        break;
+      }
+      pre_calc_offsets.push_back(pre_calc_offsets.back() + size);
+      chunk_end++;
+    }
+    pre_calc.resize(pre_calc_offsets.back());
+
+    at::parallel_for(
+        chunk_begin, chunk_end, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t n = begin; n < end; n++) {
+            const auto& bins = roi_bins[n];
+            pre_calc_for_bilinear_interpolate(
+                height,
+                width,
+                pooled_height,
+                pooled_width,
+                bins.start_h,
+                bins.start_w,
+                bins.bin_size_h,
+                bins.bin_size_w,
+                bins.grid_h,
+                bins.grid_w,
+                pre_calc.data() + pre_calc_offsets[n - chunk_begin]);
+          }
+        });
 
     if (is_channels_last) {
-      roi_align_single_framework_channels_last_backward<T, ACC_T>(
-          grad_output + n * channels * pooled_height * pooled_width,
-          count,
-          channels,
-          height,
-          width,
-          pooled_height,
-          pooled_width,
-          roi_bin_grid_h,
-          roi_bin_grid_w,
-          pre_calc,
-          grad_input + roi_batch_ind * channels * height * width);
+      // Channel blocks of a vector, to keep the accumulation vectorized
+      using Vec = at::vec::Vectorized<T>;
+      int64_t n_blocks = (channels + Vec::size() - 1) / Vec::size();
+      at::parallel_for(0, n_blocks, 1, [&](int64_t begin, int64_t end) {
+        int64_t channel_begin = begin * Vec::size();
+        int64_t channel_end = std::min(end * Vec::size(), channels);
+        for (int64_t n = chunk_begin; n < chunk_end; n++) {
+          const auto& bins = roi_bins[n];
+          // We do average (integral) pooling inside a bin
+          const ACC_T count = bins.grid_h * bins.grid_w; // e.g. = 4
+          roi_align_single_framework_channels_last_backward<T, ACC_T>(
+              grad_output + n * channels * pooled_height * pooled_width,
+              count,
+              channels,
+              channel_begin,
+              channel_end,
+              height,
+              width,
+              pooled_height,
+              pooled_width,
+              bins.grid_h,
+              bins.grid_w,
+              pre_calc.data() + pre_calc_offsets[n - chunk_begin],
+              grad_input + bins.batch_ind * channels * height * width);
+        }
+      });
     } else {
-      roi_align_single_framework_backward<T, ACC_T>(
-          grad_output + n * channels * pooled_height * pooled_width,
-          count,
-          channels,
-          height,
-          width,
-          pooled_height,
-          pooled_width,
-          roi_bin_grid_h,
-          roi_bin_grid_w,
-          pre_calc,
-          grad_input + roi_batch_ind * channels * height * width);
+      at::parallel_for(0, channels, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t n = chunk_begin; n < chunk_end; n++) {
+          const auto& bins = roi_bins[n];
+          // We do average (integral) pooling inside a bin
+          const ACC_T count = bins.grid_h * bins.grid_w; // e.g. = 4
+          roi_align_single_framework_backward<T, ACC_T>(
+              grad_output + (n * channels + begin) * pooled_height *
+                  pooled_width,
+              count,
+              end - begin,
+              height,
+              width,
+              pooled_height,
+              pooled_width,
+              bins.grid_h,
+              bins.grid_w,
+              pre_calc.data() + pre_calc_offsets[n - chunk_begin],
+              grad_input +
+                  (bins.batch_ind * channels + begin) * height * width);
+        }
+      });
     }
-  } // for n
-  // });
+    chunk_begin = chunk_end;
+  }
 }
 
 at::Tensor roi_align_forward_kernel_impl(
@@ -32,6 +32,49 @@ inline void wait_block_until(
     _mm_pause();
 }
 
+// Waits until a monotonically increasing counter reaches target, tolerating
+// the wrap-around of the counter.
+inline void wait_counter_reach(
+    int* states_ptr,
+    const int index,
+    const int target) {
+  volatile int* state_ptr = states_ptr + index;
+  while (static_cast<int>(
+             static_cast<unsigned>(*state_ptr) -
+             static_cast<unsigned>(target)) < 0)
+    _mm_pause();
+}
+
+// Publishes generation in the counter of this rank at offset and waits for
+// the counters of all the ranks to reach it.
+inline void shm_counter_barrier(
+    int* states_ptr,
+    const int offset,
+    const int rank,
+    const int world_size,
+    const int generation) {
+  std::atomic_thread_fence(std::memory_order_release);
+  states_ptr[offset + rank] = generation;
+  for (int i = 0; i < world_size; i++) {
+    wait_counter_reach(states_ptr, offset + i, generation);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+static inline void multiThreadMemcpy(
+    uint8_t* dst,
+    const uint8_t* src,
+    size_t nbytes) {
+  constexpr size_t bytesPerSplit = 64 * 1024;
+  int64_t splits = (nbytes + bytesPerSplit - 1) / bytesPerSplit;
+#pragma omp parallel for
+  for (int64_t i = 0; i < splits; ++i) {
+    size_t offset = i * bytesPerSplit;
+    std::memcpy(
+        dst + offset, src + offset, std::min(bytesPerSplit, nbytes - offset));
+  }
+}
+
 template <typename DST_T, typename SRC_T>
 static inline void multiThreadCopy(DST_T* dst, SRC_T* src, int size) {
   RECORD_FUNCTION("multiThreadCopy", c10::ArrayRef<c10::IValue>({}));
@@ -154,6 +197,101 @@ void reduceAdd_impl(
   }
 }
 
+/**
+ * @brief Gathers the shard [shard_begin, shard_end) owned by every rank into
+ * the full buffer of all the ranks through the shared memory buffer. The
+ * states after the first world_size entries of t_state are used as two
+ * counters per rank, one set after the shard is published and one after the
+ * gathered data is consumed, so that the shared buffer is free again when the
+ * call returns. All ranks pass the same generation, which increases by one on
+ * every call.
+ */
+at::Tensor shm_allgather_shards_kernel_impl(
+    at::Tensor& t_in,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    int64_t shard_begin,
+    int64_t shard_end,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size) {
+  RECORD_FUNCTION(
+      "ipex::shm_allgather_shards", c10::ArrayRef<c10::IValue>({}));
+  auto element_size = t_in.element_size();
+  auto nbytes = t_in.numel() * element_size;
+  uint8_t* buf = (uint8_t*)t_in.data_ptr();
+  uint8_t* address = (uint8_t*)t_address.data_ptr();
+  int* states_ptr = t_state.data_ptr<int>();
+  int gen = static_cast<int>(generation);
+  int ready_offset = world_size;
+  int done_offset = 2 * world_size;
+
+  multiThreadMemcpy(
+      address + shard_begin * element_size,
+      buf + shard_begin * element_size,
+      (shard_end - shard_begin) * element_size);
+  shm_counter_barrier(states_ptr, ready_offset, rank, world_size, gen);
+
+  multiThreadMemcpy(buf, address, shard_begin * element_size);
+  multiThreadMemcpy(
+      buf + shard_end * element_size,
+      address + shard_end * element_size,
+      nbytes - shard_end * element_size);
+  shm_counter_barrier(states_ptr, done_offset, rank, world_size, gen);
+  return t_in;
+}
+
+/**
+ * @brief Gathers the [rows, cols_r] slice of every rank r directly into the
+ * column window [cols_per_rank[r], cols_per_rank[r + 1]) of t_out, which is
+ * a contiguous [rows, cols_per_rank[world_size]] tensor. The slices are
+ * staged in the shared memory buffer back to back and copied out row by row,
+ * so no per-rank temporary or concatenation is needed. Uses the same
+ * counters and generation as shm_allgather_shards.
+ */
+at::Tensor& shm_allgather_cols_kernel_impl(
+    at::Tensor& t_in,
+    at::Tensor& t_out,
+    at::Tensor& t_address,
+    at::Tensor& t_state,
+    std::vector<int64_t> cols_per_rank,
+    int64_t generation,
+    int64_t rank,
+    int64_t world_size) {
+  RECORD_FUNCTION("ipex::shm_allgather_cols", c10::ArrayRef<c10::IValue>({}));
+  auto element_size = t_in.element_size();
+  int64_t total_cols = cols_per_rank[world_size];
+  int64_t rows = t_out.numel() / total_cols;
+  uint8_t* in = (uint8_t*)t_in.data_ptr();
+  uint8_t* out = (uint8_t*)t_out.data_ptr();
+  uint8_t* address = (uint8_t*)t_address.data_ptr();
+  int* states_ptr = t_state.data_ptr<int>();
+  int gen = static_cast<int>(generation);
+
+  int64_t my_cols = cols_per_rank[rank + 1] - cols_per_rank[rank];
+  multiThreadMemcpy(
+      address + rows * cols_per_rank[rank] * element_size,
+      in,
+      rows * my_cols * element_size);
+  shm_counter_barrier(states_ptr, world_size, rank, world_size, gen);
+
+#pragma omp parallel for collapse(2)
+  for (int64_t r = 0; r < world_size; r++) {
+    for (int64_t row = 0; row < rows; row++) {
+      int64_t cols = cols_per_rank[r + 1] - cols_per_rank[r];
+      uint8_t* src = r == rank
+          ? in + row * cols * element_size
+          : address + (rows * cols_per_rank[r] + row * cols) * element_size;
+      std::memcpy(
+          out + (row * total_cols + cols_per_rank[r]) * element_size,
+          src,
+          cols * element_size);
+    }
+  }
+  shm_counter_barrier(states_ptr, 2 * world_size, rank, world_size, gen);
+  return t_out;
+}
+
 at::Tensor shm_all_reduce_add_kernel_impl(
     at::Tensor& t_in,
     at::Tensor& t_address,
@@ -240,6 +378,14 @@ IPEX_REGISTER_DISPATCH(
     shm_all_reduce_add_kernel_stub,
     &shm_all_reduce_add_kernel_impl);
 
+IPEX_REGISTER_DISPATCH(
+    shm_allgather_shards_kernel_stub,
+    &shm_allgather_shards_kernel_impl);
+
+IPEX_REGISTER_DISPATCH(
+    shm_allgather_cols_kernel_stub,
+    &shm_allgather_cols_kernel_impl);
+
 } // namespace cpu
 } // namespace torch_ipex
 #endif
\ No newline at end of file
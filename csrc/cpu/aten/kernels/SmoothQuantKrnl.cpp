@@ -0,0 +1,242 @@
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec/functional.h>
+#include <ATen/cpu/vec/vec.h>
+#include <aten/SmoothQuant.h>
+#include <torch/csrc/autograd/function.h>
+#include <cmath>
+#include <limits>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Input channels of a task, a multiple of the vector sizes.
+constexpr int64_t kChannelBlock = 256;
+
+// Added to the absolute max of every channel, as the Python observers did.
+constexpr double kAbsMaxEps = 1e-6;
+
+// Folds n channels of lo and hi into the running min and max, a row of
+// the input is both its lo and hi.
+template <typename T>
+inline void update_min_max(
+    const T* lo,
+    const T* hi,
+    float* min,
+    float* max,
+    int64_t n) {
+  using fVec = at::vec::Vectorized<float>;
+  using bVec = at::vec::Vectorized<T>;
+  int64_t i = 0;
+  if constexpr (std::is_same<T, float>::value) {
+    for (; i + fVec::size() <= n; i += fVec::size()) {
+      at::vec::minimum(fVec::loadu(min + i), fVec::loadu(lo + i))
+          .store(min + i);
+      at::vec::maximum(fVec::loadu(max + i), fVec::loadu(hi + i))
+          .store(max + i);
+    }
+  } else {
+    for (; i + bVec::size() <= n; i += bVec::size()) {
+      fVec lo0, lo1, hi0, hi1;
+      std::tie(lo0, lo1) = at::vec::convert_to_float<T>(bVec::loadu(lo + i));
+      std::tie(hi0, hi1) = at::vec::convert_to_float<T>(bVec::loadu(hi + i));
+      int64_t j = i + fVec::size();
+      at::vec::minimum(fVec::loadu(min + i), lo0).store(min + i);
+      at::vec::maximum(fVec::loadu(max + i), hi0).store(max + i);
+      at::vec::minimum(fVec::loadu(min + j), lo1).store(min + j);
+      at::vec::maximum(fVec::loadu(max + j), hi1).store(max + j);
+    }
+  }
+  for (; i < n; i++) {
+    float x = static_cast<float>(lo[i]);
+    float y = static_cast<float>(hi[i]);
+    // NaN propagates as in torch.aminmax
+    if (x < min[i] || std::isnan(x)) {
+      min[i] = x;
+    }
+    if (y > max[i] || std::isnan(y)) {
+      max[i] = y;
+    }
+  }
+}
+
+template <typename T>
+void smooth_quant_observe_impl(
+    const at::Tensor& input,
+    at::Tensor& min_val,
+    at::Tensor& max_val) {
+  const int64_t channels = input.size(-1);
+  const int64_t rows = input.numel() / channels;
+  const int64_t num_blocks = (channels + kChannelBlock - 1) / kChannelBlock;
+  // Rows are split as well when there are fewer channel blocks than
+  // threads, the partial ranges of the row chunks are folded at the end.
+  const int64_t num_chunks = std::min(
+      rows,
+      std::max<int64_t>(
+          1, (at::get_num_threads() + num_blocks - 1) / num_blocks));
+  const int64_t chunk_rows = (rows + num_chunks - 1) / num_chunks;
+  const T* in = input.data_ptr<T>();
+  float* min_ptr = min_val.data_ptr<float>();
+  float* max_ptr = max_val.data_ptr<float>();
+  std::vector<float> partial_min, partial_max;
+  if (num_chunks > 1) {
+    partial_min.resize(
+        num_chunks * channels, std::numeric_limits<float>::infinity());
+    partial_max.resize(
+        num_chunks * channels, -std::numeric_limits<float>::infinity());
+  }
+  at::parallel_for(
+      0, num_chunks * num_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t task = begin; task < end; task++) {
+          int64_t chunk = task / num_blocks;
+          int64_t c0 = (task % num_blocks) * kChannelBlock;
+          int64_t n = std::min(kChannelBlock, channels - c0);
+          int64_t r0 = chunk * chunk_rows;
+          int64_t r1 = std::min(r0 + chunk_rows, rows);
+          float* min = num_chunks > 1 ? partial_min.data() + chunk * channels
+                                      : min_ptr;
+          float* max = num_chunks > 1 ? partial_max.data() + chunk * channels
+                                      : max_ptr;
+          for (int64_t r = r0; r < r1; r++) {
+            const T* row = in + r * channels + c0;
+            update_min_max(row, row, min + c0, max + c0, n);
+          }
+        }
+      });
+  if (num_chunks == 1) {
+    return;
+  }
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; block++) {
+      int64_t c0 = block * kChannelBlock;
+      int64_t n = std::min(kChannelBlock, channels - c0);
+      for (int64_t chunk = 0; chunk < num_chunks; chunk++) {
+        update_min_max(
+            partial_min.data() + chunk * channels + c0,
+            partial_max.data() + chunk * channels + c0,
+            min_ptr + c0,
+            max_ptr + c0,
+            n);
+      }
+    }
+  });
+}
+
+void smooth_quant_observe_kernel_impl(
+    const at::Tensor& input,
+    at::Tensor& min_val,
+    at::Tensor& max_val) {
+  if (input.scalar_type() == at::kFloat) {
+    smooth_quant_observe_impl<float>(input, min_val, max_val);
+  } else if (input.scalar_type() == at::kBFloat16) {
+    smooth_quant_observe_impl<at::BFloat16>(input, min_val, max_val);
+  } else if (input.scalar_type() == at::kHalf) {
+    smooth_quant_observe_impl<at::Half>(input, min_val, max_val);
+  } else {
+    TORCH_CHECK(false, "smooth_quant_observe: unsupported input dtype");
+  }
+}
+
+/**
+ * Estimated quantization error of the output of a linear layer smoothed
+ * with alpha, from the per channel ranges only. Both the activation, per
+ * tensor, and the weight are quantized to the same number of levels, so the
+ * quantization steps are proportional to the quantized ranges: the
+ * activation range, including 0, and twice the largest absolute weight.
+ * Bounding the weight of every output channel by the largest one, channel j
+ * adds
+ *   (range_x * max(|W_j|) * s_j) ** 2 + (range_w * max(|X_j|) / s_j) ** 2
+ * to the error, the rounding of either operand times the magnitude of the
+ * other.
+ */
+double smooth_quant_error(
+    const float* act_min,
+    const float* act_max,
+    const std::vector<double>& log_x,
+    const std::vector<double>& log_w,
+    double alpha) {
+  int64_t channels = log_x.size();
+  double x_min = 0, x_max = 0, w_max = 0;
+  double wei_sum = 0, act_sum = 0;
+  for (int64_t j = 0; j < channels; j++) {
+    double log_s = alpha * log_x[j] - (1 - alpha) * log_w[j];
+    double s = std::exp(log_s);
+    double w = std::exp(log_w[j] + log_s);
+    double x = std::exp(log_x[j] - log_s);
+    x_min = std::min(x_min, act_min[j] / s);
+    x_max = std::max(x_max, act_max[j] / s);
+    w_max = std::max(w_max, w);
+    wei_sum += w * w;
+    act_sum += x * x;
+  }
+  double range_x = x_max - x_min;
+  double range_w = 2 * w_max;
+  return range_x * range_x * wei_sum + range_w * range_w * act_sum;
+}
+
+std::tuple<at::Tensor, at::Tensor, double>
+smooth_quant_scaling_factors_kernel_impl(
+    const at::Tensor& act_min,
+    const at::Tensor& act_max,
+    const at::Tensor& wei_min,
+    const at::Tensor& wei_max,
+    const std::vector<double>& alphas) {
+  const int64_t channels = act_min.numel();
+  const float* act_min_ptr = act_min.data_ptr<float>();
+  const float* act_max_ptr = act_max.data_ptr<float>();
+  const float* wei_min_ptr = wei_min.data_ptr<float>();
+  const float* wei_max_ptr = wei_max.data_ptr<float>();
+  // Logs of the absolute max of every channel, the factors of all alphas
+  // are exp(alpha * log_x - (1 - alpha) * log_w).
+  std::vector<double> log_x(channels), log_w(channels);
+  for (int64_t j = 0; j < channels; j++) {
+    float x_abs = std::max(std::abs(act_min_ptr[j]), std::abs(act_max_ptr[j]));
+    float w_abs = std::max(std::abs(wei_min_ptr[j]), std::abs(wei_max_ptr[j]));
+    log_x[j] = std::log(x_abs + kAbsMaxEps);
+    log_w[j] = std::log(w_abs + kAbsMaxEps);
+  }
+
+  double alpha = alphas[0];
+  if (alphas.size() > 1) {
+    const int64_t num_alphas = alphas.size();
+    std::vector<double> errors(num_alphas);
+    at::parallel_for(0, num_alphas, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t a = begin; a < end; a++) {
+        errors[a] = smooth_quant_error(
+            act_min_ptr, act_max_ptr, log_x, log_w, alphas[a]);
+      }
+    });
+    // The first of the best candidates
+    int64_t best = 0;
+    for (int64_t a = 1; a < num_alphas; a++) {
+      if (errors[a] < errors[best]) {
+        best = a;
+      }
+    }
+    alpha = alphas[best];
+  }
+
+  auto act_factors = at::empty({channels}, act_min.options());
+  auto wei_factors = at::empty({channels}, act_min.options());
+  float* act_factors_ptr = act_factors.data_ptr<float>();
+  float* wei_factors_ptr = wei_factors.data_ptr<float>();
+  for (int64_t j = 0; j < channels; j++) {
+    double log_s = alpha * log_x[j] - (1 - alpha) * log_w[j];
+    act_factors_ptr[j] = static_cast<float>(std::exp(-log_s));
+    wei_factors_ptr[j] = static_cast<float>(std::exp(log_s));
+  }
+  return std::make_tuple(act_factors, wei_factors, alpha);
+}
+
+} // namespace
+
+IPEX_REGISTER_DISPATCH(
+    smooth_quant_observe_kernel_stub,
+    &smooth_quant_observe_kernel_impl);
+IPEX_REGISTER_DISPATCH(
+    smooth_quant_scaling_factors_kernel_stub,
+    &smooth_quant_scaling_factors_kernel_impl);
+
+} // namespace cpu
+} // namespace torch_ipex
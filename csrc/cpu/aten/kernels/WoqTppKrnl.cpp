@@ -2366,6 +2366,61 @@ void qlinear_woq_affine_impl(
     }
   }();
 
+  // The K blocks handed to a thread at a time on the parallel M path
+  const bool parallel_kcb = M >= PARALLEL_M_THRESHOLD && !is_4bit_flag &&
+      std::is_same<T, TComp>() && !std::is_same<TComp, uint8_t>();
+  long KCB_BLOCK_SIZE = IPEX_KCB_BLOCK_SIZE;
+  // BLOCK_M and the K block are looked up per shape in the tuning database,
+  // and tuned on first use when autotuning, beyond the batches computed in
+  // a single block
+  if (M > 48 && tuning::is_active()) {
+    tuning::Params defaults{{"block_m", BLOCK_M}, {"kcb", KCB_BLOCK_SIZE}};
+    std::vector<tuning::Params> candidates;
+    for (long block_m : {32L, 48L, 64L}) {
+      if (!parallel_kcb) {
+        candidates.push_back({{"block_m", block_m}});
+        continue;
+      }
+      for (long kcb : {16L, 32L, 64L, 128L}) {
+        candidates.push_back({{"block_m", block_m}, {"kcb", kcb}});
+      }
+    }
+    auto kernel = std::string("woq_gemm_") +
+        c10::toString(c10::CppTypeToScalarType<TComp>::value) +
+        (is_4bit_flag ? "_4bit" : "_8bit");
+    auto params = tuning::tuned(
+        tuning::make_key(kernel.c_str(), x.scalar_type(), M, N, K),
+        defaults,
+        candidates,
+        [&]() {
+          qlinear_woq_affine_impl<
+              T,
+              TComp,
+              TGemmOut,
+              Tout,
+              TScale,
+              TZero,
+              quant_a_mode,
+              quant_w_mode>(
+              x,
+              qw_packed,
+              scales,
+              b,
+              at::empty_like(y),
+              qw_type,
+              k_splits,
+              fusion_type,
+              others_list,
+              quant_block_k,
+              zps,
+              scales_a_ptr,
+              zps_a_ptr,
+              compensation);
+        });
+    BLOCK_M = tuning::get(params, "block_m", BLOCK_M);
+    KCB_BLOCK_SIZE = tuning::get(params, "kcb", KCB_BLOCK_SIZE);
+  }
+
   auto BLOCK_M_rem = M % BLOCK_M;
 
   // TODO(jgong5): use heuristics to decide k_splits
@@ -2385,16 +2440,7 @@ void qlinear_woq_affine_impl(
   auto ldy = N;
   auto ldc = (no_y_buf || k_splits > 1) ? ldy : Nb;
   auto str_a = no_x_buf == true ? Kb : BLOCK_M * Kb;
-  auto Kcb = Kc;
-  if (M < PARALLEL_M_THRESHOLD) {
-    Kcb = 1;
-  } else if (
-      is_4bit_flag || !std::is_same<T, TComp>() ||
-      std::is_same<TComp, uint8_t>()) {
-    Kcb = 1;
-  } else if (M >= PARALLEL_M_THRESHOLD) {
-    Kcb = IPEX_KCB_BLOCK_SIZE;
-  }
+  auto Kcb = parallel_kcb ? KCB_BLOCK_SIZE : 1;
   auto px = GetVLAPtr<T>(x, {Kc, Kb});
   auto pw = GetVLAPtr<uint8_t>(
       (uint8_t*)qw_packed.data_ptr(),
@@ -2499,7 +2545,7 @@ void qlinear_woq_affine_impl(
       quant_a_mode,                                  \
       quant_w_mode,                                  \
       prefetch_dist>(                                \
-      /*M*/ block_m, /*K*/ Kb, lda, ldc, IPEX_KCB_BLOCK_SIZE, str_a);
+      /*M*/ block_m, /*K*/ Kb, lda, ldc, KCB_BLOCK_SIZE, str_a);
 
 #define GET_NO_DEQUANT_GEMM_TPP(prefetch_dist, block_m) \
   NoDequantGemmTPP<                                     \
@@ -2511,7 +2557,7 @@ void qlinear_woq_affine_impl(
       quant_a_mode,                                     \
       quant_w_mode,                                     \
       prefetch_dist>(                                   \
-      /*M*/ block_m, /*K*/ Kb, lda, ldc, IPEX_KCB_BLOCK_SIZE, str_a);
+      /*M*/ block_m, /*K*/ Kb, lda, ldc, KCB_BLOCK_SIZE, str_a);
 
 #define RUN_DEQUANT_GEMM_TPP(                                 \
     gemm_kernel, no_tile_cfg, kc_start, quant_block_multiple) \
@@ -1,5 +1,6 @@
 #pragma once
 #include <ATen/ATen.h>
+#include <ATen/native/CPUBlas.h>
 #include "mkl.h"
 
 inline void _mkl_gemm(
@@ -87,5 +88,19 @@ inline void _mkl_gemm(
     const float& beta,
     float* c,
     const int& ldc) {
-  TORCH_CHECK(false, "_mkl_gemm does not support FP16 yet");
+  // oneMKL has no FP16 GEMM with FP32 outputs in the supported versions, the
+  // ATen one goes through oneDNN, with AMX-FP16 where available.
+  using at::native::TransposeType;
+  auto ta = transa == CblasNoTrans ? TransposeType::NoTranspose
+                                   : TransposeType::Transpose;
+  auto tb = transb == CblasNoTrans ? TransposeType::NoTranspose
+                                   : TransposeType::Transpose;
+  if (layout == CblasColMajor) {
+    at::native::cpublas::gemm(
+        ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+  } else {
+    // C.T = B.T @ A.T in column major
+    at::native::cpublas::gemm(
+        tb, ta, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+  }
 }
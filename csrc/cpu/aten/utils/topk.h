@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace torch_ipex {
+namespace cpu {
+
+// Orders candidates by descending value, and by ascending index on ties so
+// that the result matches torch.topk / torch.argmax.
+inline bool topk_better(
+    const std::pair<float, int64_t>& a,
+    const std::pair<float, int64_t>& b) {
+  return a.first > b.first || (a.first == b.first && a.second < b.second);
+}
+
+/**
+ * Keeps the k best (value, index) pairs seen so far in a heap whose front is
+ * the worst kept candidate, so a candidate that does not make it costs one
+ * comparison.
+ */
+class RunningTopK {
+ public:
+  explicit RunningTopK(int64_t k = 1) : k_(k) {
+    heap_.reserve(k);
+  }
+
+  void reset(int64_t k) {
+    k_ = k;
+    heap_.clear();
+    heap_.reserve(k);
+  }
+
+  inline void push(float value, int64_t index) {
+    if (std::isnan(value)) {
+      return;
+    }
+    if ((int64_t)heap_.size() < k_) {
+      heap_.emplace_back(value, index);
+      std::push_heap(heap_.begin(), heap_.end(), topk_better);
+    } else if (topk_better({value, index}, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), topk_better);
+      heap_.back() = {value, index};
+      std::push_heap(heap_.begin(), heap_.end(), topk_better);
+    }
+  }
+
+  // Worst value kept, candidates below it can be skipped once full.
+  inline float threshold() const {
+    return (int64_t)heap_.size() < k_ ? -std::numeric_limits<float>::infinity()
+                                      : heap_.front().first;
+  }
+
+  void merge(const RunningTopK& other) {
+    for (auto& candidate : other.heap_) {
+      push(candidate.first, candidate.second);
+    }
+  }
+
+  // Returns the kept candidates in descending order.
+  std::vector<std::pair<float, int64_t>> sorted() const {
+    auto result = heap_;
+    std::sort(result.begin(), result.end(), topk_better);
+    return result;
+  }
+
+ private:
+  int64_t k_;
+  std::vector<std::pair<float, int64_t>> heap_;
+};
+
+/**
+ * Online log-sum-exp: keeps the running max and the sum of exp(x - max).
+ */
+struct RunningLogSumExp {
+  float max = -std::numeric_limits<float>::infinity();
+  float sum = 0.f;
+
+  inline void push(float x) {
+    if (x == -std::numeric_limits<float>::infinity()) {
+      return;
+    }
+    if (x > max) {
+      sum = sum * std::exp(max - x) + 1.f;
+      max = x;
+    } else {
+      sum += std::exp(x - max);
+    }
+  }
+
+  void merge(const RunningLogSumExp& other) {
+    if (other.max == -std::numeric_limits<float>::infinity()) {
+      return;
+    }
+    if (other.max > max) {
+      sum = sum * std::exp(max - other.max) + other.sum;
+      max = other.max;
+    } else {
+      sum += other.sum * std::exp(other.max - max);
+    }
+  }
+
+  inline float value() const {
+    return max + std::log(sum);
+  }
+};
+
+} // namespace cpu
+} // namespace torch_ipex
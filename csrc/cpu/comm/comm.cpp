@@ -1,9 +1,21 @@
 #include "comm.h"
 #include <ATen/ATen.h>
+#include "comm_worker.h"
 #include "messager.h"
 
 namespace torch_ipex {
 namespace cpu {
+void init_with_store(
+    c10::intrusive_ptr<c10d::Store> store,
+    int rank,
+    int world_size) {
+#ifdef BUILD_CPU_WITH_ONECCL
+  Messenger::setStore(std::move(store), rank, world_size);
+#else
+  TORCH_CHECK(false, "BUILD_CPU_WITH_ONECCL is not enabled.");
+#endif
+}
+
 int get_rank() {
 #ifdef BUILD_CPU_WITH_ONECCL
   return Messenger::getInstance().getRank();
@@ -24,11 +36,27 @@ int get_world_size() {
 
 void barrier() {
 #ifdef BUILD_CPU_WITH_ONECCL
+  CommWorker::getInstance().drain();
   Messenger::getInstance().barrier();
 #else
   TORCH_CHECK(false, "BUILD_CPU_WITH_ONECCL is not enabled.");
   return;
 #endif
 }
+
+std::shared_ptr<CommHandle> allreduce_add_async(at::Tensor t_in) {
+#ifdef BUILD_CPU_WITH_ONECCL
+  RECORD_FUNCTION("ipex::allreduce_add_async", c10::ArrayRef<c10::IValue>({}));
+  TORCH_CHECK(
+      t_in.is_contiguous(), "allreduce_add_async: input must be contiguous");
+  // The task holds a reference of t_in, so the storage outlives the
+  // collective even if the caller drops it before wait().
+  return CommWorker::getInstance().submit(
+      [t_in]() mutable { Messenger::getInstance().reduceAdd(t_in); });
+#else
+  TORCH_CHECK(false, "BUILD_CPU_WITH_ONECCL is not enabled.");
+  return nullptr;
+#endif
+}
 } // namespace cpu
 } // namespace torch_ipex
\ No newline at end of file
@@ -1,9 +1,31 @@
 #pragma once
 
+#include <ATen/ATen.h>
+#include <torch/csrc/distributed/c10d/Store.hpp>
+#include <memory>
+
 namespace torch_ipex {
 namespace cpu {
+
+/**
+ * Waitable handle of a collective launched on the communication thread.
+ * wait() blocks until the collective has finished and rethrows the error
+ * raised by it, if any.
+ */
+class CommHandle {
+ public:
+  virtual ~CommHandle() = default;
+  virtual void wait() = 0;
+  virtual bool is_completed() = 0;
+};
+
+void init_with_store(
+    c10::intrusive_ptr<c10d::Store> store,
+    int rank,
+    int world_size);
 void barrier();
 int get_world_size();
 int get_rank();
+std::shared_ptr<CommHandle> allreduce_add_async(at::Tensor t_in);
 } // namespace cpu
-} // namespace torch_ipex
\ No newline at end of file
+} // namespace torch_ipex
@@ -0,0 +1,120 @@
+#ifdef BUILD_CPU_WITH_ONECCL
+#include "comm_worker.h"
+#include <omp.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace torch_ipex {
+namespace cpu {
+
+namespace {
+
+// Parses a core list like "0,2,4-7".
+std::vector<int> parse_core_list(const char* str) {
+  std::vector<int> cores;
+  std::stringstream ss(str);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (item.empty()) {
+      continue;
+    }
+    auto dash = item.find('-');
+    if (dash == std::string::npos) {
+      cores.push_back(std::stoi(item));
+    } else {
+      int first = std::stoi(item.substr(0, dash));
+      int last = std::stoi(item.substr(dash + 1));
+      for (int core = first; core <= last; core++) {
+        cores.push_back(core);
+      }
+    }
+  }
+  return cores;
+}
+
+} // namespace
+
+CommWorker::~CommWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CommWorker::start() {
+  auto env = std::getenv("IPEX_COMM_CORES");
+  if (env != nullptr) {
+    reserved_cores_ = parse_core_list(env);
+  }
+  thread_ = std::thread([this] { this->loop(); });
+  started_ = true;
+}
+
+std::shared_ptr<CommHandle> CommWorker::submit(std::function<void()> task) {
+  std::promise<void> promise;
+  std::shared_future<void> future = promise.get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!started_) {
+      start();
+    }
+    queue_.emplace_back(std::move(task), std::move(promise));
+  }
+  cv_.notify_one();
+  return std::make_shared<CommWork>(std::move(future));
+}
+
+void CommWorker::drain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this] { return queue_.empty() && !busy_; });
+}
+
+void CommWorker::loop() {
+  if (!reserved_cores_.empty()) {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (auto core : reserved_cores_) {
+      CPU_SET(core, &mask);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask);
+  }
+  // The ICV is per thread, the compute threads keep their own team size.
+  omp_set_num_threads(
+      reserved_cores_.empty() ? 1 : static_cast<int>(reserved_cores_.size()));
+
+  while (true) {
+    std::pair<std::function<void()>, std::promise<void>> work;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (stop_ && queue_.empty()) {
+        return;
+      }
+      work = std::move(queue_.front());
+      queue_.pop_front();
+      busy_ = true;
+    }
+    try {
+      work.first();
+      work.second.set_value();
+    } catch (...) {
+      work.second.set_exception(std::current_exception());
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      busy_ = false;
+    }
+    idle_cv_.notify_all();
+  }
+}
+
+} // namespace cpu
+} // namespace torch_ipex
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+#ifdef BUILD_CPU_WITH_ONECCL
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "comm.h"
+
+namespace torch_ipex {
+namespace cpu {
+
+class CommWork : public CommHandle {
+ public:
+  explicit CommWork(std::shared_future<void> future)
+      : future_(std::move(future)) {}
+
+  void wait() override {
+    future_.get();
+  }
+
+  bool is_completed() override {
+    return future_.wait_for(std::chrono::seconds(0)) ==
+        std::future_status::ready;
+  }
+
+ private:
+  std::shared_future<void> future_;
+};
+
+/**
+ * A dedicated thread that runs collectives in submission order so that the
+ * caller can overlap them with compute. Every rank must submit collectives in
+ * the same order, which holds as long as only the main thread submits.
+ *
+ * The thread is started lazily on the first submit(). IPEX_COMM_CORES (e.g.
+ * "55" or "54,55" or "52-55") pins it to cores reserved for communication and
+ * sets the size of its OpenMP team to the number of reserved cores, so that
+ * the SHM reduction does not compete with the GEMM threads.
+ */
+class CommWorker {
+ public:
+  static CommWorker& getInstance() {
+    static CommWorker instance;
+    return instance;
+  }
+
+  std::shared_ptr<CommHandle> submit(std::function<void()> task);
+
+  // Blocks until all previously submitted collectives have finished. The
+  // blocking collectives call this first to keep the cross-rank order.
+  void drain();
+
+ private:
+  CommWorker() = default;
+  ~CommWorker();
+  CommWorker(const CommWorker&) = delete;
+  CommWorker& operator=(const CommWorker&) = delete;
+
+  void start();
+  void loop();
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable idle_cv_;
+  std::deque<std::pair<std::function<void()>, std::promise<void>>> queue_;
+  std::vector<int> reserved_cores_;
+  bool started_ = false;
+  bool stop_ = false;
+  bool busy_ = false;
+};
+
+} // namespace cpu
+} // namespace torch_ipex
+#endif
@@ -3,8 +3,17 @@
 #include <mpi.h>
 
 #include <torch/all.h>
+#include <torch/csrc/distributed/c10d/PrefixStore.hpp>
+#include <torch/csrc/distributed/c10d/Store.hpp>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <vector>
 #include "oneapi/ccl.hpp"
 #ifdef USE_SHM
 #include "shm_reduction.h"
@@ -13,19 +22,31 @@
 class Messenger {
  private:
   Messenger() {
+    auto& bootstrap = storeBootstrap();
+    bootstrap.created = true;
     // User has set the SINGLE_INSTANCE environment variable
-    // or program is not with MPI.
-    if (std::getenv("SINGLE_INSTANCE") != nullptr || !withMpirun()) {
+    // or program is neither bootstrapped by a store nor with MPI.
+    if (std::getenv("SINGLE_INSTANCE") != nullptr ||
+        (!bootstrap.store && !withMpirun())) {
       std::cout << "[INFO] SINGLE_INSTANCE MODE." << std::endl;
       this->pcomm = nullptr;
 #ifdef USE_SHM
       this->pshm = nullptr;
+      this->pinter_comm = nullptr;
 #endif
       this->rank = 0;
       this->size = 1;
       return;
     }
 
+    if (bootstrap.store) {
+      initWithStore(bootstrap.store, bootstrap.rank, bootstrap.size);
+    } else {
+      initWithMpi();
+    }
+  }
+
+  void initWithMpi() {
     int flag = 0;
     MPI_Initialized(&flag);
     if (flag) {
@@ -38,70 +59,229 @@ class Messenger {
 
     atexit(Messenger::mpi_finalize);
 
-    if (rank == 0) {
-      kvs = ccl::create_main_kvs();
-      main_addr = kvs->get_address();
-      MPI_Bcast(
-          (void*)main_addr.data(),
-          main_addr.size(),
-          MPI_BYTE,
-          0,
-          MPI_COMM_WORLD);
-    } else {
-      MPI_Bcast(
-          (void*)main_addr.data(),
-          main_addr.size(),
-          MPI_BYTE,
-          0,
-          MPI_COMM_WORLD);
-      kvs = ccl::create_kvs(main_addr);
+    pcomm = createCommunicator(
+        size,
+        rank,
+        [](ccl::kvs::address_type& addr) {
+          MPI_Bcast(
+              (void*)addr.data(), addr.size(), MPI_BYTE, 0, MPI_COMM_WORLD);
+        },
+        kvs);
+
+    rank = pcomm->rank();
+    size = pcomm->size();
+
+#ifdef USE_SHM
+    // Group the ranks sharing a physical machine. SHM reduces within such a
+    // node, and ranks with the same local rank on different nodes form the
+    // inter-node communicator that reduces one shard each.
+    MPI_Comm_split_type(
+        MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_size(node_comm, &local_size);
+    MPI_Comm_rank(node_comm, &local_rank);
+
+    int min_local_size = 0;
+    int max_local_size = 0;
+    MPI_Allreduce(
+        &local_size, &min_local_size, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce(
+        &local_size, &max_local_size, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+    pshm = nullptr;
+    pinter_comm = nullptr;
+    // Ranks spread unevenly across the nodes keep using oneCCL only.
+    if (min_local_size == max_local_size && local_size > 1) {
+      MPI_Comm_split(MPI_COMM_WORLD, local_rank, rank, &inter_comm);
+      MPI_Comm_size(inter_comm, &num_nodes);
+      MPI_Comm_rank(inter_comm, &node_id);
+      if (num_nodes > 1) {
+        pinter_comm = createCommunicator(
+            num_nodes,
+            node_id,
+            [this](ccl::kvs::address_type& addr) {
+              MPI_Bcast(
+                  (void*)addr.data(),
+                  addr.size(),
+                  MPI_BYTE,
+                  0,
+                  this->inter_comm);
+            },
+            inter_kvs);
+      }
+      pshm = new ShmReduction(
+          local_rank, local_size, [this](int* pid_fd, size_t count) {
+            MPI_Bcast(pid_fd, count, MPI_INT, 0, this->node_comm);
+          });
     }
+#endif
+  }
 
-    pcomm = new ccl::communicator(ccl::create_communicator(size, rank, kvs));
+  /**
+   * Bootstraps oneCCL and the SHM segments through a c10d Store instead of
+   * MPI, so that any launcher providing a store (torchrun, Kubernetes
+   * operators, ...) gets the same collectives as mpirun. The kvs addresses
+   * and the names of the SHM segments are published in the store, and the
+   * ranks of a node are the ones reporting the same hostname.
+   */
+  void initWithStore(
+      const c10::intrusive_ptr<c10d::Store>& base_store,
+      int world_rank,
+      int world_size) {
+    auto store =
+        c10::make_intrusive<c10d::PrefixStore>("ipex_comm", base_store);
+    ccl::init();
+    rank = world_rank;
+    size = world_size;
+    pcomm = createCommunicator(
+        size,
+        rank,
+        [&](ccl::kvs::address_type& addr) {
+          shareBytes(*store, "main_kvs", addr.data(), addr.size(), rank == 0);
+        },
+        kvs);
 
     rank = pcomm->rank();
     size = pcomm->size();
 
 #ifdef USE_SHM
-    char my_hostname[MPI_MAX_PROCESSOR_NAME];
-    char all_hostnames[MPI_MAX_PROCESSOR_NAME * MPI_MAX_PROCESSOR_NAME];
-    int hostname_len;
-
-    // Check ranks are on the same physical machine
-    MPI_Get_processor_name(my_hostname, &hostname_len);
-    MPI_Allgather(
-        my_hostname,
-        MPI_MAX_PROCESSOR_NAME,
-        MPI_CHAR,
-        all_hostnames,
-        MPI_MAX_PROCESSOR_NAME,
-        MPI_CHAR,
-        MPI_COMM_WORLD);
-
-    int same_hostnames = 1;
-    for (int i = 1; i < size; i++) {
-      if (strcmp(my_hostname, &all_hostnames[i * MPI_MAX_PROCESSOR_NAME]) !=
-          0) {
-        same_hostnames = 0;
-        break;
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+    storeSet(*store, "host/" + std::to_string(rank), host);
+    std::vector<std::string> hosts(size);
+    for (int r = 0; r < size; r++) {
+      hosts[r] = storeGet(*store, "host/" + std::to_string(r));
+    }
+    // Nodes are numbered in the order of their first rank.
+    std::vector<std::string> node_hosts;
+    std::vector<int> node_sizes;
+    for (int r = 0; r < size; r++) {
+      auto it = std::find(node_hosts.begin(), node_hosts.end(), hosts[r]);
+      if (it == node_hosts.end()) {
+        node_hosts.push_back(hosts[r]);
+        node_sizes.push_back(0);
+        it = node_hosts.end() - 1;
+      }
+      int node = it - node_hosts.begin();
+      if (r == rank) {
+        node_id = node;
+        local_rank = node_sizes[node];
       }
+      node_sizes[node]++;
     }
+    num_nodes = node_hosts.size();
+    local_size = node_sizes[node_id];
 
-    if (same_hostnames) {
-      pshm = new ShmReduction(rank, size, [this](int* pid_fd, size_t count) {
-        this->broadcast(pid_fd, count);
-      });
-    } else {
-      pshm = nullptr;
+    pshm = nullptr;
+    pinter_comm = nullptr;
+    // Ranks spread unevenly across the nodes keep using oneCCL only.
+    bool even = std::all_of(node_sizes.begin(), node_sizes.end(), [&](int n) {
+      return n == node_sizes[0];
+    });
+    if (even && local_size > 1) {
+      if (num_nodes > 1) {
+        auto key = "inter_kvs/" + std::to_string(local_rank);
+        pinter_comm = createCommunicator(
+            num_nodes,
+            node_id,
+            [&](ccl::kvs::address_type& addr) {
+              shareBytes(*store, key, addr.data(), addr.size(), node_id == 0);
+            },
+            inter_kvs);
+      }
+      // Several jobs may share /dev/shm, keep the name unique.
+      auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+      auto name = std::string(SHM_NAME) + "_" + std::to_string(getpid()) + "_" +
+          std::to_string(stamp);
+      auto key = "shm_name/" + std::to_string(node_id);
+      pshm = new ShmReduction(
+          local_rank, local_size, name, [&](const std::string& own_name) {
+            if (local_rank == 0) {
+              storeSet(*store, key, own_name);
+            }
+            return storeGet(*store, key);
+          });
+      // Unlinked by the local rank 0 once all the local ranks mapped it.
+      auto attached_key = "shm_attached/" + std::to_string(node_id) + "/";
+      storeSet(*store, attached_key + std::to_string(local_rank), "1");
+      if (local_rank == 0) {
+        std::vector<std::string> attached_keys;
+        for (int r = 0; r < local_size; r++) {
+          attached_keys.push_back(attached_key + std::to_string(r));
+        }
+        store->wait(attached_keys);
+        pshm->unlink();
+      }
     }
 #endif
   }
 
+  // Creates a communicator of size ranks, share_addr passes the address of
+  // the kvs created by rank 0 to the other ranks.
+  static ccl::communicator* createCommunicator(
+      int size,
+      int rank,
+      const std::function<void(ccl::kvs::address_type&)>& share_addr,
+      ccl::shared_ptr_class<ccl::kvs>& comm_kvs) {
+    ccl::kvs::address_type addr;
+    if (rank == 0) {
+      comm_kvs = ccl::create_main_kvs();
+      addr = comm_kvs->get_address();
+    }
+    share_addr(addr);
+    if (rank != 0) {
+      comm_kvs = ccl::create_kvs(addr);
+    }
+    return new ccl::communicator(
+        ccl::create_communicator(size, rank, comm_kvs));
+  }
+
+  static void storeSet(
+      c10d::Store& store,
+      const std::string& key,
+      const std::string& value) {
+    store.set(key, std::vector<uint8_t>(value.begin(), value.end()));
+  }
+
+  // Blocks until key is set.
+  static std::string storeGet(c10d::Store& store, const std::string& key) {
+    auto value = store.get(key);
+    return std::string(value.begin(), value.end());
+  }
+
+  static void shareBytes(
+      c10d::Store& store,
+      const std::string& key,
+      char* data,
+      size_t count,
+      bool is_root) {
+    if (is_root) {
+      storeSet(store, key, std::string(data, count));
+    } else {
+      auto value = storeGet(store, key);
+      TORCH_CHECK(value.size() == count, "Messenger: bad value of ", key);
+      std::memcpy(data, value.data(), count);
+    }
+  }
+
+  struct StoreBootstrap {
+    c10::intrusive_ptr<c10d::Store> store;
+    int rank = 0;
+    int size = 1;
+    bool created = false;
+  };
+
+  static StoreBootstrap& storeBootstrap() {
+    static StoreBootstrap bootstrap;
+    return bootstrap;
+  }
+
   ~Messenger() {
     delete pcomm;
 #ifdef USE_SHM
     if (pshm != nullptr)
       delete pshm;
+    if (pinter_comm != nullptr)
+      delete pinter_comm;
 #endif
   }
 
@@ -122,7 +302,7 @@ class Messenger {
     }
   }
 
-  void ccl_allreduce_add(at::Tensor& t_in) {
+  void ccl_allreduce_add(at::Tensor& t_in, ccl::communicator& comm) {
     auto ccl_dtype = get_ccl_dtype(t_in.scalar_type());
     ccl::allreduce(
         t_in.data_ptr(),
@@ -130,16 +310,64 @@ class Messenger {
         (size_t)t_in.numel(),
         ccl_dtype,
         ccl::reduction::sum,
-        *pcomm)
+        comm)
         .wait();
   }
 
+  void ccl_allreduce_add(at::Tensor& t_in) {
+    ccl_allreduce_add(t_in, *pcomm);
+  }
+
+#ifdef USE_SHM
+  /**
+   * Two-level allreduce of a chunk that fits into the SHM buffer: SHM
+   * reduction within the node, oneCCL allreduce of the shard owned by this
+   * local rank among the ranks with the same local rank on the other nodes,
+   * then SHM allgather of the shards within the node.
+   */
+  void hierarchical_allreduce_add(at::Tensor& t_chunk) {
+    pshm->reduceAdd(t_chunk);
+    int64_t numel = t_chunk.numel();
+    // Keep the shard boundaries cache line aligned.
+    int64_t align = std::max<int64_t>(1, 64 / t_chunk.element_size());
+    int64_t shard_size = (numel + local_size - 1) / local_size;
+    shard_size = (shard_size + align - 1) / align * align;
+    int64_t shard_begin = std::min(numel, local_rank * shard_size);
+    int64_t shard_end = std::min(numel, shard_begin + shard_size);
+    if (shard_end > shard_begin) {
+      auto t_shard = t_chunk.slice(0, shard_begin, shard_end);
+      RECORD_FUNCTION("ccl::inter_node_allreduce", std::vector<c10::IValue>());
+      ccl_allreduce_add(t_shard, *pinter_comm);
+    }
+    pshm->allgatherShards(t_chunk, shard_begin, shard_end);
+  }
+#endif
+
  public:
   static Messenger& getInstance() {
     static Messenger instance;
     return instance;
   }
 
+  /**
+   * Makes the communicators bootstrap through store rather than MPI. Must be
+   * called before the first collective, i.e. before getInstance().
+   */
+  static void setStore(
+      c10::intrusive_ptr<c10d::Store> store,
+      int rank,
+      int size) {
+    auto& bootstrap = storeBootstrap();
+    TORCH_CHECK(
+        !bootstrap.created,
+        "The communicators are already initialized, set the store before the first collective");
+    TORCH_CHECK(
+        rank >= 0 && rank < size, "Messenger: bad rank ", rank, " of ", size);
+    bootstrap.store = std::move(store);
+    bootstrap.rank = rank;
+    bootstrap.size = size;
+  }
+
   bool isMaster() {
     return rank == 0;
   }
@@ -154,30 +382,64 @@ class Messenger {
 
   /**
    * Performs a reduction operation by adding the elements of the input tensor.
-   * If USE_SHM is defined and the size of the tensor exceeds the shared memory
-   * size or local ranks flag is false, the reduction is performed using the
-   * ccl_allreduce_add method. Otherwise, the reduction is performed using the
-   * reduceAdd method of the pshm object which used SHM. If USE_SHM is not
-   * defined, the reduction is always performed using the ccl_allreduce_add
-   * method.
+   * If USE_SHM is defined and there are several ranks on the node, the tensor
+   * is reduced in chunks that fit into the shared memory buffer. Within a
+   * single node each chunk is reduced with the reduceAdd method of the pshm
+   * object. When the job spans several nodes, each chunk goes through
+   * hierarchical_allreduce_add. Otherwise, the reduction is performed using
+   * the ccl_allreduce_add method.
    *
    * @param t_in The input tensor to be reduced.
    */
   void reduceAdd(at::Tensor& t_in) {
 #ifdef USE_SHM
-    if (t_in.numel() * sizeof(float) > pshm->getSHMSize() || pshm == nullptr) {
+    if (pshm == nullptr) {
       this->ccl_allreduce_add(t_in);
-    } else {
-      pshm->reduceAdd(t_in);
+      return;
+    }
+    bool multi_node = pinter_comm != nullptr;
+    int64_t chunk_size = pshm->getChunkSize(t_in.scalar_type());
+    int64_t numel = t_in.numel();
+    auto t_flat = t_in.view({-1});
+    for (int64_t start = 0; start < numel; start += chunk_size) {
+      auto t_chunk =
+          t_flat.slice(0, start, std::min(numel, start + chunk_size));
+      if (multi_node) {
+        hierarchical_allreduce_add(t_chunk);
+      } else {
+        pshm->reduceAdd(t_chunk);
+      }
     }
 #else
     this->ccl_allreduce_add(t_in);
 #endif
   }
 
-  at::Tensor allgather(
+  /**
+   * Gathers the [..., cols_r] slice of every rank r into the column window
+   * [cols_per_rank[r], cols_per_rank[r + 1]) of the contiguous output t_out.
+   * Within a single node the slices go through SHM straight into t_out.
+   * Otherwise oneCCL gathers them into per-rank buffers that are then copied
+   * into the windows.
+   */
+  at::Tensor& allgather(
       at::Tensor data,
-      const std::vector<at::Tensor>& vec_data_out) {
+      at::Tensor& t_out,
+      const std::vector<int64_t>& cols_per_rank) {
+    data = data.contiguous();
+#ifdef USE_SHM
+    if (pshm != nullptr && pinter_comm == nullptr && pshm->canGather(t_out)) {
+      pshm->allgatherColumns(data, t_out, cols_per_rank);
+      return t_out;
+    }
+#endif
+    std::vector<at::Tensor> vec_data_out;
+    auto shape = data.sizes();
+    for (int64_t r = 0; r < size; r++) {
+      std::vector<int64_t> t_out_shape(shape.begin(), shape.end() - 1);
+      t_out_shape.push_back(cols_per_rank[r + 1] - cols_per_rank[r]);
+      vec_data_out.push_back(at::empty(t_out_shape, data.options()));
+    }
     std::vector<size_t> recvCounts;
     std::transform(
         vec_data_out.begin(),
@@ -201,7 +463,13 @@ class Messenger {
           *pcomm)
           .wait();
     }
-    return at::cat(vec_data_out, -1);
+    for (int64_t r = 0; r < size; r++) {
+      t_out
+          .narrow(
+              -1, cols_per_rank[r], cols_per_rank[r + 1] - cols_per_rank[r])
+          .copy_(vec_data_out[r]);
+    }
+    return t_out;
   }
 
   void barrier() {
@@ -246,12 +514,20 @@ class Messenger {
   int rank;
 
   ccl::shared_ptr_class<ccl::kvs> kvs;
-  ccl::kvs::address_type main_addr;
 
   ccl::communicator* pcomm;
 
 #ifdef USE_SHM
   ShmReduction* pshm;
+  // Ranks of this node, and ranks with the same local rank on other nodes.
+  MPI_Comm node_comm;
+  MPI_Comm inter_comm;
+  int local_rank = 0;
+  int local_size = 1;
+  int node_id = 0;
+  int num_nodes = 1;
+  ccl::shared_ptr_class<ccl::kvs> inter_kvs;
+  ccl::communicator* pinter_comm;
 #endif
 };
 #endif
\ No newline at end of file
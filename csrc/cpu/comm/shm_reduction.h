@@ -15,6 +15,7 @@
 #include <cstring>
 #include <functional>
 #include <iostream>
+#include <string>
 #include "aten/ShmAllReduceAdd.h"
 
 namespace torch_ipex {
@@ -36,26 +37,16 @@ struct ShmContext {
   void* address;
   at::Tensor t_address;
   size_t nstates;
+  size_t nblock_states;
   size_t nblocks;
   size_t nbytes;
 };
 
-inline void connect_shm(ShmContext* ctx) {
-  char fd_path[64];
-  snprintf(
-      fd_path,
-      sizeof(fd_path),
-      "/proc/%d/fd/%d",
-      ctx->pid_fd[0],
-      ctx->pid_fd[1]);
-  ctx->fp = open(fd_path, O_RDWR);
-  if (ctx->fp == -1) {
-    perror("Bad file descriptor.");
-    exit(-1);
-  }
-
+// Maps the segment opened as ctx->fp, which is sized for ctx already.
+inline void map_shm(ShmContext* ctx) {
   const int total_size =
-      ctx->nstates * sizeof(int) + ctx->nbytes + ctx->nblocks * ctx->nstates;
+      ctx->nstates * sizeof(int) + ctx->nbytes +
+      ctx->nblocks * ctx->nblock_states;
 
   // Map the shared memory into the address space of the process
   void* shm_ptr =
@@ -72,11 +63,11 @@ inline void connect_shm(ShmContext* ctx) {
   ctx->t_blockState =
       at::from_blob(
           (void*)ctx->blockState,
-          {(signed long)ctx->nblocks, (signed long)ctx->nstates},
+          {(signed long)ctx->nblocks, (signed long)ctx->nblock_states},
           at::kByte)
           .to(at::kCPU);
   ctx->address =
-      (void*)((uint8_t*)ctx->blockState + ctx->nblocks * ctx->nstates);
+      (void*)((uint8_t*)ctx->blockState + ctx->nblocks * ctx->nblock_states);
   ctx->t_address = at::from_blob(
                        (void*)ctx->address,
                        {(signed long)(ctx->nbytes / sizeof(float))},
@@ -84,6 +75,34 @@ inline void connect_shm(ShmContext* ctx) {
                        .to(at::kCPU);
 }
 
+inline void connect_shm(ShmContext* ctx) {
+  char fd_path[64];
+  snprintf(
+      fd_path,
+      sizeof(fd_path),
+      "/proc/%d/fd/%d",
+      ctx->pid_fd[0],
+      ctx->pid_fd[1]);
+  ctx->fp = open(fd_path, O_RDWR);
+  if (ctx->fp == -1) {
+    perror("Bad file descriptor.");
+    exit(-1);
+  }
+  map_shm(ctx);
+}
+
+// Opens the segment created by create_shm under ctx->name. Unlike
+// connect_shm it does not need to see the /proc of the creator, only the
+// same /dev/shm.
+inline void open_shm(ShmContext* ctx) {
+  ctx->fp = shm_open(ctx->name, O_RDWR, S_IRUSR | S_IWUSR);
+  if (ctx->fp == -1) {
+    perror("shm open failed.");
+    exit(-1);
+  }
+  map_shm(ctx);
+}
+
 inline void create_shm(ShmContext* ctx) {
   ctx->fp = shm_open(ctx->name, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
 
@@ -92,40 +111,16 @@ inline void create_shm(ShmContext* ctx) {
     exit(-1);
   }
   const int total_size =
-      ctx->nstates * sizeof(int) + ctx->nbytes + ctx->nblocks * ctx->nstates;
+      ctx->nstates * sizeof(int) + ctx->nbytes +
+      ctx->nblocks * ctx->nblock_states;
   // Truncate the shared memory to the desired size
   if (ftruncate(ctx->fp, total_size) == -1) {
     perror("shm ftruncate failed.");
     exit(-1);
   }
-
-  // Map the shared memory into the address space of the process
-  void* shm_ptr =
-      mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_SHARED, ctx->fp, 0);
-  if (shm_ptr == MAP_FAILED) {
-    perror("shm mmap failed.");
-    exit(-1);
-  }
   ctx->pid_fd[0] = getpid();
   ctx->pid_fd[1] = ctx->fp;
-  ctx->state = (int*)shm_ptr;
-  ctx->t_state =
-      at::from_blob((void*)ctx->state, {(signed long)ctx->nstates}, at::kInt)
-          .to(at::kCPU);
-  ctx->blockState = (uint8_t*)((int*)shm_ptr + ctx->nstates);
-  ctx->t_blockState =
-      at::from_blob(
-          (void*)ctx->blockState,
-          {(signed long)ctx->nblocks, (signed long)ctx->nstates},
-          at::kByte)
-          .to(at::kCPU);
-  ctx->address =
-      (void*)((uint8_t*)ctx->blockState + ctx->nblocks * ctx->nstates);
-  ctx->t_address = at::from_blob(
-                       (void*)ctx->address,
-                       {(signed long)(ctx->nbytes / sizeof(float))},
-                       at::kFloat)
-                       .to(at::kCPU);
+  map_shm(ctx);
 }
 
 inline void close_shm(ShmContext* ctx) {
@@ -141,16 +136,13 @@ inline void close_shm(ShmContext* ctx) {
 
 class ShmReduction {
  public:
+  // The segment is passed as the (pid, fd) pair of rank 0, which callback
+  // broadcasts to the other ranks.
   ShmReduction(int rank, int size, std::function<void(int*, size_t)> callback)
-      : rank_(rank), rank_size_(size) {
-    shmCtx_.name = SHM_NAME;
-    shmCtx_.nstates = size;
-    shmCtx_.nbytes = MAX_SHM_SIZE;
-    shmCtx_.nblocks = MAX_SHM_BLOCK_COUNT;
+      : rank_(rank), rank_size_(size), name_(SHM_NAME) {
+    init_context();
     if (rank_ == 0) {
-      torch_ipex::cpu::create_shm(&shmCtx_);
-      std::fill_n(shmCtx_.state, shmCtx_.nstates, 0);
-      std::fill_n(shmCtx_.blockState, shmCtx_.nstates * shmCtx_.nblocks, 0);
+      create_segment();
     }
 
     callback(shmCtx_.pid_fd, 2);
@@ -160,14 +152,54 @@ class ShmReduction {
     }
   }
 
+  // The segment is passed by name: rank 0 creates it as name and share_name
+  // returns the name published by rank 0 once the segment exists.
+  ShmReduction(
+      int rank,
+      int size,
+      const std::string& name,
+      std::function<std::string(const std::string&)> share_name)
+      : rank_(rank), rank_size_(size), name_(name) {
+    init_context();
+    if (rank_ == 0) {
+      create_segment();
+    }
+
+    name_ = share_name(name_);
+    shmCtx_.name = name_.c_str();
+
+    if (rank != 0) {
+      torch_ipex::cpu::open_shm(&shmCtx_);
+    }
+  }
+
   ~ShmReduction() {
     torch_ipex::cpu::close_shm(&shmCtx_);
   }
 
+  // Removes the name of the segment, the mappings stay valid. Once every
+  // rank has mapped it, so that it does not outlive a job that is killed.
+  void unlink() {
+    shm_unlink(shmCtx_.name);
+  }
+
   int getSHMSize() {
     return MAX_SHM_SIZE;
   }
 
+  // Number of elements reduced through SHM in one round. The upper half of
+  // the buffer is kept for the allgathers, so that a rank can publish its
+  // data while slower ranks still read the reduced data of the previous
+  // collective. There are block states for MAX_SHM_BLOCK_COUNT blocks per
+  // rank, which bounds the round to as many blocks of SHM_BLOCK_SIZE_L
+  // elements.
+  int64_t getChunkSize(at::ScalarType dtype) {
+    int64_t bytes = MAX_SHM_SIZE / 2;
+    return std::min<int64_t>(
+        bytes / std::max(sizeof(float), at::elementSize(dtype)),
+        (int64_t)MAX_SHM_BLOCK_COUNT * SHM_BLOCK_SIZE_L);
+  }
+
   void reduceAdd(at::Tensor& t_in) {
     bool is_small = t_in.numel() < 51200;
     auto block_size = is_small ? SHM_BLOCK_SIZE_S : SHM_BLOCK_SIZE_L;
@@ -182,9 +214,72 @@ class ShmReduction {
         rank_size_);
   }
 
+  // Every rank owns [shard_begin, shard_end) of t_in and receives the shards
+  // of the other ranks. t_in must fit into getChunkSize(dtype).
+  void allgatherShards(
+      at::Tensor& t_in,
+      int64_t shard_begin,
+      int64_t shard_end) {
+    auto half = shmCtx_.t_address.numel() / 2;
+    auto t_gather_address = shmCtx_.t_address.narrow(0, half, half);
+    torch_ipex::cpu::shm_allgather_shards_kernel_stub(
+        kCPU,
+        t_in,
+        t_gather_address,
+        shmCtx_.t_state,
+        shard_begin,
+        shard_end,
+        ++gather_generation_,
+        rank_,
+        rank_size_);
+  }
+
+  // Gathers the column slice of every rank into its column window of t_out.
+  // The whole t_out must fit into half of the SHM buffer, see canGather.
+  void allgatherColumns(
+      at::Tensor& t_in,
+      at::Tensor& t_out,
+      const std::vector<int64_t>& cols_per_rank) {
+    auto half = shmCtx_.t_address.numel() / 2;
+    auto t_gather_address = shmCtx_.t_address.narrow(0, half, half);
+    torch_ipex::cpu::shm_allgather_cols_kernel_stub(
+        kCPU,
+        t_in,
+        t_out,
+        t_gather_address,
+        shmCtx_.t_state,
+        cols_per_rank,
+        ++gather_generation_,
+        rank_,
+        rank_size_);
+  }
+
+  bool canGather(const at::Tensor& t_out) {
+    return t_out.numel() * t_out.element_size() <= MAX_SHM_SIZE / 2;
+  }
+
   int rank_;
   int rank_size_;
 
  private:
+  void init_context() {
+    shmCtx_.name = name_.c_str();
+    // One reduction state per rank followed by the two counters per rank used
+    // by allgatherShards. The block states are only used by the reduction.
+    shmCtx_.nstates = 3 * rank_size_;
+    shmCtx_.nblock_states = rank_size_;
+    shmCtx_.nbytes = MAX_SHM_SIZE;
+    shmCtx_.nblocks = MAX_SHM_BLOCK_COUNT;
+  }
+
+  void create_segment() {
+    torch_ipex::cpu::create_shm(&shmCtx_);
+    std::fill_n(shmCtx_.state, shmCtx_.nstates, 0);
+    std::fill_n(
+        shmCtx_.blockState, shmCtx_.nblock_states * shmCtx_.nblocks, 0);
+  }
+
+  std::string name_;
   torch_ipex::cpu::ShmContext shmCtx_;
+  int64_t gather_generation_ = 0;
 };
@@ -5,6 +5,7 @@
 #include <c10/util/Exception.h>
 
 #include <Macros.h>
+#include <utils/telemetry.h>
 #include <atomic>
 #include <type_traits>
 
@@ -37,6 +38,11 @@ using namespace c10;
 // To call:
 //   stub(kCPU, tensor);
 //
+// When the kernel telemetry is enabled, every call records a
+// telemetry::KernelScope named after the stub, with the ISA of the chosen
+// kernel and the size and bytes of its tensor arguments (see
+// utils/telemetry.h).
+//
 // TODO: CPU instruction set selection should be folded into whatever
 // the main dispatch mechanism is.
 
@@ -205,10 +211,55 @@ struct DispatchStub<rT (*)(Args...), T> {
             ));
   }
 
+  static const char* isa_name(FnPtr call_ptr) {
+#ifdef HAVE_AVX512_FP16_CPU_DEFINITION
+    if (call_ptr == AVX512_FP16) {
+      return "AVX512_FP16";
+    }
+#endif
+#ifdef HAVE_AMX_CPU_DEFINITION
+    if (call_ptr == AMX) {
+      return "AMX";
+    }
+#endif
+#ifdef HAVE_AVX512_BF16_CPU_DEFINITION
+    if (call_ptr == AVX512_BF16) {
+      return "AVX512_BF16";
+    }
+#endif
+#ifdef HAVE_AVX512_VNNI_CPU_DEFINITION
+    if (call_ptr == AVX512_VNNI) {
+      return "AVX512_VNNI";
+    }
+#endif
+#ifdef HAVE_AVX512_CPU_DEFINITION
+    if (call_ptr == AVX512) {
+      return "AVX512";
+    }
+#endif
+#ifdef HAVE_AVX2_VNNI_CPU_DEFINITION
+    if (call_ptr == AVX2_VNNI) {
+      return "AVX2_VNNI";
+    }
+#endif
+#ifdef HAVE_AVX2_CPU_DEFINITION
+    if (call_ptr == AVX2) {
+      return "AVX2";
+    }
+#endif
+    return call_ptr == DEFAULT ? "DEFAULT" : "XPU";
+  }
+
  public:
   template <typename... ArgTypes>
   rT operator()(DeviceType device_type, ArgTypes&&... args) {
     FnPtr call_ptr = get_call_ptr(device_type);
+    telemetry::KernelScope scope;
+    if (C10_UNLIKELY(telemetry::is_enabled())) {
+      auto tensor_args = telemetry::tensor_args(args...);
+      scope.start(T::kernel_name, tensor_args.size, isa_name(call_ptr));
+      scope.add_bytes(tensor_args.bytes);
+    }
     return (*call_ptr)(std::forward<ArgTypes>(args)...);
   }
 
@@ -265,12 +316,13 @@ struct RegisterHIPDispatch {
 // adding parentheses and using helper struct to get rid of the parentheses, do
 // not work with MSVC. So do a `using`-declaration if you need to pass in such
 // `fn`, e.g., grid_sampler_2d_backward_cpu_kernel in GridSampleKernel.h.
-#define IPEX_DECLARE_DISPATCH(fn, name)    \
-  struct name : DispatchStub<fn, name> {   \
-    name() = default;                      \
-    name(const name&) = delete;            \
-    name& operator=(const name&) = delete; \
-  };                                       \
+#define IPEX_DECLARE_DISPATCH(fn, name)               \
+  struct name : DispatchStub<fn, name> {              \
+    static constexpr const char* kernel_name = #name; \
+    name() = default;                                 \
+    name(const name&) = delete;                       \
+    name& operator=(const name&) = delete;            \
+  };                                                  \
   extern IPEX_API struct name name
 
 #define IPEX_DEFINE_DISPATCH(name) struct name name
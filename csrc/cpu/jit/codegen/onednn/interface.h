@@ -4,6 +4,10 @@
 #include <torch/csrc/jit/ir/ir.h>
 #include <torch/csrc/jit/passes/pass_manager.h>
 
+#include <map>
+#include <string>
+#include <vector>
+
 namespace torch_ipex {
 namespace jit {
 namespace fuser {
@@ -25,6 +29,17 @@ IPEX_API void setLlgaWeightCacheEnabled(bool enabled);
 
 IPEX_API bool getLlgaWeightCacheEnabled();
 
+// Bucket boundaries the dynamic dims of the LLGA partition inputs are padded
+// up to, see shape_bucket.h. Empty, i.e. disabled, unless set here or with
+// IPEX_LLGA_SHAPE_BUCKETS.
+IPEX_API void setLlgaShapeBuckets(std::vector<int64_t> buckets);
+
+IPEX_API std::vector<int64_t> getLlgaShapeBuckets();
+
+IPEX_API std::map<std::string, int64_t> getLlgaShapeBucketStats();
+
+IPEX_API void resetLlgaShapeBucketStats();
+
 } // namespace onednn
 } // namespace fuser
 
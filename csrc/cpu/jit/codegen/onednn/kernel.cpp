@@ -4,11 +4,15 @@
 #include "kernel.h"
 #include "operator.h"
 #include "runtime.h"
+#include "shape_bucket.h"
 
 #include <ATen/core/functional.h>
 #include <ATen/quantized/Quantizer.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <algorithm>
+#include <map>
+
 namespace torch_ipex {
 namespace jit {
 namespace fuser {
@@ -451,9 +455,108 @@ std::pair<compiled_partition, ArgSpecs> LlgaKernel::compile(
   return std::make_pair(compilation, outputSpecs);
 }
 
+c10::optional<PaddedDims> LlgaKernel::padInputsToBuckets(Stack& stack) {
+  std::call_once(bucketableInitialized_, [&]() {
+    // Outputs in opaque layout cannot be sliced
+    bucketable_ = isRowIndependent(graph_);
+    for (size_t i = 0; i < nOutputs_; i++) {
+      bucketable_ = bucketable_ && !useOpaqueLayout(i);
+    }
+  });
+  if (!bucketable_) {
+    return c10::nullopt;
+  }
+
+  // The dims other than the last one differing from the profiled shape are
+  // dynamic, they must have the same size across the inputs.
+  auto stackInputs = last(stack, nGraphInputs_);
+  std::vector<std::vector<int64_t>> dynamicDims(nGraphInputs_);
+  std::map<int64_t, int64_t> dynamicSizes;
+  for (size_t i = 0; i < nGraphInputs_; i++) {
+    if (!stackInputs[i].isTensor()) {
+      return c10::nullopt;
+    }
+    const auto& input = stackInputs[i].toTensor();
+    if (input.is_mkldnn()) {
+      return c10::nullopt;
+    }
+    auto profiled = graph_->inputs()[i]->type()->expect<TensorType>()->sizes();
+    auto rank = profiled.size().value_or(0);
+    for (int64_t d = 0; d + 1 < input.dim(); d++) {
+      auto profiledSize = d < rank ? profiled[d] : c10::nullopt;
+      if (input.size(d) == 1 || profiledSize == input.size(d)) {
+        continue;
+      }
+      auto it = dynamicSizes.find(d);
+      if (it != dynamicSizes.end() && it->second != input.size(d)) {
+        return c10::nullopt;
+      }
+      dynamicSizes[d] = input.size(d);
+      dynamicDims[i].push_back(d);
+    }
+  }
+  if (dynamicSizes.empty()) {
+    return c10::nullopt;
+  }
+  PaddedDims paddedDims;
+  for (auto& dimAndSize : dynamicSizes) {
+    auto bucket = bucketSize(dimAndSize.second);
+    if (bucket < 0) {
+      return c10::nullopt;
+    }
+    if (bucket > dimAndSize.second) {
+      paddedDims.push_back({dimAndSize.first, dimAndSize.second, bucket});
+    }
+  }
+
+  int64_t inputElements = 0;
+  int64_t paddingElements = 0;
+  std::vector<int64_t> shapeKey;
+  for (size_t i = 0; i < nGraphInputs_; i++) {
+    auto input = stackInputs[i].toTensor();
+    inputElements += input.numel();
+    shapeKey.insert(shapeKey.end(), input.sizes().begin(), input.sizes().end());
+    auto paddedShape = input.sizes().vec();
+    for (auto& padded : paddedDims) {
+      auto& dims = dynamicDims[i];
+      if (std::find(dims.begin(), dims.end(), padded[0]) != dims.end()) {
+        paddedShape[padded[0]] = padded[2];
+      }
+    }
+    if (paddedShape == input.sizes()) {
+      continue;
+    }
+    // The padding rows only reach the padding rows of the outputs, their
+    // values do not matter as long as they are finite.
+    auto paddedInput = input.is_quantized()
+        ? at::new_qtensor(paddedShape, input.options(), input.quantizer())
+        : at::zeros(paddedShape, input.options());
+    auto unpadded = paddedInput;
+    for (int64_t d = 0; d < input.dim(); d++) {
+      unpadded = unpadded.narrow(d, 0, input.size(d));
+    }
+    unpadded.copy_(input);
+    paddingElements += paddedInput.numel() - input.numel();
+    stack[stack.size() - nGraphInputs_ + i] = std::move(paddedInput);
+  }
+
+  auto& counters = shapeBucketCounters();
+  counters.bucketedRuns++;
+  counters.inputElements += inputElements;
+  counters.paddingElements += paddingElements;
+  {
+    std::lock_guard<std::mutex> lock(bucketedShapesMutex_);
+    if (bucketedShapes_.insert(shapeKey).second) {
+      counters.distinctShapes++;
+    }
+  }
+  return paddedDims;
+}
+
 LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
     Stack& stack,
-    TensorArgs& outputs) {
+    TensorArgs& outputs,
+    bool bucketed) {
   RECORD_FUNCTION("LLGA_bridge::prepareKernel", c10::ArrayRef<c10::IValue>({}));
   // Grab input values from stack
   auto stackInputs = last(stack, nGraphInputs_);
@@ -479,6 +582,9 @@ LlgaKernel::cp_entry& LlgaKernel::compileAndCache(
   auto iter = cache_items_map_.find(key);
   if (iter == cache_items_map_.end()) {
     GRAPH_DEBUG("Compiling partition");
+    if (bucketed) {
+      shapeBucketCounters().bucketCompilations++;
+    }
     cp_entry compiledPartitionEntry;
     auto input_shape = inputs[0].sizes().vec();
     auto inputSpecs = initializeInputSpecs(inputs);
@@ -525,7 +631,12 @@ void LlgaKernel::run(Stack& stack) {
   TensorArgs outputs;
   outputs.reserve(nOutputs_);
 
-  auto& compiledPartitionEntry = compileAndCache(stack, outputs);
+  c10::optional<PaddedDims> paddedDims;
+  if (shapeBucketsEnabled()) {
+    paddedDims = padInputsToBuckets(stack);
+  }
+  auto& compiledPartitionEntry =
+      compileAndCache(stack, outputs, paddedDims.has_value());
 
 #ifdef GRAPH_DEBUG_ENABLED
   GRAPH_DEBUG("Executing partition");
@@ -541,6 +652,15 @@ void LlgaKernel::run(Stack& stack) {
   // Update the stack.
   drop(stack, nGraphInputs_);
   for (auto& o : outputs) {
+    if (paddedDims.has_value()) {
+      // Slice the padding off, the dims are those of the inputs as the
+      // partition only has row-wise ops.
+      for (auto& padded : *paddedDims) {
+        if (o.dim() > padded[0] + 1 && o.size(padded[0]) == padded[2]) {
+          o = o.narrow(padded[0], 0, padded[1]);
+        }
+      }
+    }
     push_one(stack, std::move(o));
   }
 #ifdef GRAPH_DEBUG_ENABLED
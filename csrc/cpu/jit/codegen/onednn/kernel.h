@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "codegen/LlgaTensorImpl.h"
 #include "graph_helper.h"
@@ -49,6 +52,8 @@ using ArgSpecs = std::vector<ArgSpec>;
 using RunArg = dnnl::graph::tensor;
 using RunArgs = std::vector<RunArg>;
 using TensorArgs = std::vector<at::Tensor>;
+// (dim, unpadded size, bucket) of the inputs padded by shape bucketing
+using PaddedDims = std::vector<std::array<int64_t, 3>>;
 
 class LlgaKernel {
  public:
@@ -109,7 +114,14 @@ class LlgaKernel {
       const TensorArgs& inputs,
       ArgSpecs& inputSpecs);
 
-  cp_entry& compileAndCache(torch::jit::Stack& stack, TensorArgs& outputs);
+  cp_entry& compileAndCache(
+      torch::jit::Stack& stack,
+      TensorArgs& outputs,
+      bool bucketed);
+
+  // Pads the dynamic dims of the inputs on the stack up to their bucket, see
+  // shape_bucket.h. Returns nullopt when the shapes are not bucketed.
+  c10::optional<PaddedDims> padInputsToBuckets(torch::jit::Stack& stack);
 
   void prepareRunArgs(
       RunArgs& inputLlgaTensors,
@@ -184,6 +196,10 @@ class LlgaKernel {
   std::once_flag constantSpecInitializedFlag_;
   std::once_flag tracedInputShapesInitialized_;
   std::vector<short> inplacePairOffsets_;
+  std::once_flag bucketableInitialized_;
+  bool bucketable_ = false;
+  std::mutex bucketedShapesMutex_;
+  std::unordered_set<std::vector<int64_t>> bucketedShapes_;
 };
 
 } // namespace onednn
@@ -131,7 +131,11 @@ void IpexQuantFusion(std::shared_ptr<torch::jit::Graph>& graph) {
       graph);
   graph_rewrite::replaceMergedEmbCatWithQmergedEmbCat(graph);
   GRAPH_DUMP(
-      "After replaceMergedEmbCatWithQmergedEmbCat. Before preprocessSizeForQLstm",
+      "After replaceMergedEmbCatWithQmergedEmbCat. Before replaceMergedEmbInteractionWithQmergedEmbInteraction",
+      graph);
+  graph_rewrite::replaceMergedEmbInteractionWithQmergedEmbInteraction(graph);
+  GRAPH_DUMP(
+      "After replaceMergedEmbInteractionWithQmergedEmbInteraction. Before preprocessSizeForQLstm",
       graph);
   graph_rewrite::preprocessSizeForQLstm(graph);
   GRAPH_DUMP(
@@ -0,0 +1,194 @@
+#include "shape_bucket.h"
+#include "interface.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <unordered_set>
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+using namespace torch::jit;
+
+namespace {
+
+using Buckets = std::vector<int64_t>;
+
+// IPEX_LLGA_SHAPE_BUCKETS="64,128,256,512"
+std::shared_ptr<const Buckets> bucketsFromEnv() {
+  auto buckets = std::make_shared<Buckets>();
+  auto env = std::getenv("IPEX_LLGA_SHAPE_BUCKETS");
+  if (env != nullptr) {
+    std::stringstream ss(env);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      if (!item.empty()) {
+        buckets->push_back(std::stoll(item));
+      }
+    }
+    std::sort(buckets->begin(), buckets->end());
+  }
+  return buckets;
+}
+
+std::shared_ptr<const Buckets>& buckets() {
+  static std::shared_ptr<const Buckets> buckets_ = bucketsFromEnv();
+  return buckets_;
+}
+
+// Whether v only depends on constants, e.g. a (dequantized) weight
+bool isConstantOperand(Value* v) {
+  auto* node = v->node();
+  while (node->kind() == Symbol::aten("dequantize") ||
+         node->kind() == aten::to || node->kind() == aten::t ||
+         node->kind() == aten::transpose) {
+    node = node->input(0)->node();
+  }
+  return node->kind() == prim::Constant;
+}
+
+bool isLastDim(Value* input, Value* dim) {
+  auto dim_value = toIValue(dim);
+  if (!dim_value.has_value() || !dim_value->isInt()) {
+    return false;
+  }
+  auto d = dim_value->toInt();
+  if (d == -1) {
+    return true;
+  }
+  auto type = input->type()->cast<TensorType>();
+  auto rank = type ? type->dim() : c10::nullopt;
+  return rank.has_value() && d == static_cast<int64_t>(*rank) - 1;
+}
+
+} // namespace
+
+void setLlgaShapeBuckets(std::vector<int64_t> new_buckets) {
+  std::sort(new_buckets.begin(), new_buckets.end());
+  TORCH_CHECK(
+      new_buckets.empty() || new_buckets.front() > 0,
+      "LLGA shape buckets must be positive");
+  std::atomic_store(
+      &buckets(),
+      std::shared_ptr<const Buckets>(
+          std::make_shared<Buckets>(std::move(new_buckets))));
+}
+
+std::vector<int64_t> getLlgaShapeBuckets() {
+  return *std::atomic_load(&buckets());
+}
+
+std::map<std::string, int64_t> getLlgaShapeBucketStats() {
+  auto& counters = shapeBucketCounters();
+  return {
+      {"bucketed_runs", counters.bucketedRuns.load()},
+      {"compilations", counters.bucketCompilations.load()},
+      {"distinct_shapes", counters.distinctShapes.load()},
+      {"compilations_saved",
+       counters.distinctShapes.load() - counters.bucketCompilations.load()},
+      {"input_elements", counters.inputElements.load()},
+      {"padding_elements", counters.paddingElements.load()},
+  };
+}
+
+void resetLlgaShapeBucketStats() {
+  auto& counters = shapeBucketCounters();
+  counters.bucketedRuns = 0;
+  counters.bucketCompilations = 0;
+  counters.distinctShapes = 0;
+  counters.inputElements = 0;
+  counters.paddingElements = 0;
+}
+
+bool shapeBucketsEnabled() {
+  return !std::atomic_load(&buckets())->empty();
+}
+
+int64_t bucketSize(int64_t size) {
+  auto current = std::atomic_load(&buckets());
+  auto it = std::lower_bound(current->begin(), current->end(), size);
+  return it == current->end() ? -1 : *it;
+}
+
+ShapeBucketCounters& shapeBucketCounters() {
+  static ShapeBucketCounters counters;
+  return counters;
+}
+
+bool isRowIndependent(const std::shared_ptr<Graph>& graph) {
+  static const std::unordered_set<Symbol> eltwise = {
+      aten::add,
+      aten::sub,
+      aten::mul,
+      aten::div,
+      aten::relu,
+      aten::gelu,
+      aten::sigmoid,
+      aten::tanh,
+      aten::elu,
+      aten::leaky_relu,
+      aten::hardtanh,
+      aten::hardswish,
+      aten::hardsigmoid,
+      aten::mish,
+      aten::clamp,
+      aten::abs,
+      aten::exp,
+      aten::log,
+      aten::sqrt,
+      aten::rsqrt,
+      aten::round,
+      aten::pow,
+      aten::square,
+      aten::to,
+      aten::type_as,
+      Symbol::aten("quantize_per_tensor"),
+      Symbol::aten("dequantize"),
+  };
+  for (auto* node : graph->block()->nodes()) {
+    auto kind = node->kind();
+    if (kind == prim::Constant || kind == aten::linear ||
+        eltwise.count(kind)) {
+      continue;
+    }
+    if (kind == prim::ListConstruct) {
+      // constant arguments, e.g. the normalized_shape of layer_norm
+      bool constant = std::all_of(
+          node->inputs().begin(), node->inputs().end(), [](Value* v) {
+            return v->node()->kind() == prim::Constant;
+          });
+      if (constant) {
+        continue;
+      }
+      return false;
+    }
+    // Rows times a weight
+    if ((kind == aten::matmul || kind == aten::mm) &&
+        isConstantOperand(node->input(1))) {
+      continue;
+    }
+    // Normalized or reduced along the last dim only
+    if (kind == aten::layer_norm) {
+      auto shape = toIValue(node->input(1));
+      if (shape.has_value() && shape->isIntList() &&
+          shape->toIntVector().size() == 1) {
+        continue;
+      }
+      return false;
+    }
+    if (kind == aten::softmax && isLastDim(node->input(0), node->input(1))) {
+      continue;
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
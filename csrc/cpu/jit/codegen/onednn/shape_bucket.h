@@ -0,0 +1,55 @@
+#pragma once
+
+#include <torch/csrc/jit/ir/ir.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace torch_ipex {
+namespace jit {
+namespace fuser {
+namespace onednn {
+
+// Shape bucketing of the LLGA partitions.
+//
+// A partition is compiled per concrete input shape, so that e.g. every new
+// sequence length of an NLP model costs a compilation. In bucketing mode,
+// the dims of the partition inputs that differ from the profiled shape are
+// padded up to the next configured bucket boundary, so that the partition
+// is compiled once per bucket, and the padding is sliced off the outputs.
+//
+// Padding is only correct for partitions whose output rows only depend on
+// the same rows of the inputs, e.g. linear + eltwise, and only along the
+// dims other than the last one. Partitions reducing or mixing along other
+// dims, e.g. attention scores or convolutions, are never padded.
+
+// Smallest bucket boundary >= size, or -1 when bucketing is disabled or size
+// is larger than the largest boundary.
+int64_t bucketSize(int64_t size);
+
+bool shapeBucketsEnabled();
+
+// Whether padding the non-last dims of the inputs of graph leaves the
+// unpadded rows of its outputs unchanged.
+bool isRowIndependent(const std::shared_ptr<torch::jit::Graph>& graph);
+
+struct ShapeBucketCounters {
+  // Calls run with bucketed input shapes, padded or already on a boundary
+  std::atomic<int64_t> bucketedRuns{0};
+  // Compilations of bucketed partitions
+  std::atomic<int64_t> bucketCompilations{0};
+  // Distinct unpadded input shapes served by the bucketed partitions, each
+  // of which would have been a compilation without bucketing
+  std::atomic<int64_t> distinctShapes{0};
+  // Elements of the bucketed runs inputs, before padding and added by it
+  std::atomic<int64_t> inputElements{0};
+  std::atomic<int64_t> paddingElements{0};
+};
+
+ShapeBucketCounters& shapeBucketCounters();
+
+} // namespace onednn
+} // namespace fuser
+} // namespace jit
+} // namespace torch_ipex
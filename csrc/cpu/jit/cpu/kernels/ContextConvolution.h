@@ -3,6 +3,7 @@
 #include <ATen/Tensor.h>
 
 #include <ideep.hpp>
+#include "NumaWeightReplicas.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -27,6 +28,8 @@ struct ContextConvolution final {
   bool weight_is_channels_last_;
   ideep::convolution_forward_params conv_params_;
   ideep::convolution_forward::super conv_desc_;
+  // Copies of weight_packed_ per NUMA node, see NumaWeightReplicas
+  NumaWeightReplicas weight_replicas_;
 
   ContextConvolution() = delete;
 
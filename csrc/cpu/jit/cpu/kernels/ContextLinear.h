@@ -3,6 +3,7 @@
 #include <ATen/Tensor.h>
 
 #include <ideep.hpp>
+#include "NumaWeightReplicas.h"
 
 namespace torch_ipex {
 namespace cpu {
@@ -14,6 +15,8 @@ struct ContextLinear final {
   // at_weight is used for autograd and optimizer update
   at::Tensor at_weight_;
   c10::optional<at::Tensor> at_bias_;
+  // Copies of weight_packed_ per NUMA node, see NumaWeightReplicas
+  NumaWeightReplicas weight_replicas_;
 
   ContextLinear() = delete;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/Tensor.h>
+#include "NumaWeightReplicas.h"
 
 #define WOQ_DTYPE_INT8 1
 #define WOQ_DTYPE_INT4 2
@@ -30,6 +31,10 @@ struct ContextLinearWoq final {
   // Compensation for INT8 GEMM.
   // Compensation = Σ(k)(W[k][n] - ZP[n]) for each block.
   c10::optional<at::Tensor> cached_compensation_ = c10::nullopt;
+  // Copies of at_weight_ and cached_weight_ per NUMA node, see
+  // NumaWeightReplicas
+  NumaWeightReplicas weight_replicas_;
+  NumaWeightReplicas cached_weight_replicas_;
 
   ContextLinearWoq() = delete;
 
@@ -363,21 +363,24 @@ at::Tensor& convolution_bottleneck_run(
     context1.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, mkldnn_input},
-         {DNNL_ARG_WEIGHTS, context1.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context1.weight_replicas_.local(context1.weight_packed_)},
          {DNNL_ARG_BIAS, context1.bias_},
          {DNNL_ARG_DST, ouput1},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
     context2.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, ouput1},
-         {DNNL_ARG_WEIGHTS, context2.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context2.weight_replicas_.local(context2.weight_packed_)},
          {DNNL_ARG_BIAS, context2.bias_},
          {DNNL_ARG_DST, ouput2},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
     context3.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, ouput2},
-         {DNNL_ARG_WEIGHTS, context3.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context3.weight_replicas_.local(context3.weight_packed_)},
          {DNNL_ARG_BIAS, context3.bias_},
          {DNNL_ARG_DST, mkldnn_input},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
@@ -446,28 +449,32 @@ at::Tensor convolution_bottleneck_run(
     context1.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, mkldnn_input},
-         {DNNL_ARG_WEIGHTS, context1.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context1.weight_replicas_.local(context1.weight_packed_)},
          {DNNL_ARG_BIAS, context1.bias_},
          {DNNL_ARG_DST, ouput1},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
     context2.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, ouput1},
-         {DNNL_ARG_WEIGHTS, context2.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context2.weight_replicas_.local(context2.weight_packed_)},
          {DNNL_ARG_BIAS, context2.bias_},
          {DNNL_ARG_DST, ouput2},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
     context3.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, mkldnn_input},
-         {DNNL_ARG_WEIGHTS, context3.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context3.weight_replicas_.local(context3.weight_packed_)},
          {DNNL_ARG_BIAS, context3.bias_},
          {DNNL_ARG_DST, ouput3},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
     context4.conv_desc_.execute(
         ideep::stream::default_stream(),
         {{DNNL_ARG_SRC, ouput2},
-         {DNNL_ARG_WEIGHTS, context4.weight_packed_},
+         {DNNL_ARG_WEIGHTS,
+          context4.weight_replicas_.local(context4.weight_packed_)},
          {DNNL_ARG_BIAS, context4.bias_},
          {DNNL_ARG_DST, ouput3},
          {DNNL_ARG_SCRATCHPAD, scratchpad}});
@@ -652,6 +659,8 @@ at::Tensor run(
       context.dilation_,
       context.groups_);
 
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   if (input_.sizes().vec() == context.conv_params_.pd.src_desc().get_dims() &&
       attr.has_same_postop_as(context.conv_params_.op_attr) &&
       attr.get_all_scales() == context.conv_params_.op_attr.get_all_scales() &&
@@ -674,14 +683,14 @@ at::Tensor run(
           context.conv_params_,
           context.conv_desc_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           mkldnn_output);
     } else {
       ideep::convolution_forward::compute(
           context.conv_params_,
           context.conv_desc_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           context.bias_,
           mkldnn_output);
     }
@@ -689,7 +698,7 @@ at::Tensor run(
   }
   return convolution_kernel(
       input_,
-      context.weight_packed_,
+      weight,
       context.bias_,
       context.stride_,
       context.padding_,
@@ -742,6 +751,8 @@ at::Tensor& run(
       context.dilation_,
       context.groups_);
 
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   if (input_.sizes().vec() == context.conv_params_.pd.src_desc().get_dims() &&
       attr == context.conv_params_.op_attr &&
       omp_get_max_threads() == context.conv_params_.pd_use_threads) {
@@ -753,21 +764,21 @@ at::Tensor& run(
           context.conv_params_,
           context.conv_desc_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           mkldnn_output);
     } else {
       ideep::convolution_forward::compute(
           context.conv_params_,
           context.conv_desc_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           context.bias_,
           mkldnn_output);
     }
   } else {
     convolution_kernel_output(
         input_,
-        context.weight_packed_,
+        weight,
         context.bias_,
         accumu,
         context.stride_,
@@ -783,6 +794,8 @@ void run_core_fast_path_nhwc(
     const ContextConvolution& context,
     void* input,
     void* output) {
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   auto mkldnn_input = ideep::tensor(
       context.conv_params_.pd.src_desc(), input, ideep::engine::cpu_engine());
   auto mkldnn_output = ideep::tensor(
@@ -792,14 +805,14 @@ void run_core_fast_path_nhwc(
     ideep::convolution_forward::compute<false, false>(
         context.conv_params_,
         mkldnn_input,
-        context.weight_packed_,
+        weight,
         context.bias_,
         mkldnn_output);
   } else {
     ideep::convolution_forward::compute<false, false>(
         context.conv_params_,
         mkldnn_input,
-        context.weight_packed_,
+        weight,
         mkldnn_output);
   }
 }
@@ -808,6 +821,8 @@ void run_core_fast_path(
     const ContextConvolution& context,
     const at::Tensor& input,
     at::Tensor& accumu) {
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   auto input_layout = input.suggest_memory_format();
   bool use_channels_last = input_layout == at::MemoryFormat::ChannelsLast ||
       input_layout == at::MemoryFormat::ChannelsLast3d;
@@ -820,14 +835,14 @@ void run_core_fast_path(
       ideep::convolution_forward::compute<false, false>(
           context.conv_params_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           context.bias_,
           mkldnn_output);
     } else {
       ideep::convolution_forward::compute<false, false>(
           context.conv_params_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           mkldnn_output);
     }
   } else {
@@ -835,14 +850,14 @@ void run_core_fast_path(
       ideep::convolution_forward::compute<true, false>(
           context.conv_params_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           context.bias_,
           mkldnn_output);
     } else {
       ideep::convolution_forward::compute<true, false>(
           context.conv_params_,
           mkldnn_input,
-          context.weight_packed_,
+          weight,
           mkldnn_output);
     }
   }
@@ -853,9 +868,11 @@ void run_core_fallback(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   convolution_kernel_output(
       input,
-      context.weight_packed_,
+      weight,
       context.bias_,
       accumu,
       context.stride_,
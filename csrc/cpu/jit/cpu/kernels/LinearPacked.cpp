@@ -275,7 +275,11 @@ at::Tensor run(
   c10::MaybeOwned<at::Tensor> bias_maybe_owned =
       at::borrow_from_optional_tensor(context.at_bias_);
   const at::Tensor& bias = *bias_maybe_owned;
-  return linear_kernel(input_, context.weight_packed_, bias, attr);
+  return linear_kernel(
+      input_,
+      context.weight_replicas_.local(context.weight_packed_),
+      bias,
+      attr);
 }
 
 at::Tensor& run(
@@ -290,7 +294,12 @@ at::Tensor& run(
   c10::MaybeOwned<at::Tensor> bias_maybe_owned =
       at::borrow_from_optional_tensor(context.at_bias_);
   const at::Tensor& bias = *bias_maybe_owned;
-  linear_kernel_output(input_, context.weight_packed_, bias, accumu, attr);
+  linear_kernel_output(
+      input_,
+      context.weight_replicas_.local(context.weight_packed_),
+      bias,
+      accumu,
+      attr);
   return accumu;
 }
 
@@ -307,7 +316,12 @@ at::Tensor run(
       at::borrow_from_optional_tensor(context.at_bias_);
   const at::Tensor& bias = *bias_maybe_owned;
 
-  return linear_kernel(input_, context.weight_packed_, bias, attr, post_op_src);
+  return linear_kernel(
+      input_,
+      context.weight_replicas_.local(context.weight_packed_),
+      bias,
+      attr,
+      post_op_src);
 }
 
 void run_core(
@@ -321,22 +335,19 @@ void run_core(
   TORCH_CHECK(
       input.size(input.dim() - 1) == context.weight_packed_.get_dims()[1],
       "Check the shapes of mat1 and mat2, they cannot be multiplied!");
+  const ideep::tensor& weight =
+      context.weight_replicas_.local(context.weight_packed_);
   if (context.at_bias_) {
     auto mkl_bias = itensor_view_from_dense(*context.at_bias_);
     ideep::inner_product_forward::prepare(
-        param,
-        mkldnn_input,
-        context.weight_packed_,
-        mkl_bias,
-        mkldnn_output,
-        attr);
+        param, mkldnn_input, weight, mkl_bias, mkldnn_output, attr);
     ideep::inner_product_forward::compute<true, false>(
-        param, mkldnn_input, context.weight_packed_, mkl_bias, mkldnn_output);
+        param, mkldnn_input, weight, mkl_bias, mkldnn_output);
   } else {
     ideep::inner_product_forward::prepare(
-        param, mkldnn_input, context.weight_packed_, mkldnn_output, attr);
+        param, mkldnn_input, weight, mkldnn_output, attr);
     ideep::inner_product_forward::compute<true, false>(
-        param, mkldnn_input, context.weight_packed_, mkldnn_output);
+        param, mkldnn_input, weight, mkldnn_output);
   }
 }
 
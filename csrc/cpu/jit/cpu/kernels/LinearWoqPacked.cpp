@@ -193,6 +193,43 @@ c10::intrusive_ptr<WoqLinearOpContext> createWoqLinearPrePackOpContextInt4(
       cache_weight_for_large_batch);
 }
 
+c10::intrusive_ptr<WoqLinearOpContext>
+createWoqLinearPrePackOpContextFromPacked(
+    at::Tensor&& packed_weight,
+    int64_t weight_dtype,
+    std::vector<int64_t>&& weight_shape,
+    at::Tensor&& scales,
+    c10::optional<at::Tensor>&& zero_points,
+    c10::optional<at::Tensor>&& bias,
+    c10::optional<at::Tensor>&& g_idx,
+    c10::optional<at::Tensor>&& cached_weight,
+    c10::optional<at::Tensor>&& cached_compensation,
+    int64_t group_size,
+    int64_t lowp_mode,
+    int64_t act_quant_mode,
+    bool cache_weight_for_large_batch) {
+  RECORD_FUNCTION(
+      "ipex_prepack::createWoqLinearPrePackOpContextFromPacked",
+      c10::ArrayRef<c10::IValue>({}));
+
+  auto op_context = create_from_packed(
+      packed_weight,
+      weight_dtype,
+      weight_shape,
+      scales,
+      zero_points,
+      bias,
+      g_idx,
+      cached_weight,
+      cached_compensation,
+      group_size,
+      lowp_mode,
+      act_quant_mode,
+      cache_weight_for_large_batch);
+  return c10::make_intrusive<IpexWoqLinearOpContext>(
+      c10::nullopt, std::move(op_context));
+}
+
 static const std::map<c10::string_view, int64_t> WOQ_DTYPE_MAP = {
     {"int8", WOQ_DTYPE_INT8},
     {"int4", WOQ_DTYPE_INT4},
@@ -274,6 +311,22 @@ at::Tensor woq_linear_run(
   return op_context->run(input);
 }
 
+// Number of output channels of a packed weight: N, or N padded to a multiple of
+// the block size.
+static int64_t _packed_n(
+    const at::Tensor& packed_weight,
+    int64_t N,
+    bool is_4bit) {
+  auto packed_shape = packed_weight.sizes();
+  if (packed_shape.size() == 4) {
+    return packed_shape[0] * packed_shape[3] * (is_4bit ? 2 : 1);
+  }
+  if (packed_shape.size() == 2) {
+    return packed_shape[0];
+  }
+  return N;
+}
+
 ContextLinearWoq create(
     at::Tensor& weight,
     int64_t weight_dtype,
@@ -304,70 +357,86 @@ ContextLinearWoq create(
     packed_weight = woq_linear_pack_weight(
         weight, weight_dtype, weight_shape, group_size, lowp_mode);
   }
-  auto packed_shape = packed_weight.sizes();
+  // The compensation is not computed if OC is padded
+  c10::optional<at::Tensor> compensation = c10::nullopt;
+  if (weight_dtype == WOQ_DTYPE_INT8 && lowp_mode == 3 &&
+      _packed_n(packed_weight, N, is_4bit) == N) {
+    compensation = c10::make_optional<at::Tensor>(
+        woq_linear_compute_compensation(
+            weight, weight_dtype, group_size, lowp_mode));
+  }
+  c10::optional<at::Tensor> cached_weight = c10::nullopt;
+  return create_from_packed(
+      packed_weight,
+      weight_dtype,
+      weight_shape,
+      scales,
+      zero_points,
+      bias,
+      g_idx,
+      cached_weight,
+      compensation,
+      group_size,
+      lowp_mode,
+      act_quant_mode,
+      cache_weight_for_large_batch);
+}
+
+ContextLinearWoq create_from_packed(
+    at::Tensor& packed_weight,
+    int64_t weight_dtype,
+    std::vector<int64_t>& weight_shape,
+    at::Tensor& scales,
+    c10::optional<at::Tensor>& zero_points,
+    c10::optional<at::Tensor>& bias,
+    c10::optional<at::Tensor>& g_idx,
+    c10::optional<at::Tensor>& cached_weight,
+    c10::optional<at::Tensor>& cached_compensation,
+    int64_t group_size,
+    int64_t lowp_mode,
+    int64_t act_quant_mode,
+    bool cache_weight_for_large_batch) {
+  int64_t N = weight_shape[0];
+  bool is_4bit =
+      (weight_dtype == WOQ_DTYPE_INT4 || weight_dtype == WOQ_DTYPE_NF4);
+  at::Tensor scales_float = scales;
+  c10::optional<at::Tensor> zero_points_float = c10::nullopt;
+  if (zero_points.has_value() && zero_points.value().defined()) {
+    zero_points_float = c10::make_optional(zero_points.value().to(c10::kFloat));
+  }
+  c10::optional<at::Tensor> bias_padded = std::move(bias);
   // If OC is not a multiple of BLOCK_N, it may be padded.
-  bool oc_is_padded = (packed_shape.size() == 4 && is_4bit &&
-                       packed_shape[0] * packed_shape[3] * 2 != N) ||
-      (packed_shape.size() == 4 && !is_4bit &&
-       packed_shape[0] * packed_shape[3] != N) ||
-      (packed_shape.size() == 2 && packed_shape[0] != N);
-  if (oc_is_padded) {
-    int64_t padded_N = packed_shape.size() == 4
-        ? (is_4bit ? packed_shape[0] * packed_shape[3] * 2
-                   : packed_shape[0] * packed_shape[3])
-        : packed_shape[0];
+  int64_t padded_N = _packed_n(packed_weight, N, is_4bit);
+  if (padded_N != N) {
     std::vector<int64_t> pad_vec = scales.dim() == 1
         ? std::vector<int64_t>({0, padded_N - N})
         : std::vector<int64_t>({0, 0, 0, padded_N - N});
-    auto scales_padded = at::pad(scales, pad_vec, "constant", 1.f);
-    c10::optional<at::Tensor> zero_points_padded = c10::nullopt;
-    if (zero_points.has_value() && zero_points.value().defined()) {
-      auto zero_points_float = zero_points.value().to(c10::kFloat);
-      auto zero_points_tensor_padded =
-          at::pad(zero_points_float, pad_vec, "constant", 0.f);
-      zero_points_padded = c10::make_optional(zero_points_tensor_padded);
+    scales_float = at::pad(scales, pad_vec, "constant", 1.f);
+    if (zero_points_float.has_value()) {
+      zero_points_float = c10::make_optional(
+          at::pad(zero_points_float.value(), pad_vec, "constant", 0.f));
     }
-    c10::optional<at::Tensor> bias_padded = c10::nullopt;
-    if (bias.has_value() && bias.value().defined()) {
-      auto bias_tensor_padded =
-          at::pad(bias.value(), {0, padded_N - N}, "constant", 0.f);
-      bias_padded = c10::make_optional(bias_tensor_padded);
+    if (bias_padded.has_value() && bias_padded.value().defined()) {
+      bias_padded = c10::make_optional(
+          at::pad(bias_padded.value(), {0, padded_N - N}, "constant", 0.f));
+    } else {
+      bias_padded = c10::nullopt;
     }
-    return ContextLinearWoq(
-        std::move(packed_weight),
-        weight_dtype,
-        std::move(weight_shape),
-        std::move(scales_padded),
-        std::move(zero_points_padded),
-        std::move(bias_padded),
-        std::move(g_idx),
-        group_size,
-        lowp_mode,
-        act_quant_mode,
-        cache_weight_for_large_batch);
-  }
-  c10::optional<at::Tensor> zero_points_float = c10::nullopt;
-  if (zero_points.has_value() && zero_points.value().defined()) {
-    zero_points_float = c10::make_optional(zero_points.value().to(c10::kFloat));
   }
   auto context = ContextLinearWoq(
       std::move(packed_weight),
       weight_dtype,
       std::move(weight_shape),
-      std::move(scales),
+      std::move(scales_float),
       std::move(zero_points_float),
-      std::move(bias),
+      std::move(bias_padded),
       std::move(g_idx),
       group_size,
       lowp_mode,
       act_quant_mode,
       cache_weight_for_large_batch);
-  if (weight_dtype == WOQ_DTYPE_INT8 && lowp_mode == 3) {
-    auto compensation = woq_linear_compute_compensation(
-        weight, weight_dtype, group_size, lowp_mode);
-    context.cached_compensation_ =
-        c10::make_optional<at::Tensor>(std::move(compensation));
-  }
+  context.cached_weight_ = std::move(cached_weight);
+  context.cached_compensation_ = std::move(cached_compensation);
   return context;
 }
 
@@ -460,6 +529,10 @@ at::Tensor run(ContextLinearWoq& context, const at::Tensor& input) {
       !context.cached_weight_.has_value()) {
     _dequant_weight_and_cache_in_context(context);
   }
+  auto weight = context.weight_replicas_.local(context.at_weight_);
+  auto cached_weight = context.cached_weight_.has_value()
+      ? context.cached_weight_replicas_.local(context.cached_weight_.value())
+      : at::Tensor();
   auto M = input.numel() > 0 ? input.numel() / input.size(-1) : 0;
   bool fast_path_lowp_mode_3 = false;
   if (M >= SMALL_BATCH_THRESHOLD && context.cached_weight_.has_value() &&
@@ -468,7 +541,7 @@ at::Tensor run(ContextLinearWoq& context, const at::Tensor& input) {
       auto input_reshaped = input.dim() == 2 ? input.unsqueeze(0) : input;
       auto out = tpp_linear_bias_forward_cpu(
           input_reshaped.to(c10::kBFloat16).contiguous(),
-          context.cached_weight_.value(),
+          cached_weight,
           context.bias_list_[2],
           c10::nullopt);
       return input.dim() == 2 ? out.squeeze(0) : out;
@@ -494,8 +567,7 @@ at::Tensor run(ContextLinearWoq& context, const at::Tensor& input) {
   input_ = _shuffle_input_channels_if_needed(context, input_);
   auto res = woq_linear_kernel(
       input_,
-      fast_path_lowp_mode_3 ? context.cached_weight_.value()
-                            : context.at_weight_,
+      fast_path_lowp_mode_3 ? cached_weight : weight,
       context.weight_dtype_,
       context.scales_list_,
       context.zero_points_list_,
@@ -522,6 +594,10 @@ at::Tensor run_unary(
       !context.cached_weight_.has_value()) {
     _dequant_weight_and_cache_in_context(context);
   }
+  auto weight = context.weight_replicas_.local(context.at_weight_);
+  auto cached_weight = context.cached_weight_.has_value()
+      ? context.cached_weight_replicas_.local(context.cached_weight_.value())
+      : at::Tensor();
   auto M = input.numel() > 0 ? input.numel() / input.size(-1) : 0;
   bool fast_path_lowp_mode_3 = false;
   if (M >= SMALL_BATCH_THRESHOLD && context.cached_weight_.has_value() &&
@@ -532,14 +608,14 @@ at::Tensor run_unary(
         if (algorithm == "none") {
           auto out = tpp_linear_gelu_forward_cpu(
               input_reshaped.to(c10::kBFloat16).contiguous(),
-              context.cached_weight_.value(),
+              cached_weight,
               context.bias_list_[2],
               c10::nullopt);
           return input.dim() == 2 ? out.squeeze(0) : out;
         } else if (algorithm == "tanh") {
           auto out = tpp_linear_gelu_tanh_forward_cpu(
               input_reshaped.to(c10::kBFloat16).contiguous(),
-              context.cached_weight_.value(),
+              cached_weight,
               context.bias_list_[2],
               c10::nullopt);
           return input.dim() == 2 ? out.squeeze(0) : out;
@@ -547,14 +623,14 @@ at::Tensor run_unary(
       } else if (post_op == "silu") {
         auto out = tpp_linear_silu_forward_cpu(
             input_reshaped.to(c10::kBFloat16).contiguous(),
-            context.cached_weight_.value(),
+            cached_weight,
             context.bias_list_[2],
             c10::nullopt);
         return input.dim() == 2 ? out.squeeze(0) : out;
       } else if (post_op == "relu") {
         auto out = tpp_linear_relu_forward_cpu(
             input_reshaped.to(c10::kBFloat16).contiguous(),
-            context.cached_weight_.value(),
+            cached_weight,
             context.bias_list_[2],
             c10::nullopt);
         return input.dim() == 2 ? out.squeeze(0) : out;
@@ -581,8 +657,7 @@ at::Tensor run_unary(
   input_ = _shuffle_input_channels_if_needed(context, input_);
   auto res = woq_linear_unary_kernel(
       input_,
-      fast_path_lowp_mode_3 ? context.cached_weight_.value()
-                            : context.at_weight_,
+      fast_path_lowp_mode_3 ? cached_weight : weight,
       context.weight_dtype_,
       context.scales_list_,
       context.zero_points_list_,
@@ -612,6 +687,10 @@ at::Tensor run_binary(
       !context.cached_weight_.has_value()) {
     _dequant_weight_and_cache_in_context(context);
   }
+  auto weight = context.weight_replicas_.local(context.at_weight_);
+  auto cached_weight = context.cached_weight_.has_value()
+      ? context.cached_weight_replicas_.local(context.cached_weight_.value())
+      : at::Tensor();
   bool fast_path_lowp_mode_3 = false;
   if (M >= SMALL_BATCH_THRESHOLD && context.cached_weight_.has_value() &&
       context.cached_weight_.value().defined()) {
@@ -621,7 +700,7 @@ at::Tensor run_binary(
         auto out = tpp_linear_add_forward_cpu(
             input_reshaped.to(c10::kBFloat16).contiguous(),
             others[0],
-            context.cached_weight_.value(),
+            cached_weight,
             context.bias_list_[2],
             1.0,
             c10::nullopt);
@@ -631,7 +710,7 @@ at::Tensor run_binary(
             input_reshaped.to(c10::kBFloat16),
             others[0],
             others[1],
-            context.cached_weight_.value(),
+            cached_weight,
             context.bias_list_[2],
             1.0,
             c10::nullopt);
@@ -640,7 +719,7 @@ at::Tensor run_binary(
         auto out = tpp_linear_mul_forward_cpu(
             input_reshaped.to(c10::kBFloat16),
             others[0],
-            context.cached_weight_.value(),
+            cached_weight,
             context.bias_list_[2],
             c10::nullopt);
         return input.dim() == 2 ? out.squeeze(0) : out;
@@ -667,8 +746,7 @@ at::Tensor run_binary(
   input_ = _shuffle_input_channels_if_needed(context, input_);
   auto res = woq_linear_binary_kernel(
       input_,
-      fast_path_lowp_mode_3 ? context.cached_weight_.value()
-                            : context.at_weight_,
+      fast_path_lowp_mode_3 ? cached_weight : weight,
       context.weight_dtype_,
       context.scales_list_,
       context.zero_points_list_,
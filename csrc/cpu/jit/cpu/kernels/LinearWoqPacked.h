@@ -36,6 +36,25 @@ c10::intrusive_ptr<WoqLinearOpContext> createWoqLinearPrePackOpContextInt4(
     int64_t act_quant_mode,
     bool cache_weight_for_large_batch = false);
 
+// Creates the context of a weight packed beforehand, e.g. by a previous
+// process, without packing or copying it. The scales, zero points and bias
+// are those of the unpadded output channels.
+c10::intrusive_ptr<WoqLinearOpContext>
+createWoqLinearPrePackOpContextFromPacked(
+    at::Tensor&& packed_weight,
+    int64_t weight_dtype,
+    std::vector<int64_t>&& weight_shape,
+    at::Tensor&& scales,
+    c10::optional<at::Tensor>&& zero_points,
+    c10::optional<at::Tensor>&& bias,
+    c10::optional<at::Tensor>&& g_idx,
+    c10::optional<at::Tensor>&& cached_weight,
+    c10::optional<at::Tensor>&& cached_compensation,
+    int64_t group_size,
+    int64_t lowp_mode,
+    int64_t act_quant_mode,
+    bool cache_weight_for_large_batch);
+
 std::tuple<
     at::Tensor,
     std::vector<at::Tensor>,
@@ -77,6 +96,21 @@ ContextLinearWoq create(
     int64_t act_quant_mode,
     bool cache_weight_for_large_batch);
 
+ContextLinearWoq create_from_packed(
+    at::Tensor& packed_weight,
+    int64_t weight_dtype,
+    std::vector<int64_t>& weight_shape,
+    at::Tensor& scales,
+    c10::optional<at::Tensor>& zero_points,
+    c10::optional<at::Tensor>& bias,
+    c10::optional<at::Tensor>& g_idx,
+    c10::optional<at::Tensor>& cached_weight,
+    c10::optional<at::Tensor>& cached_compensation,
+    int64_t group_size,
+    int64_t lowp_mode,
+    int64_t act_quant_mode,
+    bool cache_weight_for_large_batch);
+
 at::Tensor run(ContextLinearWoq& context, const at::Tensor& input);
 
 at::Tensor run_unary(
@@ -0,0 +1,161 @@
+#include "NumaWeightReplicas.h"
+
+#include <ATen/ATen.h>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+
+namespace {
+
+#ifndef _WIN32
+// Flags of get_mempolicy from <numaif.h>, which is shipped with libnuma.
+constexpr unsigned long kMpolFNode = 1 << 0;
+constexpr unsigned long kMpolFAddr = 1 << 1;
+#endif
+
+int read_numa_node_count() {
+#ifdef _WIN32
+  return 1;
+#else
+  // A list of increasing ranges like "0-1" or "0,2-3", so the last number
+  // is the highest node id.
+  std::ifstream file("/sys/devices/system/node/possible");
+  std::string nodes;
+  if (!(file >> nodes)) {
+    return 1;
+  }
+  auto pos = nodes.find_last_of(",-");
+  auto last = nodes.substr(pos == std::string::npos ? 0 : pos + 1);
+  try {
+    return std::stoi(last) + 1;
+  } catch (...) {
+    return 1;
+  }
+#endif
+}
+
+// NUMA node of the page holding addr, -1 if unknown.
+int numa_node_of(const void* addr) {
+#ifdef _WIN32
+  return -1;
+#else
+  int node = -1;
+  if (syscall(
+          SYS_get_mempolicy,
+          &node,
+          nullptr,
+          0,
+          const_cast<void*>(addr),
+          kMpolFNode | kMpolFAddr) != 0) {
+    return -1;
+  }
+  return node;
+#endif
+}
+
+} // namespace
+
+bool numa_replicate_weights_enabled() {
+  static bool enabled = []() {
+    auto env = std::getenv("IPEX_NUMA_REPLICATE_WEIGHTS");
+    return env != nullptr && std::string(env) == "1";
+  }();
+  return enabled;
+}
+
+int numa_node_count() {
+  static int count = read_numa_node_count();
+  return count;
+}
+
+int current_numa_node() {
+#ifdef _WIN32
+  return 0;
+#else
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0 ||
+      node >= (unsigned)numa_node_count()) {
+    return 0;
+  }
+  return node;
+#endif
+}
+
+int NumaWeightReplicas::replica_node() {
+  if (!numa_replicate_weights_enabled() || numa_node_count() <= 1) {
+    return -1;
+  }
+  return current_numa_node();
+}
+
+NumaWeightReplicas::Replica& NumaWeightReplicas::replica_of(int node) const {
+  if (replicas_.empty()) {
+    replicas_.resize(numa_node_count());
+  }
+  return replicas_[node];
+}
+
+at::Tensor NumaWeightReplicas::local(const at::Tensor& weight) const {
+  int node = replica_node();
+  if (node < 0 || !weight.defined() || weight.numel() == 0) {
+    return weight;
+  }
+  std::lock_guard<std::mutex> lock(*mutex_);
+  auto& replica = replica_of(node);
+  if (replica.source != weight.data_ptr()) {
+    replica.source = weight.data_ptr();
+    // Only the first page is checked, the weight is usually allocated at
+    // once by a single thread.
+    if (numa_node_of(weight.data_ptr()) == node) {
+      replica.buffer = weight;
+    } else {
+      replica.buffer = at::empty_strided(
+          weight.sizes(), weight.strides(), weight.options());
+      replica.buffer.copy_(weight);
+    }
+  }
+  return replica.buffer;
+}
+
+const ideep::tensor& NumaWeightReplicas::local(
+    const ideep::tensor& weight) const {
+  int node = replica_node();
+  if (node < 0 || weight.is_empty()) {
+    return weight;
+  }
+  std::lock_guard<std::mutex> lock(*mutex_);
+  auto& replica = replica_of(node);
+  void* data = weight.get_data_handle();
+  if (replica.source != data) {
+    replica.source = data;
+    if (numa_node_of(data) == node) {
+      replica.buffer = at::Tensor();
+      replica.packed = weight;
+    } else {
+      int64_t nbytes = weight.get_desc().get_size();
+      replica.buffer = at::empty({nbytes}, at::kByte);
+      replica.buffer.copy_(at::from_blob(data, {nbytes}, at::kByte));
+      replica.packed.init(weight.get_desc(), replica.buffer.data_ptr());
+    }
+  }
+  return replica.packed;
+}
+
+void NumaWeightReplicas::clear() {
+  std::lock_guard<std::mutex> lock(*mutex_);
+  replicas_.clear();
+}
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
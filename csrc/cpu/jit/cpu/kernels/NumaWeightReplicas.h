@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+
+#include <ideep.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch_ipex {
+namespace cpu {
+namespace detail {
+
+// Whether IPEX_NUMA_REPLICATE_WEIGHTS=1, read once.
+bool numa_replicate_weights_enabled();
+
+// Number of NUMA nodes of the machine, 1 if unknown.
+int numa_node_count();
+
+// NUMA node of the CPU the calling thread is running on, 0 if unknown.
+int current_numa_node();
+
+// NumaWeightReplicas keeps one copy of a prepacked weight per NUMA node so
+// that the streams of a MultiStreamModule spanning several sockets all read
+// their weights from local memory. The copy of a node is made by the first
+// thread running the op on that node: it is allocated and first touched by
+// that thread and the OpenMP threads of its stream, so its pages land on the
+// node. The copies are only made if IPEX_NUMA_REPLICATE_WEIGHTS=1 and the
+// machine has several NUMA nodes, otherwise the weight itself is returned.
+//
+// The copies are read-only snapshots of the weight: clear() must be called
+// after the weight is updated in place, and must not run concurrently with
+// local().
+class NumaWeightReplicas {
+ public:
+  NumaWeightReplicas() : mutex_(std::make_unique<std::mutex>()) {}
+  NumaWeightReplicas(NumaWeightReplicas&&) = default;
+  NumaWeightReplicas& operator=(NumaWeightReplicas&&) = default;
+
+  // Returns the copy of weight local to the node of the calling thread.
+  at::Tensor local(const at::Tensor& weight) const;
+  const ideep::tensor& local(const ideep::tensor& weight) const;
+
+  void clear();
+
+ private:
+  struct Replica {
+    // Data pointer of the weight the replica was made from.
+    const void* source = nullptr;
+    // Owns the memory of packed for an ideep weight.
+    at::Tensor buffer;
+    ideep::tensor packed;
+  };
+
+  // Returns the node whose replica should be used, -1 if not replicating.
+  static int replica_node();
+  Replica& replica_of(int node) const;
+
+  std::unique_ptr<std::mutex> mutex_;
+  mutable std::vector<Replica> replicas_;
+};
+
+} // namespace detail
+} // namespace cpu
+} // namespace torch_ipex
@@ -5,10 +5,90 @@
 #include "LinearMKLPacked.h"
 #include "LinearPacked.h"
 #include "LinearWoqPacked.h"
+#include "utils/telemetry.h"
 
 namespace torch_ipex {
 namespace cpu {
 
+namespace {
+
+int64_t rows_of(const at::Tensor& input) {
+  int64_t K = input.dim() > 0 ? input.size(-1) : 0;
+  return K > 0 ? input.numel() / K : 0;
+}
+
+// Adds the FLOPs and bytes of a linear with N output channels to the
+// telemetry of the op, see utils/telemetry.h.
+void record_linear(
+    telemetry::KernelScope& scope,
+    const at::Tensor& input,
+    int64_t N,
+    uint64_t weight_bytes) {
+  int64_t M = rows_of(input);
+  int64_t K = input.size(-1);
+  scope.add_flops(2 * M * N * K);
+  scope.add_bytes(
+      input.nbytes() + weight_bytes + M * N * input.element_size());
+}
+
+void record_linear(
+    telemetry::KernelScope& scope,
+    const detail::ContextLinear& context,
+    const at::Tensor& input) {
+  if (scope.active()) {
+    record_linear(
+        scope,
+        input,
+        context.weight_packed_.get_dims()[0],
+        context.weight_packed_.get_desc().get_size());
+  }
+}
+
+void record_linear(
+    telemetry::KernelScope& scope,
+    const detail::ContextLinearMKL& context,
+    const at::Tensor& input) {
+  if (scope.active()) {
+    record_linear(
+        scope, input, context.sgemm_sizes_[2], context.at_weight_.nbytes());
+  }
+}
+
+#ifdef USE_LIBXSMM
+void record_linear(
+    telemetry::KernelScope& scope,
+    const detail::ContextLinearWoq& context,
+    const at::Tensor& input) {
+  if (scope.active()) {
+    record_linear(
+        scope, input, context.weight_shape_[0], context.at_weight_.nbytes());
+  }
+}
+#endif
+
+// Each element of a convolution output, or of a transposed convolution
+// input, is multiplied by the weights of one output, resp. input, channel.
+void record_convolution(
+    telemetry::KernelScope& scope,
+    const at::Tensor& input,
+    const at::Tensor& output,
+    const ideep::tensor& weight,
+    bool transposed) {
+  int64_t weight_numel = 1;
+  for (auto dim : weight.get_dims()) {
+    weight_numel *= dim;
+  }
+  const at::Tensor& per_channel = transposed ? input : output;
+  if (per_channel.dim() > 1 && per_channel.size(1) > 0) {
+    scope.add_flops(
+        2 * per_channel.numel() * (weight_numel / per_channel.size(1)));
+  }
+  scope.add_bytes(
+      input.nbytes() + weight.get_desc().get_size() + output.nbytes());
+}
+
+} // namespace
+
 template <typename T1, typename T2>
 void load_from_ctx_template(T1* self, c10::intrusive_ptr<T2> other) {
   auto& other_ctx_ = other->get_context();
@@ -83,15 +163,28 @@ int64_t ConvolutionOpContext::get_groups() {
 at::Tensor IpexConvolutionOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::convolution::run(op_context_, input, attr);
+  telemetry::KernelScope scope("ipex_prepack::convolution", input.numel());
+  auto output =
+      torch_ipex::cpu::detail::convolution::run(op_context_, input, attr);
+  if (scope.active()) {
+    record_convolution(
+        scope, input, output, op_context_.weight_packed_, false);
+  }
+  return output;
 }
 
 at::Tensor& IpexConvolutionOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::convolution::run(
+  telemetry::KernelScope scope("ipex_prepack::convolution", input.numel());
+  auto& output = torch_ipex::cpu::detail::convolution::run(
       op_context_, input, accumu, attr);
+  if (scope.active()) {
+    record_convolution(
+        scope, input, output, op_context_.weight_packed_, false);
+  }
+  return output;
 }
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor> IpexConvolutionOpContext::
@@ -133,6 +226,7 @@ at::Tensor IpexConvolutionOpContext::get_data_handle() {
 void IpexConvolutionOpContext::load_from_ctx(
     c10::intrusive_ptr<ConvolutionOpContext> other) {
   load_from_ctx_template(this, other);
+  op_context_.weight_replicas_.clear();
 }
 
 c10::intrusive_ptr<LinearOpContext> IpexLinearOpContext::create_context(
@@ -154,6 +248,8 @@ at::Tensor IpexLinearOpContext::get_data_handle() {
 at::Tensor IpexLinearOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
+  telemetry::KernelScope scope("ipex_prepack::linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::linear::run(op_context_, input, attr);
 }
 
@@ -161,6 +257,8 @@ at::Tensor& IpexLinearOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
+  telemetry::KernelScope scope("ipex_prepack::linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::linear::run(op_context_, input, accumu, attr);
 }
 
@@ -168,6 +266,8 @@ at::Tensor IpexLinearOpContext::run_with_binary_post_op(
     const at::Tensor& input,
     const std::vector<ideep::tensor>& post_op_src,
     const ideep::attr_t& attr) {
+  telemetry::KernelScope scope("ipex_prepack::linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::linear::run(
       op_context_, input, post_op_src, attr);
 }
@@ -204,6 +304,7 @@ at::Tensor IpexLinearOpContext::to_public(const at::Tensor& tensor) {
 void IpexLinearOpContext::load_from_ctx(
     c10::intrusive_ptr<LinearOpContext> other) {
   load_from_ctx_template(this, other);
+  op_context_.weight_replicas_.clear();
 }
 
 c10::intrusive_ptr<ConvTransposeOpContext> IpexConvTransposeOpContext::
@@ -265,12 +366,16 @@ at::Tensor IpexLinearMKLOpContext::pack(const at::Tensor& tensor) {
 }
 
 at::Tensor IpexLinearMKLOpContext::run(const at::Tensor& input) {
+  telemetry::KernelScope scope("ipex_prepack::mkl_sgemm", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input);
 }
 
 at::Tensor& IpexLinearMKLOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu) {
+  telemetry::KernelScope scope("ipex_prepack::mkl_sgemm", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::mkl_sgemm::run(op_context_, input, accumu);
 }
 
@@ -298,15 +403,28 @@ void IpexLinearMKLOpContext::load_from_ctx(
 at::Tensor IpexConvTransposeOpContext::run(
     const at::Tensor& input,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::conv_transpose::run(op_context_, input, attr);
+  telemetry::KernelScope scope(
+      "ipex_prepack::conv_transpose", input.numel());
+  auto output =
+      torch_ipex::cpu::detail::conv_transpose::run(op_context_, input, attr);
+  if (scope.active()) {
+    record_convolution(scope, input, output, op_context_.weight_packed_, true);
+  }
+  return output;
 }
 
 at::Tensor& IpexConvTransposeOpContext::run(
     const at::Tensor& input,
     at::Tensor& accumu,
     const ideep::attr_t& attr) {
-  return torch_ipex::cpu::detail::conv_transpose::run(
+  telemetry::KernelScope scope(
+      "ipex_prepack::conv_transpose", input.numel());
+  auto& output = torch_ipex::cpu::detail::conv_transpose::run(
       op_context_, input, accumu, attr);
+  if (scope.active()) {
+    record_convolution(scope, input, output, op_context_.weight_packed_, true);
+  }
+  return output;
 }
 
 std::tuple<at::Tensor, at::Tensor, at::Tensor> IpexConvTransposeOpContext::
@@ -398,6 +516,8 @@ at::Tensor IpexWoqLinearOpContext::get_data_handle() {
 }
 
 at::Tensor IpexWoqLinearOpContext::run(const at::Tensor& input) {
+  telemetry::KernelScope scope("ipex_prepack::woq_linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::woq_linear::run(op_context_, input);
 }
 
@@ -406,6 +526,8 @@ at::Tensor IpexWoqLinearOpContext::run_unary(
     const c10::string_view& post_op,
     const torch::List<c10::optional<at::Scalar>>& scalars,
     const c10::optional<c10::string_view>& algorithm) {
+  telemetry::KernelScope scope("ipex_prepack::woq_linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::woq_linear::run_unary(
       op_context_, input, post_op, scalars, algorithm);
 }
@@ -414,6 +536,8 @@ at::Tensor IpexWoqLinearOpContext::run_binary(
     const at::Tensor& input,
     const c10::string_view& post_op,
     const std::vector<at::Tensor>& others) {
+  telemetry::KernelScope scope("ipex_prepack::woq_linear", rows_of(input));
+  record_linear(scope, op_context_, input);
   return torch_ipex::cpu::detail::woq_linear::run_binary(
       op_context_, input, post_op, others);
 }
@@ -496,6 +620,8 @@ at::Tensor IpexWoqLinearOpContext::pack(const at::Tensor& tensor) {
 void IpexWoqLinearOpContext::load_from_ctx(
     c10::intrusive_ptr<WoqLinearOpContext> other) {
   load_from_ctx_template(this, other);
+  op_context_.weight_replicas_.clear();
+  op_context_.cached_weight_replicas_.clear();
 }
 #endif
 } // namespace cpu
@@ -16,6 +16,7 @@ using detail::linear::createLinearPrePackOpContext;
 using detail::mkl_sgemm::createLinearMKLPrePackOpContext;
 #ifdef USE_LIBXSMM
 using detail::woq_linear::createWoqLinearPrePackOpContext;
+using detail::woq_linear::createWoqLinearPrePackOpContextFromPacked;
 using detail::woq_linear::createWoqLinearPrePackOpContextInt4;
 using detail::woq_linear::packWoqLinearWeight;
 using detail::woq_linear::unpackWoqLinearWeight;
@@ -195,6 +196,9 @@ TORCH_LIBRARY(ipex_prepack, m) {
   m.def(
       "weight_only_qlinear_prepack_int4(Tensor W, Tensor scales, Tensor? zeros, Tensor? B, Tensor? g_idx, int? batch_size, int group_size, int lowp_mode, int act_quant_mode, bool cache_weight_for_large_batch = False) "
       "-> __torch__.torch.classes.ipex_prepack.WoqLinearOpContext");
+  m.def(
+      "weight_only_qlinear_prepack_from_packed(Tensor W, int W_dtype, int[] W_shape, Tensor scales, Tensor? zero_points, Tensor? B, Tensor? g_idx, Tensor? cached_weight, Tensor? compensation, int group_size, int lowp_mode, int act_quant_mode, bool cache_weight_for_large_batch = False) "
+      "-> __torch__.torch.classes.ipex_prepack.WoqLinearOpContext");
   m.def(
       "woq_linear_pack_weight(Tensor W, str W_dtype, int[] W_shape, Tensor scales, Tensor? zero_points, Tensor? B, Tensor? g_idx, int group_size, int lowp_mode) "
       "-> (Tensor, Tensor[], Tensor[]?, Tensor[]?, Tensor?)");
@@ -218,6 +222,9 @@ TORCH_LIBRARY_IMPL(ipex_prepack, CPU, m) {
   m.impl(
       "weight_only_qlinear_prepack_int4",
       TORCH_FN(createWoqLinearPrePackOpContextInt4));
+  m.impl(
+      "weight_only_qlinear_prepack_from_packed",
+      TORCH_FN(createWoqLinearPrePackOpContextFromPacked));
   m.impl("woq_linear_pack_weight", TORCH_FN(packWoqLinearWeight));
   m.impl("woq_linear_unpack_weight", TORCH_FN(unpackWoqLinearWeight));
 }
@@ -164,6 +164,8 @@ void IPEXFusionPass(std::shared_ptr<Graph>& graph) {
   graph_rewrite::FuseRMSNorm(graph);
   // fuse add+layernorm
   graph_rewrite::FuseAddLayerNorm(graph);
+  // fuse group_norm+silu/gelu(+add)
+  graph_rewrite::FuseGroupNormAct(graph);
 
   // deconvolution fusion
   GRAPH_DUMP(
@@ -246,6 +246,113 @@ void FuseAddLayerNorm(std::shared_ptr<Graph>& graph) {
   rewriter_aten.runOnGraph(graph);
 }
 
+// Fuses group_norm -> silu / gelu (-> add) into ipex::group_norm_act, which
+// applies the activation and the residual add in the sweep writing the
+// output, as in the ResNet blocks of the diffusion UNets.
+void FuseGroupNormAct(std::shared_ptr<Graph>& graph) {
+  std::string aten_gn_silu = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool):
+        %y = aten::group_norm(%input, %num_groups, %weight, %bias, %eps, %cudnn_enabled)
+        %r = aten::silu(%y)
+        return (%r) )";
+  std::string aten_gn_gelu = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %approximate:str):
+        %y = aten::group_norm(%input, %num_groups, %weight, %bias, %eps, %cudnn_enabled)
+        %r = aten::gelu(%y, %approximate)
+        return (%r) )";
+  auto aten_gn_silu_add = at::jit::CodeTemplate(R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %other, %alpha):
+        %y = aten::group_norm(%input, %num_groups, %weight, %bias, %eps, %cudnn_enabled)
+        %a = aten::silu(%y)
+        %r = aten::add(${add_operands}, %alpha)
+        return (%r) )");
+  auto aten_gn_gelu_add = at::jit::CodeTemplate(R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %approximate:str, %other, %alpha):
+        %y = aten::group_norm(%input, %num_groups, %weight, %bias, %eps, %cudnn_enabled)
+        %a = aten::gelu(%y, %approximate)
+        %r = aten::add(${add_operands}, %alpha)
+        return (%r) )");
+  auto aten_gn_add = at::jit::CodeTemplate(R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %other, %alpha):
+        %a = aten::group_norm(%input, %num_groups, %weight, %bias, %eps, %cudnn_enabled)
+        %r = aten::add(${add_operands}, %alpha)
+        return (%r) )");
+
+  std::string fused_gn_silu = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool):
+        %act : str = prim::Constant[value="silu"]()
+        %approximate : str = prim::Constant[value="none"]()
+        %other : NoneType = prim::Constant()
+        %r = ipex::group_norm_act(%input, %num_groups, %weight, %bias, %eps, %act, %approximate, %other)
+        return (%r) )";
+  std::string fused_gn_gelu = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %approximate:str):
+        %act : str = prim::Constant[value="gelu"]()
+        %other : NoneType = prim::Constant()
+        %r = ipex::group_norm_act(%input, %num_groups, %weight, %bias, %eps, %act, %approximate, %other)
+        return (%r) )";
+  std::string fused_gn_silu_add = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %other, %alpha):
+        %act : str = prim::Constant[value="silu"]()
+        %approximate : str = prim::Constant[value="none"]()
+        %r = ipex::group_norm_act(%input, %num_groups, %weight, %bias, %eps, %act, %approximate, %other)
+        return (%r) )";
+  std::string fused_gn_gelu_add = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %approximate:str, %other, %alpha):
+        %act : str = prim::Constant[value="gelu"]()
+        %r = ipex::group_norm_act(%input, %num_groups, %weight, %bias, %eps, %act, %approximate, %other)
+        return (%r) )";
+  std::string fused_gn_add = R"(
+      graph(%input, %num_groups:int, %weight, %bias, %eps:float, %cudnn_enabled:bool, %other, %alpha):
+        %act : str = prim::Constant[value="none"]()
+        %approximate : str = prim::Constant[value="none"]()
+        %r = ipex::group_norm_act(%input, %num_groups, %weight, %bias, %eps, %act, %approximate, %other)
+        return (%r) )";
+
+  // The residual is a tensor added with alpha 1
+  auto add_filter = [](const Match& match,
+                       const std::unordered_map<std::string, Value*>& vmap) {
+    auto other = match.values_map.at(vmap.at("other"));
+    if (!other->type()->cast<TensorType>() || utils::is_scalar(other)) {
+      return false;
+    }
+    auto alpha = match.values_map.at(vmap.at("alpha"));
+    if (alpha->node()->kind() != prim::Constant) {
+      return false;
+    }
+    auto alpha_value = toIValue(alpha).value();
+    return (alpha_value.isDouble() && alpha_value.toDouble() == 1.0) ||
+        (alpha_value.isInt() && alpha_value.toInt() == 1);
+  };
+  auto gelu_add_filter = [&](const Match& match,
+                             const std::unordered_map<std::string, Value*>&
+                                 vmap) {
+    return utils::aten_gelu_approximate_is_supported(match, vmap) &&
+        add_filter(match, vmap);
+  };
+
+  // The add patterns are rewritten first as they contain the others.
+  for (const auto& add_operands : {"%a, %other", "%other, %a"}) {
+    at::jit::TemplateEnv env;
+    env.s("add_operands", add_operands);
+    SubgraphRewriter rewriter_silu_add, rewriter_gelu_add, rewriter_add;
+    rewriter_silu_add.RegisterRewritePattern(
+        aten_gn_silu_add.format(env), fused_gn_silu_add);
+    rewriter_gelu_add.RegisterRewritePattern(
+        aten_gn_gelu_add.format(env), fused_gn_gelu_add);
+    rewriter_add.RegisterRewritePattern(aten_gn_add.format(env), fused_gn_add);
+    rewriter_silu_add.runOnGraph(graph, add_filter);
+    rewriter_gelu_add.runOnGraph(graph, gelu_add_filter);
+    rewriter_add.runOnGraph(graph, add_filter);
+  }
+
+  SubgraphRewriter rewriter_silu, rewriter_gelu;
+  rewriter_silu.RegisterRewritePattern(aten_gn_silu, fused_gn_silu);
+  rewriter_gelu.RegisterRewritePattern(aten_gn_gelu, fused_gn_gelu);
+  rewriter_silu.runOnGraph(graph);
+  rewriter_gelu.runOnGraph(graph, utils::aten_gelu_approximate_is_supported);
+}
+
 void FuseMatmulDivOrMul(std::shared_ptr<Graph>& graph) {
   const std::string div_str = R"(div)";
   const std::string div_inplace_str = R"(div_)";
@@ -766,8 +873,13 @@ void replaceInteractionWithQInteraction(std::shared_ptr<Graph>& graph) {
   }
 }
 
-void replaceMergedEmbCatWithQmergedEmbCat(std::shared_ptr<Graph>& graph) {
-  // graph->print(std::cout);
+// Replaces the fp32 op of a merged embedding bag whose weights are
+// dequantized and whose output is quantized with its int8 op, which takes the
+// same inputs followed by the output scale, zero point and dtype.
+static void replaceMergedEmbWithQmergedEmb(
+    std::shared_ptr<Graph>& graph,
+    const std::string& op,
+    const std::string& qop) {
   std::vector<std::string> patterns;
   std::vector<std::string> replacements;
   std::string graph_common_head = R"(graph()";
@@ -778,13 +890,14 @@ void replaceMergedEmbCatWithQmergedEmbCat(std::shared_ptr<Graph>& graph) {
       R"(%weights : Tensor[] = prim::ListConstruct()";
   std::string list_construct_common_tail = R"() )";
   std::string replacement_common_tail =
-      R"(%out = ipex::qmerged_embeddingbag_cat(%weights, %indices,  %offsets, %qdense, %o_scale, %o_zp, %o_dtype) return (%out) )";
+      R"(%out = )" + qop +
+      R"((%weights, %indices,  %offsets, %qdense, %o_scale, %o_zp, %o_dtype) return (%out) )";
   std::string pattern_common_tail =
-      R"(%dense=aten::dequantize(%qdense)  %out = torch_ipex::merged_embeddingbag_cat_forward(%weights, %indices, %offsets, %dense)  %qout = aten::quantize_per_tensor(%out, %o_scale, %o_zp, %o_dtype) return (%qout) )";
+      R"(%dense=aten::dequantize(%qdense)  %out = )" + op +
+      R"((%weights, %indices, %offsets, %dense)  %qout = aten::quantize_per_tensor(%out, %o_scale, %o_zp, %o_dtype) return (%qout) )";
 
   for (auto* n : graph->block()->nodes()) {
-    if (n->kind() ==
-        Symbol::fromQualString("torch_ipex::merged_embeddingbag_cat_forward")) {
+    if (n->kind() == Symbol::fromQualString(op)) {
       size_t id = 0;
       auto weightslist = n->input(0)->node();
 
@@ -838,6 +951,21 @@ void replaceMergedEmbCatWithQmergedEmbCat(std::shared_ptr<Graph>& graph) {
   }
 }
 
+void replaceMergedEmbCatWithQmergedEmbCat(std::shared_ptr<Graph>& graph) {
+  replaceMergedEmbWithQmergedEmb(
+      graph,
+      "torch_ipex::merged_embeddingbag_cat_forward",
+      "ipex::qmerged_embeddingbag_cat");
+}
+
+void replaceMergedEmbInteractionWithQmergedEmbInteraction(
+    std::shared_ptr<Graph>& graph) {
+  replaceMergedEmbWithQmergedEmb(
+      graph,
+      "torch_ipex::merged_embeddingbag_interaction_forward",
+      "ipex::qmerged_embeddingbag_interaction");
+}
+
 // When converting LSTM to int8 LSTM, IPEX will pre-hook the LSTM forward
 // function to insert quant and dequant node. After converting the model, when
 // entering the forward function, if the hidden state and cell state are empty,
@@ -37,6 +37,8 @@ void replaceInteractionWithQInteraction(
     std::shared_ptr<torch::jit::Graph>& graph);
 void replaceMergedEmbCatWithQmergedEmbCat(
     std::shared_ptr<torch::jit::Graph>& graph);
+void replaceMergedEmbInteractionWithQmergedEmbInteraction(
+    std::shared_ptr<torch::jit::Graph>& graph);
 void preprocessSizeForQLstm(std::shared_ptr<torch::jit::Graph>& graph);
 void replaceLstmWithQLstm(std::shared_ptr<torch::jit::Graph>& graph);
 void replaceAddWithQAdd(std::shared_ptr<torch::jit::Graph>& graph);
@@ -65,6 +67,7 @@ void fuseLinearMulAdd(std::shared_ptr<torch::jit::Graph>& graph);
 
 void FuseRMSNorm(std::shared_ptr<torch::jit::Graph>& graph);
 void FuseAddLayerNorm(std::shared_ptr<torch::jit::Graph>& graph);
+void FuseGroupNormAct(std::shared_ptr<torch::jit::Graph>& graph);
 void FuseMatmulDivOrMul(std::shared_ptr<torch::jit::Graph>& graph);
 void FuseConcatBnRelu(std::shared_ptr<torch::jit::Graph>& graph);
 
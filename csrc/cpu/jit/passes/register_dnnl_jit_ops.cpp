@@ -5,6 +5,7 @@
 
 #include "aten/AddLayerNorm.h"
 #include "aten/ConcatBnRelu.h"
+#include "aten/GroupNorm.h"
 #include "aten/MergedEmbCat.h"
 #include "aten/RMSNorm.h"
 #include "cpu/kernels/ConvPacked.h"
@@ -1399,6 +1400,27 @@ torch::jit::RegisterOperators op({
         },
         aliasAnalysisFromSchema()),
 
+    Operator(
+        "ipex::qmerged_embeddingbag_interaction(Tensor[] weights, "
+        "Tensor[] index, Tensor[] offsets, Tensor qdense, float o_scale, "
+        "int o_zp, ScalarType o_dtype) -> Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = dil_qmerged_embeddingbag_interaction(
+                (std::move(peek(stack, 0, 7))).toTensorVector(),
+                (std::move(peek(stack, 1, 7))).toTensorVector(),
+                (std::move(peek(stack, 2, 7))).toTensorVector(),
+                (std::move(peek(stack, 3, 7))).toTensor(),
+                (std::move(peek(stack, 4, 7))).toDouble(),
+                (std::move(peek(stack, 5, 7))).toInt(),
+                (std::move(peek(stack, 6, 7))).toScalarType());
+            drop(stack, 7);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
+
     Operator(
         "ipex::quantized_lstm(Tensor quantized_input, Tensor[] hx, Tensor [] quantized_weights, bool has_biases, int num_layers, float dropout_p, bool train, bool bidirectional, bool batch_first, float scale, int zp, int dtype) -> (Tensor, Tensor, Tensor)",
         [](const Node* node) -> Operation {
@@ -1482,6 +1504,27 @@ torch::jit::RegisterOperators op({
           };
         },
         aliasAnalysisFromSchema()),
+    Operator(
+        "ipex::group_norm_act(Tensor input, int num_groups, Tensor? weight, "
+        "Tensor? bias, float eps, str act, str approximate, Tensor? other) -> "
+        "Tensor",
+        [](const Node* node) -> Operation {
+          return [](Stack* stack) {
+            auto result = group_norm_act(
+                (std::move(peek(stack, 0, 8))).toTensor(),
+                (std::move(peek(stack, 1, 8))).toInt(),
+                toOptionalTensor(std::move(peek(stack, 2, 8))),
+                toOptionalTensor(std::move(peek(stack, 3, 8))),
+                (std::move(peek(stack, 4, 8))).toDouble(),
+                (std::move(peek(stack, 5, 8))).toStringView(),
+                (std::move(peek(stack, 6, 8))).toStringView(),
+                toOptionalTensor(std::move(peek(stack, 7, 8))));
+            drop(stack, 8);
+            torch::jit::pack(stack, std::move(result));
+            return 0;
+          };
+        },
+        aliasAnalysisFromSchema()),
     Operator(
         "ipex::concat_bn_relu(Tensor[] a, Tensor bn_scale, Tensor bn_beta, "
         "Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled, int dim) -> "
@@ -26,6 +26,11 @@ const std::map<std::string, PostOp>& supported_unary_post_op_fusion_set();
 const std::map<std::string, NonUnaryPostOp>&
 supported_non_unary_post_op_fusion_set();
 
+// Check if the approximate of the matched aten::gelu is supported by IPEX
+bool aten_gelu_approximate_is_supported(
+    const torch::jit::Match& match,
+    const std::unordered_map<std::string, torch::jit::Value*>& vmap);
+
 // Check if the memory format of the tensor is ChannelsLast(3d)
 bool is_channelslast(c10::TensorType tensor);
 // Check if the memory format of the tensor is Contiguous
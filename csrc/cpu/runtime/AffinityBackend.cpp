@@ -0,0 +1,185 @@
+#include "AffinityBackend.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace torch_ipex {
+namespace runtime {
+
+namespace {
+// IOMP symbol
+kmp_create_affinity_mask_p kmp_create_affinity_mask_ext;
+kmp_set_affinity_mask_proc_p kmp_set_affinity_mask_proc_ext;
+kmp_set_affinity_p kmp_set_affinity_ext;
+kmp_destroy_affinity_mask_p kmp_destroy_affinity_mask_ext;
+kmp_get_affinity_p kmp_get_affinity_ext;
+kmp_get_affinity_max_proc_p kmp_get_affinity_max_proc_ext;
+
+// IOMP symbol loading control flag
+std::once_flag
+    iomp_symbol_loading_call_once_flag; // call_once_flag to ensure the iomp
+                                        // symbol loaded once globally
+std::atomic<bool> iomp_symbol_loaded{false};
+
+void* open_iomp_library() {
+  void* handle = NULL;
+#ifdef _WIN32
+  // ToDo: need confirm search path:
+  return NULL;
+
+  handle =
+      LoadLibraryExA("libiomp5md.dll", NULL, LOAD_LIBRARY_SEARCH_DLL_LOAD_DIR);
+#else
+  handle = dlopen(NULL, RTLD_NOW | RTLD_GLOBAL);
+#endif
+  return handle;
+}
+
+void* get_func_from_library(void* handle, const char* name) {
+#ifdef _WIN32
+  return GetProcAddress((HMODULE)handle, name);
+#else
+  return dlsym(handle, name);
+#endif
+}
+
+void loading_iomp_symbol() {
+  void* handle = open_iomp_library();
+  if (handle == NULL ||
+      get_func_from_library(handle, "kmp_create_affinity_mask") == NULL ||
+      get_func_from_library(handle, "kmp_set_affinity_mask_proc") == NULL ||
+      get_func_from_library(handle, "kmp_set_affinity") == NULL ||
+      get_func_from_library(handle, "kmp_get_affinity") == NULL ||
+      get_func_from_library(handle, "kmp_destroy_affinity_mask") == NULL ||
+      get_func_from_library(handle, "kmp_get_affinity_max_proc") == NULL) {
+    iomp_symbol_loaded = false;
+    return;
+  }
+
+  kmp_create_affinity_mask_ext =
+      (kmp_create_affinity_mask_p)get_func_from_library(
+          handle, "kmp_create_affinity_mask");
+  kmp_set_affinity_mask_proc_ext =
+      (kmp_set_affinity_mask_proc_p)get_func_from_library(
+          handle, "kmp_set_affinity_mask_proc");
+  kmp_set_affinity_ext =
+      (kmp_set_affinity_p)get_func_from_library(handle, "kmp_set_affinity");
+  kmp_get_affinity_ext =
+      (kmp_get_affinity_p)get_func_from_library(handle, "kmp_get_affinity");
+  kmp_destroy_affinity_mask_ext =
+      (kmp_destroy_affinity_mask_p)get_func_from_library(
+          handle, "kmp_destroy_affinity_mask");
+  kmp_get_affinity_max_proc_ext =
+      (kmp_get_affinity_max_proc_p)get_func_from_library(
+          handle, "kmp_get_affinity_max_proc");
+
+  iomp_symbol_loaded = true;
+  return;
+}
+
+// Forwards to the kmp_* API of the preloaded Intel OpenMP library.
+class IompAffinityBackend : public AffinityBackend {
+ public:
+  const char* name() const override {
+    return "iomp";
+  }
+  void create_mask(kmp_affinity_mask_t* mask) override {
+    kmp_create_affinity_mask_ext(mask);
+  }
+  int set_mask_proc(int proc, kmp_affinity_mask_t* mask) override {
+    return kmp_set_affinity_mask_proc_ext(proc, mask);
+  }
+  int set_affinity(kmp_affinity_mask_t* mask) override {
+    return kmp_set_affinity_ext(mask);
+  }
+  int get_affinity(kmp_affinity_mask_t* mask) override {
+    return kmp_get_affinity_ext(mask);
+  }
+  void destroy_mask(kmp_affinity_mask_t* mask) override {
+    kmp_destroy_affinity_mask_ext(mask);
+  }
+  int get_max_proc() override {
+    return kmp_get_affinity_max_proc_ext();
+  }
+};
+
+#ifndef _WIN32
+// Binds the calling thread with pthread_setaffinity_np. The masks are
+// dynamically sized cpu_set_t, so machines with more than CPU_SETSIZE
+// processors are supported. Unlike the kmp_* API, the binding is not known
+// by the OpenMP runtime, it relies on the runtime keeping the same worker
+// threads for the parallel regions of the same team size, which libgomp and
+// libiomp both do.
+class NativeAffinityBackend : public AffinityBackend {
+ public:
+  NativeAffinityBackend()
+      : max_proc_(sysconf(_SC_NPROCESSORS_CONF)),
+        set_size_(CPU_ALLOC_SIZE(max_proc_)) {}
+
+  const char* name() const override {
+    return "native";
+  }
+  void create_mask(kmp_affinity_mask_t* mask) override {
+    cpu_set_t* set = CPU_ALLOC(max_proc_);
+    CPU_ZERO_S(set_size_, set);
+    *mask = set;
+  }
+  int set_mask_proc(int proc, kmp_affinity_mask_t* mask) override {
+    if (proc < 0 || proc >= max_proc_) {
+      return -1;
+    }
+    CPU_SET_S(proc, set_size_, (cpu_set_t*)*mask);
+    return 0;
+  }
+  int set_affinity(kmp_affinity_mask_t* mask) override {
+    return pthread_setaffinity_np(
+        pthread_self(), set_size_, (cpu_set_t*)*mask);
+  }
+  int get_affinity(kmp_affinity_mask_t* mask) override {
+    return pthread_getaffinity_np(
+        pthread_self(), set_size_, (cpu_set_t*)*mask);
+  }
+  void destroy_mask(kmp_affinity_mask_t* mask) override {
+    CPU_FREE((cpu_set_t*)*mask);
+    *mask = nullptr;
+  }
+  int get_max_proc() override {
+    return max_proc_;
+  }
+
+ private:
+  int max_proc_;
+  size_t set_size_;
+};
+#endif
+} // namespace
+
+bool do_load_iomp_symbol() {
+  // If invoking std::call_once concurrently, only one thread will invoke the
+  // function as active execution. The other threads as passive execution will
+  // not return until the finish of active execution.
+  std::call_once(iomp_symbol_loading_call_once_flag, loading_iomp_symbol);
+  return iomp_symbol_loaded;
+}
+
+AffinityBackend* get_affinity_backend() {
+  if (do_load_iomp_symbol()) {
+    static IompAffinityBackend iomp_backend;
+    return &iomp_backend;
+  }
+#ifdef _WIN32
+  return nullptr;
+#else
+  static NativeAffinityBackend native_backend;
+  return &native_backend;
+#endif
+}
+
+} // namespace runtime
+} // namespace torch_ipex
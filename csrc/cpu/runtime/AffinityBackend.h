@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CPUPool.h"
+
+namespace torch_ipex {
+namespace runtime {
+
+// Thread affinity primitives used by the runtime API. The masks are opaque
+// handles created and destroyed by the backend that created them. All the
+// setters and getters apply to the calling thread, so the runtime calls them
+// from every thread of an OpenMP parallel region.
+class AffinityBackend {
+ public:
+  virtual ~AffinityBackend() = default;
+  virtual const char* name() const = 0;
+  virtual void create_mask(kmp_affinity_mask_t* mask) = 0;
+  // Returns 0 on success.
+  virtual int set_mask_proc(int proc, kmp_affinity_mask_t* mask) = 0;
+  virtual int set_affinity(kmp_affinity_mask_t* mask) = 0;
+  virtual int get_affinity(kmp_affinity_mask_t* mask) = 0;
+  virtual void destroy_mask(kmp_affinity_mask_t* mask) = 0;
+  virtual int get_max_proc() = 0;
+};
+
+// Returns the backend of the kmp_* affinity API if the Intel OpenMP library
+// is preloaded, otherwise the backend binding the OpenMP workers with
+// pthread_setaffinity_np, which works with any OpenMP runtime. Returns
+// nullptr if none of them is available on the platform.
+AffinityBackend* get_affinity_backend();
+
+} // namespace runtime
+} // namespace torch_ipex
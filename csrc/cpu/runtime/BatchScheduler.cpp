@@ -0,0 +1,273 @@
+#include "BatchScheduler.h"
+
+#include <ATen/ATen.h>
+#include <cmath>
+#include <numeric>
+
+namespace torch_ipex {
+namespace runtime {
+
+namespace {
+
+uint64_t elapsed_us(
+    std::chrono::steady_clock::time_point begin,
+    std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - begin)
+      .count();
+}
+
+// Splits an output batched on dim 0 into the outputs of the requests.
+std::vector<c10::IValue> split_output(
+    const c10::IValue& output,
+    const std::vector<int64_t>& sizes) {
+  std::vector<c10::IValue> results;
+  if (output.isTensor()) {
+    for (auto& part : output.toTensor().split_with_sizes(sizes, 0)) {
+      results.emplace_back(part);
+    }
+  } else if (output.isTuple()) {
+    auto elements = output.toTupleRef().elements();
+    std::vector<std::vector<c10::IValue>> parts(sizes.size());
+    for (auto& element : elements) {
+      auto split = split_output(element, sizes);
+      for (size_t i = 0; i < sizes.size(); i++) {
+        parts[i].emplace_back(std::move(split[i]));
+      }
+    }
+    for (auto& part : parts) {
+      results.emplace_back(c10::ivalue::Tuple::create(std::move(part)));
+    }
+  } else if (output.isTensorList()) {
+    std::vector<c10::List<at::Tensor>> parts(sizes.size());
+    for (const at::Tensor& element : output.toTensorVector()) {
+      auto split = element.split_with_sizes(sizes, 0);
+      for (size_t i = 0; i < sizes.size(); i++) {
+        parts[i].push_back(split[i]);
+      }
+    }
+    for (auto& part : parts) {
+      results.emplace_back(std::move(part));
+    }
+  } else {
+    TORCH_CHECK(
+        false,
+        "BatchScheduler: the output must be a tensor, or a tuple or list of tensors, got ",
+        output.tagKind());
+  }
+  return results;
+}
+
+} // namespace
+
+void Histogram::record(uint64_t value) {
+  int bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+  bucket = std::min(bucket, kNumBuckets - 1);
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::snapshot() const {
+  std::vector<uint64_t> result(kNumBuckets);
+  for (int i = 0; i < kNumBuckets; i++) {
+    result[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+uint64_t Histogram::count() const {
+  auto buckets = snapshot();
+  return std::accumulate(buckets.begin(), buckets.end(), (uint64_t)0);
+}
+
+uint64_t Histogram::quantile(double q) const {
+  auto buckets = snapshot();
+  uint64_t total = std::accumulate(buckets.begin(), buckets.end(), (uint64_t)0);
+  if (total == 0) {
+    return 0;
+  }
+  uint64_t rank = std::max<uint64_t>(1, std::ceil(q * total));
+  uint64_t seen = 0;
+  for (int i = 0; i < kNumBuckets; i++) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return i == 0 ? 0 : (uint64_t(1) << i);
+    }
+  }
+  return uint64_t(1) << (kNumBuckets - 1);
+}
+
+BatchScheduler::BatchScheduler(
+    const torch::jit::Module& module,
+    const std::vector<std::shared_ptr<CPUPool>>& cpu_pools,
+    int64_t max_batch_size,
+    int64_t max_delay_us,
+    int64_t queue_capacity)
+    : module_(module),
+      cpu_pools_(cpu_pools),
+      max_batch_size_(max_batch_size),
+      max_delay_(max_delay_us),
+      grad_mode_(at::GradMode::is_enabled()),
+      queue_(queue_capacity) {
+  TORCH_CHECK(!cpu_pools.empty(), "BatchScheduler: expect at least 1 stream");
+  TORCH_CHECK(
+      max_batch_size > 0 && max_delay_us >= 0 && queue_capacity > 0,
+      "BatchScheduler: bad max_batch_size, max_delay_us or queue_capacity");
+  // Notice: We shouldn't load iomp symbol in sub_thread, otherwise race
+  // condition happens.
+  if (!is_runtime_ext_enabled()) {
+    throw std::runtime_error(
+        "Fail to init BatchScheduler. No thread affinity backend "
+        "is available for the runtime API.");
+  }
+  for (auto& cpu_pool : cpu_pools_) {
+    auto executor = std::make_shared<TaskExecutor>(*cpu_pool);
+    auto task = std::make_shared<std::packaged_task<void()>>([this]() {
+      at::GradMode::set_enabled(this->grad_mode_);
+      this->stream_loop();
+    });
+    stream_done_.emplace_back(task->get_future());
+    {
+      std::unique_lock<std::mutex> lock(executor->get_mutex());
+      executor->get_tasks().emplace([task]() { (*task)(); });
+    }
+    executor->get_condition().notify_one();
+    executors_.emplace_back(std::move(executor));
+  }
+}
+
+BatchScheduler::~BatchScheduler() {
+  this->stop();
+}
+
+std::future<c10::IValue> BatchScheduler::submit(
+    std::vector<c10::IValue>&& inputs) {
+  TORCH_CHECK(!inputs.empty(), "BatchScheduler: expect at least 1 input");
+  int64_t batch_size = -1;
+  for (auto& input : inputs) {
+    TORCH_CHECK(
+        input.isTensor() && input.toTensor().dim() > 0,
+        "BatchScheduler: the inputs must be tensors batched on dim 0");
+    int64_t size = input.toTensor().size(0);
+    TORCH_CHECK(
+        batch_size < 0 || size == batch_size,
+        "BatchScheduler: the inputs of a request must have the same batch size");
+    batch_size = size;
+  }
+
+  Request request;
+  request.inputs = std::move(inputs);
+  request.batch_size = batch_size;
+  request.enqueue_time = std::chrono::steady_clock::now();
+  auto future = request.promise.get_future();
+  if (stopped_ || !queue_.push(std::move(request))) {
+    throw std::runtime_error("BatchScheduler: submit on stopped scheduler");
+  }
+  num_requests_.fetch_add(1, std::memory_order_relaxed);
+  return future;
+}
+
+void BatchScheduler::stream_loop() {
+  while (true) {
+    std::vector<Request> batch;
+    {
+      std::lock_guard<std::mutex> lock(collect_mutex_);
+      Request first;
+      if (!queue_.pop(first)) {
+        // Stopped and drained.
+        return;
+      }
+      int64_t total = first.batch_size;
+      // The delay counts from the submission of the first request, so a
+      // backlog forms full batches without waiting.
+      auto deadline = first.enqueue_time + max_delay_;
+      batch.emplace_back(std::move(first));
+      std::function<bool(const Request&)> fits =
+          [this, &total](const Request& request) {
+            return total + request.batch_size <= this->max_batch_size_;
+          };
+      Request next;
+      while (total < max_batch_size_ &&
+             queue_.pop_until(next, deadline, fits)) {
+        total += next.batch_size;
+        batch.emplace_back(std::move(next));
+      }
+      queue_depth_.record(queue_.size());
+      batch_size_.record(total);
+    }
+    num_batches_.fetch_add(1, std::memory_order_relaxed);
+    run_batch(batch);
+  }
+}
+
+void BatchScheduler::run_batch(std::vector<Request>& batch) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<int64_t> sizes;
+  for (auto& request : batch) {
+    queue_delay_us_.record(elapsed_us(request.enqueue_time, start));
+    sizes.push_back(request.batch_size);
+  }
+
+  std::vector<c10::IValue> results;
+  try {
+    std::vector<c10::IValue> stack;
+    if (batch.size() == 1) {
+      stack = batch[0].inputs;
+    } else {
+      size_t num_inputs = batch[0].inputs.size();
+      for (size_t i = 0; i < num_inputs; i++) {
+        std::vector<at::Tensor> parts;
+        for (auto& request : batch) {
+          TORCH_CHECK(
+              request.inputs.size() == num_inputs,
+              "BatchScheduler: the requests of a batch must have the same number of inputs");
+          parts.push_back(request.inputs[i].toTensor());
+        }
+        stack.emplace_back(at::cat(parts, 0));
+      }
+    }
+    auto output = module_.forward(std::move(stack));
+    if (batch.size() == 1) {
+      results.emplace_back(std::move(output));
+    } else {
+      results = split_output(output, sizes);
+    }
+  } catch (...) {
+    auto error = std::current_exception();
+    for (auto& request : batch) {
+      request.promise.set_exception(error);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    batch[i].promise.set_value(std::move(results[i]));
+    latency_us_.record(
+        elapsed_us(batch[i].enqueue_time, std::chrono::steady_clock::now()));
+  }
+}
+
+BatchSchedulerStats BatchScheduler::stats() const {
+  BatchSchedulerStats stats;
+  stats.num_requests = num_requests_.load();
+  stats.num_batches = num_batches_.load();
+  stats.queue_depth = queue_depth_.snapshot();
+  stats.latency_us = latency_us_.snapshot();
+  stats.queue_delay_us = queue_delay_us_.snapshot();
+  stats.batch_size = batch_size_.snapshot();
+  return stats;
+}
+
+void BatchScheduler::stop() {
+  if (stopped_.exchange(true)) {
+    return;
+  }
+  queue_.close();
+  for (auto& done : stream_done_) {
+    done.wait();
+  }
+  for (auto& executor : executors_) {
+    executor->stop_executor();
+  }
+}
+
+} // namespace runtime
+} // namespace torch_ipex
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <ATen/core/ivalue.h>
+#include <Macros.h>
+#include <torch/csrc/jit/api/module.h>
+#include "CPUPool.h"
+#include "TaskExecutor.h"
+
+namespace torch_ipex {
+namespace runtime {
+
+/*BoundedQueue is a blocking multi-producer multi-consumer queue*/
+template <class T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity) {}
+
+  // Blocks while the queue is full. Returns false if the queue is closed.
+  bool push(T&& item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_full_.wait(
+          lock, [this] { return closed_ || items_.size() < capacity_; });
+      if (closed_) {
+        return false;
+      }
+      items_.emplace_back(std::move(item));
+    }
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Blocks until an item is available or the deadline is reached. Returns
+  // false on timeout, if the queue is closed and drained, or if the first
+  // item is rejected by fits, in which case it stays in the queue.
+  template <class Clock, class Duration>
+  bool pop_until(
+      T& item,
+      const std::chrono::time_point<Clock, Duration>& deadline,
+      const std::function<bool(const T&)>& fits = nullptr) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (!not_empty_.wait_until(
+              lock, deadline, [this] { return closed_ || !items_.empty(); }) ||
+          items_.empty() || (fits && !fits(items_.front()))) {
+        return false;
+      }
+      item = std::move(items_.front());
+      items_.pop_front();
+    }
+    not_full_.notify_one();
+    return true;
+  }
+
+  // Blocks until an item is available. Returns false if the queue is closed
+  // and drained.
+  bool pop(T& item) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+      if (items_.empty()) {
+        return false;
+      }
+      item = std::move(items_.front());
+      items_.pop_front();
+    }
+    not_full_.notify_one();
+    return true;
+  }
+
+  void close() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+  size_t size() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return items_.size();
+  }
+
+ private:
+  size_t capacity_;
+  bool closed_{false};
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+/*Histogram with power of 2 buckets: bucket i counts values in [2^(i-1), 2^i),
+ * bucket 0 counts 0*/
+class IPEX_API Histogram {
+ public:
+  static constexpr int kNumBuckets = 40;
+  void record(uint64_t value);
+  std::vector<uint64_t> snapshot() const;
+  // Upper bound of the bucket holding the given quantile in [0, 1].
+  uint64_t quantile(double q) const;
+  uint64_t count() const;
+
+ private:
+  std::atomic<uint64_t> buckets_[kNumBuckets] = {};
+};
+
+struct BatchSchedulerStats {
+  uint64_t num_requests;
+  uint64_t num_batches;
+  // Requests waiting in the queue, sampled when a batch is formed.
+  std::vector<uint64_t> queue_depth;
+  // Time in microseconds from submit to the result being ready.
+  std::vector<uint64_t> latency_us;
+  // Time in microseconds from submit to the batch being started.
+  std::vector<uint64_t> queue_delay_us;
+  std::vector<uint64_t> batch_size;
+};
+
+/*BatchScheduler coalesces the requests submitted to a script module into
+ * batches run on several streams, each stream being a CPUPool with its own
+ * TaskExecutor*/
+class IPEX_API BatchScheduler {
+ public:
+  /**
+   * @param module script module taking tensors batched on dim 0 and
+   * returning a tensor, or a tuple or list of tensors batched on dim 0.
+   * @param cpu_pools one CPUPool per stream.
+   * @param max_batch_size max sum of the dim 0 sizes of the requests of a
+   * batch. A larger request forms a batch on its own.
+   * @param max_delay_us max time the first request of a batch waits for more
+   * requests.
+   * @param queue_capacity max number of pending requests, submit blocks
+   * while the queue is full.
+   */
+  BatchScheduler(
+      const torch::jit::Module& module,
+      const std::vector<std::shared_ptr<CPUPool>>& cpu_pools,
+      int64_t max_batch_size,
+      int64_t max_delay_us,
+      int64_t queue_capacity);
+  BatchScheduler(const BatchScheduler& scheduler) = delete;
+  BatchScheduler(BatchScheduler&& scheduler) = delete;
+  BatchScheduler& operator=(const BatchScheduler& scheduler) = delete;
+  BatchScheduler& operator=(BatchScheduler&& scheduler) = delete;
+  ~BatchScheduler();
+
+  std::future<c10::IValue> submit(std::vector<c10::IValue>&& inputs);
+  BatchSchedulerStats stats() const;
+  // Stops accepting requests, finishes the pending ones and joins the
+  // streams.
+  void stop();
+
+ private:
+  struct Request {
+    std::vector<c10::IValue> inputs;
+    int64_t batch_size;
+    std::chrono::steady_clock::time_point enqueue_time;
+    std::promise<c10::IValue> promise;
+  };
+
+  void stream_loop();
+  void run_batch(std::vector<Request>& batch);
+
+  torch::jit::Module module_;
+  // TaskExecutor only keeps a reference of its CPUPool.
+  std::vector<std::shared_ptr<CPUPool>> cpu_pools_;
+  int64_t max_batch_size_;
+  std::chrono::microseconds max_delay_;
+  bool grad_mode_;
+  BoundedQueue<Request> queue_;
+  // Only one idle stream collects a batch at a time, so that a burst of
+  // requests fills one batch instead of being spread over all the streams.
+  std::mutex collect_mutex_;
+  std::vector<std::shared_ptr<TaskExecutor>> executors_;
+  std::vector<std::future<void>> stream_done_;
+  std::atomic<bool> stopped_{false};
+
+  std::atomic<uint64_t> num_requests_{0};
+  std::atomic<uint64_t> num_batches_{0};
+  Histogram queue_depth_;
+  Histogram latency_us_;
+  Histogram queue_delay_us_;
+  Histogram batch_size_;
+};
+
+} // namespace runtime
+} // namespace torch_ipex
@@ -1,9 +1,9 @@
 #include "CPUPool.h"
+#include "AffinityBackend.h"
 
 #ifdef _WIN32
 #include <Windows.h>
 #else
-#include <dlfcn.h>
 #include <unistd.h>
 #endif
 
@@ -13,82 +13,12 @@ namespace runtime {
 std::vector<int32_t> available_cpu_cores = init_process_available_cores();
 
 namespace {
-// IOMP symbol
-kmp_create_affinity_mask_p kmp_create_affinity_mask_ext;
-kmp_set_affinity_mask_proc_p kmp_set_affinity_mask_proc_ext;
-kmp_set_affinity_p kmp_set_affinity_ext;
-kmp_destroy_affinity_mask_p kmp_destroy_affinity_mask_ext;
-kmp_get_affinity_p kmp_get_affinity_ext;
-kmp_get_affinity_max_proc_p kmp_get_affinity_max_proc_ext;
-
-// IOMP symbol loading control flag
-std::once_flag
-    iomp_symbol_loading_call_once_flag; // call_once_flag to ensure the iomp
-                                        // symbol loaded once globally
-std::atomic<bool> iomp_symbol_loaded{false};
-
 // current_cpu_core_list is only used to cache the cpu_core_list setting
 // of _pin_cpu_cores. It's thread_local, so different task thread can have
 // different settings to support task API.
 thread_local std::vector<int32_t> current_cpu_core_list{-1};
 } // namespace
 
-void* open_iomp_library() {
-  void* handle = NULL;
-#ifdef _WIN32
-  // ToDo: need confirm search path:
-  return NULL;
-
-  handle =
-      LoadLibraryExA("libiomp5md.dll", NULL, LOAD_LIBRARY_SEARCH_DLL_LOAD_DIR);
-#else
-  handle = dlopen(NULL, RTLD_NOW | RTLD_GLOBAL);
-#endif
-  return handle;
-}
-
-void* get_func_from_library(void* handle, const char* name) {
-#ifdef _WIN32
-  return GetProcAddress((HMODULE)handle, name);
-#else
-  return dlsym(handle, name);
-#endif
-}
-
-void loading_iomp_symbol() {
-  void* handle = open_iomp_library();
-  if (handle == NULL ||
-      get_func_from_library(handle, "kmp_create_affinity_mask") == NULL ||
-      get_func_from_library(handle, "kmp_set_affinity_mask_proc") == NULL ||
-      get_func_from_library(handle, "kmp_set_affinity") == NULL ||
-      get_func_from_library(handle, "kmp_get_affinity") == NULL ||
-      get_func_from_library(handle, "kmp_destroy_affinity_mask") == NULL ||
-      get_func_from_library(handle, "kmp_get_affinity_max_proc") == NULL) {
-    iomp_symbol_loaded = false;
-    return;
-  }
-
-  kmp_create_affinity_mask_ext =
-      (kmp_create_affinity_mask_p)get_func_from_library(
-          handle, "kmp_create_affinity_mask");
-  kmp_set_affinity_mask_proc_ext =
-      (kmp_set_affinity_mask_proc_p)get_func_from_library(
-          handle, "kmp_set_affinity_mask_proc");
-  kmp_set_affinity_ext =
-      (kmp_set_affinity_p)get_func_from_library(handle, "kmp_set_affinity");
-  kmp_get_affinity_ext =
-      (kmp_get_affinity_p)get_func_from_library(handle, "kmp_get_affinity");
-  kmp_destroy_affinity_mask_ext =
-      (kmp_destroy_affinity_mask_p)get_func_from_library(
-          handle, "kmp_destroy_affinity_mask");
-  kmp_get_affinity_max_proc_ext =
-      (kmp_get_affinity_max_proc_p)get_func_from_library(
-          handle, "kmp_get_affinity_max_proc");
-
-  iomp_symbol_loaded = true;
-  return;
-}
-
 std::vector<int32_t> get_process_available_cores() {
   return torch_ipex::runtime::available_cpu_cores;
 }
@@ -97,7 +27,7 @@ std::vector<int32_t> get_process_available_cores() {
 std::vector<int32_t> init_process_available_cores() {
   std::vector<int32_t> available_cpu_cores_internal;
 
-  if (is_runtime_ext_enabled()) {
+  if (do_load_iomp_symbol()) {
     // When IOMP preloaded.
     // Step1: Get the main thread affinity information:
     // 2 knowning external command may change it during process starts up:
@@ -106,22 +36,19 @@ std::vector<int32_t> init_process_available_cores() {
     // We need to save this information firstly and restore it later.
     // Since main thread affinity may be changed in step2, when to query
     // available cores.
+    AffinityBackend* backend = get_affinity_backend();
     kmp_affinity_mask_t main_thread_pre_mask;
-    kmp_create_affinity_mask_ext(&main_thread_pre_mask);
-    kmp_get_affinity_ext(&main_thread_pre_mask);
+    backend->create_mask(&main_thread_pre_mask);
+    backend->get_affinity(&main_thread_pre_mask);
 
     // Step2: Test which cores the thread has privilege to use.
-    // Step2 should work with IOMP preloaded. If not, We also need to support
-    // it. Because we need to create a default cpupool in MultiStreamModule when
-    // IPEX start up. We shouldn't break this behavior when IOMP is not
-    // preloaded. But this information makes no sense when IOMP not preloaded.
-    int nproc_online = kmp_get_affinity_max_proc_ext();
+    int nproc_online = backend->get_max_proc();
     for (int i = 0; i < nproc_online; i++) {
       kmp_affinity_mask_t mask;
-      kmp_create_affinity_mask_ext(&mask);
-      auto resutl1 = kmp_set_affinity_mask_proc_ext(i, &mask);
-      auto resutl2 = kmp_set_affinity_ext(&mask);
-      kmp_destroy_affinity_mask_ext(&mask);
+      backend->create_mask(&mask);
+      auto resutl1 = backend->set_mask_proc(i, &mask);
+      auto resutl2 = backend->set_affinity(&mask);
+      backend->destroy_mask(&mask);
       if ((resutl1 == 0) && (resutl2 == 0)) {
         // success to change main thread affinity to this core.
         // It means main thread has privilege to use this core.
@@ -131,8 +58,8 @@ std::vector<int32_t> init_process_available_cores() {
 
     // Step3: restore the main thread affinity since it will be changed in
     // step2.
-    kmp_set_affinity_ext(&main_thread_pre_mask);
-    kmp_destroy_affinity_mask_ext(&main_thread_pre_mask);
+    backend->set_affinity(&main_thread_pre_mask);
+    backend->destroy_mask(&main_thread_pre_mask);
   } else {
 #ifdef _WIN32
     int nproc_online = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
@@ -140,9 +67,8 @@ std::vector<int32_t> init_process_available_cores() {
       available_cpu_cores_internal.emplace_back(i);
     }
 #else
-    // When IOMP didn't preload, We support for IPEX init without preload IOMP.
-    // But this information makes no sense and shouldn't be used without preload
-    // IOMP.
+    // When IOMP didn't preload, the cores are the ones of the main thread
+    // affinity, which the native affinity backend is allowed to bind to.
     // Step1: Get the main thread affinity
     cpu_set_t main_thread_pre_set;
     CPU_ZERO(&main_thread_pre_set);
@@ -194,31 +120,24 @@ std::vector<int32_t> filter_cores_by_thread_affinity(
   return filter_cpu_core_list;
 }
 
-inline bool do_load_iomp_symbol() {
-  // If invoking std::call_once concurrently, only one thread will invoke the
-  // function as active execution. The other threads as passive execution will
-  // not return until the finish of active execution.
-  std::call_once(iomp_symbol_loading_call_once_flag, loading_iomp_symbol);
-  return iomp_symbol_loaded;
-}
-
 bool is_runtime_ext_enabled() {
-  return do_load_iomp_symbol();
+  return get_affinity_backend() != nullptr;
 }
 
 void init_runtime_ext() {
-  if (!do_load_iomp_symbol()) {
+  if (!is_runtime_ext_enabled()) {
     throw std::runtime_error(
-        "Didn't preload IOMP before using the runtime API");
+        "No thread affinity backend is available for the runtime API");
   }
   return;
 }
 
 void _pin_cpu_cores(const torch_ipex::runtime::CPUPool& cpu_pool) {
   const std::vector<int32_t>& cpu_core_list = cpu_pool.get_cpu_core_list();
-  if (!is_runtime_ext_enabled()) {
+  AffinityBackend* backend = get_affinity_backend();
+  if (backend == nullptr) {
     throw std::runtime_error(
-        "Didn't preload IOMP before using the runtime API");
+        "No thread affinity backend is available for the runtime API");
   }
 
   // Create the OMP thread pool and bind to cores of cpu_pools one by one
@@ -229,10 +148,10 @@ void _pin_cpu_cores(const torch_ipex::runtime::CPUPool& cpu_pool) {
     int thread_id = omp_get_thread_num();
     int phy_core_id = cpu_core_list[thread_id];
     kmp_affinity_mask_t mask;
-    kmp_create_affinity_mask_ext(&mask);
-    kmp_set_affinity_mask_proc_ext(phy_core_id, &mask);
-    kmp_set_affinity_ext(&mask);
-    kmp_destroy_affinity_mask_ext(&mask);
+    backend->create_mask(&mask);
+    backend->set_mask_proc(phy_core_id, &mask);
+    backend->set_affinity(&mask);
+    backend->destroy_mask(&mask);
   }
   // Cache the cpu_core_list for query.
   current_cpu_core_list = cpu_core_list;
@@ -244,9 +163,10 @@ bool is_same_core_affinity_setting(const std::vector<int32_t>& cpu_core_list) {
 }
 
 CPUPool get_cpu_pool_from_mask_affinity() {
-  if (!is_runtime_ext_enabled()) {
+  AffinityBackend* backend = get_affinity_backend();
+  if (backend == nullptr) {
     throw std::runtime_error(
-        "Didn't preload IOMP before using the runtime API");
+        "No thread affinity backend is available for the runtime API");
   }
   int max_number_threads = omp_get_max_threads();
   // init the vector<mask>
@@ -255,17 +175,18 @@ CPUPool get_cpu_pool_from_mask_affinity() {
   {
     int thread_id = omp_get_thread_num();
     kmp_affinity_mask_t mask;
-    kmp_create_affinity_mask_ext(&mask);
-    kmp_get_affinity_ext(&mask);
+    backend->create_mask(&mask);
+    backend->get_affinity(&mask);
     threads_mask[thread_id] = mask;
   }
   return CPUPool(std::move(threads_mask));
 }
 
 void set_mask_affinity_from_cpu_pool(const CPUPool& cpu_pool) {
-  if (!is_runtime_ext_enabled()) {
+  AffinityBackend* backend = get_affinity_backend();
+  if (backend == nullptr) {
     throw std::runtime_error(
-        "Didn't preload IOMP before using the runtime API");
+        "No thread affinity backend is available for the runtime API");
   }
   std::vector<kmp_affinity_mask_t> threads_mask =
       cpu_pool.get_cpu_affinity_mask();
@@ -275,7 +196,7 @@ void set_mask_affinity_from_cpu_pool(const CPUPool& cpu_pool) {
     // we will destory the mask inside the CPUPool deconstructor
     int thread_id = omp_get_thread_num();
     kmp_affinity_mask_t mask = threads_mask[thread_id];
-    kmp_set_affinity_ext(&mask);
+    backend->set_affinity(&mask);
   }
 }
 
@@ -289,7 +210,7 @@ CPUPool::CPUPool(std::vector<kmp_affinity_mask_t>&& cpu_core_mask) {
   // condition happens.
   if (!is_runtime_ext_enabled()) {
     throw std::runtime_error(
-        "Fail to init CPUPool. Didn't preload IOMP before using the runtime API.");
+        "Fail to init CPUPool. No thread affinity backend is available for the runtime API.");
   }
   this->cpu_affinity_mask = cpu_core_mask;
   this->cpu_affinity_mask_initialized_ = true;
@@ -341,9 +262,10 @@ CPUPool::~CPUPool() {
   if (this->cpu_affinity_mask_initialized_) {
     // If we are using the cpu_affinity_mask expression for CPUPool
     // Ensure we destory the mask in cpu_affinity_mask.
+    AffinityBackend* backend = get_affinity_backend();
     for (int i = 0; i < this->cpu_affinity_mask.size(); i++) {
       kmp_affinity_mask_t mask = this->cpu_affinity_mask[i];
-      kmp_destroy_affinity_mask_ext(&mask);
+      backend->destroy_mask(&mask);
     }
   }
 }
@@ -8,8 +8,8 @@ TaskExecutor::TaskExecutor(const torch_ipex::runtime::CPUPool& cpu_pool) {
   // condition happens.
   if (!is_runtime_ext_enabled()) {
     throw std::runtime_error(
-        "Fail to init TaskExecutor. Didn't preload IOMP "
-        "before using the runtime API.");
+        "Fail to init TaskExecutor. No thread affinity backend "
+        "is available for the runtime API.");
   }
   this->stop = false;
 
@@ -74,6 +74,7 @@ static std::vector<at::Tensor> fused_self_attention_fwd_unpad(
     std::vector<at::Tensor> inputs,
     bool training) {
   GlobalPass _gp(FWD);
+  constexpr bool flash = false;
   if (inputs[6].dtype() == at::kFloat) {
     typedef float T;
 #include "fused_self_attention_fwd_tmpl.h"
@@ -87,6 +88,39 @@ static std::vector<at::Tensor> fused_self_attention_bwd_unpad(
     double p,
     std::vector<at::Tensor> inputs) {
   GlobalPass _gp(BWD);
+  constexpr bool flash = false;
+  if (inputs[0].dtype() == at::kFloat) {
+    typedef float T;
+#include "fused_self_attention_bwd_tmpl.h"
+  } else {
+    typedef bfloat16 T;
+#include "fused_self_attention_bwd_tmpl.h"
+  }
+}
+
+// Same as fused_self_attention_fwd_unpad without materializing the attention
+// probabilities: they are folded into the context with an online softmax and
+// only the log-sum-exp of their rows is saved for the backward.
+static std::vector<at::Tensor> fused_self_attention_flash_fwd_unpad(
+    double p,
+    std::vector<at::Tensor> inputs,
+    bool training) {
+  GlobalPass _gp(FWD);
+  constexpr bool flash = true;
+  if (inputs[6].dtype() == at::kFloat) {
+    typedef float T;
+#include "fused_self_attention_fwd_tmpl.h"
+  } else {
+    typedef bfloat16 T;
+#include "fused_self_attention_fwd_tmpl.h"
+  }
+}
+
+static std::vector<at::Tensor> fused_self_attention_flash_bwd_unpad(
+    double p,
+    std::vector<at::Tensor> inputs) {
+  GlobalPass _gp(BWD);
+  constexpr bool flash = true;
   if (inputs[0].dtype() == at::kFloat) {
     typedef float T;
 #include "fused_self_attention_bwd_tmpl.h"
@@ -232,6 +266,18 @@ TORCH_LIBRARY_FRAGMENT(torch_ipex, m) {
           c10::AliasAnalysisKind::PURE_FUNCTION),
       torch_ipex::tpp::fused_self_attention_bwd_unpad);
 
+  m.def(
+      torch::schema(
+          "torch_ipex::fused_self_attention_flash_fwd_unpad(float p, Tensor[] inputs,  bool training) -> Tensor[]",
+          c10::AliasAnalysisKind::PURE_FUNCTION),
+      torch_ipex::tpp::fused_self_attention_flash_fwd_unpad);
+
+  m.def(
+      torch::schema(
+          "torch_ipex::fused_self_attention_flash_bwd_unpad(float p, Tensor[] inputs) -> Tensor[]",
+          c10::AliasAnalysisKind::PURE_FUNCTION),
+      torch_ipex::tpp::fused_self_attention_flash_bwd_unpad);
+
   m.def(
       torch::schema(
           "torch_ipex::fused_dense_dropout_layernorm_fwd_unpad(float p, float eps, Tensor[] inputs, bool training) -> Tensor[]",
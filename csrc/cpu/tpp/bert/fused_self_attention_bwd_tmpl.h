@@ -8,11 +8,29 @@ auto t_Wv = inputs[i++]; // [HS][NH]
 auto t_HS_T = inputs[i++]; // [B][S][HS]
 auto t_HM = inputs[i++]; // Optional [B][N][S][S]
 auto t_EHS_T = inputs[i++]; // [B][S][HS]
-auto t_QL_T = inputs[i++];
+// The flash attention recomputes the attention probabilities from QL, KL_TV
+// and the log-sum-exp of their rows
+at::Tensor t_QL_T, t_AP, t_APD_T; // Not for flash
+at::Tensor t_QL, t_QL_V, t_KL_TV, t_CL, t_LSE, t_AM; // For flash only
+if (flash) {
+  t_QL = inputs[i++];
+  t_QL_V = inputs[i++];
+  t_QL_T = t_AP = t_APD_T = t_QL.new_empty({0});
+} else {
+  t_QL_T = inputs[i++];
+}
 auto t_KL_V = inputs[i++];
+if (flash)
+  t_KL_TV = inputs[i++];
 auto t_VL_TV = inputs[i++];
-auto t_AP = inputs[i++];
-auto t_APD_T = inputs[i++];
+if (flash) {
+  t_CL = inputs[i++];
+  t_LSE = inputs[i++];
+  t_AM = inputs[i++]; // Optional [B][S]
+} else {
+  t_AP = inputs[i++];
+  t_APD_T = inputs[i++];
+}
 auto t_APD_mask = inputs[i++];
 auto t_offs = inputs[i++]; // [B+1]
 auto t_offs2 = inputs[i++]; // [B+1]
@@ -51,7 +69,7 @@ at::Tensor t_dEHS; // = t_QL.new_empty({S1, N, S2, H});
 
 auto t_dAPD = at::empty_like(t_AP);
 // auto t_dAPD_V = at::empty_like(t_dAPO);
-auto t_dAPD_V = t_AP.new_empty({N, SS1, S2, S2});
+auto t_dAPD_V = flash ? t_AP : t_AP.new_empty({N, SS1, S2, S2});
 
 auto null_EHS = false;
 
@@ -79,7 +97,8 @@ if (grad_wt_flag == XformTPP::XFORM_N2V_TPP) {
   t_dWq = t_dWq.view({N, N, H / 2, H, 2});
   t_dWk = t_dWk.view({N, N, H / 2, H, 2});
   t_dWv = t_dWv.view({N, N, H / 2, H, 2});
-  t_dAPD_V = t_dAPD_V.view({N, SS1, S2 / 2, S2, 2});
+  if (!flash)
+    t_dAPD_V = t_dAPD_V.view({N, SS1, S2 / 2, S2, 2});
 }
 auto t_Wq_TV = wt_tensor_for_bwd_compact(N, H, N, H, t_Wq);
 auto t_Wk_TV = wt_tensor_for_bwd_compact(N, H, N, H, t_Wk);
@@ -278,7 +297,123 @@ auto t_Wv_TV = wt_tensor_for_bwd_compact(N, H, N, H, t_Wv);
     }
   }
 #else
-  {
+  // Flash attention: the attention probabilities are recomputed one block at
+  // a time, dKL and dVL of a block of keys and dQL of all the blocks of
+  // queries of the sequence are accumulated in fp32.
+  if (flash) {
+    RECORD_SCOPE(dac_gemm, {t_QL, t_KL_TV});
+    {
+      DECL_VLA_PTR_PT(T, QL, [N][S2 * H], t_QL);
+      DECL_VLA_PTR_PT(T, QL_V, [N][S2 * H], t_QL_V);
+      DECL_VLA_PTR_PT(T, KL_TV, [N][H * S2], t_KL_TV);
+      DECL_VLA_PTR_PT(T, CL, [N][S2 * H], t_CL);
+      DECL_VLA_PTR_PT(float, LSE, [S1][S2], t_LSE);
+      DECL_VLA_PTR_PT(T, AM, [S2], t_AM);
+      auto a_gemm_tpp = SCOPEITGEMM((BrgemmExtTPP<T, float>(
+          S2, S2, H, S2 * H, H * S2, 0.0, XformTPP::XFORM_NONE_TPP, 0, 1)));
+      auto a_scale_tpp = SCOPEIT((ScaleTPP<float, float>(S2 * S2)), EW_SCL);
+      auto add_mask_tpp = SCOPEIT(AddBiasTPP<T>(S2, S2), EW_ADD);
+      auto lse_softmax_fwd_tpp =
+          SCOPEIT((LseSoftMaxFwdTPP<float, T>(S2, S2)), SOFTMAX);
+      // Applies the dropout mask of the forward
+      auto dropout_fwd_tpp = SCOPEIT(DropOutBwdTPP<T>(S2 * S2, p), DROPOUT);
+      auto a_xpose_tpp =
+          SCOPEIT(XformExtTPP<T>(S2, S2, XformTPP::XFORM_XPOSE_TPP), XPOSE);
+      auto delta_tpp = SCOPEIT((MulReduceTPP<T, T, float>(S2, H)), EW_RED);
+      auto block_softmax_bwd_tpp =
+          SCOPEIT((BlockSoftMaxBwdTPP<float, float, T>(S2, S2)), SOFTMAX);
+      auto acc_gemm_tpp = SCOPEITGEMM((BrgemmExtTPP<T, float>(
+          S2, H, S2, S2 * S2, S2 * H, 1.0, XformTPP::XFORM_NONE_TPP, 0, 1)));
+      auto acc_zero_tpp = SCOPEIT(SetZeroTPP<float>(S2 * H), EW_ZERO);
+      auto acc_convert_tpp = SCOPEIT((ConvertTPP<float, T>(S2, H)), EW_COPY);
+      // Per thread scratch of the longest sequence, for delta and dQL_acc
+      int64_t max_len = 0;
+      for (int b = 0; b < B; b++) {
+        max_len = std::max(max_len, offs[b + 1] - offs[b]);
+      }
+      int64_t scratch_size = max_len * S2 * (H + 1);
+      std::vector<float> scratch(omp_get_max_threads() * scratch_size);
+      RECORD_FUNCTION("parallel_for", std::vector<c10::IValue>());
+#pragma omp parallel for collapse(2) schedule(static, 1)
+      for (int b = 0; b < B; b++) {
+        for (int n = 0; n < N; n++) {
+          int64_t start = offs[b];
+          int64_t end = offs[b + 1];
+          int64_t len = end - start;
+          float* thread_scratch =
+              scratch.data() + omp_get_thread_num() * scratch_size;
+          // Rowsum of dCL * CL, the softmax backward term of the full rows
+          DECL_VLA_PTR(float, delta, [S2], thread_scratch);
+          DECL_VLA_PTR(float, dQL_acc, [S2][H], thread_scratch + max_len * S2);
+          for (int s11 = start; s11 < end; s11++) {
+            delta_tpp(dCL[s11][n], CL[s11][n], delta[s11 - start]);
+            acc_zero_tpp(dQL_acc[s11 - start][0]);
+          }
+          for (int s21 = start; s21 < end; s21++) {
+            int64_t ls21 = s21 - start;
+            float dKL_acc[S2][H];
+            float dVL_acc[S2][H];
+            acc_zero_tpp(dKL_acc[0]);
+            acc_zero_tpp(dVL_acc[0]);
+            for (int s11 = start, ss1 = offs2[b]; s11 < end;
+                 s11++, ss1 += len) {
+              int64_t ls11 = s11 - start;
+              float AS[S2][S2];
+              T AP_blk[S2][S2];
+              T APD_blk[S2][S2];
+              T APD_blk_T[S2][S2];
+              a_gemm_tpp(QL[s11][n], KL_TV[s21][n], AS[0], 1);
+              a_scale_tpp(AS[0], AS[0], one_by_sqrt_H);
+              if (t_AM.numel() != 0)
+                add_mask_tpp(AM[s21], AS[0]);
+              lse_softmax_fwd_tpp(AS[0], LSE[n][s11], AP_blk[0]);
+              T* APD_ptr = AP_blk[0];
+              if (p > 0) {
+                dropout_fwd_tpp(
+                    AP_blk[0], APD_blk[0], APD_mask[n][ss1 + ls21]);
+                APD_ptr = APD_blk[0];
+              }
+              // dVL += APD_T * dCL
+              a_xpose_tpp(APD_ptr, APD_blk_T[0]);
+              acc_gemm_tpp(
+                  APD_blk_T[0], dCL_V[atrans_blk(s11, n)], dVL_acc[0], 1);
+              // dAPD = dCL * VL_TV
+              float dtAPD[S2][S2];
+              T dtAPD_bf[S2][S2];
+              T dtAPD_bf_T[S2][S2];
+              ci_gemm_tpp(dCL[s11][n], VL_TV[s21][n], dtAPD[0], 1);
+              if (t_HM.numel() != 0) {
+                // FIXME: shape of head mask is not correct here yet
+                PCL_ASSERT(0, "t_HM used");
+              }
+              if (p > 0)
+                dropout_bwd_tpp(dtAPD[0], dtAPD[0], APD_mask[n][ss1 + ls21]);
+              block_softmax_bwd_tpp(
+                  dtAPD[0], dtAPD[0], AP_blk[0], delta[ls11]);
+              scale_tpp(dtAPD[0], dtAPD_bf[0], one_by_sqrt_H);
+              // dQL += dAPD * KL_V
+              acc_gemm_tpp(dtAPD_bf[0], KL_V[s21][n], dQL_acc[ls11][0], 1);
+              // dKL += dAPD_T * QL
+              a_xpose_tpp(dtAPD_bf[0], dtAPD_bf_T[0]);
+              acc_gemm_tpp(dtAPD_bf_T[0], QL_V[s11][n], dKL_acc[0], 1);
+            }
+            acc_convert_tpp(dKL_acc[0], dKL[s21][n]);
+            acc_convert_tpp(dVL_acc[0], dVL[s21][n]);
+            if (dt_bf16) {
+              cw_n2v_tpp(dKL[s21][n], dKL_V[atrans_blk(s21, n)]);
+              cw_n2v_tpp(dVL[s21][n], dVL_V[atrans_blk(s21, n)]);
+            }
+          }
+          for (int s11 = start; s11 < end; s11++) {
+            acc_convert_tpp(dQL_acc[s11 - start][0], dQL[s11][n]);
+            if (dt_bf16)
+              cw_n2v_tpp(dQL[s11][n], dQL_V[atrans_blk(s11, n)]);
+          }
+        }
+      }
+    }
+  }
+  if (!flash) {
     RECORD_SCOPE(dac_gemm, {t_APD_T, t_dCL_V});
     {
       RECORD_FUNCTION("parallel_for", std::vector<c10::IValue>());
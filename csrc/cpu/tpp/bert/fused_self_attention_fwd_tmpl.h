@@ -58,22 +58,31 @@ auto t_VL_V = t_EHS.new_empty({S1, N, S2, H});
 if (dt_bf16)
   t_VL_V = t_VL_V.view({S1, N, S2 / 2, H, 2});
 auto t_VL_TV = t_VL_V;
-auto t_AP = t_QL.new_empty({N, SS1, S2, S2});
-auto t_CL = t_AP.new_empty({S1, N, S2, H});
+// The flash attention keeps the log-sum-exp of each row of the attention
+// probabilities instead of the probabilities
+auto t_AP = flash ? t_QL.new_empty({0}) : t_QL.new_empty({N, SS1, S2, S2});
+auto t_LSE = flash ? at::empty({N, S1, S2}, at::kFloat) : at::empty({0});
+auto t_CL = t_QL.new_empty({S1, N, S2, H});
 
 auto t_APD = t_AP;
-auto t_APD_mask = at::empty({N, SS1, (S2 * S2 + 15) / 16}, at::kShort);
-if (p > 0 || t_HM.numel() != 0) {
+auto t_APD_mask = (flash && p == 0)
+    ? at::empty({0}, at::kShort)
+    : at::empty({N, SS1, (S2 * S2 + 15) / 16}, at::kShort);
+if (!flash && (p > 0 || t_HM.numel() != 0)) {
   t_APD = at::empty_like(t_AP);
 }
 
 auto t_APD_T = t_APD;
+auto t_QL_V = t_QL;
 
 if (bf16_training) {
   t_HS_T = t_HS.new_empty({N, S1, H, S2}); // For BWD only
   t_EHS_T = null_EHS ? t_HS_T : t_HS.new_empty({N, S1, H, S2}); // For BWD only
 
-  t_QL_T = t_HS.new_empty({N, S1, H, S2}); // For BWD only
+  if (flash)
+    t_QL_V = t_HS.new_empty({S1, N, S2 / 2, H, 2}); // For BWD only
+  else
+    t_QL_T = t_HS.new_empty({N, S1, H, S2}); // For BWD only
 }
 if (training) {
   if (dt_bf16) {
@@ -83,7 +92,8 @@ if (training) {
     t_KL_V = t_EHS.new_empty({S1, N, S2, H}); // Saved For BWD
     t_VL_TV = t_EHS.new_empty({S1, N, H, S2}); // For BWD only
   }
-  t_APD_T = t_QL.new_empty({N, SS1, S2, S2}); // For BWD only
+  if (!flash)
+    t_APD_T = t_QL.new_empty({N, SS1, S2, S2}); // For BWD only
 }
 
 {
@@ -180,14 +190,19 @@ if (training) {
             DECL_VLA_PTR_PT(T, Wq_V, [N][H * H], t_Wq_V);
             DECL_VLA_PTR_PT(T, QL, [N][S2 * H], t_QL);
             DECL_VLA_PTR_PT(T, QL_T, [S1][H * S2], t_QL_T); // For BWD only
+            DECL_VLA_PTR_PT(T, QL_V, [N][S2 * H], t_QL_V); // For BWD only
             if (bf16_training && nk == 0)
               xpose_tpp(BN, S2 * H, S1 * S2 * H, HS[s1][bn], HS_T[bn][s1]);
             if (bn == 0)
               copy_bias_tpp(Bq[nk], QL[s1][nk]);
             qkv_gemm_tpp(HS[s1][bn], Wq_V[nk][bn], QL[s1][nk], BN, true);
             if (bf16_training)
-              if (bn == N - BN)
-                xpose_tpp(QL[s1][nk], QL_T[nk][s1]);
+              if (bn == N - BN) {
+                if (flash)
+                  v_xpose_tpp_1(QL[s1][nk], QL_V[s1][nk]);
+                else
+                  xpose_tpp(QL[s1][nk], QL_T[nk][s1]);
+              }
           },
           [&]() { qkv_gemm_tpp.config(); },
           [&]() { qkv_gemm_tpp.release(); });
@@ -295,9 +310,77 @@ if (training) {
 #endif
     }
   }
+  // Flash attention: the scores of a block of queries are computed one block
+  // of keys at a time and folded into the context with an online softmax.
+  if (flash) {
+    RECORD_SCOPE(ac_gemm, {t_QL, t_KL_TV});
+    {
+      DECL_VLA_PTR_PT(float, LSE, [S1][S2], t_LSE);
+      auto online_softmax_fwd_tpp =
+          SCOPEIT((OnlineSoftMaxFwdTPP<float, T>(S2, S2)), SOFTMAX);
+      auto o_gemm_tpp = SCOPEITGEMM((BrgemmExtTPP<T, float>(
+          S2, H, S2, S2 * S2, S2 * H, 1.0, XformTPP::XFORM_NONE_TPP, 0, 1)));
+      auto o_scale_tpp = SCOPEIT((ScaleTPP<float, float>(H)), EW_SCL);
+      auto o_zero_tpp = SCOPEIT(SetZeroTPP<float>(S2 * H), EW_ZERO);
+      auto o_convert_tpp = SCOPEIT((ConvertTPP<float, T>(S2, H)), EW_COPY);
+      RECORD_FUNCTION("parallel_for", std::vector<c10::IValue>());
+#ifndef _WIN32 // TODO: Fix crash on ICX Windows. CMPLRLLVM-55384
+#pragma omp parallel for collapse(2) schedule(static, 1)
+#else
+#pragma omp for
+#endif
+      for (int b = 0; b < B; b++) {
+        for (int n = 0; n < N; n++) {
+          int64_t start = offs[b];
+          int64_t ss1 = offs2[b];
+          int64_t end = offs[b + 1];
+          int64_t len = end - start;
+          for (int s11 = start; s11 < end; s11++, ss1 += len) {
+            float AS[S2][S2];
+            T AP_blk[S2][S2];
+            T APD_blk[S2][S2];
+            float CL_f32[S2][H];
+            float row_max[S2], row_sum[S2], corr[S2];
+            for (int r = 0; r < S2; r++) {
+              row_max[r] = -INFINITY;
+              row_sum[r] = 0.0f;
+            }
+            o_zero_tpp(CL_f32[0]);
+            for (int s21 = start; s21 < end; s21++) {
+              int64_t ls21 = s21 - start;
+              a_gemm_tpp(QL[s11][n], KL_TV[s21][n], AS[0], 1);
+              scale_tpp(AS[0], AS[0], one_by_sqrt_H);
+              if (t_AM.numel() != 0)
+                add_mask_tpp(AM[s21], AS[0]);
+              // exp(AS - max), normalized once all the blocks are seen
+              online_softmax_fwd_tpp(AS[0], AP_blk[0], row_max, row_sum, corr);
+              T* APD_ptr = AP_blk[0];
+              if (p > 0) {
+                dropout_fwd_tpp(
+                    AP_blk[0], rng_state, APD_blk[0], APD_mask[n][ss1 + ls21]);
+                APD_ptr = APD_blk[0];
+              }
+              if (t_HM.numel() != 0) {
+                // FIXME: shape of head mask is not correct here yet
+                PCL_ASSERT(0, "t_HM used");
+              }
+              for (int r = 0; r < S2; r++)
+                o_scale_tpp(CL_f32[r], CL_f32[r], corr[r]);
+              o_gemm_tpp(APD_ptr, VL_V[s21][n], CL_f32[0], 1);
+            }
+            for (int r = 0; r < S2; r++) {
+              o_scale_tpp(CL_f32[r], CL_f32[r], 1.0 / row_sum[r]);
+              LSE[n][s11][r] = row_max[r] + logf(row_sum[r]);
+            }
+            o_convert_tpp(CL_f32[0], CL[s11][n]);
+          }
+        }
+      }
+    }
+  }
   // Take the dot product between "query" and "key" to get the raw attention
   // scores.
-  {
+  if (!flash) {
     RECORD_SCOPE(ac_gemm, {t_QL, t_KL_TV});
     {
       RECORD_FUNCTION("parallel_for", std::vector<c10::IValue>());
@@ -354,6 +437,20 @@ if (training) {
 // auto t_APO = t_APD.permute({0, 2, 1, 4, 3, 5}).contiguous().view({B, N, S,
 // S});
 auto t_APO = t_APD;
+if (flash) {
+  return std::vector<at::Tensor>(
+      {t_CL,
+       t_APO,
+       t_HS_T,
+       null_EHS ? t_EHS_orig : t_EHS_T,
+       t_QL,
+       t_QL_V,
+       t_KL_V,
+       t_KL_TV,
+       t_VL_TV,
+       t_LSE,
+       t_APD_mask});
+}
 return std::vector<at::Tensor>(
     {t_CL,
      t_APO,
@@ -11,6 +11,7 @@
 #endif
 #include <cstdint>
 #include "../../utils/isa_utils.h"
+#include "../../utils/tuning.h"
 #include "tpp/tensor_helper.h"
 #include "tpp/xsmm_functors.h"
 
@@ -22,6 +23,10 @@ static int FT_OPT_SIZE = env2int("FT_OPT_SIZE", 256);
 static int NCB_BLOCK_SIZE = env2int("NCB_BLOCK_SIZE", 64);
 static const char* GEMM_LOOP_SCHEME =
     getenv("GEMM_LOOP_SCHEME") ? getenv("GEMM_LOOP_SCHEME") : "aCB";
+// Loop schemes of the first token path tried by the autotuner. The loop over
+// the Nc blocks accumulates into the output, so it stays outermost and
+// serial.
+static const char* const GEMM_LOOP_SCHEMES[] = {"aCB", "aBC", "aCb", "aBc"};
 
 REGISTER_LOCAL_SCOPE(
     tpp_linear_krnl,
@@ -89,6 +94,75 @@ inline at::Tensor wt_tensor_for_first_token(at::Tensor& t) {
   return t_new;
 }
 
+template <typename T, typename Tout>
+inline void tpp_linear_no_bias(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt,
+    at::Tensor& t_out,
+    int b_vnni);
+
+struct TppGemmBlocking {
+  bool large_cache_opt;
+  long ncb;
+  const char* loop_scheme;
+};
+
+// Blocking of a TPP linear: whether to take the first token path, its Nc
+// block and its loop scheme. They come from the tuning database by the shape
+// of the call, are tuned on first use when autotuning, or default to
+// FT_OPT_SIZE, NCB_BLOCK_SIZE and GEMM_LOOP_SCHEME. The fused linears share
+// the blocking of the plain one.
+template <typename T>
+inline TppGemmBlocking tpp_gemm_blocking(
+    const at::Tensor& t_in,
+    const at::Tensor& t_wt) {
+  auto in_sizes = t_in.sizes();
+  auto wt_sizes = t_wt.sizes();
+  auto BS = in_sizes[0] * in_sizes[1];
+  if (!tuning::is_active()) {
+    return {BS > FT_OPT_SIZE, NCB_BLOCK_SIZE, GEMM_LOOP_SCHEME};
+  }
+  auto C = in_sizes[2];
+  auto K = wt_sizes[0] * wt_sizes[3];
+  auto Nc = wt_sizes[1];
+  // -1 stands for GEMM_LOOP_SCHEME
+  tuning::Params defaults{
+      {"large_cache_opt", BS > FT_OPT_SIZE},
+      {"ncb", NCB_BLOCK_SIZE},
+      {"loop_scheme", -1}};
+  std::vector<tuning::Params> candidates;
+  // A single block of rows has nothing to gain from the first token path
+  if (BS > 64) {
+    candidates.push_back({{"large_cache_opt", 0}});
+    for (long ncb : {16L, 32L, 64L, 128L}) {
+      for (long scheme = 0; scheme < 4; scheme++) {
+        candidates.push_back(
+            {{"large_cache_opt", 1},
+             {"ncb", std::min<long>(ncb, Nc)},
+             {"loop_scheme", scheme}});
+      }
+      if (ncb >= Nc) {
+        break;
+      }
+    }
+  }
+  auto params = tuning::tuned(
+      tuning::make_key("tpp_gemm", t_wt.scalar_type(), BS, K, C),
+      defaults,
+      candidates,
+      [&]() {
+        auto t_out = t_in.new_empty({in_sizes[0], in_sizes[1], K});
+        tpp_linear_no_bias<T, T>(
+            t_in, t_wt, t_out, std::is_same<T, float>() ? 0 : 1);
+      });
+  auto scheme = tuning::get(params, "loop_scheme", -1);
+  return {
+      tuning::get(params, "large_cache_opt", BS > FT_OPT_SIZE) != 0,
+      tuning::get(params, "ncb", NCB_BLOCK_SIZE),
+      scheme >= 0 && scheme < 4 ? GEMM_LOOP_SCHEMES[scheme]
+                                : GEMM_LOOP_SCHEME};
+}
+
 template <typename T, typename Tout = T>
 inline void tpp_linear_bias(
     const at::Tensor& t_in,
@@ -100,8 +174,9 @@ inline void tpp_linear_bias(
   auto in_sizes = t_in.sizes();
   auto wt_sizes = t_wt_.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     if (wt_sizes[3] != 100) {
       t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
       wt_sizes = t_wt_.sizes();
@@ -131,7 +206,7 @@ inline void tpp_linear_bias(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
@@ -145,7 +220,7 @@ inline void tpp_linear_bias(
 
   {
     RECORD_SCOPE(tpp_linear_krnl, {t_in, t_wt_V});
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto ogemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0L, BS, BSb}, {Nk}}, loop_scheme);
     ogemm_loop(
@@ -189,8 +264,9 @@ inline void tpp_linear_no_bias(
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
   auto wt_sizes = t_wt_.sizes();
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     if (wt_sizes[3] != 100) {
       t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
       wt_sizes = t_wt_.sizes();
@@ -215,7 +291,7 @@ inline void tpp_linear_no_bias(
   auto BSb = 64L;
   auto rem = BS % BSb;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   auto zero_tpp = SCOPEIT(SetZeroTPP<Tout>(BSb, Hk, K), EW_ZERO);
   auto zero_tpp_rem = SCOPEIT(SetZeroTPP<Tout>(rem, Hk, K), EW_ZERO);
@@ -226,7 +302,7 @@ inline void tpp_linear_no_bias(
 
   {
     RECORD_SCOPE(tpp_linear_krnl, {t_in, t_wt_V});
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto gemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     gemm_loop(
@@ -263,8 +339,9 @@ inline void tpp_linear_mul(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -290,7 +367,7 @@ inline void tpp_linear_mul(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
@@ -307,7 +384,7 @@ inline void tpp_linear_mul(
   {
     RECORD_SCOPE(tpp_linear_mul_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto ogemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0L, BS, BSb}, {Nk}}, loop_scheme);
     ogemm_loop(
@@ -360,8 +437,9 @@ inline void tpp_linear_add_add(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -388,7 +466,7 @@ inline void tpp_linear_add_add(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<T>(BSb, Hk, K), BIAS);
   auto copy_bias_tpp_rem = SCOPEIT(CpyBiasTPP<T>(rem, Hk, K), BIAS);
@@ -406,7 +484,7 @@ inline void tpp_linear_add_add(
   {
     RECORD_SCOPE(tpp_linear_add_add_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto ogemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0L, BS, BSb}, {Nk}}, loop_scheme);
     ogemm_loop(
@@ -458,8 +536,9 @@ inline void tpp_linear_gelu(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -484,7 +563,7 @@ inline void tpp_linear_gelu(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
   auto copy_bias_tpp_rem = SCOPEIT(CpyBiasTPP<Tout>(rem, Hk, K), BIAS);
@@ -500,7 +579,7 @@ inline void tpp_linear_gelu(
   {
     RECORD_SCOPE(tpp_linear_gelu_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto igemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     igemm_loop(
@@ -550,8 +629,9 @@ inline void tpp_linear_gelu_tanh(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -576,7 +656,7 @@ inline void tpp_linear_gelu_tanh(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
   auto copy_bias_tpp_rem = SCOPEIT(CpyBiasTPP<Tout>(rem, Hk, K), BIAS);
@@ -592,7 +672,7 @@ inline void tpp_linear_gelu_tanh(
   {
     RECORD_SCOPE(tpp_linear_gelu_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto igemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     igemm_loop(
@@ -655,8 +735,9 @@ inline void tpp_fused_gate_up_proj(
   auto t_wt_up_ = t_wt_up;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_gate_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_gate_ = wt_tensor_for_first_token<T>(t_wt_gate_);
     t_wt_up_ = wt_tensor_for_first_token<T>(t_wt_up_);
     large_cache_opt = true;
@@ -690,7 +771,7 @@ inline void tpp_fused_gate_up_proj(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias_gate = (t_bias_gate.numel() > 0);
   bool with_bias_up = (t_bias_up.numel() > 0);
@@ -710,7 +791,7 @@ inline void tpp_fused_gate_up_proj(
   {
     RECORD_SCOPE(tpp_fused_gate_up_proj_krnl, {t_in, t_wt_gate_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto igemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     igemm_loop(
@@ -781,8 +862,9 @@ inline void tpp_linear_add(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -808,7 +890,7 @@ inline void tpp_linear_add(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<T>(BSb, Hk, K), BIAS);
@@ -825,7 +907,7 @@ inline void tpp_linear_add(
   {
     RECORD_SCOPE(tpp_linear_add_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto ogemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0L, BS, BSb}, {Nk}}, loop_scheme);
     ogemm_loop(
@@ -875,8 +957,9 @@ inline void tpp_linear_silu(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -901,7 +984,7 @@ inline void tpp_linear_silu(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
@@ -918,7 +1001,7 @@ inline void tpp_linear_silu(
   {
     RECORD_SCOPE(tpp_linear_silu_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto igemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     igemm_loop(
@@ -968,8 +1051,9 @@ inline void tpp_linear_relu(
   auto t_wt_ = t_wt;
   auto in_sizes = t_in.sizes();
   auto BS = in_sizes[0] * in_sizes[1];
+  auto blocking = tpp_gemm_blocking<T>(t_in, t_wt_);
   bool large_cache_opt = false;
-  if (BS > FT_OPT_SIZE) { // first token compute
+  if (blocking.large_cache_opt) { // first token compute
     t_wt_ = wt_tensor_for_first_token<T>(t_wt_);
     large_cache_opt = true;
   }
@@ -994,7 +1078,7 @@ inline void tpp_linear_relu(
   auto BSb = 64L;
   auto rem = BS % 64;
   if (large_cache_opt)
-    Ncb = NCB_BLOCK_SIZE;
+    Ncb = blocking.ncb;
 
   bool with_bias = (t_bias.numel() > 0);
   auto copy_bias_tpp = SCOPEIT(CpyBiasTPP<Tout>(BSb, Hk, K), BIAS);
@@ -1011,7 +1095,7 @@ inline void tpp_linear_relu(
   {
     RECORD_SCOPE(tpp_linear_relu_krnl, {t_in, t_wt_V});
 
-    auto loop_scheme = large_cache_opt ? GEMM_LOOP_SCHEME : "aCb";
+    auto loop_scheme = large_cache_opt ? blocking.loop_scheme : "aCb";
     auto igemm_loop = torch_ipex::tpp::ThreadedLoop<3>(
         {{0, Nc, Ncb, false}, {0, BS, BSb}, {Nk}}, loop_scheme);
     igemm_loop(
@@ -3682,6 +3682,199 @@ class VarSoftMaxBwdTPP {
   Eqn eqn0, eqn1;
 };
 
+// Softmax of rows split in blocks of S3 columns, computed one block at a time
+// (online softmax). Each call updates the running max and sum of the S2 rows
+// with a block and writes the block out as exp(in - max), taken with the new
+// max. corr gets the factor by which the blocks seen before have to be
+// rescaled, i.e. exp(old max - new max). max starts at -inf and sum at 0.
+template <typename Tin, typename Tout>
+class OnlineSoftMaxFwdTPP {
+ public:
+  OnlineSoftMaxFwdTPP() {}
+  OnlineSoftMaxFwdTPP(int S2, int S3)
+      : S2(S2),
+        S3(S3),
+        kmax(
+            1,
+            S3,
+            S3,
+            S3,
+            XsmmDtype<Tin>(),
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_UNARY_REDUCE_ROWS,
+            LIBXSMM_MELTW_TYPE_UNARY_REDUCE_X_OP_MAX),
+        ksub(
+            1,
+            S3,
+            S3,
+            S3,
+            XsmmDtype<Tin>(),
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_BINARY_BCAST_SCALAR_IN_1,
+            LIBXSMM_MELTW_TYPE_BINARY_SUB),
+        kexp(
+            1,
+            S3,
+            S3,
+            S3,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_UNARY_NONE,
+            LIBXSMM_MELTW_TYPE_UNARY_EXP),
+        ksum(
+            1,
+            S3,
+            S3,
+            S3,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_UNARY_REDUCE_ROWS,
+            LIBXSMM_MELTW_TYPE_UNARY_REDUCE_X_OP_ADD),
+        kcvt(
+            1,
+            S3,
+            S3,
+            S3,
+            LIBXSMM_DATATYPE_F32,
+            XsmmDtype<Tout>(),
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_UNARY_NONE,
+            LIBXSMM_MELTW_TYPE_UNARY_IDENTITY) {}
+  void operator()(Tin* in, Tout* out, float* max, float* sum, float* corr) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      LIBXSMM_ALIGNED(float tmp[S3], 64);
+      float rmax = 0;
+      kmax(&in[s2 * S3], &rmax);
+      float new_max = max[s2] < rmax ? rmax : max[s2];
+      corr[s2] = max[s2] == -INFINITY ? 0.0f : expf(max[s2] - new_max);
+      ksub(&in[s2 * S3], &new_max, tmp);
+      kexp(tmp, tmp);
+      float lsum;
+      ksum(tmp, &lsum);
+      max[s2] = new_max;
+      sum[s2] = sum[s2] * corr[s2] + lsum;
+      kcvt(tmp, &out[s2 * S3]);
+    }
+  }
+  void ref(Tin* in, Tout* out, float* max, float* sum, float* corr) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      float new_max = max[s2];
+      for (int s3 = 0; s3 < S3; s3++) {
+        float cur = upconvert_to_float(in[s2 * S3 + s3]);
+        if (new_max < cur)
+          new_max = cur;
+      }
+      corr[s2] = max[s2] == -INFINITY ? 0.0f : expf(max[s2] - new_max);
+      float lsum = 0.0f;
+      for (int s3 = 0; s3 < S3; s3++) {
+        float z = expf(upconvert_to_float(in[s2 * S3 + s3]) - new_max);
+        out[s2 * S3 + s3] = z;
+        lsum += z;
+      }
+      max[s2] = new_max;
+      sum[s2] = sum[s2] * corr[s2] + lsum;
+    }
+  }
+
+ private:
+  int S2, S3;
+  UnaryTPP kmax;
+  BinaryTPP ksub;
+  UnaryTPP kexp;
+  UnaryTPP ksum;
+  UnaryTPP kcvt;
+};
+
+// Recomputes the softmax of S2 rows of S3 columns from the log-sum-exp of the
+// rows saved by the forward: out = exp(in - lse).
+template <typename Tin, typename Tout>
+class LseSoftMaxFwdTPP {
+ public:
+  LseSoftMaxFwdTPP() {}
+  LseSoftMaxFwdTPP(int S2, int S3)
+      : S2(S2),
+        S3(S3),
+        ksub(
+            1,
+            S3,
+            S3,
+            S3,
+            XsmmDtype<Tin>(),
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_BINARY_BCAST_SCALAR_IN_1,
+            LIBXSMM_MELTW_TYPE_BINARY_SUB),
+        kexp(
+            1,
+            S3,
+            S3,
+            S3,
+            LIBXSMM_DATATYPE_F32,
+            XsmmDtype<Tout>(),
+            LIBXSMM_DATATYPE_F32,
+            LIBXSMM_MELTW_FLAG_UNARY_NONE,
+            LIBXSMM_MELTW_TYPE_UNARY_EXP) {}
+  void operator()(Tin* in, float* lse, Tout* out) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      LIBXSMM_ALIGNED(float tmp[S3], 64);
+      ksub(&in[s2 * S3], &lse[s2], tmp);
+      kexp(tmp, &out[s2 * S3]);
+    }
+  }
+  void ref(Tin* in, float* lse, Tout* out) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      for (int s3 = 0; s3 < S3; s3++) {
+        out[s2 * S3 + s3] =
+            expf(upconvert_to_float(in[s2 * S3 + s3]) - lse[s2]);
+      }
+    }
+  }
+
+ private:
+  int S2, S3;
+  BinaryTPP ksub;
+  UnaryTPP kexp;
+};
+
+// Softmax backward of one block of S2 rows of S3 columns, with the rowsum of
+// gout * out over the full rows given in delta:
+// gin = out * (gout - delta).
+template <typename T1, typename T2, typename T3>
+class BlockSoftMaxBwdTPP {
+ public:
+  BlockSoftMaxBwdTPP() {}
+  BlockSoftMaxBwdTPP(int S2, int S3) : S2(S2), S3(S3), eqn(S3, 1) {}
+  void operator()(T1* gin, T2* gout, T3* out, float* delta) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      libxsmm_matrix_eqn_param eqn_param;
+      libxsmm_matrix_arg arg_array[3];
+      arg_array[0].primary = (void*)&gout[s2 * S3];
+      arg_array[1].primary = (void*)&out[s2 * S3];
+      arg_array[2].primary = (void*)&delta[s2];
+      eqn_param.inputs = arg_array;
+      eqn_param.output.primary = (void*)&gin[s2 * S3];
+      eqn(&eqn_param);
+    }
+  }
+  void ref(T1* gin, T2* gout, T3* out, float* delta) {
+    for (int s2 = 0; s2 < S2; s2++) {
+      for (int s3 = 0; s3 < S3; s3++) {
+        int64_t ind = s2 * S3 + s3;
+        gin[ind] = upconvert_to_float(out[ind]) *
+            (upconvert_to_float(gout[ind]) - delta[s2]);
+      }
+    }
+  }
+
+ private:
+  int S2, S3;
+  typename VarSoftMaxBwdTPP<T1, T2, T3>::Eqn eqn;
+};
+
 template <typename T>
 class LayerNormFwdTPP {
  public:
@@ -0,0 +1,350 @@
+#include "telemetry.h"
+
+#include <dyndisp/DispatchStub.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+namespace torch_ipex {
+namespace telemetry {
+
+namespace {
+
+// Both are powers of 2.
+constexpr size_t kTableSize = 512;
+constexpr size_t kRingSize = 1024;
+
+int64_t env_int(const char* name, int64_t default_value) {
+  auto env = std::getenv(name);
+  if (env == nullptr) {
+    return default_value;
+  }
+  try {
+    return std::stoll(env);
+  } catch (...) {
+    return default_value;
+  }
+}
+
+std::atomic<int64_t> sample_period{
+    env_int("IPEX_KERNEL_TELEMETRY_SAMPLE_PERIOD", 0)};
+// Bumped by reset(), a thread table recorded in an older epoch is stale.
+std::atomic<uint64_t> epoch{0};
+std::atomic<uint64_t> dropped_calls{0};
+
+// The slots and the events are only written by the thread owning them. Their
+// fields are atomics so that snapshots can read them at any time.
+struct Slot {
+  std::atomic<const char*> kernel{nullptr};
+  std::atomic<const char*> isa{nullptr};
+  std::atomic<int> bucket{0};
+  std::atomic<uint64_t> calls{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::atomic<uint64_t> max_ns{0};
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> flops{0};
+};
+
+struct Event {
+  std::atomic<const char*> kernel{nullptr};
+  std::atomic<const char*> isa{nullptr};
+  std::atomic<int> bucket{0};
+  std::atomic<uint64_t> start_ns{0};
+  std::atomic<uint64_t> duration_ns{0};
+};
+
+// Single writer, so a relaxed load and store is enough, no atomic RMW.
+inline void store_relaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.store(value, std::memory_order_relaxed);
+}
+
+inline uint64_t load_relaxed(const std::atomic<uint64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+struct ThreadTable {
+  explicit ThreadTable(int64_t index) : index(index) {}
+
+  // Open addressing with linear probing, the slots are never removed but by
+  // clear().
+  Slot* find(const char* kernel, int bucket, const char* isa) {
+    size_t hash = std::hash<const void*>()(kernel) * 31 +
+        std::hash<const void*>()(isa) + bucket * 0x9e3779b9;
+    for (size_t i = 0; i < kTableSize; i++) {
+      Slot& slot = slots[(hash + i) & (kTableSize - 1)];
+      const char* slot_kernel = slot.kernel.load(std::memory_order_relaxed);
+      if (slot_kernel == nullptr) {
+        slot.isa.store(isa, std::memory_order_relaxed);
+        slot.bucket.store(bucket, std::memory_order_relaxed);
+        slot.kernel.store(kernel, std::memory_order_release);
+        return &slot;
+      }
+      if (slot_kernel == kernel &&
+          slot.bucket.load(std::memory_order_relaxed) == bucket &&
+          slot.isa.load(std::memory_order_relaxed) == isa) {
+        return &slot;
+      }
+    }
+    return nullptr;
+  }
+
+  void clear() {
+    for (auto& slot : slots) {
+      slot.kernel.store(nullptr, std::memory_order_relaxed);
+      store_relaxed(slot.calls, 0);
+      store_relaxed(slot.total_ns, 0);
+      store_relaxed(slot.max_ns, 0);
+      store_relaxed(slot.bytes, 0);
+      store_relaxed(slot.flops, 0);
+    }
+    num_events.store(0, std::memory_order_relaxed);
+    calls_since_sample = 0;
+  }
+
+  const int64_t index;
+  std::atomic<uint64_t> epoch{0};
+  Slot slots[kTableSize];
+  Event ring[kRingSize];
+  std::atomic<uint64_t> num_events{0};
+  uint64_t calls_since_sample = 0;
+};
+
+using StatsKey = std::tuple<std::string, int, std::string>;
+
+// Adds the counters of the used slots of a table to stats, merged by key.
+void fold_table(
+    const ThreadTable& table,
+    std::map<StatsKey, KernelStats>& stats) {
+  for (auto& slot : table.slots) {
+    const char* kernel = slot.kernel.load(std::memory_order_acquire);
+    if (kernel == nullptr) {
+      continue;
+    }
+    int bucket = slot.bucket.load(std::memory_order_relaxed);
+    const char* isa = slot.isa.load(std::memory_order_relaxed);
+    auto& entry = stats[std::make_tuple(kernel, bucket, isa)];
+    entry.calls += load_relaxed(slot.calls);
+    entry.total_ns += load_relaxed(slot.total_ns);
+    entry.max_ns = std::max(entry.max_ns, load_relaxed(slot.max_ns));
+    entry.bytes += load_relaxed(slot.bytes);
+    entry.flops += load_relaxed(slot.flops);
+  }
+}
+
+struct Registry {
+  std::mutex mutex;
+  // Tables of the live threads.
+  std::vector<ThreadTable*> tables;
+  int64_t next_index = 0;
+  // Counters of the threads exited in retired_epoch, their events are
+  // dropped with their tables.
+  std::map<StatsKey, KernelStats> retired;
+  uint64_t retired_epoch = 0;
+};
+
+// Leaked, so that the threads exiting after the static destructors can still
+// record.
+Registry& registry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+// Registers the table of a thread, and on thread exit folds its counters
+// into the retired ones and frees it.
+struct LocalTable {
+  LocalTable() {
+    auto& registry_ = registry();
+    std::lock_guard<std::mutex> lock(registry_.mutex);
+    table = std::make_unique<ThreadTable>(registry_.next_index++);
+    registry_.tables.push_back(table.get());
+  }
+
+  ~LocalTable() {
+    auto& registry_ = registry();
+    std::lock_guard<std::mutex> lock(registry_.mutex);
+    auto& tables = registry_.tables;
+    tables.erase(std::find(tables.begin(), tables.end(), table.get()));
+    uint64_t current_epoch = epoch.load(std::memory_order_acquire);
+    if (registry_.retired_epoch != current_epoch) {
+      registry_.retired.clear();
+      registry_.retired_epoch = current_epoch;
+    }
+    if (table->epoch.load(std::memory_order_acquire) == current_epoch) {
+      fold_table(*table, registry_.retired);
+    }
+  }
+
+  std::unique_ptr<ThreadTable> table;
+};
+
+ThreadTable& local_table() {
+  thread_local LocalTable local;
+  ThreadTable& table = *local.table;
+  uint64_t current_epoch = epoch.load(std::memory_order_acquire);
+  if (table.epoch.load(std::memory_order_relaxed) != current_epoch) {
+    table.clear();
+    table.epoch.store(current_epoch, std::memory_order_release);
+  }
+  return table;
+}
+
+uint64_t to_ns(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+      .count();
+}
+
+// Calls f on the table of every live thread recorded in the current epoch.
+template <typename F>
+void for_each_table(const F& f) {
+  auto& registry_ = registry();
+  std::lock_guard<std::mutex> lock(registry_.mutex);
+  uint64_t current_epoch = epoch.load(std::memory_order_acquire);
+  for (auto* table : registry_.tables) {
+    if (table->epoch.load(std::memory_order_acquire) == current_epoch) {
+      f(*table);
+    }
+  }
+}
+
+} // namespace
+
+std::atomic<bool> telemetry_enabled{[]() {
+  auto env = std::getenv("IPEX_KERNEL_TELEMETRY");
+  return env != nullptr && std::string(env) == "1";
+}()};
+
+void set_enabled(bool enabled) {
+  telemetry_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void set_sample_period(int64_t period) {
+  sample_period.store(std::max<int64_t>(period, 0), std::memory_order_relaxed);
+}
+
+int64_t get_sample_period() {
+  return sample_period.load(std::memory_order_relaxed);
+}
+
+void reset() {
+  epoch.fetch_add(1, std::memory_order_acq_rel);
+  dropped_calls.store(0, std::memory_order_relaxed);
+}
+
+void KernelScope::start(const char* kernel, int64_t size, const char* isa) {
+  static const char* ipex_isa =
+      cpu::CPUCapabilityToString(cpu::get_cpu_capability());
+  kernel_ = kernel;
+  bucket_ = shape_bucket(size);
+  isa_ = isa != nullptr ? isa : ipex_isa;
+  active_ = true;
+  start_ = std::chrono::steady_clock::now();
+}
+
+void KernelScope::finish() {
+  auto end = std::chrono::steady_clock::now();
+  uint64_t duration_ns = to_ns(end - start_);
+  auto& table = local_table();
+  Slot* slot = table.find(kernel_, bucket_, isa_);
+  if (slot == nullptr) {
+    dropped_calls.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    store_relaxed(slot->calls, load_relaxed(slot->calls) + 1);
+    store_relaxed(slot->total_ns, load_relaxed(slot->total_ns) + duration_ns);
+    store_relaxed(
+        slot->max_ns, std::max(load_relaxed(slot->max_ns), duration_ns));
+    store_relaxed(slot->bytes, load_relaxed(slot->bytes) + bytes_);
+    store_relaxed(slot->flops, load_relaxed(slot->flops) + flops_);
+  }
+
+  int64_t period = sample_period.load(std::memory_order_relaxed);
+  if (period > 0 && ++table.calls_since_sample >= (uint64_t)period) {
+    table.calls_since_sample = 0;
+    uint64_t n = table.num_events.load(std::memory_order_relaxed);
+    Event& event = table.ring[n & (kRingSize - 1)];
+    event.kernel.store(kernel_, std::memory_order_relaxed);
+    event.isa.store(isa_, std::memory_order_relaxed);
+    event.bucket.store(bucket_, std::memory_order_relaxed);
+    store_relaxed(event.start_ns, to_ns(start_.time_since_epoch()));
+    store_relaxed(event.duration_ns, duration_ns);
+    table.num_events.store(n + 1, std::memory_order_release);
+  }
+}
+
+std::vector<KernelStats> snapshot() {
+  // The same kernel name may have several addresses across libraries, so
+  // the keys are merged by content.
+  std::map<StatsKey, KernelStats> merged;
+  for_each_table([&](ThreadTable& table) { fold_table(table, merged); });
+  {
+    // The counters of the exited threads.
+    auto& registry_ = registry();
+    std::lock_guard<std::mutex> lock(registry_.mutex);
+    if (registry_.retired_epoch == epoch.load(std::memory_order_acquire)) {
+      for (auto& item : registry_.retired) {
+        auto& stats = merged[item.first];
+        stats.calls += item.second.calls;
+        stats.total_ns += item.second.total_ns;
+        stats.max_ns = std::max(stats.max_ns, item.second.max_ns);
+        stats.bytes += item.second.bytes;
+        stats.flops += item.second.flops;
+      }
+    }
+  }
+  std::vector<KernelStats> result;
+  for (auto& item : merged) {
+    auto stats = item.second;
+    stats.kernel = std::get<0>(item.first);
+    stats.bucket = std::get<1>(item.first);
+    stats.isa = std::get<2>(item.first);
+    result.emplace_back(std::move(stats));
+  }
+  std::sort(
+      result.begin(),
+      result.end(),
+      [](const KernelStats& a, const KernelStats& b) {
+        return a.total_ns > b.total_ns;
+      });
+  return result;
+}
+
+std::vector<KernelEvent> events() {
+  std::vector<KernelEvent> result;
+  for_each_table([&](ThreadTable& table) {
+    uint64_t n = table.num_events.load(std::memory_order_acquire);
+    uint64_t first = n > kRingSize ? n - kRingSize : 0;
+    for (uint64_t i = first; i < n; i++) {
+      // An event may be overwritten while being read if the thread records
+      // concurrently, at worst it mixes two events of the thread.
+      auto& event = table.ring[i & (kRingSize - 1)];
+      const char* kernel = event.kernel.load(std::memory_order_relaxed);
+      if (kernel == nullptr) {
+        continue;
+      }
+      result.push_back(
+          {kernel,
+           event.bucket.load(std::memory_order_relaxed),
+           event.isa.load(std::memory_order_relaxed),
+           table.index,
+           load_relaxed(event.start_ns),
+           load_relaxed(event.duration_ns)});
+    }
+  });
+  std::sort(
+      result.begin(),
+      result.end(),
+      [](const KernelEvent& a, const KernelEvent& b) {
+        return a.start_ns < b.start_ns;
+      });
+  return result;
+}
+
+uint64_t dropped() {
+  return dropped_calls.load(std::memory_order_relaxed);
+}
+
+} // namespace telemetry
+} // namespace torch_ipex
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <ATen/core/TensorBase.h>
+#include <Macros.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace torch_ipex {
+namespace telemetry {
+
+// Low overhead kernel telemetry, cheap enough to stay enabled in production.
+//
+// Each KernelScope adds its call count, wall time, bytes and FLOPs to the
+// counters of its (kernel, shape bucket, ISA) key. The counters live in a
+// table owned by the calling thread, so recording takes no lock and touches
+// no shared cache line. Snapshots merge the tables of all the threads.
+// Optionally, one call out of every sample_period calls of a thread also
+// leaves a timestamped event in a ring buffer of the thread, which can be
+// dumped as a Chrome trace.
+//
+// Every IPEX DispatchStub kernel and the run() of the prepacked op contexts
+// record a KernelScope. It is disabled by default, enable it with
+// IPEX_KERNEL_TELEMETRY=1 or set_enabled(true). The sample period is read
+// from IPEX_KERNEL_TELEMETRY_SAMPLE_PERIOD, 0 (no events) by default.
+
+IPEX_API extern std::atomic<bool> telemetry_enabled;
+
+inline bool is_enabled() {
+  return telemetry_enabled.load(std::memory_order_relaxed);
+}
+
+IPEX_API void set_enabled(bool enabled);
+IPEX_API void set_sample_period(int64_t period);
+IPEX_API int64_t get_sample_period();
+// Drops the counters and the events recorded so far.
+IPEX_API void reset();
+
+// Shape bucket of a size: ceil(log2(size)), 0 for sizes up to 1.
+inline int shape_bucket(int64_t size) {
+  return size <= 1 ? 0 : 64 - __builtin_clzll((uint64_t)(size - 1));
+}
+
+struct KernelStats {
+  std::string kernel;
+  int bucket = 0;
+  std::string isa;
+  uint64_t calls = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  uint64_t bytes = 0;
+  uint64_t flops = 0;
+};
+
+struct KernelEvent {
+  std::string kernel;
+  int bucket;
+  std::string isa;
+  // Index of the recording thread in the order threads first recorded.
+  int64_t thread;
+  // steady_clock time in nanoseconds.
+  uint64_t start_ns;
+  uint64_t duration_ns;
+};
+
+// Counters of all the threads merged by key, including the exited ones: the
+// table of a thread is folded into a process wide one and freed on exit.
+IPEX_API std::vector<KernelStats> snapshot();
+// Sampled events still held by the ring buffers of the live threads, a ring
+// buffer keeps the last 1024 events of its thread.
+IPEX_API std::vector<KernelEvent> events();
+// Number of calls not counted because the table of the thread was full.
+IPEX_API uint64_t dropped();
+
+class IPEX_API KernelScope {
+ public:
+  // An inactive scope, use start() to record.
+  KernelScope() = default;
+  // kernel and isa must outlive the process, e.g. be string literals. size
+  // picks the shape bucket. A null isa stands for the ISA level of IPEX.
+  KernelScope(const char* kernel, int64_t size, const char* isa = nullptr) {
+    if (is_enabled()) {
+      start(kernel, size, isa);
+    }
+  }
+  KernelScope(const KernelScope&) = delete;
+  KernelScope& operator=(const KernelScope&) = delete;
+  ~KernelScope() {
+    if (active_) {
+      finish();
+    }
+  }
+
+  void start(const char* kernel, int64_t size, const char* isa = nullptr);
+  bool active() const {
+    return active_;
+  }
+  void add_bytes(uint64_t bytes) {
+    bytes_ += bytes;
+  }
+  void add_flops(uint64_t flops) {
+    flops_ += flops;
+  }
+
+ private:
+  void finish();
+
+  bool active_ = false;
+  int bucket_ = 0;
+  const char* kernel_ = nullptr;
+  const char* isa_ = nullptr;
+  uint64_t bytes_ = 0;
+  uint64_t flops_ = 0;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Size and bytes of the dense tensor arguments of a kernel: the size is the
+// numel of the first one.
+struct TensorArgs {
+  int64_t size = -1;
+  uint64_t bytes = 0;
+
+  template <typename Arg>
+  void add(const Arg& arg) {
+    if constexpr (std::is_base_of<at::TensorBase, std::decay_t<Arg>>::value) {
+      if (arg.defined() && arg.layout() == c10::kStrided) {
+        if (size < 0) {
+          size = arg.numel();
+        }
+        bytes += arg.nbytes();
+      }
+    }
+  }
+};
+
+template <typename... Args>
+TensorArgs tensor_args(const Args&... args) {
+  TensorArgs result;
+  (result.add(args), ...);
+  return result;
+}
+
+} // namespace telemetry
+} // namespace torch_ipex
@@ -0,0 +1,99 @@
+#include "tuning.h"
+
+#include "telemetry.h"
+
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+
+namespace torch_ipex {
+namespace tuning {
+
+namespace {
+
+struct Database {
+  // Read on every call of a tuned kernel, written once per tuned shape.
+  std::shared_mutex mutex;
+  std::map<Key, Params> entries;
+};
+
+Database& database() {
+  static Database database_;
+  return database_;
+}
+
+thread_local const Params* current_candidate = nullptr;
+
+} // namespace
+
+std::atomic<bool> autotune_enabled{[]() {
+  auto env = std::getenv("IPEX_AUTOTUNE");
+  return env != nullptr && std::string(env) == "1";
+}()};
+std::atomic<bool> has_entries{false};
+
+bool Key::operator<(const Key& other) const {
+  return std::tie(kernel, dtype, m_bucket, n, k) <
+      std::tie(other.kernel, other.dtype, other.m_bucket, other.n, other.k);
+}
+
+Key make_key(
+    const char* kernel,
+    c10::ScalarType dtype,
+    int64_t m,
+    int64_t n,
+    int64_t k) {
+  return {kernel, dtype, telemetry::shape_bucket(m), n, k};
+}
+
+void set_autotune(bool enabled) {
+  autotune_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool lookup(const Key& key, Params& params) {
+  if (current_candidate != nullptr) {
+    params = *current_candidate;
+    return true;
+  }
+  auto& database_ = database();
+  std::shared_lock<std::shared_mutex> lock(database_.mutex);
+  auto it = database_.entries.find(key);
+  if (it == database_.entries.end()) {
+    return false;
+  }
+  params = it->second;
+  return true;
+}
+
+void record(const Key& key, const Params& params) {
+  auto& database_ = database();
+  std::unique_lock<std::shared_mutex> lock(database_.mutex);
+  database_.entries[key] = params;
+  has_entries.store(true, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<Key, Params>> entries() {
+  auto& database_ = database();
+  std::shared_lock<std::shared_mutex> lock(database_.mutex);
+  return {database_.entries.begin(), database_.entries.end()};
+}
+
+void clear() {
+  auto& database_ = database();
+  std::unique_lock<std::shared_mutex> lock(database_.mutex);
+  database_.entries.clear();
+  has_entries.store(false, std::memory_order_relaxed);
+}
+
+ScopedCandidate::ScopedCandidate(const Params& params)
+    : previous_(current_candidate) {
+  current_candidate = &params;
+}
+
+ScopedCandidate::~ScopedCandidate() {
+  current_candidate = previous_;
+}
+
+} // namespace tuning
+} // namespace torch_ipex
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <Macros.h>
+#include <c10/core/ScalarType.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace torch_ipex {
+namespace tuning {
+
+// Per-shape tuning database of kernel blocking parameters.
+//
+// The TPP GEMMs and the WOQ GEMM look up their block sizes and loop scheme
+// per call by (kernel, dtype, M bucket, N, K) instead of using process-wide
+// constants. M is bucketed like the telemetry, ceil(log2(M)), as it varies
+// with the batch and the sequence length; N and K are those of the weight.
+// A missing entry gives the defaults of the kernel or, in autotuning mode,
+// is tuned on first use: the kernel times each of its candidates on the
+// inputs of the call and records the fastest one.
+//
+// The database is in memory. ipex.cpu.tuning loads it from the JSON file of
+// IPEX_TUNING_DB at startup and saves it there at exit when autotuning, the
+// entries are only valid for the CPU model and thread count they were tuned
+// with. Autotuning is off by default, enable it with IPEX_AUTOTUNE=1 or
+// set_autotune(true).
+
+// Named integer parameters of a kernel, e.g. {"kcb": 64}.
+using Params = std::map<std::string, int64_t>;
+
+struct Key {
+  std::string kernel;
+  c10::ScalarType dtype;
+  int m_bucket;
+  int64_t n;
+  int64_t k;
+
+  bool operator<(const Key& other) const;
+};
+
+IPEX_API Key make_key(
+    const char* kernel,
+    c10::ScalarType dtype,
+    int64_t m,
+    int64_t n,
+    int64_t k);
+
+IPEX_API extern std::atomic<bool> autotune_enabled;
+// Whether the database has any entry, to skip the lookups when it is empty.
+IPEX_API extern std::atomic<bool> has_entries;
+
+IPEX_API void set_autotune(bool enabled);
+inline bool is_autotune_enabled() {
+  return autotune_enabled.load(std::memory_order_relaxed);
+}
+// Whether tuned() may return anything but the defaults. The kernels check it
+// before building their candidates and key, which costs more than the
+// defaults on every call.
+inline bool is_active() {
+  return has_entries.load(std::memory_order_relaxed) || is_autotune_enabled();
+}
+
+// Looks key up, a candidate being timed by tune() takes precedence.
+IPEX_API bool lookup(const Key& key, Params& params);
+IPEX_API void record(const Key& key, const Params& params);
+IPEX_API std::vector<std::pair<Key, Params>> entries();
+IPEX_API void clear();
+
+// Makes lookup() return params on this thread while it is in scope.
+class IPEX_API ScopedCandidate {
+ public:
+  explicit ScopedCandidate(const Params& params);
+  ~ScopedCandidate();
+  ScopedCandidate(const ScopedCandidate&) = delete;
+  ScopedCandidate& operator=(const ScopedCandidate&) = delete;
+
+ private:
+  const Params* previous_;
+};
+
+constexpr int kTuneIters = 5;
+
+// Returns the params of key from the database. On a miss, returns defaults,
+// or when autotuning, times run with each candidate, records the fastest
+// and returns it. run calls the kernel, which gets the candidate from
+// lookup(), and must have no side effect but its own output.
+template <typename F>
+Params tuned(
+    const Key& key,
+    const Params& defaults,
+    const std::vector<Params>& candidates,
+    F&& run) {
+  Params params;
+  if (is_active() && lookup(key, params)) {
+    return params;
+  }
+  if (!is_autotune_enabled() || candidates.size() < 2) {
+    return defaults;
+  }
+  Params best = defaults;
+  auto best_time = std::chrono::steady_clock::duration::max();
+  for (auto& candidate : candidates) {
+    ScopedCandidate scope(candidate);
+    // Warm up, e.g. generate the TPP kernels of the candidate
+    run();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kTuneIters; i++) {
+      run();
+    }
+    auto time = std::chrono::steady_clock::now() - start;
+    if (time < best_time) {
+      best_time = time;
+      best = candidate;
+    }
+  }
+  record(key, best);
+  return best;
+}
+
+inline int64_t get(const Params& params, const char* name, int64_t value) {
+  auto it = params.find(name);
+  return it == params.end() ? value : it->second;
+}
+
+} // namespace tuning
+} // namespace torch_ipex
@@ -54,6 +54,9 @@ def register_fallback_aten_ops():
     make_fallback(torch.ops.torch_ipex.tpp_linear_mul)
     make_fallback(torch.ops.torch_ipex.masked_multihead_self_attention)
     make_fallback(torch.ops.torch_ipex.rotary_position_embedding)
+    make_fallback(torch.ops.torch_ipex.rmsnorm)
+    make_fallback(torch.ops.torch_ipex.add_rmsnorm)
+    make_fallback(torch.ops.torch_ipex.add_layernorm)
 
     make_fallback(torch.ops.torch_ipex.add_softmax_)
     make_fallback(torch.ops.torch_ipex.bmm_add)
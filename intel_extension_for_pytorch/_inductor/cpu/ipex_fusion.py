@@ -1,5 +1,12 @@
+import functools
+import itertools
+
 import torch
-from torch._inductor.pattern_matcher import PatternMatcherPass
+from torch._inductor.pattern_matcher import (
+    PatternMatcherPass,
+    fwd_only,
+    register_replacement,
+)
 
 patterns = PatternMatcherPass()
 
@@ -14,7 +21,195 @@ patterns = PatternMatcherPass()
 #     return L[torch.ops.torch_ipex.bmm_add](mat3, mat1, mat2, 1.0)
 
 
+# RMSNorm as written by the HF LLMs (LLaMA, Mistral, Qwen2, ...): the
+# statistics are computed in float and the result is cast back to the
+# input dtype before the weight is applied.
+def _rmsnorm_pattern_1(x, weight, eps):
+    x_fp32 = x.to(torch.float32)
+    variance = x_fp32.pow(2).mean(-1, keepdim=True)
+    return weight * (x_fp32 * torch.rsqrt(variance + eps)).to(x.dtype)
+
+
+# RMSNorm computed in the input dtype, the weight applied last.
+def _rmsnorm_pattern_2(x, weight, eps):
+    variance = x.pow(2).mean(-1, keepdim=True)
+    return x * torch.rsqrt(variance + eps) * weight
+
+
+def _rmsnorm_replacement(x, weight, eps):
+    return torch.ops.torch_ipex.rmsnorm(x, weight, eps)
+
+
+# The residual add followed by RMSNorm. The sum must have no other user: the
+# IPEX kernel can only return it by writing it back to an input (add_back),
+# which the functional graph does not allow.
+def _add_rmsnorm_pattern_1(a, b, weight, eps):
+    return _rmsnorm_pattern_1(a + b, weight, eps)
+
+
+def _add_rmsnorm_pattern_2(a, b, weight, eps):
+    return _rmsnorm_pattern_2(a + b, weight, eps)
+
+
+def _add_rmsnorm_replacement(a, b, weight, eps):
+    return torch.ops.torch_ipex.add_rmsnorm(a, b, weight, eps, False)
+
+
+def _add_layernorm_pattern(a, b, weight, bias, eps):
+    return torch.nn.functional.layer_norm(a + b, weight.shape, weight, bias, eps)
+
+
+def _add_layernorm_replacement(a, b, weight, bias, eps):
+    return torch.ops.torch_ipex.add_layernorm(
+        a, b, 1, [weight.size(0)], weight, bias, eps
+    )
+
+
+# The activations of linear_fuse_eltwise.EltwiseType, applied by the oneDNN
+# linear as a post-op.
+_LINEAR_ELTWISE = [(torch.relu, 1), (torch.sigmoid, 2)]
+
+
+def _linear_eltwise_patterns(eltwise_fn, eltwise, has_bias):
+    if has_bias:
+
+        def pattern(x, weight, bias, handle, out_features):
+            return eltwise_fn(
+                torch.ops.torch_ipex.ipex_linear(x, weight, bias, handle, out_features)
+            )
+
+        def replacement(x, weight, bias, handle, out_features):
+            return torch.ops.torch_ipex.ipex_linear_eltwise(
+                x, weight, bias, eltwise, handle, out_features
+            )
+
+    else:
+
+        def pattern(x, weight, handle, out_features):
+            return eltwise_fn(
+                torch.ops.torch_ipex.ipex_linear(x, weight, None, handle, out_features)
+            )
+
+        def replacement(x, weight, handle, out_features):
+            return torch.ops.torch_ipex.ipex_linear_eltwise(
+                x, weight, None, eltwise, handle, out_features
+            )
+
+    return pattern, replacement
+
+
+def _val(match, name):
+    return match.kwargs[name].meta["val"]
+
+
+def _is_rmsnorm(match):
+    x = _val(match, "x")
+    weight = _val(match, "weight")
+    # The IPEX kernel returns the dtype of the input, a float weight would
+    # promote the result of the pattern to float.
+    out = match.output_node().meta["val"]
+    return (
+        x.device.type == "cpu"
+        and weight.dim() == 1
+        and weight.size(0) == x.size(-1)
+        and out.dtype == x.dtype
+    )
+
+
+def _is_add_rmsnorm(match):
+    a = _val(match, "a")
+    b = _val(match, "b")
+    weight = _val(match, "weight")
+    out = match.output_node().meta["val"]
+    return (
+        a.device.type == "cpu"
+        and a.shape == b.shape
+        and a.dtype == b.dtype
+        and weight.dim() == 1
+        and weight.size(0) == a.size(-1)
+        and out.dtype == a.dtype
+    )
+
+
+def _is_add_layernorm(match):
+    return (
+        _is_add_rmsnorm(match)
+        and _val(match, "bias").shape == _val(match, "weight").shape
+    )
+
+
+def _is_cpu_linear(match):
+    return _val(match, "x").device.type == "cpu"
+
+
+@functools.lru_cache(None)
+def _register_ipex_patterns():
+    # The patterns are traced with the decompositions of Inductor, so that
+    # they match the post-grad graph, in float and in bfloat16 as the latter
+    # adds casts to the decomposed layer_norm.
+    for dtype in [torch.float32, torch.bfloat16]:
+        x = torch.empty(2, 4, 8, dtype=dtype)
+        weight = torch.empty(8, dtype=dtype)
+        # Before the RMSNorm patterns, which would otherwise match the same
+        # subgraph with the sum as input.
+        for pattern in [_add_rmsnorm_pattern_1, _add_rmsnorm_pattern_2]:
+            register_replacement(
+                pattern,
+                _add_rmsnorm_replacement,
+                [x, x, weight],
+                fwd_only,
+                [patterns],
+                extra_check=_is_add_rmsnorm,
+                scalar_workaround={"eps": 1e-6},
+            )
+        for pattern in [_rmsnorm_pattern_1, _rmsnorm_pattern_2]:
+            register_replacement(
+                pattern,
+                _rmsnorm_replacement,
+                [x, weight],
+                fwd_only,
+                [patterns],
+                extra_check=_is_rmsnorm,
+                scalar_workaround={"eps": 1e-6},
+            )
+        # The reduction dims of the decomposed layer_norm are absolute, one
+        # pattern per rank of the input.
+        for shape in [(2, 4, 8), (4, 8)]:
+            a = torch.empty(shape, dtype=dtype)
+            register_replacement(
+                _add_layernorm_pattern,
+                _add_layernorm_replacement,
+                [a, a, weight, weight],
+                fwd_only,
+                [patterns],
+                extra_check=_is_add_layernorm,
+                scalar_workaround={"eps": 1e-5},
+            )
+        # Traced on meta tensors, as the prepacked linear can not run without
+        # a real op context. The weight is prepacked, only out_features gives
+        # the output shape.
+        x = torch.empty(4, 8, dtype=dtype, device="meta")
+        weight = torch.empty(16, 8, dtype=dtype, device="meta")
+        bias = torch.empty(16, dtype=dtype, device="meta")
+        for (eltwise_fn, eltwise), has_bias in itertools.product(
+            _LINEAR_ELTWISE, [True, False]
+        ):
+            pattern, replacement = _linear_eltwise_patterns(
+                eltwise_fn, eltwise, has_bias
+            )
+            register_replacement(
+                pattern,
+                replacement,
+                [x, weight, bias] if has_bias else [x, weight],
+                fwd_only,
+                [patterns],
+                extra_check=_is_cpu_linear,
+                scalar_workaround={"handle": 123456789, "out_features": 16},
+            )
+
+
 def _ipex_fusion_passes(gm: torch.fx.GraphModule):
+    _register_ipex_patterns()
     patterns.apply(gm.graph)
     gm.graph.lint()
     gm.recompile()
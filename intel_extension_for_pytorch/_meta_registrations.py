@@ -701,3 +701,38 @@ def meta_rmsnorm(
     eps,
 ):
     return input.new_empty(input.shape)
+
+
+@register_meta("add_rmsnorm")
+def meta_add_rmsnorm(
+    input,
+    input1,
+    weight,
+    eps,
+    add_back,
+):
+    return input.new_empty(input.shape)
+
+
+@register_meta("add_layernorm")
+def meta_add_layernorm(
+    a,
+    b,
+    alpha,
+    normalized_shape,
+    weight,
+    bias,
+    eps,
+):
+    return a.new_empty(a.shape)
+
+
+@register_meta("bert_mha_varlen")
+def meta_bert_mha_varlen(
+    qkv,
+    cu_seqlens,
+    head_num,
+    head_size,
+    scale,
+):
+    return qkv.new_empty((qkv.shape[0], head_num, head_size))
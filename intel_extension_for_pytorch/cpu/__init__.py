@@ -2,3 +2,5 @@ from . import runtime
 from . import autocast
 from . import auto_ipex
 from . import comm
+from . import telemetry
+from . import tuning
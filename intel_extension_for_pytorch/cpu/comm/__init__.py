@@ -1,4 +1,6 @@
+import os
 import torch
+import torch.distributed as dist
 import intel_extension_for_pytorch._C as torch_ipex_cpp
 
 
@@ -6,9 +8,70 @@ def has_ccl():
     return hasattr(torch.ops.torch_ipex, "all_reduce_add")
 
 
+_MPI_ENV_KEYS = [
+    "MPI_LOCALRANKID",
+    "MPI_LOCALNRANKS",
+    "PMI_RANK",
+    "PMI_SIZE",
+    "PMIX_RANK",
+]
+_TORCHRUN_ENV_KEYS = ["RANK", "WORLD_SIZE", "MASTER_ADDR", "MASTER_PORT"]
+_bootstrapped = False
+
+
+def init_with_store(store=None, rank=None, world_size=None):
+    r"""
+    Bootstraps the oneCCL and shared memory collectives through a c10d Store
+    rather than MPI. Must be called before the first collective.
+
+    Args:
+        store (torch.distributed.Store): the store shared by all the ranks.
+            Defaults to the store of the default process group if it is
+            initialized, otherwise to the store of the ``env://`` rendezvous
+            set up by torchrun.
+        rank (int): rank of this process, required with ``store``.
+        world_size (int): number of ranks, required with ``store``.
+    """
+    global _bootstrapped
+    if store is None:
+        if dist.is_initialized():
+            store = dist.distributed_c10d._get_default_store()
+            rank = dist.get_rank()
+            world_size = dist.get_world_size()
+        else:
+            store, rank, world_size = next(dist.rendezvous("env://"))
+    assert rank is not None and world_size is not None
+    torch_ipex_cpp.init_with_store(store, rank, world_size)
+    _bootstrapped = True
+
+
+def _maybe_init_with_store():
+    # Launched by torchrun or the like rather than mpirun: bootstrap through
+    # the store of the launcher so that the SHM collectives are still used.
+    global _bootstrapped
+    if _bootstrapped:
+        return
+    _bootstrapped = True
+    if any(os.getenv(key) is not None for key in _MPI_ENV_KEYS):
+        return
+    if not all(os.getenv(key) is not None for key in _TORCHRUN_ENV_KEYS):
+        return
+    if int(os.environ["WORLD_SIZE"]) > 1:
+        init_with_store()
+
+
+def _with_bootstrap(fn):
+    def wrapper(*args, **kwargs):
+        _maybe_init_with_store()
+        return fn(*args, **kwargs)
+
+    return wrapper
+
+
 if has_ccl():
-    get_world_size = torch_ipex_cpp.get_world_size
-    get_rank = torch_ipex_cpp.get_rank
-    barrier = torch_ipex_cpp.barrier
-    allreduce_add = torch.ops.torch_ipex.all_reduce_add
-    allgather = torch.ops.torch_ipex.allgather
+    get_world_size = _with_bootstrap(torch_ipex_cpp.get_world_size)
+    get_rank = _with_bootstrap(torch_ipex_cpp.get_rank)
+    barrier = _with_bootstrap(torch_ipex_cpp.barrier)
+    allreduce_add = _with_bootstrap(torch.ops.torch_ipex.all_reduce_add)
+    allgather = _with_bootstrap(torch.ops.torch_ipex.allgather)
+    allreduce_add_async = _with_bootstrap(torch_ipex_cpp.allreduce_add_async)
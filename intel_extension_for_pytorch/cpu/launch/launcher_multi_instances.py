@@ -77,6 +77,15 @@ class MultiInstancesLauncher(Launcher):
             + '"core_id,core_id,..." or list of core ranges "core_id-core_id,...". '
             + "By default all cores will be used.",
         )
+        group.add_argument(
+            "--shared-weights-dir",
+            "--shared_weights_dir",
+            default="",
+            type=str,
+            help="Directory, e.g. on a tmpfs or hugetlbfs mount, where the instances on a NUMA node share "
+            + "one copy of their packed weight-only quantized weights. Each NUMA node gets its own "
+            + "subdirectory. Only the weights packed by ipex.llm.optimize are shared.",
+        )
         group.add_argument(
             "--benchmark",
             action="store_true",
@@ -159,6 +168,12 @@ class MultiInstancesLauncher(Launcher):
         omp_num_threads = self.check_env("OMP_NUM_THREADS", len(pool))
         environ_local["OMP_NUM_THREADS"] = str(omp_num_threads)
         self.verbose("info", f"env: OMP_NUM_THREADS={omp_num_threads}")
+        if args.shared_weights_dir:
+            shared_weights_dir = os.path.join(
+                args.shared_weights_dir, f'node_{nodes_list_local.replace(",", "_")}'
+            )
+            environ_local["IPEX_SHARED_WEIGHTS_DIR"] = shared_weights_dir
+            self.verbose("info", f"env: IPEX_SHARED_WEIGHTS_DIR={shared_weights_dir}")
 
         if not args.no_python:
             cmd.append(sys.executable)
@@ -1,4 +1,5 @@
 from .task import Task
+from .batch_scheduler import BatchScheduler
 from .cpupool import pin, CPUPool, is_runtime_ext_enabled
 from .multi_stream import (
     MultiStreamModule,
@@ -0,0 +1,98 @@
+import torch
+import intel_extension_for_pytorch as ipex
+from .cpupool import CPUPool
+from .multi_stream import get_default_num_streams
+
+
+class BatchScheduler(object):
+    r"""
+    Request-level dynamic batching for online inference. Requests submitted
+    from any thread are queued, coalesced into batches of up to
+    ``max_batch_size`` samples or until the first request of the batch has
+    waited ``max_delay_ms``, and each batch runs on an idle stream. The
+    queueing, batching and execution happen in C++ without holding the GIL.
+
+    Args:
+        model (torch.jit.ScriptModule): The input model. Its inputs and
+            outputs (a tensor, or a tuple or list of tensors) are batched on
+            dim 0.
+        num_streams (Union[int, str]): Number of streams, each stream owns
+            ``cpu_pool`` cores divided evenly. Default: "AUTO".
+        cpu_pool (intel_extension_for_pytorch.cpu.runtime.CPUPool): The
+            cores used by all the streams.
+        max_batch_size (int): Max number of samples of a batch.
+        max_delay_ms (float): Max time in milliseconds a request waits for
+            other requests to batch with.
+        queue_capacity (int): Max number of pending requests. ``submit``
+            blocks while the queue is full.
+
+    Returns:
+        intel_extension_for_pytorch.cpu.runtime.BatchScheduler: Generated
+        intel_extension_for_pytorch.cpu.runtime.BatchScheduler object.
+
+    :meta public:
+    """
+
+    def __init__(
+        self,
+        model: torch.jit.ScriptModule,
+        num_streams="AUTO",
+        cpu_pool: CPUPool = None,
+        max_batch_size: int = 8,
+        max_delay_ms: float = 2.0,
+        queue_capacity: int = 1024,
+    ):
+        assert isinstance(
+            model, torch.jit.ScriptModule
+        ), "BatchScheduler only supports torch.jit.ScriptModule"
+        if cpu_pool is None:
+            cpu_pool = CPUPool()
+        assert type(cpu_pool) is CPUPool
+        core_list = cpu_pool.core_ids
+        if isinstance(num_streams, str):
+            assert (
+                num_streams.upper() == "AUTO"
+            ), 'Input of num_streams must be Number of instances or string "AUTO"'
+            num_streams = get_default_num_streams(cpu_pool)
+        num_streams = max(1, min(num_streams, len(core_list)))
+        # Same core split as MultiStreamModule: the first streams get one
+        # extra core when the cores are not divisible by the streams.
+        cores_per_stream, num_extra = divmod(len(core_list), num_streams)
+        self.cpu_pools = []
+        start = 0
+        for i in range(num_streams):
+            end = start + cores_per_stream + (1 if i < num_extra else 0)
+            self.cpu_pools.append(CPUPool(core_list[start:end]))
+            start = end
+        self._scheduler = ipex._C.BatchScheduler(
+            model._c,
+            [pool.cpu_pool for pool in self.cpu_pools],
+            max_batch_size,
+            int(max_delay_ms * 1000),
+            queue_capacity,
+        )
+
+    def submit(self, *args):
+        r"""
+        Submits one request. The returned future's ``get()`` returns the part
+        of the batch output belonging to this request.
+        """
+        return self._scheduler.submit(*args)
+
+    def __call__(self, *args):
+        return self.submit(*args).get()
+
+    def stats(self):
+        r"""
+        Returns the number of requests and batches, and the histograms of the
+        queue depth, the latency and queueing delay in microseconds and the
+        batch size. Bucket ``i`` of a histogram counts the values in
+        ``[2 ** (i - 1), 2 ** i)``, bucket 0 counts the zeros.
+        """
+        return self._scheduler.stats()
+
+    def stop(self):
+        r"""
+        Stops accepting requests and waits for the pending ones.
+        """
+        self._scheduler.stop()
@@ -97,8 +97,11 @@ def is_runtime_ext_enabled():
 
     Returns:
         bool: Whether the runtime exetension is enabled or not. If the
-            Intel OpenMP Library is preloaded, this API will return True.
-            Otherwise, it will return False.
+            Intel OpenMP Library is preloaded, threads are bound with its
+            ``kmp_*`` API. Otherwise, on Linux, they are bound with
+            ``pthread_setaffinity_np``, which works with any OpenMP runtime,
+            and this API also returns True. It returns False if neither is
+            available, e.g. on Windows without the Intel OpenMP Library.
     """
 
     return ipex._C.is_runtime_ext_enabled() == 1
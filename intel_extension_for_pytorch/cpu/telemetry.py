@@ -0,0 +1,104 @@
+import json
+import intel_extension_for_pytorch._C as core
+
+
+def enable(sample_period=None):
+    r"""
+    Enables the kernel telemetry. Every IPEX dispatch stub kernel and every
+    run of a prepacked linear or convolution op counts its calls, wall time,
+    bytes, FLOPs and ISA per kernel and shape bucket, in counters private to
+    the calling thread. It can also be enabled with
+    ``IPEX_KERNEL_TELEMETRY=1``.
+
+    Args:
+        sample_period (int): If set, one call out of ``sample_period`` calls
+            of each thread is also recorded as a timestamped event, 0 records
+            no event. Defaults to ``IPEX_KERNEL_TELEMETRY_SAMPLE_PERIOD`` or 0.
+
+    :meta public:
+    """
+    if sample_period is not None:
+        core._telemetry_set_sample_period(sample_period)
+    core._telemetry_set_enabled(True)
+
+
+def disable():
+    r"""
+    Disables the kernel telemetry, the counters are kept.
+
+    :meta public:
+    """
+    core._telemetry_set_enabled(False)
+
+
+def is_enabled():
+    return core._telemetry_is_enabled()
+
+
+def reset():
+    r"""
+    Drops the counters and the events recorded so far.
+
+    :meta public:
+    """
+    core._telemetry_reset()
+
+
+def snapshot():
+    r"""
+    Returns the counters of all the threads, one dict per kernel, shape bucket
+    and ISA, sorted by decreasing total time. The dicts hold ``kernel``,
+    ``bucket``, ``isa``, ``calls``, ``total_ns``, ``max_ns``, ``bytes`` and
+    ``flops``. Bucket ``b`` holds the calls whose size, i.e. the rows of a
+    linear input or the numel of the first tensor argument otherwise, is in
+    ``(2 ** (b - 1), 2 ** b]``.
+
+    :meta public:
+    """
+    return core._telemetry_snapshot()
+
+
+def events():
+    r"""
+    Returns the sampled events still held by the per-thread ring buffers,
+    sorted by start time.
+
+    :meta public:
+    """
+    return core._telemetry_events()
+
+
+def dump_json(path):
+    r"""
+    Writes the snapshot as JSON, along with the number of calls not counted
+    because a thread ran more than 512 distinct keys.
+
+    :meta public:
+    """
+    with open(path, "w") as f:
+        json.dump({"kernels": snapshot(), "dropped": core._telemetry_dropped()}, f)
+
+
+def dump_chrome_trace(path):
+    r"""
+    Writes the sampled events in the Chrome trace event format, viewable in
+    chrome://tracing or Perfetto.
+
+    :meta public:
+    """
+    trace = []
+    for event in events():
+        trace.append(
+            {
+                "name": event["kernel"],
+                "cat": "ipex_kernel",
+                "ph": "X",
+                "ts": event["start_ns"] / 1000.0,
+                "dur": event["duration_ns"] / 1000.0,
+                "pid": 0,
+                "tid": event["thread"],
+                "args": {"bucket": event["bucket"], "isa": event["isa"]},
+            }
+        )
+    with open(path, "w") as f:
+        json.dump({"traceEvents": trace}, f)
@@ -20,6 +20,10 @@ except ImportError:
 USE_BF16_PARAMS = True
 layer_use_bf16 = False
 unpad = True
+# Opt-in: use the flash attention, which does not keep the attention
+# probabilities, when they are not returned. It matches the default path up to
+# the rounding of the unnormalized probabilities in bf16.
+flash_attention = False
 print_cou = 0
 
 
@@ -235,6 +239,80 @@ class BertSelfAttentionFunction(torch.autograd.Function):
         )
 
 
+class BertFlashSelfAttentionFunction(torch.autograd.Function):
+    @staticmethod
+    def forward(ctx, p, training, *inputs):
+        (
+            context_layer,
+            _,
+            hs_t,
+            ehs_t,
+            ql,
+            ql_v,
+            kl_v,
+            kl_tv,
+            vl_tv,
+            lse,
+            ap_dp_mask,
+        ) = torch.ops.torch_ipex.fused_self_attention_flash_fwd_unpad(
+            p, inputs, training
+        )
+        (qw, qb, kw, kb, vw, vb, hs, am, hm, ehs, eam, offs, offs2) = inputs
+        ctx.save_for_backward(
+            qw,
+            kw,
+            vw,
+            hs_t,
+            hm,
+            ehs_t,
+            ql,
+            ql_v,
+            kl_v,
+            kl_tv,
+            vl_tv,
+            context_layer,
+            lse,
+            eam if ehs.numel() > 0 else am,
+            ap_dp_mask,
+            offs,
+            offs2,
+        )
+        ctx.p = p
+        return context_layer
+
+    @staticmethod
+    def backward(ctx, grad_out):
+        inputs = [grad_out.contiguous(), grad_out.new_empty(0)]
+        inputs += ctx.saved_tensors
+        (
+            dqw,
+            dqb,
+            dkw,
+            dkb,
+            dvw,
+            dvb,
+            dhs,
+            dehs,
+        ) = torch.ops.torch_ipex.fused_self_attention_flash_bwd_unpad(ctx.p, inputs)
+        return (
+            None,
+            None,
+            dqw,
+            dqb,
+            dkw,
+            dkb,
+            dvw,
+            dvb,
+            dhs,
+            None,
+            None,
+            dehs,
+            None,
+            None,
+            None,
+        )
+
+
 class BertSelfAttention(BlockedModule):
     r"""PCL Bert Self Attention Layer using libxsmm blocked GEMM"""
 
@@ -417,9 +495,15 @@ class BertSelfAttention(BlockedModule):
             inputs = [
                 i.to(torch.bfloat16) if i.is_floating_point() else i for i in inputs
             ]
-        outputs = BertSelfAttentionFunction.apply(
-            p, self.training, output_attentions, *inputs
-        )
+        if flash_attention and not output_attentions and head_mask is None:
+            context_layer = BertFlashSelfAttentionFunction.apply(
+                p, self.training, *inputs
+            )
+            outputs = (context_layer,)
+        else:
+            outputs = BertSelfAttentionFunction.apply(
+                p, self.training, output_attentions, *inputs
+            )
         # outputs = BertSelfAttentionFunction.apply(p, self.training, True, *inputs)
         context_layer = outputs[0]
 
@@ -0,0 +1,250 @@
+r"""Per-shape tuning database of the TPP and WOQ GEMM blocking parameters.
+
+The TPP linears and the WOQ linears look up their block sizes and loop
+scheme per call by kernel, dtype, bucket of M (``ceil(log2(M))``), N and K.
+A shape missing from the database uses the defaults of the kernel or, in
+autotuning mode, is tuned on first use: the kernel times each of its
+candidates on the inputs of the call and records the fastest one.
+
+At import, the database is loaded from the JSON file of ``IPEX_TUNING_DB`` if
+it exists, and when autotuning is enabled with ``IPEX_AUTOTUNE=1``, saved
+back to it at exit. The entries are only loaded on the CPU model and with the
+thread count they were tuned with.
+
+The database can also be filled offline, e.g.::
+
+    python -m intel_extension_for_pytorch.cpu.tuning --output tuning.json \
+        --shapes 128x4096x4096 512x11008x4096 --dtype bfloat16
+"""
+
+import argparse
+import atexit
+import json
+import os
+import platform
+import warnings
+
+import torch
+import intel_extension_for_pytorch._C as core
+
+TUNING_DB_ENV = "IPEX_TUNING_DB"
+_VERSION = 1
+
+
+def enable_autotune():
+    r"""
+    Enables the autotuning of the shapes missing from the database.
+
+    :meta public:
+    """
+    core._tuning_set_autotune(True)
+
+
+def disable_autotune():
+    r"""
+    Disables the autotuning, the shapes missing from the database use the
+    defaults of the kernels.
+
+    :meta public:
+    """
+    core._tuning_set_autotune(False)
+
+
+def is_autotune_enabled():
+    return core._tuning_is_autotune_enabled()
+
+
+def entries():
+    r"""
+    Returns the entries of the database, one dict per kernel, dtype and shape
+    holding ``kernel``, ``dtype``, ``m_bucket``, ``n``, ``k`` and ``params``.
+
+    :meta public:
+    """
+    return core._tuning_entries()
+
+
+def clear():
+    r"""
+    Drops the entries of the database.
+
+    :meta public:
+    """
+    core._tuning_clear()
+
+
+def _machine():
+    model = platform.processor()
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    model = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    return {"cpu": model, "threads": torch.get_num_threads()}
+
+
+def load(path):
+    r"""
+    Adds the entries of the database file ``path``, unless it was tuned on
+    another CPU model or thread count.
+
+    Args:
+        path (str): path of the JSON database.
+
+    Returns:
+        Whether the entries were loaded.
+
+    :meta public:
+    """
+    with open(path) as f:
+        db = json.load(f)
+    if db.get("version") != _VERSION:
+        warnings.warn(f"Ignoring {path}, it has another tuning database version")
+        return False
+    machine = _machine()
+    for key, value in machine.items():
+        if db[key] != value:
+            warnings.warn(
+                f"Ignoring {path}, it was tuned with {key} {db[key]} and this"
+                f" process runs with {value}"
+            )
+            return False
+    for entry in db["entries"]:
+        core._tuning_record(
+            entry["kernel"],
+            entry["dtype"],
+            entry["m_bucket"],
+            entry["n"],
+            entry["k"],
+            entry["params"],
+        )
+    return True
+
+
+def save(path):
+    r"""
+    Writes the database to ``path``, along with the CPU model and the thread
+    count it was tuned with.
+
+    Args:
+        path (str): path of the JSON database.
+
+    :meta public:
+    """
+    db = dict(_machine(), version=_VERSION, entries=entries())
+    tmp_path = f"{path}.{os.getpid()}.tmp"
+    with open(tmp_path, "w") as f:
+        json.dump(db, f, indent=1)
+    os.replace(tmp_path, path)
+
+
+def _save_at_exit(path):
+    if entries():
+        save(path)
+
+
+def _init():
+    path = os.environ.get(TUNING_DB_ENV)
+    if not path:
+        return
+    if os.path.exists(path):
+        load(path)
+    if is_autotune_enabled():
+        atexit.register(_save_at_exit, path)
+
+
+def _tpp_linear(n, k, dtype):
+    import intel_extension_for_pytorch as ipex
+    from intel_extension_for_pytorch.cpu._auto_kernel_selection import (
+        _enable_tpp,
+        _disable_tpp,
+    )
+
+    model = torch.nn.Sequential(torch.nn.Linear(k, n, bias=False)).eval()
+    _enable_tpp()
+    try:
+        return ipex.optimize(model.to(dtype), dtype=dtype)
+    finally:
+        _disable_tpp()
+
+
+def _woq_linear(n, k, dtype):
+    import intel_extension_for_pytorch as ipex
+    from intel_extension_for_pytorch.quantization import WoqLowpMode
+
+    model = torch.nn.Sequential(torch.nn.Linear(k, n, bias=False)).eval()
+    lowp_mode = {
+        torch.float: WoqLowpMode.NONE,
+        torch.bfloat16: WoqLowpMode.BF16,
+        torch.half: WoqLowpMode.FP16,
+    }[dtype]
+    qconfig_mapping = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+        lowp_mode=lowp_mode
+    )
+    x = torch.randn(1, k)
+    prepared = ipex.quantization.prepare(model, qconfig_mapping, example_inputs=x)
+    return ipex.quantization.convert(prepared)
+
+
+def tune(shapes, dtype=torch.bfloat16, kernels=("tpp", "woq")):
+    r"""
+    Tunes the TPP and the WOQ linears at the given shapes, the results are
+    recorded in the database.
+
+    Args:
+        shapes (list): (M, N, K) of the linears, M being the number of rows
+            of their input.
+        dtype (torch.dtype): dtype of the input and, for TPP, of the weight.
+        kernels (tuple): ``"tpp"`` and / or ``"woq"``.
+
+    :meta public:
+    """
+    was_enabled = is_autotune_enabled()
+    enable_autotune()
+    try:
+        with torch.no_grad():
+            for m, n, k in shapes:
+                x = torch.randn(m, k).to(dtype)
+                if "tpp" in kernels:
+                    _tpp_linear(n, k, dtype)(x)
+                if "woq" in kernels:
+                    _woq_linear(n, k, dtype)(x)
+    finally:
+        if not was_enabled:
+            disable_autotune()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Tunes the blocking of the IPEX TPP and WOQ linears"
+    )
+    parser.add_argument(
+        "--shapes",
+        nargs="+",
+        required=True,
+        help="shapes of the linears as MxNxK, M being the rows of the input",
+    )
+    parser.add_argument(
+        "--dtype", default="bfloat16", choices=["float32", "bfloat16", "float16"]
+    )
+    parser.add_argument(
+        "--kernels", nargs="+", default=["tpp", "woq"], choices=["tpp", "woq"]
+    )
+    parser.add_argument(
+        "--output", required=True, help="database to update, created if missing"
+    )
+    args = parser.parse_args()
+    if os.path.exists(args.output):
+        load(args.output)
+    shapes = [tuple(int(size) for size in shape.split("x")) for shape in args.shapes]
+    tune(shapes, getattr(torch, args.dtype), args.kernels)
+    save(args.output)
+
+
+_init()
+
+if __name__ == "__main__":
+    main()
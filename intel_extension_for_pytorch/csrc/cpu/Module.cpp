@@ -26,6 +26,8 @@
 #include "utils/isa_utils.h"
 #include "utils/module_version.h"
 #include "utils/onednn_utils.h"
+#include "utils/telemetry.h"
+#include "utils/tuning.h"
 
 #include <c10/core/DeviceType.h>
 #include <torch/csrc/Exceptions.h>
@@ -37,6 +39,7 @@
 #include "aten/EmbeddingBag.h"
 #include "aten/TPPShmAllReduceAdd.h"
 #include "comm/comm.h"
+#include "runtime/BatchScheduler.h"
 #include "runtime/CPUPool.h"
 #include "runtime/TaskExecutor.h"
 #include "toolkit/sklearn.h"
@@ -142,6 +145,18 @@ void InitIpexModuleBindings(py::module m) {
   m.def(
       "_jit_llga_weight_cache_enabled",
       &torch_ipex::jit::fuser::onednn::getLlgaWeightCacheEnabled);
+  m.def(
+      "_jit_set_llga_shape_buckets",
+      &torch_ipex::jit::fuser::onednn::setLlgaShapeBuckets);
+  m.def(
+      "_jit_llga_shape_buckets",
+      &torch_ipex::jit::fuser::onednn::getLlgaShapeBuckets);
+  m.def(
+      "_jit_llga_shape_bucket_stats",
+      &torch_ipex::jit::fuser::onednn::getLlgaShapeBucketStats);
+  m.def(
+      "_jit_reset_llga_shape_bucket_stats",
+      &torch_ipex::jit::fuser::onednn::resetLlgaShapeBucketStats);
 
   m.def("enable_jit_opt", []() {
     AutoOptConfig::singleton().set_jit_fuse(true);
@@ -172,6 +187,89 @@ void InitIpexModuleBindings(py::module m) {
     return AutoOptConfig::singleton().get_jit_concat_linear();
   });
 
+  // Kernel telemetry
+  m.def("_telemetry_set_enabled", &torch_ipex::telemetry::set_enabled);
+  m.def("_telemetry_is_enabled", &torch_ipex::telemetry::is_enabled);
+  m.def(
+      "_telemetry_set_sample_period",
+      &torch_ipex::telemetry::set_sample_period);
+  m.def(
+      "_telemetry_get_sample_period",
+      &torch_ipex::telemetry::get_sample_period);
+  m.def("_telemetry_reset", &torch_ipex::telemetry::reset);
+  m.def("_telemetry_dropped", &torch_ipex::telemetry::dropped);
+  m.def("_telemetry_snapshot", []() {
+    py::list result;
+    for (auto& stats : torch_ipex::telemetry::snapshot()) {
+      py::dict item;
+      item["kernel"] = stats.kernel;
+      item["bucket"] = stats.bucket;
+      item["isa"] = stats.isa;
+      item["calls"] = stats.calls;
+      item["total_ns"] = stats.total_ns;
+      item["max_ns"] = stats.max_ns;
+      item["bytes"] = stats.bytes;
+      item["flops"] = stats.flops;
+      result.append(item);
+    }
+    return result;
+  });
+  m.def("_telemetry_events", []() {
+    py::list result;
+    for (auto& event : torch_ipex::telemetry::events()) {
+      py::dict item;
+      item["kernel"] = event.kernel;
+      item["bucket"] = event.bucket;
+      item["isa"] = event.isa;
+      item["thread"] = event.thread;
+      item["start_ns"] = event.start_ns;
+      item["duration_ns"] = event.duration_ns;
+      result.append(item);
+    }
+    return result;
+  });
+
+  // Kernel tuning database
+  m.def("_tuning_set_autotune", &torch_ipex::tuning::set_autotune);
+  m.def(
+      "_tuning_is_autotune_enabled",
+      &torch_ipex::tuning::is_autotune_enabled);
+  m.def("_tuning_clear", &torch_ipex::tuning::clear);
+  m.def(
+      "_tuning_record",
+      [](const std::string& kernel,
+         const std::string& dtype,
+         int m_bucket,
+         int64_t n,
+         int64_t k,
+         const std::map<std::string, int64_t>& params) {
+        // dtype is named as by c10::toString
+        for (int i = 0; i < static_cast<int>(c10::ScalarType::NumOptions);
+             i++) {
+          auto scalar_type = static_cast<c10::ScalarType>(i);
+          if (dtype == c10::toString(scalar_type)) {
+            torch_ipex::tuning::record(
+                {kernel, scalar_type, m_bucket, n, k}, params);
+            return;
+          }
+        }
+        TORCH_CHECK(false, "Unknown dtype ", dtype, " in the tuning database");
+      });
+  m.def("_tuning_entries", []() {
+    py::list result;
+    for (auto& entry : torch_ipex::tuning::entries()) {
+      py::dict item;
+      item["kernel"] = entry.first.kernel;
+      item["dtype"] = c10::toString(entry.first.dtype);
+      item["m_bucket"] = entry.first.m_bucket;
+      item["n"] = entry.first.n;
+      item["k"] = entry.first.k;
+      item["params"] = entry.second;
+      result.append(item);
+    }
+    return result;
+  });
+
   // BF32
   py::enum_<FP32MathMode>(m, "FP32MathMode")
       .value("FP32", FP32MathMode::FP32)
@@ -230,6 +328,57 @@ void InitIpexModuleBindings(py::module m) {
             return self.run_async(std::move(args), std::move(kwargs));
           });
 
+  py::class_<
+      torch_ipex::runtime::BatchScheduler,
+      std::shared_ptr<torch_ipex::runtime::BatchScheduler>>(
+      m, "BatchScheduler")
+      .def(py::init(
+          [](const torch::jit::Module& module,
+             const std::vector<std::shared_ptr<torch_ipex::runtime::CPUPool>>&
+                 cpu_pools,
+             int64_t max_batch_size,
+             int64_t max_delay_us,
+             int64_t queue_capacity) {
+            return std::make_shared<torch_ipex::runtime::BatchScheduler>(
+                module, cpu_pools, max_batch_size, max_delay_us, queue_capacity);
+          }))
+      .def(
+          "submit",
+          [](torch_ipex::runtime::BatchScheduler& self, py::args& args) {
+            std::vector<c10::IValue> inputs;
+            for (auto& arg : args) {
+              inputs.emplace_back(
+                  torch::jit::toIValue(arg, c10::TensorType::get()));
+            }
+            auto future_tensor_result =
+                std::make_unique<torch_ipex::runtime::FutureTensor>();
+            {
+              // submit blocks while the queue is full
+              pybind11::gil_scoped_release no_gil_guard;
+              future_tensor_result->future_script_tensor =
+                  self.submit(std::move(inputs));
+            }
+            future_tensor_result->script_module_initialized_ = true;
+            return future_tensor_result;
+          })
+      .def(
+          "stats",
+          [](torch_ipex::runtime::BatchScheduler& self) {
+            auto stats = self.stats();
+            py::dict result;
+            result["num_requests"] = stats.num_requests;
+            result["num_batches"] = stats.num_batches;
+            result["queue_depth"] = stats.queue_depth;
+            result["latency_us"] = stats.latency_us;
+            result["queue_delay_us"] = stats.queue_delay_us;
+            result["batch_size"] = stats.batch_size;
+            return result;
+          })
+      .def(
+          "stop",
+          &torch_ipex::runtime::BatchScheduler::stop,
+          py::call_guard<py::gil_scoped_release>());
+
   m.def(
       "get_process_available_cores",
       &torch_ipex::runtime::get_process_available_cores);
@@ -275,10 +424,20 @@ void InitIpexModuleBindings(py::module m) {
   m.def("tpp_fused_lamb_v2", &torch_ipex::tpp::fused_lamb_v2);
 
   // communication related
+  m.def("init_with_store", &torch_ipex::cpu::init_with_store);
   m.def("get_rank", &torch_ipex::cpu::get_rank);
   m.def("tpp_shm_allreduce", &torch_ipex::cpu::tpp_shmallreduce_forward);
   m.def("get_world_size", &torch_ipex::cpu::get_world_size);
   m.def("barrier", &torch_ipex::cpu::barrier);
+  py::class_<
+      torch_ipex::cpu::CommHandle,
+      std::shared_ptr<torch_ipex::cpu::CommHandle>>(m, "CommHandle")
+      .def(
+          "wait",
+          &torch_ipex::cpu::CommHandle::wait,
+          py::call_guard<py::gil_scoped_release>())
+      .def("is_completed", &torch_ipex::cpu::CommHandle::is_completed);
+  m.def("allreduce_add_async", &torch_ipex::cpu::allreduce_add_async);
 
   // Module version
   m.def("_get_mkl_version", []() {
@@ -6,6 +6,7 @@ if has_cpu():
     from .merged_embeddingbag import MergedEmbeddingBagWithSGD
     from .merged_embeddingbag import MergedEmbeddingBag
     from .merged_embeddingbag import MergedEmbeddingBagWithCat
+    from .merged_embeddingbag import MergedEmbeddingBagWithInteraction
     from .merged_embeddingbag import MergedEmbeddingBagWithAdaGrad
     from .merged_embeddingbag import DistMergeEmbeddingBagWithAdaGrad
     from ...cpu.nn.linear_fuse_eltwise import IPEXLinearEltwise
@@ -58,6 +58,21 @@ def merged_embeddingbag_with_cat(
     )
 
 
+def merged_embeddingbag_with_interaction(
+    weights,
+    indices,
+    offsets,
+    dense_feature,
+):
+    if torch.is_grad_enabled():
+        raise NotImplementedError(
+            "merged_embeddingbag_with_interaction does not support training"
+        )
+    return torch.ops.torch_ipex.merged_embeddingbag_interaction_forward(
+        weights, indices, offsets, dense_feature
+    )
+
+
 def merged_embeddingbag_sgd(
     weights, indices, offsets, pooling_mode, include_last_offset, sgd_args
 ):
@@ -653,6 +668,55 @@ class MergedEmbeddingBagWithCat(MergedEmbeddingBag):
         )
 
 
+class MergedEmbeddingBagWithInteraction(MergedEmbeddingBag):
+    r"""
+    To support `MergedEmbeddingBag` followed by the DLRM interaction of its
+    outputs with an given dense feature. The pooled embeddings are not written
+    to memory: each sample is pooled into a cache-resident buffer and its
+    pairwise interaction is computed right away. Only SUM pooling and tables
+    of the same embedding dim as the dense feature are supported.
+    Native usage for multiple EmbeddingBag followed by the interaction is:
+
+        >>> EmbLists = torch.nn.Modulist(emb1, emb2, emb3, ..., emb_m)
+        >>> inputs = [in1, in2, in3, ..., in_m]
+        >>> outputs = []
+        >>> for i in range(len(EmbLists)):
+        >>>     outputs.append(Emb[in_i])
+        >>> out = ipex.nn.functional.interaction(dense_feature, *outputs)
+
+
+    The optimized path is:
+
+        >>> EmbLists = torch.nn.Modulist(emb1, emb2, emb3, ..., emb_m)
+        >>> merged_emb = MergedEmbeddingBagWithInteraction.from_embeddingbag_list(EmbLists)
+        >>> out = merged_emb(inputs, offsets, dense_feature)
+    """
+
+    embedding_specs: List[EmbeddingSpec]
+
+    def __init__(
+        self,
+        embedding_specs: List[EmbeddingSpec],
+    ):
+        super(MergedEmbeddingBagWithInteraction, self).__init__(embedding_specs)
+
+    def forward(self, indices, offsets, dense_feature):
+        r"""
+        Args:
+            indices (Tensor): a list of indices for all tables
+            offsets (Tensor): a list of offsets for all tables
+            dense_feature (Tensor): dense feature of the interaction
+        Returns:
+            output shape of `(batch_size, emb_dim + F * (F - 1) / 2)` which F = num of tables + 1.
+        """
+        return merged_embeddingbag_with_interaction(
+            self.weights,
+            indices,
+            offsets,
+            dense_feature,
+        )
+
+
 import torch.distributed as dist
 
 
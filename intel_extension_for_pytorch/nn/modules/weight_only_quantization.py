@@ -17,6 +17,10 @@ from intel_extension_for_pytorch.nn.utils._model_convert import (
     prepack_awq_weight,
     _convert_optimum_format_to_desired,
 )
+from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+    load_woq_linear,
+    record_woq_linear,
+)
 
 from intel_extension_for_pytorch.llm.quantization.utils import QuantMethod, QuantDtype
 from intel_extension_for_pytorch.quantization._qconfig import (
@@ -128,6 +132,14 @@ class WeightOnlyQuantizedLinear(nn.Module):
             assert (
                 sym_quant is True
             ), "WOQ NF4 and INT8 with lowp-mode 3 must use symmetric quantization"
+        if not hasattr(mod, "in_features"):
+            mod.in_features = mod.weight.size()[1]
+        if not hasattr(mod, "out_features"):
+            mod.out_features = mod.weight.size()[0]
+        qlinear = load_woq_linear(cls, mod, dtype)
+        if qlinear is not None:
+            mod.weight = torch.nn.Parameter()
+            return qlinear
 
         if group_size == -1:
             qweight, scales, zero_points = quantize_per_channel(
@@ -137,10 +149,6 @@ class WeightOnlyQuantizedLinear(nn.Module):
             qweight, scales, zero_points = quantize_per_block(
                 mod.weight, dtype, group_size, scales, zero_points, sym_quant
             )
-        if not hasattr(mod, "in_features"):
-            mod.in_features = mod.weight.size()[1]
-        if not hasattr(mod, "out_features"):
-            mod.out_features = mod.weight.size()[0]
         cache_weight_for_large_batch = (
             qconfig.cache_weight_for_large_batch and lowp_mode in (2, 3)
         )
@@ -159,7 +167,7 @@ class WeightOnlyQuantizedLinear(nn.Module):
         )
         del qweight
         mod.weight = torch.nn.Parameter()
-        return qlinear
+        return record_woq_linear(qlinear)
 
     @classmethod
     def from_float_and_int4_weight(
@@ -222,6 +230,10 @@ class WeightOnlyQuantizedLinear(nn.Module):
             mod.in_features = mod.weight.size()[1]
         if not hasattr(mod, "out_features"):
             mod.out_features = mod.weight.size()[0]
+        qlinear = load_woq_linear(cls, mod, WoqWeightDtype.INT4)
+        if qlinear is not None:
+            mod.weight = torch.nn.Parameter()
+            return qlinear
 
         qlinear = cls(mod.in_features, mod.out_features, dtype=WoqWeightDtype.INT4)
         if mod.bias is not None:
@@ -252,7 +264,7 @@ class WeightOnlyQuantizedLinear(nn.Module):
             else WoqWeightQScheme.SYMMETRIC
         )
         del qweight
-        return qlinear
+        return record_woq_linear(qlinear)
 
     @classmethod
     def from_int4_weight(
@@ -403,6 +415,10 @@ class WeightOnlyQuantizedLinear(nn.Module):
                 "Currently ipex.llm.quantization.IPEXWeightOnlyQuantizedLinear.from_weight() supports 4bits with AWQ or GPTQ."
             )
 
+    @classmethod
+    def _init_from_mod(cls, mod, dtype):
+        return cls(mod.in_features, mod.out_features, mod.bias is not None, dtype=dtype)
+
     @classmethod
     def _init_cls(
         cls,
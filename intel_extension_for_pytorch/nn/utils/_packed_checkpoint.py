@@ -0,0 +1,420 @@
+r"""Checkpoint of prepacked weight-only quantized (WOQ) linear weights.
+
+Quantizing and packing the weights of an LLM takes a large part of its
+loading time. The first run of ``packed_woq_checkpoint(path)`` records the op
+contexts of the WOQ linears created under it and writes their packed weights
+to ``path``; later runs read the op contexts back instead of quantizing and
+packing again. The tensors are page-aligned in the file and mapped into
+memory, so the packed weights are not copied at load time.
+
+The WOQ linears are matched by creation order, which is deterministic for a
+given model and quantization config, and each one is checked against the
+recorded shape and config. Packed weights depend on the ISA level, so a file
+only loads with the IPEX and PyTorch versions and the ISA level it was
+written with.
+
+The file is mapped shared, so the instances of a multi-instance run on one
+node share a single copy of the weights: the first instance to take the lock
+file packs and writes them, then switches to the weights of the file, the
+others wait and map them. On a tmpfs or
+hugetlbfs mount, the pages are placed on the NUMA node of the writer, which
+is why the launcher gives each NUMA node its own directory
+(``--shared-weights-dir``).
+
+File layout: ``IPEXPACK``, the format version (uint32), the offset and size
+of the JSON header (uint64), then from the second page on the tensor data,
+each tensor starting at a page boundary, and the header. The file is padded
+to the block size of its file system, the huge page size on hugetlbfs.
+"""
+
+import contextlib
+import hashlib
+import json
+import mmap
+import os
+import struct
+import sys
+import warnings
+
+import torch
+import intel_extension_for_pytorch._C as core
+
+_MAGIC = b"IPEXPACK"
+_VERSION = 1
+_PREFIX = struct.Struct("<IQQ")
+_ALIGNMENT = 4096
+
+# Optional tensors of an op context, in the order of the
+# weight_only_qlinear_prepack_from_packed arguments.
+_OPTIONAL_TENSORS = (
+    "zero_points",
+    "bias",
+    "g_idx",
+    "cached_weight",
+    "compensation",
+)
+
+# Values sampled per tensor by state_dict_digest
+_DIGEST_SAMPLES = 4096
+
+# Set by the launcher to a directory per NUMA node
+SHARED_WEIGHTS_DIR_ENV = "IPEX_SHARED_WEIGHTS_DIR"
+
+_active = None
+
+
+def _align(offset):
+    return (offset + _ALIGNMENT - 1) // _ALIGNMENT * _ALIGNMENT
+
+
+def _environment():
+    import intel_extension_for_pytorch as ipex
+
+    return {
+        "ipex_version": ipex.__version__,
+        "torch_version": torch.__version__,
+        "isa": core._get_current_isa_level().lower(),
+    }
+
+
+def _config(cls, mod, dtype):
+    return {
+        "class": cls.__name__,
+        "in_features": mod.in_features,
+        "out_features": mod.out_features,
+        "dtype": int(dtype),
+    }
+
+
+def _tensor(buffer, meta):
+    if meta is None:
+        return None
+    dtype = getattr(torch, meta["dtype"])
+    if "offset" not in meta:
+        # Dropped weight, only its shape is used
+        return torch.zeros((), dtype=dtype).expand(meta["shape"])
+    return (
+        buffer[meta["offset"] : meta["offset"] + meta["nbytes"]]
+        .view(dtype)
+        .view(meta["shape"])
+    )
+
+
+def _set_op_context(qlinear, buffer, entry):
+    tensors = entry["tensors"]
+    qlinear._op_context = (
+        torch.ops.ipex_prepack.weight_only_qlinear_prepack_from_packed(
+            _tensor(buffer, tensors["weight"]),
+            entry["dtype"],
+            entry["weight_shape"],
+            _tensor(buffer, tensors["scales"]),
+            *[_tensor(buffer, tensors.get(name)) for name in _OPTIONAL_TENSORS],
+            entry["group_size"],
+            entry["lowp_mode"],
+            entry["act_quant_mode"],
+            entry["cache_weight_for_large_batch"],
+        )
+    )
+    qlinear.weight = qlinear._op_context.get_weight()
+
+
+def _map(path):
+    # Shared mapping, so that the processes mapping the file share its pages.
+    # It is read-only, a stray write to the weights faults instead of
+    # changing the file under the other processes.
+    with open(path, "rb") as f:
+        # A shared read-only mapping on POSIX, also available on Windows
+        buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    with warnings.catch_warnings():
+        # The tensor is not writable, which frombuffer warns about
+        warnings.simplefilter("ignore", UserWarning)
+        # The tensor keeps the mapping alive
+        return torch.frombuffer(buffer, dtype=torch.uint8)
+
+
+class _Recorder:
+    def __init__(self, path):
+        self.path = path
+        self.qlinears = []
+        self.dropped = set()
+        self.saved = False
+
+    def record(self, qlinear):
+        assert (
+            not self.saved
+        ), f"WOQ linear created after the packed checkpoint {self.path} was written"
+        self.qlinears.append(qlinear)
+
+    def drop_weight(self, qlinear):
+        self.dropped.add(id(qlinear))
+
+    def _entry(self, qlinear):
+        ctx = qlinear._op_context
+        n = qlinear.out_features
+        bias = ctx.get_bias()
+        tensors = {
+            "weight": ctx.get_weight(),
+            # Scales and zero points are already narrowed to N
+            "scales": ctx.get_scales(),
+            "zero_points": ctx.get_zero_points(),
+            "bias": bias.narrow(0, 0, n) if bias is not None else None,
+            "g_idx": ctx.get_g_idx(),
+            "cached_weight": ctx.get_cached_weight(),
+            "compensation": ctx.get_cached_compensation(),
+        }
+        entry = _config(type(qlinear), qlinear, qlinear.dtype)
+        entry.update(
+            {
+                "weight_shape": list(ctx.get_weight_shape()),
+                "bias": bool(qlinear.bias),
+                "group_size": qlinear._group_size,
+                "lowp_mode": int(qlinear._lowp_mode),
+                "act_quant_mode": int(qlinear._act_quant_mode),
+                "cache_weight_for_large_batch": bool(
+                    qlinear._cache_weight_for_large_batch
+                ),
+                "weight_qscheme": int(qlinear._weight_qscheme),
+            }
+        )
+        return entry, tensors
+
+    def save(self):
+        if self.saved or not self.qlinears:
+            return
+        self.saved = True
+        entries = []
+        data = []
+        # Data starts after the first page, which holds the prefix
+        offset = _ALIGNMENT
+        for qlinear in self.qlinears:
+            entry, tensors = self._entry(qlinear)
+            metas = {}
+            for name, t in tensors.items():
+                if t is None:
+                    continue
+                metas[name] = {
+                    "dtype": str(t.dtype).split(".")[-1],
+                    "shape": list(t.shape),
+                }
+                if name == "weight" and id(qlinear) in self.dropped:
+                    continue
+                t = t.detach().contiguous().reshape(-1).view(torch.uint8)
+                metas[name].update({"offset": offset, "nbytes": t.numel()})
+                data.append((offset, t))
+                offset = _align(offset + t.numel())
+            entries.append(dict(entry, tensors=metas))
+        header = json.dumps(dict(_environment(), entries=entries)).encode()
+        prefix = _MAGIC + _PREFIX.pack(_VERSION, offset, len(header))
+        # hugetlbfs only supports writes through a mapping of huge pages
+        block = (
+            os.statvfs(os.path.dirname(os.path.abspath(self.path))).f_bsize
+            if hasattr(os, "statvfs")
+            else _ALIGNMENT
+        )
+        size = (offset + len(header) + block - 1) // block * block
+        tmp_path = f"{self.path}.{os.getpid()}.tmp"
+        try:
+            buffer = torch.from_file(
+                tmp_path, shared=True, size=size, dtype=torch.uint8
+            )
+            for start, t in [(0, prefix), (offset, header)]:
+                buffer[start : start + len(t)].copy_(
+                    torch.frombuffer(bytearray(t), dtype=torch.uint8)
+                )
+            for start, t in data:
+                buffer[start : start + t.numel()].copy_(t)
+            del buffer
+            # Readers never see a partially written file
+            os.replace(tmp_path, self.path)
+        finally:
+            if os.path.exists(tmp_path):
+                os.unlink(tmp_path)
+        # Switch to the weights in the file, so that this process shares them
+        # too and frees its own copy.
+        buffer = _map(self.path)
+        for qlinear, entry in zip(self.qlinears, entries):
+            _set_op_context(qlinear, buffer, entry)
+
+
+class _Loader:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            magic = f.read(len(_MAGIC))
+            if magic != _MAGIC:
+                raise RuntimeError(f"{path} is not a packed WOQ checkpoint")
+            version, header_offset, header_size = _PREFIX.unpack(f.read(_PREFIX.size))
+            if version != _VERSION:
+                raise RuntimeError(
+                    f"{path} has format version {version}, expected {_VERSION}"
+                )
+            f.seek(header_offset)
+            header = json.loads(f.read(header_size))
+        for key, value in _environment().items():
+            if header[key] != value:
+                raise RuntimeError(
+                    f"{path} was written with {key} {header[key]}, it cannot be"
+                    f" loaded with {key} {value}. Please remove it to repack the"
+                    " weights."
+                )
+        self.path = path
+        self.entries = header["entries"]
+        self.next = 0
+        self.buffer = _map(path)
+
+    def load(self, cls, mod, dtype):
+        from intel_extension_for_pytorch.quantization._qconfig import (
+            WoqActQuantMode,
+            WoqLowpMode,
+            WoqWeightQScheme,
+        )
+
+        if self.next == len(self.entries):
+            raise RuntimeError(
+                f"{self.path} has fewer WOQ linears than the model, it was"
+                " written for another model or quantization config"
+            )
+        entry = self.entries[self.next]
+        expected = _config(cls, mod, dtype)
+        found = {key: entry[key] for key in expected}
+        if found != expected:
+            raise RuntimeError(
+                f"WOQ linear {self.next} of {self.path} is {found}, but the"
+                f" model has {expected}"
+            )
+        self.next += 1
+        qlinear = cls._init_from_mod(mod, dtype)
+        _set_op_context(qlinear, self.buffer, entry)
+        qlinear.bias = entry["bias"]
+        qlinear._lowp_mode = WoqLowpMode(entry["lowp_mode"])
+        qlinear._act_quant_mode = WoqActQuantMode(entry["act_quant_mode"])
+        qlinear._group_size = entry["group_size"]
+        qlinear._cache_weight_for_large_batch = entry["cache_weight_for_large_batch"]
+        qlinear._weight_qscheme = WoqWeightQScheme(entry["weight_qscheme"])
+        return qlinear
+
+    def check_done(self):
+        if self.next != len(self.entries):
+            raise RuntimeError(
+                f"{self.path} has {len(self.entries)} WOQ linears, but the model"
+                f" created {self.next}"
+            )
+
+
+def _flock(f, lock):
+    # fcntl is POSIX only, the processes sharing a checkpoint are not
+    # serialized on other platforms.
+    if sys.platform == "win32":
+        return
+    import fcntl
+
+    fcntl.flock(f, fcntl.LOCK_EX if lock else fcntl.LOCK_UN)
+
+
+@contextlib.contextmanager
+def packed_woq_checkpoint(path):
+    r"""Records the WOQ linears created in the context to ``path``, or loads
+    them from ``path`` if it exists.
+
+    Args:
+        path (str): path of the packed checkpoint.
+    """
+    global _active
+    assert _active is None, "packed_woq_checkpoint cannot be nested"
+    # Held while the weights are packed and written, so that processes
+    # starting together pack them once.
+    with open(f"{path}.lock", "w") as lock:
+        _flock(lock, True)
+        if os.path.exists(path):
+            _flock(lock, False)
+            _active = _Loader(path)
+        else:
+            _active = _Recorder(path)
+        try:
+            yield
+            if isinstance(_active, _Loader):
+                _active.check_done()
+            else:
+                _active.save()
+        finally:
+            _active = None
+
+
+def is_active():
+    return _active is not None
+
+
+def is_loading():
+    return isinstance(_active, _Loader)
+
+
+def load_woq_linear(cls, mod, dtype):
+    r"""Returns the WOQ linear of ``mod`` from the packed checkpoint being
+    loaded, or ``None`` if no checkpoint is loaded."""
+    if not isinstance(_active, _Loader):
+        return None
+    return _active.load(cls, mod, dtype)
+
+
+def record_woq_linear(qlinear):
+    if isinstance(_active, _Recorder):
+        _active.record(qlinear)
+    return qlinear
+
+
+def drop_weight(qlinear):
+    r"""Leaves the weight of ``qlinear`` out of the packed checkpoint being
+    recorded, e.g. once it is concatenated into another WOQ linear. Its op
+    context is still created at load time, with a placeholder weight."""
+    if isinstance(_active, _Recorder):
+        _active.drop_weight(qlinear)
+
+
+def save():
+    r"""Writes the packed checkpoint being recorded before the end of the
+    context, so that the WOQ linears use the weights of the file from then
+    on, e.g. before they are captured by a trace."""
+    if isinstance(_active, _Recorder):
+        _active.save()
+
+
+def shared_weights_path(name, config=None):
+    r"""Returns the path of the packed checkpoint of the model ``name`` in the
+    shared weights directory of the NUMA node, or ``None`` if the process was
+    not started with ``--shared-weights-dir``.
+
+    Args:
+        name (str): name of the model.
+        config (dict): what else the packed weights depend on, e.g. the dtype
+            and the quantization config. It is hashed into the file name with
+            the IPEX and PyTorch versions and the ISA level, so that a
+            different config packs its own file instead of failing to load.
+    """
+    directory = os.environ.get(SHARED_WEIGHTS_DIR_ENV)
+    if not directory:
+        return None
+    os.makedirs(directory, exist_ok=True)
+    key = json.dumps([_environment(), config], sort_keys=True, default=str)
+    digest = hashlib.sha256(key.encode()).hexdigest()[:16]
+    return os.path.join(directory, f"{name}-{digest}.ipexpack")
+
+
+def state_dict_digest(state_dict):
+    r"""Returns a digest of the names, shapes and dtypes of the tensors of
+    ``state_dict`` and of a strided sample of their values, cheap enough for
+    the state dict of an LLM. Tensors without data, e.g. on the meta device,
+    only add their names, shapes and dtypes.
+
+    Args:
+        state_dict (dict): the state dict, e.g. of a low precision checkpoint.
+    """
+    digest = hashlib.sha256()
+    for name, t in state_dict.items():
+        if not isinstance(t, torch.Tensor):
+            continue
+        digest.update(f"{name}:{t.dtype}:{list(t.shape)}".encode())
+        if t.device.type == "meta" or t.numel() == 0:
+            continue
+        flat = t.detach().reshape(-1)
+        sample = flat[:: max(1, flat.numel() // _DIGEST_SAMPLES)].contiguous()
+        digest.update(sample.view(torch.uint8).numpy().tobytes())
+    return digest.hexdigest()
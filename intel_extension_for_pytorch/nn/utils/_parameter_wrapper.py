@@ -19,6 +19,7 @@ from intel_extension_for_pytorch.nn.utils._weight_prepack import (
     _IPEXConvTranspose3d,
     _IPEXLinearAllreduce,
     _IPEXLmHeadLinearAllreduce,
+    _PlainLinear,
     may_import_deepspeed_modules,
 )
 
@@ -68,6 +69,7 @@ def IPEX_WEIGHT_CONVERT_MODULE_CPU(inference: bool, dtype: torch.bfloat16):
     from intel_extension_for_pytorch.nn.modules import (
         MergedEmbeddingBag,
         MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
     )
 
     module_convert_list_bf16_inference = [
@@ -76,9 +78,11 @@ def IPEX_WEIGHT_CONVERT_MODULE_CPU(inference: bool, dtype: torch.bfloat16):
         torch.nn.ConvTranspose2d,
         torch.nn.ConvTranspose3d,
         torch.nn.Linear,
+        _PlainLinear,
         torch.nn.Embedding,
         torch.nn.LSTM,
         MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
         torch.nn.ParameterList,
     ]
 
@@ -111,6 +115,7 @@ def IPEX_WEIGHT_CONVERT_MODULE_CPU(inference: bool, dtype: torch.bfloat16):
         torch.nn.ConvTranspose2d,
         torch.nn.ConvTranspose3d,
         torch.nn.Linear,
+        _PlainLinear,
         torch.nn.Embedding,
         MergedEmbeddingBagWithCat,
         torch.nn.ParameterList,
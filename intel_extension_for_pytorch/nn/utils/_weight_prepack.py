@@ -274,6 +274,15 @@ torch.library.define(
 )
 
 
+class _PlainLinear(nn.Linear):
+    r"""
+    nn.Linear whose weight is cast by ipex.optimize but kept in the plain
+    layout, for kernels that read the weight directly such as
+    torch.ops.torch_ipex.lm_head_topk. Only the exact nn.Linear class is
+    prepacked.
+    """
+
+
 class _IPEXLinear(_IPEXPrepackModule):
     def __init__(self):
         super(_IPEXLinear, self).__init__()
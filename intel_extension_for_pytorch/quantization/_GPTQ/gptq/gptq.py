@@ -732,6 +732,8 @@ class GPTQ:
         self.nsamples = 0
         self.quantizer = Quantizer()
         self.perm = None  # act_order choice
+        # Solve with torch_ipex::gptq_quantize when the quantizer allows it
+        self.use_native_solver = True
 
     def add_batch(self, inp, out):
         if len(inp.shape) == 2:
@@ -748,6 +750,17 @@ class GPTQ:
         inp = math.sqrt(2 / self.nsamples) * inp.float()
         self.H += inp.matmul(inp.t())  # H = X*X, which should be a sysm matrix
 
+    def _use_native_solver(self):
+        # torch_ipex::gptq_quantize covers the per-channel quantizers on CPU
+        return (
+            self.use_native_solver
+            and self.H.device.type == "cpu"
+            and self.quantizer.perchannel
+            and self.quantizer.maxq >= 0
+            and not self.quantizer.ready()
+            and not DEBUG
+        )
+
     def fasterquant(
         self,
         W,
@@ -766,6 +779,33 @@ class GPTQ:
 
         tick = time.time()
 
+        if self._use_native_solver():
+            Q, scale, zero, perm, loss = torch.ops.torch_ipex.gptq_quantize(
+                W,
+                self.H,
+                int(self.quantizer.maxq).bit_length(),
+                groupsize,
+                self.quantizer.sym,
+                act_order,
+                static_groups,
+                blocksize,
+                percdamp,
+                self.quantizer.mse,
+                self.quantizer.norm,
+                self.quantizer.grid,
+                self.quantizer.maxshrink,
+            )
+            del self.H
+            if act_order:
+                self.perm = perm
+            self.quantizer.scale = scale[:, -1:]
+            self.quantizer.zero = zero[:, -1:]
+            logger.info(f"time {(time.time() - tick)}")
+            logger.info(f"error {loss.item()}")
+            if isinstance(self.layer, transformers.Conv1D):
+                Q = Q.t()
+            return scale, zero, Q.reshape(weight_shape).to(weight_dtype)
+
         if not self.quantizer.ready():
             self.quantizer.find_params(W, weight=True)
 
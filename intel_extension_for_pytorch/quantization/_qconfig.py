@@ -59,7 +59,11 @@ def get_smooth_quant_qconfig_mapping(
     For SmoothQuant, see https://arxiv.org/pdf/2211.10438.pdf
 
     Args:
-        alpha: Hyper-parameter for SmoothQuant.
+        alpha: Hyper-parameter for SmoothQuant. A float, a list of
+            candidate alphas, or "auto" for the candidates 0.0, 0.05, ...,
+            1.0. With several candidates, the alpha of each nn.Linear is
+            searched from the calibration statistics, selecting the one
+            with the lowest estimated quantization error.
         act_observer: Observer for activation of ops other than nn.Linear.
             HistogramObserver by default. For nn.Linear with SmoothQuant
             enabled, q-param is calculated based on act_ic_observer's and
@@ -86,14 +90,14 @@ dtype=torch.qint8, qscheme=torch.per_channel_symmetric)``
     qconfig = QConfigSmoothQuant(
         activation=SmoothQuantActivationObserver.with_args(
             reduce_range=False,
-            alpha=float(alpha),
+            alpha=alpha,
             act_observer=act_observer,
             act_ic_observer=act_ic_observer,
         ),
         weight=SmoothQuantWeightObserver.with_args(
             dtype=torch.qint8,
             qscheme=torch.per_channel_symmetric,
-            alpha=float(alpha),
+            alpha=alpha,
             wei_observer=wei_observer,
             wei_ic_observer=wei_ic_observer,
         ),
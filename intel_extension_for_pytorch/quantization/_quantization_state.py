@@ -30,7 +30,10 @@ from ._smooth_quant import SmoothQuantActivationObserver, SmoothQuantWeightObser
 
 
 if has_cpu():
-    from intel_extension_for_pytorch.nn.modules import MergedEmbeddingBagWithCat
+    from intel_extension_for_pytorch.nn.modules import (
+        MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
+    )
 
 OpConvertInfo = Tuple[
     # quantized equivalent of original op (None means keep original)
@@ -311,7 +314,9 @@ class AutoQuantizationState(torch.nn.Module):
                         observer(op._flat_weights[i])
                     else:
                         pass
-                elif has_cpu() and isinstance(op, MergedEmbeddingBagWithCat):
+                elif has_cpu() and isinstance(
+                    op, (MergedEmbeddingBagWithCat, MergedEmbeddingBagWithInteraction)
+                ):
                     observer(op.weights[i])
                 else:
                     observer(op.weight)
@@ -531,7 +536,9 @@ class AutoQuantizationState(torch.nn.Module):
                 new_args.append(arg)
             else:
                 new_args.append(op.weight)
-        elif has_cpu() and isinstance(op, MergedEmbeddingBagWithCat):
+        elif has_cpu() and isinstance(
+            op, (MergedEmbeddingBagWithCat, MergedEmbeddingBagWithInteraction)
+        ):
             weights = op.weights
             for tensor_arg_idx in range(0, len(arg_quant_infos)):
                 quant_info = arg_quant_infos[tensor_arg_idx]
@@ -904,7 +911,12 @@ class AutoQuantizationState(torch.nn.Module):
             weight_idx = 0
             if type(op) in quantized_modules_has_weights:
                 if has_cpu() and isinstance(
-                    op, (torch.nn.LSTM, MergedEmbeddingBagWithCat)
+                    op,
+                    (
+                        torch.nn.LSTM,
+                        MergedEmbeddingBagWithCat,
+                        MergedEmbeddingBagWithInteraction,
+                    ),
                 ):
                     if isinstance(op, torch.nn.LSTM):
                         weights = op._flat_weights
@@ -1030,6 +1042,7 @@ class AutoQuantizationState(torch.nn.Module):
                 if seen_q_op_info.type in (
                     str(torch.nn.EmbeddingBag),
                     str(MergedEmbeddingBagWithCat),
+                    str(MergedEmbeddingBagWithInteraction),
                 ):
                     obs = qconfig.activation()
                     self.weight_tensor_id_to_observer[
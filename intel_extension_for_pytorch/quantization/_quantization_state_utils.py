@@ -57,6 +57,9 @@ if has_cpu():
     functions_supported_by_quantization_ipex.add(
         torch.ops.torch_ipex.merged_embeddingbag_cat_forward
     )
+    functions_supported_by_quantization_ipex.add(
+        torch.ops.torch_ipex.merged_embeddingbag_interaction_forward
+    )
 
 module_types_supported_by_quantization = set(
     [
@@ -84,9 +87,13 @@ module_types_supported_by_quantization = set(
     ]
 )
 if has_cpu():
-    from intel_extension_for_pytorch.nn.modules import MergedEmbeddingBagWithCat
+    from intel_extension_for_pytorch.nn.modules import (
+        MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
+    )
 
     module_types_supported_by_quantization.add(MergedEmbeddingBagWithCat)
+    module_types_supported_by_quantization.add(MergedEmbeddingBagWithInteraction)
 
 may_inplace_module = set(
     [
@@ -265,6 +272,7 @@ def get_input_observed_arg_idxs(
     if op_type_is_module and op_type not in (
         str(torch.nn.EmbeddingBag),
         str(MergedEmbeddingBagWithCat),
+        str(MergedEmbeddingBagWithInteraction),
     ):
         # TODO(future PR): handle RNNs
         return [0]
@@ -6,7 +6,10 @@ from intel_extension_for_pytorch.utils.utils import has_cpu
 from ._utils import ParentNode, set_node_output_quantized
 
 if has_cpu():
-    from intel_extension_for_pytorch.nn.modules import MergedEmbeddingBagWithCat
+    from intel_extension_for_pytorch.nn.modules import (
+        MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
+    )
 
 add_inplace_ops = [str(torch.Tensor.add_)]
 add_ops = [str(torch.add), str(torch.Tensor.add)]
@@ -81,6 +84,9 @@ if has_cpu():
     s8_s8_symmetric_ops.append(
         str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward)
     )
+    s8_s8_symmetric_ops.append(
+        str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward)
+    )
 
 conv_gemm_fs = [
     str(F.conv2d),
@@ -350,6 +356,7 @@ def _check_has_quantizable_node_before_node(node):
                     str(interaction),
                     str(torch.ops.torch_ipex.interaction_forward),
                     str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward),
+                    str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward),
                 ]:
                     for force_inf_dtype in node.input_tensor_force_inf_dtype:
                         if force_inf_dtype == torch.qint8:
@@ -543,9 +550,13 @@ def get_default_recipe(nodes):
 
     if has_cpu():
         embedding_bag_ops.append(str(MergedEmbeddingBagWithCat))
+        embedding_bag_ops.append(str(MergedEmbeddingBagWithInteraction))
         embedding_bag_ops.append(
             str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward)
         )
+        embedding_bag_ops.append(
+            str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward)
+        )
 
     for node in nodes:
         if isinstance(node, ParentNode):
@@ -6,6 +6,55 @@ from torch.ao.quantization import (
 )
 import copy
 
+# Candidate alphas of the per-layer search of alpha="auto"
+_AUTO_ALPHA_GRID = [round(0.05 * i, 2) for i in range(21)]
+
+
+def _alpha_candidates(alpha):
+    """
+    alpha is a float, a list of candidates to search per layer, or "auto"
+    to search the candidates of _AUTO_ALPHA_GRID.
+    """
+    if isinstance(alpha, str):
+        assert alpha == "auto", "SmoothQuant alpha should be a float or 'auto'"
+        return list(_AUTO_ALPHA_GRID)
+    if isinstance(alpha, (list, tuple)):
+        assert len(alpha) > 0, "SmoothQuant alpha candidates should not be empty"
+        return [float(a) for a in alpha]
+    return [float(alpha)]
+
+
+def _alphas_to_search(observer):
+    # A single alpha may have been overridden through observer.alpha
+    if len(observer.alpha_candidates) > 1:
+        return observer.alpha_candidates
+    return [observer.alpha]
+
+
+class PerICMinMaxObserver(PerChannelMinMaxObserver):
+    """
+    PerChannelMinMaxObserver whose running min/max along the last dim, i.e.
+    the input channels of a linear layer, are updated by the native kernel
+    in a single pass over the input instead of permuting and flattening it.
+    Falls back to PerChannelMinMaxObserver for other channel axes and dtypes.
+    """
+
+    def forward(self, x_orig):
+        if (
+            x_orig.numel() == 0
+            or x_orig.device.type != "cpu"
+            or x_orig.dtype not in [torch.float, torch.bfloat16, torch.half]
+            or self.ch_axis not in [-1, x_orig.dim() - 1]
+            or self.min_val.dtype != torch.float
+        ):
+            return super().forward(x_orig)
+        x = x_orig.detach()
+        if self.min_val.numel() == 0:
+            self.min_val.resize_(x.size(-1)).fill_(float("inf"))
+            self.max_val.resize_(x.size(-1)).fill_(float("-inf"))
+        torch.ops.torch_ipex.smooth_quant_observe(x, self.min_val, self.max_val)
+        return x_orig
+
 
 class SmoothQuantActivationObserver(UniformQuantizationObserverBase):
     """
@@ -17,6 +66,9 @@ class SmoothQuantActivationObserver(UniformQuantizationObserverBase):
     2. Get max(|W_j|) for each IC in weight from the weight observer
     3. Calculate scaling factors for each IC by s_j = (max(|W_j|) ** (1 - alpha)) / (max(|X_j|) ** alpha)
         Note that factors for activation are reciprocals of that for weight
+        If alpha is "auto" or a list of candidates, the candidate with the
+        lowest estimated quantization error is selected per layer from the
+        statistics above, see torch.ops.torch_ipex.smooth_quant_scaling_factors
     4. Apply s_j to activation
     5. Find q-params per tensor and return
 
@@ -49,7 +101,7 @@ class SmoothQuantActivationObserver(UniformQuantizationObserverBase):
         )
         self.weight_obs = None
         if act_ic_observer is None:
-            self.ic_obs = PerChannelMinMaxObserver(
+            self.ic_obs = PerICMinMaxObserver(
                 ch_axis=-1,
                 dtype=dtype,
                 qscheme=torch.per_channel_affine,
@@ -76,7 +128,11 @@ class SmoothQuantActivationObserver(UniformQuantizationObserverBase):
         # if smooth_quant_enabled is false, this observer acts as
         # a normal per-tensor observer
         self.smooth_quant_enabled = smooth_quant_enabled
-        self.alpha = float(alpha)
+        self.alpha_candidates = _alpha_candidates(alpha)
+        # The selected alpha once q-params are calculated
+        self.alpha = (
+            self.alpha_candidates[0] if len(self.alpha_candidates) == 1 else 0.5
+        )
         # Normally we don't use min_val or max_val here
         # They are for checks, like `_check_observer_has_run`
         self.min_val = self.act_obs.min_val
@@ -98,20 +154,19 @@ class SmoothQuantActivationObserver(UniformQuantizationObserverBase):
             return self.act_obs.calculate_qparams()
         scales, zero_points = {}, {}
         for k in self.weight_obs.keys():
-            # Get weight per IC min/max from weight observer
-            wei_min_per_ic = self.weight_obs[k].min_val
-            wei_max_per_ic = self.weight_obs[k].max_val
             act_min_per_ic = self.ic_obs.min_val
             act_max_per_ic = self.ic_obs.max_val
-            x_abs_max_per_ic = (
-                torch.max(torch.abs(act_min_per_ic), torch.abs(act_max_per_ic)) + 1e-6
-            )
-            w_abs_max_per_ic = (
-                torch.max(torch.abs(wei_min_per_ic), torch.abs(wei_max_per_ic)) + 1e-6
-            )
             # Note: activation's scaling factors are reciprocals of weight's
-            scaling_factor = torch.pow(w_abs_max_per_ic, 1 - self.alpha) / torch.pow(
-                x_abs_max_per_ic, self.alpha
+            # The weight observer selects the same alpha from the same
+            # per IC min/max.
+            scaling_factor, _, self.alpha = (
+                torch.ops.torch_ipex.smooth_quant_scaling_factors(
+                    act_min_per_ic,
+                    act_max_per_ic,
+                    self.weight_obs[k].min_val,
+                    self.weight_obs[k].max_val,
+                    _alphas_to_search(self),
+                )
             )
             self.scaling_factors.update({k: scaling_factor})
             # Apply scaling factors to each IC's min/max
@@ -149,6 +204,7 @@ class SmoothQuantWeightObserver(UniformQuantizationObserverBase):
     2. Get max(|X_j|) for each IC in activation from the activation observer
     3. Calculate scaling factors for each IC by s_j = (max(|X_j|) ** alpha) / (max(|W_j|) ** (1 - alpha))
         Note that factors for weight are reciprocals of that for activation
+        alpha is selected per layer as by the activation observer
     4. Apply s_j to weight
     5. Find q-params per OC and return
 
@@ -199,7 +255,7 @@ class SmoothQuantWeightObserver(UniformQuantizationObserverBase):
         else:
             self.oc_obs = wei_observer()
         if wei_ic_observer is None:
-            self.ic_obs = PerChannelMinMaxObserver(
+            self.ic_obs = PerICMinMaxObserver(
                 ch_axis=1,
                 dtype=dtype,
                 qscheme=torch.per_channel_affine,
@@ -214,7 +270,11 @@ class SmoothQuantWeightObserver(UniformQuantizationObserverBase):
         # if smooth_quant_enabled is false, this observer acts as
         # a normal observer
         self.smooth_quant_enabled = smooth_quant_enabled
-        self.alpha = float(alpha)
+        self.alpha_candidates = _alpha_candidates(alpha)
+        # The selected alpha once q-params are calculated
+        self.alpha = (
+            self.alpha_candidates[0] if len(self.alpha_candidates) == 1 else 0.5
+        )
         # Normally we don't use min_val or max_val here
         # They are for checks, like `_check_observer_has_run`
         self.min_val = self.oc_obs.min_val
@@ -223,6 +283,12 @@ class SmoothQuantWeightObserver(UniformQuantizationObserverBase):
     def forward(self, x_orig):
         if not self.smooth_quant_enabled:
             return self.oc_obs.forward(x_orig)
+        # The weight is the same for every calibration batch, only copy and
+        # observe it again if it has changed
+        observed = (x_orig.data_ptr(), x_orig._version, x_orig.shape)
+        if getattr(self, "_observed_weight", None) == observed:
+            return x_orig
+        self._observed_weight = observed
         # Copy original weight to apply scaling factor
         self.w_orig = copy.deepcopy(x_orig)
         # Call per-channel observer on IC to find scaling factor
@@ -233,19 +299,15 @@ class SmoothQuantWeightObserver(UniformQuantizationObserverBase):
         if not self.smooth_quant_enabled:
             return self.oc_obs.calculate_qparams()
         # Get activation min/max per IC from activation observer
-        act_min_per_ic = self.act_obs.min_val
-        act_max_per_ic = self.act_obs.max_val
-        wei_min_per_ic = self.ic_obs.min_val
-        wei_max_per_ic = self.ic_obs.max_val
-        w_abs_max_per_ic = (
-            torch.max(torch.abs(wei_min_per_ic), torch.abs(wei_max_per_ic)) + 1e-6
-        )
-        x_abs_max_per_ic = (
-            torch.max(torch.abs(act_min_per_ic), torch.abs(act_max_per_ic)) + 1e-6
-        )
         # Note: weight's scaling factors are reciprocals of activation's
-        self.scaling_factors = torch.pow(x_abs_max_per_ic, self.alpha) / torch.pow(
-            w_abs_max_per_ic, 1 - self.alpha
+        _, self.scaling_factors, self.alpha = (
+            torch.ops.torch_ipex.smooth_quant_scaling_factors(
+                self.act_obs.min_val,
+                self.act_obs.max_val,
+                self.ic_obs.min_val,
+                self.ic_obs.max_val,
+                _alphas_to_search(self),
+            )
         )
 
         # Apply scaling factors to original weight
@@ -13,7 +13,11 @@ from torch.quantization.qconfig import QConfig
 from intel_extension_for_pytorch.nn.functional import interaction
 
 from ._quantization_state_utils import QTensorInfo
-from ._smooth_quant import SmoothQuantActivationObserver, SmoothQuantWeightObserver
+from ._smooth_quant import (
+    PerICMinMaxObserver,
+    SmoothQuantActivationObserver,
+    SmoothQuantWeightObserver,
+)
 from ._qconfig import QConfigSmoothQuant
 from intel_extension_for_pytorch.utils.utils import has_cpu
 
@@ -38,9 +42,13 @@ quantized_modules_has_weights = set(
 )
 
 if has_cpu():
-    from intel_extension_for_pytorch.nn.modules import MergedEmbeddingBagWithCat
+    from intel_extension_for_pytorch.nn.modules import (
+        MergedEmbeddingBagWithCat,
+        MergedEmbeddingBagWithInteraction,
+    )
 
     quantized_modules_has_weights.add(MergedEmbeddingBagWithCat)
+    quantized_modules_has_weights.add(MergedEmbeddingBagWithInteraction)
 
 # those ops only support int8->int8, not int8->fp32/bf16
 int8_int8_ops = set(
@@ -84,6 +92,8 @@ int8_int8_ops = set(
 if has_cpu():
     int8_int8_ops.add(str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward))
     int8_int8_ops.add(str(MergedEmbeddingBagWithCat))
+    int8_int8_ops.add(str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward))
+    int8_int8_ops.add(str(MergedEmbeddingBagWithInteraction))
 
 
 class OpQuantizeabilityType(enum.Enum):
@@ -478,16 +488,21 @@ def _check_after_nodes_all_quantized_give_node(node):
                     str(interaction),
                     str(torch.ops.torch_ipex.interaction_forward),
                     str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward),
+                    str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward),
                     str(torch.embedding_bag),
                     str(F.embedding_bag),
                     str(torch.nn.EmbeddingBag),
                     str(MergedEmbeddingBagWithCat),
+                    str(MergedEmbeddingBagWithInteraction),
                 ]
                 if next.type in int8_int8_symmetric_ops:
                     if next.type in [
                         str(interaction),
                         str(torch.ops.torch_ipex.interaction_forward),
                         str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward),
+                        str(
+                            torch.ops.torch_ipex.merged_embeddingbag_interaction_forward
+                        ),
                     ]:
                         # node.input_tensor_infos may be set, we can use force_inf_dtype to check whether this op is quantizabled.
                         for force_inf_dtype in next.input_tensor_force_inf_dtype:
@@ -535,6 +550,7 @@ def set_node_output_quantized(nodes):
             if node.type in (
                 str(torch.nn.EmbeddingBag),
                 str(MergedEmbeddingBagWithCat),
+                str(MergedEmbeddingBagWithInteraction),
             ):
                 if (
                     node.weight_tensor_infos[0].inf_dtype == torch.qint8
@@ -555,6 +571,7 @@ def set_node_output_quantized(nodes):
                 str(interaction),
                 str(torch.ops.torch_ipex.interaction_forward),
                 str(torch.ops.torch_ipex.merged_embeddingbag_cat_forward),
+                str(torch.ops.torch_ipex.merged_embeddingbag_interaction_forward),
             ]:
                 if (
                     node.input_tensor_force_inf_dtype[0] == torch.qint8
@@ -608,6 +625,7 @@ dtype_dict = {
 }
 
 IPEX_OBSERVERS = {
+    "PerICMinMaxObserver": PerICMinMaxObserver,
     "SmoothQuantActivationObserver": SmoothQuantActivationObserver,
     "SmoothQuantWeightObserver": SmoothQuantWeightObserver,
 }
@@ -1275,6 +1293,10 @@ def module_call_to_function_call(module, args, weights):
         output = torch.ops.torch_ipex.merged_embeddingbag_cat_forward(
             weights, args[0], args[1], args[2]
         )
+    elif isinstance(module, MergedEmbeddingBagWithInteraction):
+        output = torch.ops.torch_ipex.merged_embeddingbag_interaction_forward(
+            weights, args[0], args[1], args[2]
+        )
     elif isinstance(module, torch.nn.ConvTranspose2d) or isinstance(
         module, torch.nn.ConvTranspose3d
     ):
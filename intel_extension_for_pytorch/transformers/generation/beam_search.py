@@ -1,6 +1,8 @@
 import torch
 from torch import nn
 import torch.distributed as dist
+import transformers
+from packaging import version
 from ...utils._logger import logger, WarningType
 from typing import Optional, Union, List
 from transformers.generation.stopping_criteria import (
@@ -8,17 +10,135 @@ from transformers.generation.stopping_criteria import (
     validate_stopping_criteria,
 )
 from transformers.generation.logits_process import LogitsProcessorList
-from transformers.generation.beam_search import BeamScorer
+from transformers.generation.beam_search import BeamScorer, BeamSearchScorer
 import time
+from .utils import _get_lm_head_for_topk, _output_hidden_states
 from transformers.generation.utils import (
     BeamSearchEncoderDecoderOutput,
     BeamSearchDecoderOnlyOutput,
 )
 
-
 BeamSearchOutput = Union[BeamSearchEncoderDecoderOutput, BeamSearchDecoderOnlyOutput]
 
 
+class _NativeBeamSearch:
+    """
+    Runs the top-k over the beams and the hypothesis bookkeeping of a
+    BeamSearchScorer with torch.ops.torch_ipex.beam_search_step. The finished
+    hypotheses are kept in tensors and handed back to the scorer before
+    finalize. The sequences live in two preallocated buffers, every step
+    writes the reordered sequences of one to the other, input_ids is a view
+    of the current one.
+    """
+
+    def __init__(self, beam_scorer, input_ids, max_length, pad_token_id, eos_token_id):
+        batch_beam_size, self.cur_len = input_ids.shape
+        batch_size = len(beam_scorer._beam_hyps)
+        num_beams = beam_scorer.num_beams
+        max_length = max(max_length, self.cur_len + 1)
+        self.buffers = [
+            input_ids.new_empty(batch_beam_size, max_length) for _ in range(2)
+        ]
+        self.buffers[0][:, : self.cur_len] = input_ids
+        self.hyp_scores = torch.zeros(batch_size, num_beams, dtype=torch.double)
+        self.hyp_tokens = input_ids.new_zeros(batch_size, num_beams, max_length)
+        self.hyp_lens = input_ids.new_zeros(batch_size, num_beams)
+        self.worst_scores = torch.tensor(
+            [hyps.worst_score for hyps in beam_scorer._beam_hyps], dtype=torch.double
+        )
+        self.done = beam_scorer._done
+        self.eos_token_id = [int(t) for t in eos_token_id or []]
+        self.pad_token_id = pad_token_id if pad_token_id is not None else 0
+        hyps = beam_scorer._beam_hyps[0]
+        self.length_penalty = float(hyps.length_penalty)
+        self.early_stopping = (
+            str(hyps.early_stopping).lower()
+            if isinstance(hyps.early_stopping, bool)
+            else "never"
+        )
+        self.max_length = hyps.max_length if hyps.max_length is not None else 0
+
+    @staticmethod
+    def create(
+        model,
+        beam_scorer,
+        input_ids,
+        stopping_criteria,
+        pad_token_id,
+        eos_token_id,
+        output_scores,
+    ):
+        """
+        Returns None when the step can not be run natively: the scores and
+        beam indices are requested, the scorer is not a plain single group
+        BeamSearchScorer or there is no max length to size the buffers with.
+        The kernel normalizes the hypothesis scores by cur_len + 1 like the
+        BeamHypotheses of transformers 4.36 on, older versions use cur_len.
+        """
+        if (
+            version.parse(transformers.__version__) < version.parse("4.36.0")
+            or output_scores
+            or type(beam_scorer) is not BeamSearchScorer
+            or beam_scorer.num_beam_groups != 1
+            or not isinstance(beam_scorer._done, torch.Tensor)
+            or stopping_criteria.max_length is None
+            or input_ids.device.type != "cpu"
+            or model.dtype not in [torch.float, torch.bfloat16, torch.half]
+            or (eos_token_id is not None and pad_token_id is None)
+        ):
+            return None
+        return _NativeBeamSearch(
+            beam_scorer,
+            input_ids,
+            stopping_criteria.max_length,
+            pad_token_id,
+            eos_token_id,
+        )
+
+    @property
+    def input_ids(self):
+        return self.buffers[0][:, : self.cur_len]
+
+    def step(self, next_token_scores, beam_scores):
+        """
+        Takes the processed scores of the next token and updates beam_scores
+        in place, returns the next tokens and beam indices.
+        """
+        next_tokens, beam_idx = torch.ops.torch_ipex.beam_search_step(
+            next_token_scores,
+            beam_scores,
+            self.buffers[0],
+            self.buffers[1],
+            self.cur_len,
+            self.hyp_scores,
+            self.hyp_tokens,
+            self.hyp_lens,
+            self.worst_scores,
+            self.done,
+            self.eos_token_id,
+            self.pad_token_id,
+            self.length_penalty,
+            self.early_stopping,
+            self.max_length,
+        )
+        self.buffers.reverse()
+        self.cur_len += 1
+        return next_tokens, beam_idx
+
+    def update_scorer(self, beam_scorer):
+        for batch_idx, hyps in enumerate(beam_scorer._beam_hyps):
+            hyps.beams = [
+                (score, tokens[:length].clone(), None)
+                for score, tokens, length in zip(
+                    self.hyp_scores[batch_idx].tolist(),
+                    self.hyp_tokens[batch_idx],
+                    self.hyp_lens[batch_idx].tolist(),
+                )
+                if length > 0
+            ]
+            hyps.worst_score = self.worst_scores[batch_idx].item()
+
+
 def _beam_search(
     self,
     input_ids: torch.LongTensor,
@@ -154,6 +274,26 @@ def _beam_search(
     )
     beam_scores[:, 1:] = -1e9
     beam_scores = beam_scores.view((batch_size * num_beams,))
+    # select the next tokens from the top-k of a sharded LM head if the full
+    # logits are not needed, otherwise from the full scores in C++ if possible
+    tp_lm_head = _get_lm_head_for_topk(
+        self, logits_processor, return_dict_in_generate and output_scores
+    )
+    native_beam_search = (
+        _NativeBeamSearch.create(
+            self,
+            beam_scorer,
+            input_ids,
+            stopping_criteria,
+            pad_token_id,
+            eos_token_id,
+            return_dict_in_generate and output_scores,
+        )
+        if tp_lm_head is None
+        else None
+    )
+    if native_beam_search is not None:
+        input_ids = native_beam_search.input_ids
     this_peer_finished = False  # used by synced_gpus only
     while True:
         tic = time.time()
@@ -433,12 +573,13 @@ def _beam_search(
                 else:
                     outputs = self.trace_graph(**model_inputs)
             else:
-                outputs = self(
-                    **model_inputs,
-                    return_dict=True,
-                    output_attentions=output_attentions,
-                    output_hidden_states=output_hidden_states,
-                )
+                with _output_hidden_states(tp_lm_head):
+                    outputs = self(
+                        **model_inputs,
+                        return_dict=True,
+                        output_attentions=output_attentions,
+                        output_hidden_states=output_hidden_states,
+                    )
             if (
                 first_token
                 and self.model_backbone != "YuanForCausalLM"
@@ -452,12 +593,13 @@ def _beam_search(
                     outputs[0] = outputs[0].repeat_interleave(num_beams, dim=0)
                     outputs = tuple(outputs)
         else:
-            outputs = self(
-                **model_inputs,
-                return_dict=True,
-                output_attentions=output_attentions,
-                output_hidden_states=output_hidden_states,
-            )
+            with _output_hidden_states(tp_lm_head):
+                outputs = self(
+                    **model_inputs,
+                    return_dict=True,
+                    output_attentions=output_attentions,
+                    output_hidden_states=output_hidden_states,
+                )
         if synced_gpus and this_peer_finished:
             cur_len = cur_len + 1
             continue  # don't waste resources running the code we don't need
@@ -466,14 +608,16 @@ def _beam_search(
         else:
             next_token_logits = outputs[0][:, -1, :]
 
-        next_token_scores = nn.functional.log_softmax(
-            next_token_logits, dim=-1
-        )  # (batch_size * num_beams, vocab_size)
+        if tp_lm_head is None:
+            next_token_scores = nn.functional.log_softmax(
+                next_token_logits, dim=-1
+            )  # (batch_size * num_beams, vocab_size)
 
-        next_token_scores_processed = logits_processor(input_ids, next_token_scores)
-        next_token_scores = next_token_scores_processed + beam_scores[
-            :, None
-        ].expand_as(next_token_scores)
+            next_token_scores_processed = logits_processor(input_ids, next_token_scores)
+            if native_beam_search is None:
+                next_token_scores = next_token_scores_processed + beam_scores[
+                    :, None
+                ].expand_as(next_token_scores)
 
         # Store scores, attentions and hidden_states when required
         if return_dict_in_generate:
@@ -495,36 +639,66 @@ def _beam_search(
                     else (outputs.hidden_states,)
                 )
 
-        # reshape for beam search
-        vocab_size = next_token_scores.shape[-1]
-        next_token_scores = next_token_scores.view(batch_size, num_beams * vocab_size)
+        if native_beam_search is not None:
+            # beam_scores is updated in place
+            beam_next_tokens, beam_idx = native_beam_search.step(
+                next_token_scores_processed, beam_scores
+            )
+            input_ids = native_beam_search.input_ids
+            next_tokens, next_indices = beam_next_tokens, beam_idx
+        elif tp_lm_head is not None:
+            # The model returned the hidden states of the last token. The
+            # 2 * num_beams best candidates of a batch are among the 2 *
+            # num_beams best tokens of each of its beams, so only those are
+            # exchanged.
+            num_candidates = 2 * num_beams
+            candidate_scores, candidate_tokens = tp_lm_head.topk(
+                next_token_logits, num_candidates, log_probs=True
+            )
+            candidate_scores = candidate_scores + beam_scores[:, None]
+            next_token_scores, candidates = torch.topk(
+                candidate_scores.view(batch_size, num_beams * num_candidates),
+                num_candidates,
+                dim=1,
+                largest=True,
+                sorted=True,
+            )
+            next_indices = torch.div(candidates, num_candidates, rounding_mode="floor")
+            next_tokens = candidate_tokens.view(batch_size, -1).gather(1, candidates)
+        else:
+            # reshape for beam search
+            vocab_size = next_token_scores.shape[-1]
+            next_token_scores = next_token_scores.view(
+                batch_size, num_beams * vocab_size
+            )
 
-        # Sample 2 next tokens for each beam (so we have some spare tokens and match output of beam search)
-        next_token_scores, next_tokens = torch.topk(
-            next_token_scores, 2 * num_beams, dim=1, largest=True, sorted=True
-        )
+            # Sample 2 next tokens for each beam (so we have some spare tokens and match output of beam search)
+            next_token_scores, next_tokens = torch.topk(
+                next_token_scores, 2 * num_beams, dim=1, largest=True, sorted=True
+            )
 
-        next_indices = torch.div(next_tokens, vocab_size, rounding_mode="floor")
-        next_tokens = next_tokens % vocab_size
+            next_indices = torch.div(next_tokens, vocab_size, rounding_mode="floor")
+            next_tokens = next_tokens % vocab_size
 
-        # stateless
-        beam_outputs = beam_scorer.process(
-            input_ids,
-            next_token_scores,
-            next_tokens,
-            next_indices,
-            pad_token_id=pad_token_id,
-            eos_token_id=eos_token_id,
-            beam_indices=beam_indices,
-        )
+        if native_beam_search is None:
+            # stateless
+            beam_outputs = beam_scorer.process(
+                input_ids,
+                next_token_scores,
+                next_tokens,
+                next_indices,
+                pad_token_id=pad_token_id,
+                eos_token_id=eos_token_id,
+                beam_indices=beam_indices,
+            )
 
-        beam_scores = beam_outputs["next_beam_scores"]
-        beam_next_tokens = beam_outputs["next_beam_tokens"]
-        beam_idx = beam_outputs["next_beam_indices"]
+            beam_scores = beam_outputs["next_beam_scores"]
+            beam_next_tokens = beam_outputs["next_beam_tokens"]
+            beam_idx = beam_outputs["next_beam_indices"]
 
-        input_ids = torch.cat(
-            [input_ids[beam_idx, :], beam_next_tokens.unsqueeze(-1)], dim=-1
-        )
+            input_ids = torch.cat(
+                [input_ids[beam_idx, :], beam_next_tokens.unsqueeze(-1)], dim=-1
+            )
 
         model_kwargs = self._update_model_kwargs_for_generation(
             outputs, model_kwargs, is_encoder_decoder=self.config.is_encoder_decoder
@@ -555,6 +729,8 @@ def _beam_search(
             else:
                 this_peer_finished = True
 
+    if native_beam_search is not None:
+        native_beam_search.update_scorer(beam_scorer)
     sequence_outputs = beam_scorer.finalize(
         input_ids,
         beam_scores,
@@ -9,6 +9,7 @@ from transformers.generation.stopping_criteria import (
 from transformers.generation.logits_process import LogitsProcessorList
 from transformers.generation.streamers import BaseStreamer
 import time
+from .utils import _get_lm_head_for_topk, _output_hidden_states
 from transformers.generation.utils import (
     GreedySearchDecoderOnlyOutput,
     GreedySearchEncoderDecoderOutput,
@@ -92,6 +93,12 @@ def _greedy_search(
         else self.generation_config.return_dict_in_generate
     )
 
+    # select the next tokens from the top-k of a sharded LM head if the full
+    # logits are not needed
+    tp_lm_head = _get_lm_head_for_topk(
+        self, logits_processor, return_dict_in_generate and output_scores
+    )
+
     # init attention / hidden states / scores tuples
     scores = () if (return_dict_in_generate and output_scores) else None
     decoder_attentions = () if (return_dict_in_generate and output_attentions) else None
@@ -372,19 +379,21 @@ def _greedy_search(
                 else:
                     outputs = self.trace_graph(**model_inputs)
             else:
+                with _output_hidden_states(tp_lm_head):
+                    outputs = self(
+                        **model_inputs,
+                        return_dict=True,
+                        output_attentions=output_attentions,
+                        output_hidden_states=output_hidden_states,
+                    )
+        else:
+            with _output_hidden_states(tp_lm_head):
                 outputs = self(
                     **model_inputs,
                     return_dict=True,
                     output_attentions=output_attentions,
                     output_hidden_states=output_hidden_states,
                 )
-        else:
-            outputs = self(
-                **model_inputs,
-                return_dict=True,
-                output_attentions=output_attentions,
-                output_hidden_states=output_hidden_states,
-            )
 
         if synced_gpus and this_peer_finished:
             continue  # don't waste resources running the code we don't need
@@ -393,8 +402,15 @@ def _greedy_search(
         else:
             next_token_logits = outputs[0][:, -1, :]
 
-        # pre-process distribution
-        next_tokens_scores = logits_processor(input_ids, next_token_logits)
+        if tp_lm_head is not None:
+            # The model returned the hidden states of the last token, only the
+            # argmax of every rank is exchanged.
+            next_tokens = tp_lm_head.topk(next_token_logits)[1].squeeze(-1)
+        else:
+            # pre-process distribution
+            next_tokens_scores = logits_processor(input_ids, next_token_logits)
+            # argmax
+            next_tokens = torch.argmax(next_tokens_scores, dim=-1)
 
         # Store scores, attentions and hidden_states when required
         if return_dict_in_generate:
@@ -416,9 +432,6 @@ def _greedy_search(
                     else (outputs.hidden_states,)
                 )
 
-        # argmax
-        next_tokens = torch.argmax(next_tokens_scores, dim=-1)
-
         # finished sentences should have their next token be a padding token
         if eos_token_id is not None:
             if pad_token_id is None:
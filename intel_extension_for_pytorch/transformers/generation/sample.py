@@ -10,6 +10,8 @@ from transformers.generation.stopping_criteria import (
 from transformers.generation.logits_process import LogitsProcessorList
 from transformers.generation.streamers import BaseStreamer
 import time
+import os
+from .utils import _get_fused_sample_params
 from transformers.generation.utils import (
     SampleEncoderDecoderOutput,
     SampleDecoderOnlyOutput,
@@ -90,6 +92,15 @@ def _sample(
     logits_warper = (
         logits_warper if logits_warper is not None else LogitsProcessorList()
     )
+    # The fused sampler only takes its per-row seeds from the torch global
+    # generator, so it is opt-in: the sampled sequences are reproducible but
+    # differ from the ones of torch.multinomial for the same manual_seed.
+    fused_sample_params = (
+        _get_fused_sample_params(logits_processor, logits_warper)
+        if os.getenv("IPEX_FUSED_SAMPLE", "0") == "1"
+        and input_ids.device.type == "cpu"
+        else None
+    )
     if isinstance(eos_token_id, int):
         eos_token_id = [eos_token_id]
     eos_token_id_tensor = (
@@ -421,9 +432,18 @@ def _sample(
         else:
             next_token_logits = outputs[0][:, -1, :]
 
-        # pre-process distribution
-        next_token_scores = logits_processor(input_ids, next_token_logits)
-        next_token_scores = logits_warper(input_ids, next_token_scores)
+        # pre-process distribution and sample in one pass over the vocab if
+        # the processed scores are not returned
+        if fused_sample_params is not None and not (
+            return_dict_in_generate and output_scores
+        ):
+            next_tokens = torch.ops.torch_ipex.fused_sample(
+                next_token_logits, input_ids, seeds=None, **fused_sample_params
+            )
+        else:
+            next_tokens = None
+            next_token_scores = logits_processor(input_ids, next_token_logits)
+            next_token_scores = logits_warper(input_ids, next_token_scores)
 
         # Store scores, attentions and hidden_states when required
         if return_dict_in_generate:
@@ -446,8 +466,9 @@ def _sample(
                 )
 
         # sample
-        probs = nn.functional.softmax(next_token_scores, dim=-1)
-        next_tokens = torch.multinomial(probs, num_samples=1).squeeze(1)
+        if next_tokens is None:
+            probs = nn.functional.softmax(next_token_scores, dim=-1)
+            next_tokens = torch.multinomial(probs, num_samples=1).squeeze(1)
 
         # finished sentences should have their next token be a padding token
         if eos_token_id is not None:
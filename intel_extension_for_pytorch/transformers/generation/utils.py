@@ -1,3 +1,4 @@
+import contextlib
 import transformers.generation
 from transformers.utils import ModelOutput
 import transformers
@@ -122,6 +123,85 @@ def _get_attr_from_logit_processors(
     return None
 
 
+def _get_fused_sample_params(logits_processor, logits_warper):
+    """
+    Returns the arguments of torch.ops.torch_ipex.fused_sample equivalent to
+    logits_processor and logits_warper, or None if any of them can not be
+    expressed by the fused kernel.
+    """
+    logits_process = transformers.generation.logits_process
+    supported = (
+        logits_process.RepetitionPenaltyLogitsProcessor,
+        logits_process.TemperatureLogitsWarper,
+        logits_process.TopKLogitsWarper,
+        logits_process.TopPLogitsWarper,
+    )
+    processors = list(logits_processor or []) + list(logits_warper or [])
+    for processor in processors:
+        if type(processor) not in supported:
+            return None
+        if getattr(processor, "min_tokens_to_keep", 1) != 1:
+            return None
+    if any(
+        isinstance(processor, logits_process.RepetitionPenaltyLogitsProcessor)
+        for processor in logits_warper or []
+    ):
+        # The penalty is only applied before the warpers.
+        return None
+    temperature = _get_attr_from_logit_processors(
+        processors, logits_process.TemperatureLogitsWarper, "temperature"
+    )
+    repetition_penalty = _get_attr_from_logit_processors(
+        processors, logits_process.RepetitionPenaltyLogitsProcessor, "penalty"
+    )
+    top_k = _get_attr_from_logit_processors(
+        processors, logits_process.TopKLogitsWarper, "top_k"
+    )
+    top_p = _get_attr_from_logit_processors(
+        processors, logits_process.TopPLogitsWarper, "top_p"
+    )
+    return {
+        "temperature": float(temperature) if temperature is not None else 1.0,
+        "repetition_penalty": (
+            float(repetition_penalty) if repetition_penalty is not None else 1.0
+        ),
+        "presence_penalty": 0.0,
+        "top_k": int(top_k) if top_k is not None else 0,
+        "top_p": float(top_p) if top_p is not None else 1.0,
+    }
+
+
+def _get_lm_head_for_topk(model, logits_processor, output_scores):
+    """
+    Returns the column sharded (or single rank) tensor parallel LM head of
+    model if the next tokens can be selected from its top-k candidates, i.e.
+    the full logits are neither processed nor returned, or None. Traced
+    models keep the gathered logits.
+    """
+    if output_scores or len(logits_processor or []) > 0:
+        return None
+    if hasattr(model, "trace_graph"):
+        return None
+    from ..tensor_parallel import TensorParallelLMhead
+
+    lm_head = next(
+        (m for m in model.modules() if isinstance(m, TensorParallelLMhead)), None
+    )
+    if lm_head is None or not lm_head.fused_topk:
+        return None
+    return lm_head
+
+
+def _output_hidden_states(lm_head):
+    """
+    Context in which the model outputs the hidden states of lm_head instead of
+    the logits, see _get_lm_head_for_topk.
+    """
+    if lm_head is None:
+        return contextlib.nullcontext()
+    return lm_head.output_hidden_states()
+
+
 def _pad_to_max_length(
     current_segments,
     pad_token_id,
@@ -304,6 +304,7 @@ class _IPEXConcatLinearCPU(_IPEXlinearFusionCPU):
         self.tpp = tpp
         use_g_idx = False
         from intel_extension_for_pytorch.nn.modules import WeightOnlyQuantizedLinear
+        from intel_extension_for_pytorch.nn.utils import _packed_checkpoint
 
         if woq:
             for i in range(self.num_concat):
@@ -362,17 +363,21 @@ class _IPEXConcatLinearCPU(_IPEXlinearFusionCPU):
                     )
                     weights_list = []
                     break
-                qw = linear._op_context.to_public(linear._op_context.get_weight())
                 scales = linear._op_context.get_scales()
                 zero_points = linear._op_context.get_zero_points()
                 weight_shape = linear._op_context.get_weight_shape()
-                if group_size > 0:
+                if _packed_checkpoint.is_loading():
+                    # The concat linear is read from the packed checkpoint
+                    weights_list.append(torch.empty(weight_shape, device="meta"))
+                elif group_size > 0:
+                    qw = linear._op_context.to_public(linear._op_context.get_weight())
                     weights_list.append(
                         dequantize_per_block(
                             qw, scales, zero_points, w_dtype, group_size, weight_shape
                         )
                     )
                 else:
+                    qw = linear._op_context.to_public(linear._op_context.get_weight())
                     weights_list.append(
                         dequantize_per_channel(
                             qw, scales, zero_points, w_dtype, weight_shape
@@ -407,7 +412,10 @@ class _IPEXConcatLinearCPU(_IPEXlinearFusionCPU):
                 use_bias = all([b is not None for b in bias_list])
                 concat_bias = torch.concat(bias_list, 0) if use_bias else None
                 mod = nn.Linear(
-                    concat_weight.shape[1], concat_weight.shape[0], use_bias
+                    concat_weight.shape[1],
+                    concat_weight.shape[0],
+                    use_bias,
+                    device=concat_weight.device,
                 )
                 mod.weight = nn.Parameter(concat_weight)
                 mod.bias = nn.Parameter(concat_bias) if use_bias else None
@@ -415,6 +423,8 @@ class _IPEXConcatLinearCPU(_IPEXlinearFusionCPU):
                 self.concat_linear = WeightOnlyQuantizedLinear.from_float(
                     mod, concat_scales, concat_zeros
                 )
+                for linear in self.linear_list:
+                    _packed_checkpoint.drop_weight(linear)
         elif hasattr(module, "concat_linear") and module.concat_linear is not None:
             self.concat_linear = module.concat_linear
         else:
@@ -1,5 +1,6 @@
 import torch
 import copy
+import os
 import re
 import warnings
 from ..utils._logger import logger, WarningType
@@ -25,6 +26,7 @@ from .tensor_parallel import (
     shard_mha_weights,
     shard_mlp_weights,
     update_heads_info,
+    TensorParallelLMhead,
 )
 
 
@@ -1369,6 +1371,37 @@ def attach_extra_weight_for_large_batch_inference(model):
     return _convert(model, "")
 
 
+def keep_lm_head_plain_for_topk(_model):
+    r"""
+    Keeps the weight of the LM head in the plain layout read by lm_head_topk,
+    so that the next tokens of the untraced generation are selected with
+    TensorParallelLMhead.topk(). The head of a single rank model is wrapped
+    into a TensorParallelLMhead with world_size 1.
+    """
+    if os.getenv("IPEX_TP_LM_HEAD_TOPK", "1") != "1":
+        return
+    lm_head = next(
+        (m for m in _model.modules() if isinstance(m, TensorParallelLMhead)), None
+    )
+    if (
+        lm_head is None
+        and not distributed
+        and type(getattr(_model, "lm_head", None)) is torch.nn.Linear
+    ):
+        lm_head = TensorParallelLMhead(
+            _model.lm_head,
+            None,
+            None,
+            None,
+            rank=0,
+            world_size=1,
+            shard_by_col=True,
+        )
+        _model.lm_head = lm_head
+    if lm_head is not None and lm_head.gather_result:
+        lm_head.keep_plain_weight()
+
+
 def model_convert_lowering(
     _model,
     device,
@@ -1389,6 +1422,8 @@ def model_convert_lowering(
 
         _disable_tpp()
         if not is_quantization:
+            if not deployment_mode:
+                keep_lm_head_plain_for_topk(_model)
             if ipex._C.is_llga_fp32_bf16_enabled():
                 _disable_tpp()
                 _model = ipex.optimize(
@@ -1496,6 +1531,13 @@ def model_convert_lowering(
                 woq=woq,
             )
 
+        if woq:
+            from ..nn.utils import _packed_checkpoint
+
+            # The trace captures the op contexts, switch them to the weights
+            # of the packed checkpoint first
+            _packed_checkpoint.save()
+
         if deployment_mode:
             sample_inputs = (
                 get_dummy_input(_model, return_dict=True)
@@ -1770,6 +1812,7 @@ def optimize(
     sample_inputs=None,
     deployment_mode=True,
     cache_weight_for_large_batch=False,
+    packed_checkpoint=None,
 ):
     r"""
     Apply optimizations at Python frontend to the given transformers model (nn.Module).
@@ -1803,6 +1846,13 @@ def optimize(
             its inference (e.g., prefill phase) with extra memory usage. It is only valid for non-quantization cases
             where dtype = bfloat16 and weight-only quantization cases where lowp-mode=BF16/INT8. In other cases, an
             error will be raised. Default value is ``False``.
+        packed_checkpoint (str): Path of the checkpoint of the packed weights for weight only quantization.
+            If the file does not exist, the weights quantized and packed by this call are saved to it.
+            Otherwise they are mapped from it into memory instead of being quantized and packed again,
+            which requires the same model, quantization config, IPEX and PyTorch versions and ISA level.
+            The file is mapped shared, so the processes using it share one copy of the weights.
+            Default value is ``None``, or a file in the directory of the NUMA node for the processes
+            started by the launcher with ``--shared-weights-dir``. (only works on CPU)
 
 
     Returns:
@@ -1837,6 +1887,67 @@ def optimize(
 
     validate_device_avaliable(device)
 
+    from ..nn.utils import _packed_checkpoint
+
+    if (
+        packed_checkpoint is None
+        # Not in the call made under the checkpoint of an outer one
+        and not _packed_checkpoint.is_active()
+        and device == "cpu"
+        and quantization_config is not None
+        and _is_woq_qconfig(quantization_config)
+    ):
+        from torch.ao.quantization import QConfig
+        from ..quantization._qconfig import QConfigWoq
+
+        qconfig = getattr(quantization_config, "global_qconfig", quantization_config)
+        woq_fields = [f for f in QConfigWoq._fields if f not in QConfig._fields]
+        name_or_path = model.config._name_or_path.rstrip("/")
+        if os.path.isdir(name_or_path):
+            name_or_path = os.path.realpath(name_or_path)
+        # The weights come from the low precision checkpoint if any, else
+        # from the model, which also tells apart two models of the same name.
+        if isinstance(low_precision_checkpoint, tuple):
+            weights = _packed_checkpoint.state_dict_digest(low_precision_checkpoint[0])
+            checkpoint_config = low_precision_checkpoint[1]
+        elif low_precision_checkpoint is not None:
+            weights = _packed_checkpoint.state_dict_digest(low_precision_checkpoint)
+            checkpoint_config = None
+        else:
+            weights = _packed_checkpoint.state_dict_digest(model.state_dict())
+            checkpoint_config = None
+        # Shared by the instances started by the launcher on a NUMA node
+        packed_checkpoint = _packed_checkpoint.shared_weights_path(
+            os.path.basename(name_or_path) or model.config.architectures[0],
+            {
+                "model": name_or_path,
+                "model_config": model.config.to_dict(),
+                "weights": weights,
+                "checkpoint_config": checkpoint_config,
+                "dtype": str(dtype),
+                "qconfig": {f: getattr(qconfig, f, None) for f in woq_fields},
+                "cache_weight_for_large_batch": cache_weight_for_large_batch,
+            },
+        )
+    if packed_checkpoint is not None:
+        assert (
+            device == "cpu"
+            and quantization_config is not None
+            and _is_woq_qconfig(quantization_config)
+        ), "packed_checkpoint is only valid for weight only quantization on CPU"
+        with _packed_checkpoint.packed_woq_checkpoint(packed_checkpoint):
+            return optimize(
+                model,
+                dtype=dtype,
+                inplace=inplace,
+                device=device,
+                quantization_config=quantization_config,
+                low_precision_checkpoint=low_precision_checkpoint,
+                sample_inputs=sample_inputs,
+                deployment_mode=deployment_mode,
+                cache_weight_for_large_batch=cache_weight_for_large_batch,
+            )
+
     try:
         installed_pkg = {pkg.key for pkg in pkg_resources.working_set}
         min_version = "4.28.1"
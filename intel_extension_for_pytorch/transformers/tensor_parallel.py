@@ -1,7 +1,9 @@
 import torch
 import torch.nn as nn
+import contextlib
 import os
 from ..utils.utils import has_cpu
+from ..nn.utils._weight_prepack import _PlainLinear
 
 if has_cpu():
     from ..cpu import comm as ipex_comm
@@ -379,7 +381,7 @@ class TensorParallellLinear(nn.Module):
                 self.world_size,
                 self.shard_by_col,
             )
-        self.linear = nn.Linear(
+        self.linear = self.new_linear(
             weight.shape[1], weight.shape[0], bias=linear.bias is not None
         )
 
@@ -388,6 +390,9 @@ class TensorParallellLinear(nn.Module):
             self.linear.bias = bias
         del linear
 
+    def new_linear(self, in_features, out_features, bias):
+        return nn.Linear(in_features, out_features, bias=bias)
+
     def forward(self, input: torch.Tensor) -> torch.Tensor:
         return self.linear(input)
 
@@ -440,13 +445,32 @@ class TensorParallelRowLinear(TensorParallellLinear):
             shard_by_col=False,
             value_with_share_qk=value_with_share_qk,
         )
+        # Split the rows of the input into chunks and reduce chunk i on the
+        # communication thread while chunk i + 1 is being computed.
+        self.overlap_chunks = int(os.getenv("IPEX_TP_OVERLAP_CHUNKS", "1"))
 
     def forward(self, input: torch.Tensor) -> torch.Tensor:
+        if self.world_size > 1 and self.overlap_chunks > 1:
+            rows = input.reshape(-1, input.shape[-1])
+            if rows.shape[0] > 1:
+                return self.overlapped_forward(input, rows)
         out = self.linear(input)
         if self.world_size > 1:
             ipex_comm.allreduce_add(out)
         return out
 
+    def overlapped_forward(self, input, rows):
+        outs = []
+        handles = []
+        for chunk in torch.chunk(rows, min(self.overlap_chunks, rows.shape[0])):
+            out = self.linear(chunk).contiguous()
+            handles.append(ipex_comm.allreduce_add_async(out))
+            outs.append(out)
+        for handle in handles:
+            handle.wait()
+        out = torch.cat(outs, dim=0)
+        return out.view(*input.shape[:-1], out.shape[-1])
+
 
 class TensorParallelLMhead(TensorParallellLinear):
     def __init__(
@@ -470,11 +494,87 @@ class TensorParallelLMhead(TensorParallellLinear):
             shard_by_col=shard_by_col,
         )
         self.gather_result = shard_by_col
+        # Set by output_hidden_states() while the generation loop selects the
+        # next tokens with topk() instead of the gathered logits.
+        self.return_hidden = False
+        # With IPEX_TP_REUSE_LOGITS=1 the gathered logits are written into one
+        # buffer that is reused by the following steps while the shape does
+        # not change, so the logits of a step are overwritten by the next one.
+        # Only enable it when no caller keeps the logits across steps, e.g.
+        # without output_scores.
+        self.reuse_logits = os.getenv("IPEX_TP_REUSE_LOGITS", "0") == "1"
+        self.logits_buffer = None
+
+    def shard_weights(self, linear, value_with_share_qk=False):
+        if self.world_size == 1:
+            # A single rank head only wraps the linear for topk().
+            self.linear = linear
+            self.cols_per_rank = [0, linear.weight.shape[0]]
+            return
+        super().shard_weights(linear, value_with_share_qk)
+
+    def keep_plain_weight(self):
+        r"""
+        Swaps the linear to _PlainLinear, whose weight is read by
+        lm_head_topk, so that ipex.optimize keeps it in the plain layout.
+        """
+        if type(self.linear) is not nn.Linear:
+            return
+        linear = _PlainLinear(
+            self.linear.in_features,
+            self.linear.out_features,
+            bias=self.linear.bias is not None,
+            device="meta",
+        )
+        linear.weight = self.linear.weight
+        linear.bias = self.linear.bias
+        self.linear = linear
+
+    @property
+    def fused_topk(self):
+        r"""
+        Whether topk() selects the candidates from the local vocab slice
+        without gathering the logits.
+        """
+        return self.gather_result and isinstance(self.linear, nn.Linear)
+
+    @contextlib.contextmanager
+    def output_hidden_states(self):
+        r"""
+        Makes forward() return its input, so that the model outputs the hidden
+        states the next tokens are selected from with topk().
+        """
+        self.return_hidden = True
+        try:
+            yield
+        finally:
+            self.return_hidden = False
+
+    def get_logits_buffer(self, out):
+        shape = (*out.shape[:-1], self.cols_per_rank[-1])
+        if not self.reuse_logits:
+            return torch.empty(shape, dtype=out.dtype)
+        if (
+            self.logits_buffer is None
+            or self.logits_buffer.shape != shape
+            or self.logits_buffer.dtype != out.dtype
+        ):
+            self.logits_buffer = torch.empty(shape, dtype=out.dtype)
+        return self.logits_buffer
 
     def forward(self, input: torch.Tensor) -> torch.Tensor:
+        if self.return_hidden:
+            return input
         if self.gather_result:
             out = self.linear(input)
-            out = ipex_comm.allgather(out, self.cols_per_rank, self.world_size)
+            if self.world_size == 1:
+                return out
+            out = ipex_comm.allgather(
+                out,
+                self.cols_per_rank,
+                self.world_size,
+                out=self.get_logits_buffer(out),
+            )
         else:
             if self.world_size > 1:
                 input = input[
@@ -487,6 +587,42 @@ class TensorParallelLMhead(TensorParallellLinear):
 
         return out
 
+    def topk(self, input: torch.Tensor, k: int = 1, log_probs: bool = False):
+        r"""
+        Returns the top-k logits (or log-probs) over the vocab and their token
+        ids. With a column-sharded LM head, every rank keeps the top-k of its
+        vocab slice while computing the logits block by block, and only k
+        candidates per row are exchanged, so the [batch, vocab] logits are
+        never materialized.
+        """
+        if not self.fused_topk:
+            logits = self.forward(input).float()
+            if log_probs:
+                logits = torch.log_softmax(logits, dim=-1)
+            return logits.topk(k, dim=-1)
+        hidden = input.reshape(-1, input.shape[-1])
+        values, indices, lse = torch.ops.torch_ipex.lm_head_topk(
+            hidden, self.linear.weight, self.linear.bias, k, log_probs
+        )
+        if self.world_size > 1:
+            indices += self.cols_per_rank[self.rank]
+            cols = [i * k for i in range(self.world_size + 1)]
+            values = ipex_comm.allgather(values, cols, self.world_size)
+            indices = ipex_comm.allgather(indices, cols, self.world_size)
+            if log_probs:
+                lse = ipex_comm.allgather(
+                    lse.unsqueeze(-1),
+                    list(range(self.world_size + 1)),
+                    self.world_size,
+                )
+                lse = torch.logsumexp(lse, dim=-1)
+            values, pos = values.topk(k, dim=-1)
+            indices = indices.gather(-1, pos)
+        if log_probs:
+            values = values - lse.unsqueeze(-1)
+        shape = (*input.shape[:-1], k)
+        return values.view(shape), indices.view(shape)
+
 
 def shard_mha_weights(
     model,
@@ -2,13 +2,18 @@ import copy
 import torch
 from torch.ao.quantization import PlaceholderObserver, QConfigMapping
 from intel_extension_for_pytorch.utils.utils import has_cpu
+from intel_extension_for_pytorch.nn.utils import _packed_checkpoint
 from intel_extension_for_pytorch.nn.utils._model_convert import (
     prepack_awq_weight,
     _convert_optimum_format_to_desired,
 )
 
 if has_cpu():
-    from intel_extension_for_pytorch.quantization import QConfigWoq, WoqLowpMode
+    from intel_extension_for_pytorch.quantization import (
+        QConfigWoq,
+        WoqLowpMode,
+        WoqWeightDtype,
+    )
 
 # The config describes how to load low precision checkpoint for weight only quantization.
 # Weight shape is N by K if transposed is False otherwise K by N.
@@ -184,6 +189,23 @@ def _convert_woq_with_low_precision_checkpoint(
     def _convert(mod, attr_name):
         if isinstance(mod, torch.nn.Linear) and has_cpu():
             mod.qconfig = qconfig_mapping.global_qconfig
+            if _packed_checkpoint.is_loading():
+                # The packed weights are read back from the packed checkpoint,
+                # the low precision ones are neither read nor unpacked.
+                if not all(
+                    attr_name + "." + key in state_dict
+                    for key in [weight_key, scales_key, zeros_key]
+                ):
+                    return mod
+                from intel_extension_for_pytorch.nn.modules import (
+                    WeightOnlyQuantizedLinear,
+                )
+
+                mod_new = _packed_checkpoint.load_woq_linear(
+                    WeightOnlyQuantizedLinear, mod, WoqWeightDtype.INT4
+                )
+                mod.weight = torch.nn.Parameter()
+                return mod_new
             qweight, scales, qzeros, bias, group_size, g_idx = _get_linear_parameters(
                 attr_name, state_dict, checkpoint_config
             )
@@ -75,6 +75,28 @@ class MergedEmbCatDense(torch.nn.Module):
         return self.merged_emb(indices, offsets, dense)
 
 
+class EmbeddingBagListInteractionDense(torch.nn.Module):
+    def __init__(self, emb_list):
+        super(EmbeddingBagListInteractionDense, self).__init__()
+        self.emb_list = emb_list
+
+    def forward(self, indices, offsets, dense):
+        return ipex.nn.functional.interaction(dense, *self.emb_list(indices, offsets))
+
+
+class MergedEmbInteractionDense(torch.nn.Module):
+    def __init__(self, emblist):
+        super(MergedEmbInteractionDense, self).__init__()
+        self.merged_emb = (
+            ipex.nn.modules.MergedEmbeddingBagWithInteraction.from_embeddingbag_list(
+                emblist.list
+            )
+        )
+
+    def forward(self, indices, offsets, dense):
+        return self.merged_emb(indices, offsets, dense)
+
+
 class MergedEmb(torch.nn.Module):
     def __init__(self, emblist):
         super(MergedEmb, self).__init__()
@@ -190,6 +212,27 @@ def merged_emb_cat_bench(args, input):
             )
 
 
+def merged_emb_interaction_bench(args, input):
+    assert args.inference
+    indices, offsets = input
+    for dtype in [torch.float32, torch.bfloat16]:
+        emblist = EmbeddingBagList(NUM_TABLE, args.vector_size, dtype)
+        ref_m = EmbeddingBagListInteractionDense(emblist)
+        m = MergedEmbInteractionDense(emblist)
+        dense = torch.randn(args.batch_size, args.vector_size, dtype=dtype)
+        with torch.no_grad():
+            run_bench(
+                f"MergedEmbeddingBagWithInteraction: value_dtype:{dtype}",
+                m,
+                (indices, offsets, dense),
+            )
+            run_bench(
+                f"EmbeddingBagList+Interaction: value_dtype:{dtype}",
+                ref_m,
+                (indices, offsets, dense),
+            )
+
+
 def merged_emb_with_sgd(args, input):
     for dtype in [torch.float32, torch.bfloat16]:
         if dtype == torch.bfloat16:
@@ -328,6 +371,7 @@ def run():
     parser.add_argument("--batch-size", type=int, default=7168)
     parser.add_argument("--vector-size", type=int, default=128)
     parser.add_argument("--with-cat", action="store_true", default=False)
+    parser.add_argument("--with-interaction", action="store_true", default=False)
     parser.add_argument(
         "--optimizer",
         type=str,
@@ -340,6 +384,10 @@ def run():
         assert args.inference
         merged_emb_cat_bench(args, input_data)
         exit()
+    if args.with_interaction:
+        assert args.inference
+        merged_emb_interaction_bench(args, input_data)
+        exit()
 
     if args.optimizer == "sgd":
         merged_emb_with_sgd(args, input_data)
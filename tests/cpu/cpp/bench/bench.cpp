@@ -0,0 +1,162 @@
+#include "bench.h"
+
+#include <ATen/Parallel.h>
+#include <ATen/core/dispatch/Dispatcher.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace torch_ipex {
+namespace bench {
+
+namespace {
+
+// Each triad array is 256MB, far beyond the last level cache.
+constexpr int64_t kStreamSize = 64 * 1024 * 1024;
+constexpr int64_t kGemmSize = 4096;
+constexpr int kRooflineReps = 5;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+double stream_triad_gbps() {
+  auto a = at::empty({kStreamSize}, at::kFloat);
+  auto b = at::empty({kStreamSize}, at::kFloat);
+  auto c = at::empty({kStreamSize}, at::kFloat);
+  float* pa = a.data_ptr<float>();
+  float* pb = b.data_ptr<float>();
+  float* pc = c.data_ptr<float>();
+  // First touch with the same partition as the timed loop, so that each
+  // thread reads pages of its own NUMA node.
+  at::parallel_for(0, kStreamSize, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      pa[i] = 0.f;
+      pb[i] = 1.f;
+      pc[i] = 2.f;
+    }
+  });
+  const float scalar = 3.f;
+  double best = 0;
+  for (int rep = 0; rep < kRooflineReps; rep++) {
+    auto start = std::chrono::steady_clock::now();
+    at::parallel_for(0, kStreamSize, 0, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        pa[i] = pb[i] + scalar * pc[i];
+      }
+    });
+    double elapsed = seconds_since(start);
+    // STREAM convention: the write allocate of a is not counted.
+    best = std::max(best, 3.0 * kStreamSize * sizeof(float) / elapsed / 1e9);
+  }
+  return best;
+}
+
+double gemm_gflops(at::ScalarType dtype) {
+  auto a = at::randn({kGemmSize, kGemmSize}).to(dtype);
+  auto b = at::randn({kGemmSize, kGemmSize}).to(dtype);
+  auto c = at::mm(a, b);
+  double best = 0;
+  for (int rep = 0; rep < kRooflineReps; rep++) {
+    auto start = std::chrono::steady_clock::now();
+    at::mm_out(c, a, b);
+    double elapsed = seconds_since(start);
+    best = std::max(best, 2.0 * std::pow(kGemmSize, 3) / elapsed / 1e9);
+  }
+  return best;
+}
+
+std::string escape(const std::string& value) {
+  std::string result;
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+    }
+    result += c;
+  }
+  return result;
+}
+
+} // namespace
+
+std::string format_shape(
+    std::initializer_list<std::pair<const char*, int64_t>> dims) {
+  std::string result;
+  for (auto& dim : dims) {
+    result += (result.empty() ? "" : ",") + std::string(dim.first) + "=" +
+        std::to_string(dim.second);
+  }
+  return result;
+}
+
+Roofline measure_roofline() {
+  Roofline roofline;
+  roofline.stream_gbps = stream_triad_gbps();
+  roofline.fp32_gflops = gemm_gflops(at::kFloat);
+  roofline.bf16_gflops = gemm_gflops(at::kBFloat16);
+  return roofline;
+}
+
+std::vector<double> time_calls(
+    const std::function<void()>& fn,
+    int64_t warmup,
+    int64_t iters) {
+  for (int64_t i = 0; i < warmup; i++) {
+    fn();
+  }
+  std::vector<double> times;
+  times.reserve(iters);
+  for (int64_t i = 0; i < iters; i++) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    times.push_back(seconds_since(start));
+  }
+  return times;
+}
+
+bool has_op(const char* name, const char* overload) {
+  return c10::Dispatcher::singleton().findSchema({name, overload}).has_value();
+}
+
+std::vector<c10::IValue> call_op(
+    const char* name,
+    std::vector<c10::IValue> args,
+    const char* overload) {
+  auto op = c10::Dispatcher::singleton().findSchemaOrThrow(name, overload);
+  op.callBoxed(&args);
+  return args;
+}
+
+JsonLine& JsonLine::add(const char* key, const std::string& value) {
+  body_ += (body_.empty() ? "\"" : ", \"") + std::string(key) + "\": \"" +
+      escape(value) + "\"";
+  return *this;
+}
+
+JsonLine& JsonLine::add(const char* key, const char* value) {
+  return add(key, std::string(value));
+}
+
+JsonLine& JsonLine::add(const char* key, double value) {
+  char buffer[32];
+  // JSON has no representation of inf and nan.
+  snprintf(buffer, sizeof(buffer), "%.6g", std::isfinite(value) ? value : 0.0);
+  body_ += (body_.empty() ? "\"" : ", \"") + std::string(key) + "\": " + buffer;
+  return *this;
+}
+
+JsonLine& JsonLine::add(const char* key, int64_t value) {
+  body_ += (body_.empty() ? "\"" : ", \"") + std::string(key) +
+      "\": " + std::to_string(value);
+  return *this;
+}
+
+void JsonLine::write(FILE* out) {
+  fprintf(out, "{%s}\n", body_.c_str());
+  fflush(out);
+}
+
+} // namespace bench
+} // namespace torch_ipex
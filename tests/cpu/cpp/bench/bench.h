@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/core/stack.h>
+
+#include <cstdio>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch_ipex {
+namespace bench {
+
+// Machine roofline measured by the process, i.e. at the ISA level it runs
+// with: the STREAM triad bandwidth and the throughput of a large at::mm.
+struct Roofline {
+  double stream_gbps = 0;
+  double fp32_gflops = 0;
+  double bf16_gflops = 0;
+
+  // Peak GFLOP/s of the compute dtype of a kernel.
+  double peak_gflops(at::ScalarType dtype) const {
+    return dtype == at::kFloat ? fp32_gflops : bf16_gflops;
+  }
+};
+
+// One kernel at one shape. bytes is the compulsory traffic of a call, each
+// input read and each output written once, flops its useful floating point
+// operations.
+struct BenchCase {
+  std::string suite;
+  std::string kernel;
+  std::string shape;
+  at::ScalarType dtype;
+  double bytes;
+  double flops;
+  // Allocates the inputs and returns the function timed, it is only called
+  // for the selected cases.
+  std::function<std::function<void()>()> setup;
+};
+
+// "name=value,..." description of a shape.
+std::string format_shape(
+    std::initializer_list<std::pair<const char*, int64_t>> dims);
+
+void register_llm_cases(std::vector<BenchCase>& cases);
+void register_dlrm_cases(std::vector<BenchCase>& cases);
+
+Roofline measure_roofline();
+
+// Runs warmup then iters calls, returns the time of each timed call in
+// seconds.
+std::vector<double> time_calls(
+    const std::function<void()>& fn,
+    int64_t warmup,
+    int64_t iters);
+
+// Boxed call of a registered op, so that the cases do not depend on the C++
+// signatures of the kernels. Returns false if the op is not registered, e.g.
+// when IPEX is built without the library providing it.
+bool has_op(const char* name, const char* overload = "");
+std::vector<c10::IValue> call_op(
+    const char* name,
+    std::vector<c10::IValue> args,
+    const char* overload = "");
+
+// Writes one JSON object per line.
+class JsonLine {
+ public:
+  JsonLine& add(const char* key, const std::string& value);
+  JsonLine& add(const char* key, const char* value);
+  JsonLine& add(const char* key, double value);
+  JsonLine& add(const char* key, int64_t value);
+  void write(FILE* out);
+
+ private:
+  std::string body_;
+};
+
+} // namespace bench
+} // namespace torch_ipex
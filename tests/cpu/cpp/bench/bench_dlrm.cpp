@@ -0,0 +1,134 @@
+#include "bench.h"
+
+// DLRM kernels at the shapes of the MLPerf DLRM: 26 sparse features and one
+// dense feature, all of dimension 128.
+
+namespace torch_ipex {
+namespace bench {
+
+namespace {
+
+constexpr int64_t kTables = 26;
+constexpr int64_t kDim = 128;
+constexpr int64_t kRows = 100000;
+
+void add_interaction(std::vector<BenchCase>& cases) {
+  constexpr int64_t kFeatures = kTables + 1;
+  constexpr int64_t kPairs = kFeatures * (kFeatures - 1) / 2;
+  for (auto dtype : {at::kFloat, at::kBFloat16}) {
+    for (int64_t batch : {2048, 32768}) {
+      double element = c10::elementSize(dtype);
+      cases.push_back(
+          {"dlrm",
+           "interaction_forward",
+           format_shape(
+               {{"batch", batch}, {"features", kFeatures}, {"dim", kDim}}),
+           dtype,
+           (1.0 * kFeatures * batch * kDim + batch * (kDim + kPairs)) *
+               element,
+           2.0 * batch * kPairs * kDim,
+           [=]() {
+             std::vector<at::Tensor> features;
+             for (int64_t i = 0; i < kFeatures; i++) {
+               features.push_back(at::randn({batch, kDim}).to(dtype));
+             }
+             return [=]() {
+               call_op("torch_ipex::interaction_forward", {features});
+             };
+           }});
+    }
+  }
+}
+
+void add_merged_embeddingbag(std::vector<BenchCase>& cases) {
+  constexpr int64_t kPoolingSum = 0;
+  for (int64_t hotness : {1, 20}) {
+    for (int64_t batch : {2048, 32768}) {
+      double lookups = 1.0 * kTables * batch * hotness;
+      cases.push_back(
+          {"dlrm",
+           "merged_embeddingbag_forward",
+           format_shape(
+               {{"batch", batch},
+                {"tables", kTables},
+                {"rows", kRows},
+                {"dim", kDim},
+                {"hotness", hotness}}),
+           at::kFloat,
+           // Rows gathered, indices and pooled outputs.
+           lookups * (kDim * sizeof(float) + sizeof(int64_t)) +
+               1.0 * kTables * batch * kDim * sizeof(float),
+           lookups * kDim,
+           [=]() {
+             std::vector<at::Tensor> weights, indices, offsets;
+             for (int64_t i = 0; i < kTables; i++) {
+               weights.push_back(at::randn({kRows, kDim}));
+               indices.push_back(
+                   at::randint(kRows, {batch * hotness}, at::kLong));
+               offsets.push_back(
+                   at::arange(0, batch * hotness, hotness, at::kLong));
+             }
+             return [=]() {
+               call_op(
+                   "torch_ipex::merged_embeddingbag_forward",
+                   {weights, indices, offsets, kPoolingSum, false});
+             };
+           }});
+    }
+  }
+}
+
+void add_merged_embeddingbag_interaction(std::vector<BenchCase>& cases) {
+  constexpr int64_t kFeatures = kTables + 1;
+  constexpr int64_t kPairs = kFeatures * (kFeatures - 1) / 2;
+  for (auto dtype : {at::kFloat, at::kBFloat16}) {
+    for (int64_t hotness : {1, 20}) {
+      for (int64_t batch : {2048, 32768}) {
+        double element = c10::elementSize(dtype);
+        double lookups = 1.0 * kTables * batch * hotness;
+        cases.push_back(
+            {"dlrm",
+             "merged_embeddingbag_interaction_forward",
+             format_shape(
+                 {{"batch", batch},
+                  {"tables", kTables},
+                  {"rows", kRows},
+                  {"dim", kDim},
+                  {"hotness", hotness}}),
+             dtype,
+             // Rows gathered, indices, dense feature and output, the pooled
+             // embeddings stay in cache.
+             lookups * (kDim * element + sizeof(int64_t)) +
+                 1.0 * batch * (2 * kDim + kPairs) * element,
+             lookups * kDim + 2.0 * batch * kPairs * kDim,
+             [=]() {
+               std::vector<at::Tensor> weights, indices, offsets;
+               for (int64_t i = 0; i < kTables; i++) {
+                 weights.push_back(at::randn({kRows, kDim}).to(dtype));
+                 indices.push_back(
+                     at::randint(kRows, {batch * hotness}, at::kLong));
+                 offsets.push_back(
+                     at::arange(0, batch * hotness, hotness, at::kLong));
+               }
+               auto dense = at::randn({batch, kDim}).to(dtype);
+               return [=]() {
+                 call_op(
+                     "torch_ipex::merged_embeddingbag_interaction_forward",
+                     {weights, indices, offsets, dense});
+               };
+             }});
+      }
+    }
+  }
+}
+
+} // namespace
+
+void register_dlrm_cases(std::vector<BenchCase>& cases) {
+  add_interaction(cases);
+  add_merged_embeddingbag(cases);
+  add_merged_embeddingbag_interaction(cases);
+}
+
+} // namespace bench
+} // namespace torch_ipex
@@ -0,0 +1,332 @@
+#include "bench.h"
+
+#include <cmath>
+
+// LLM kernels at the shapes of a 7B Llama-like decoder: hidden size 4096, 32
+// heads of 128, MLP size 11008. "tokens" is batch * sequence length of the
+// activation, the attention kernels are timed at decode (one new token per
+// sequence) except flash attention, which serves the prompt.
+
+namespace torch_ipex {
+namespace bench {
+
+namespace {
+
+constexpr int64_t kHidden = 4096;
+constexpr int64_t kHeads = 32;
+constexpr int64_t kHeadSize = 128;
+constexpr int64_t kMlp = 11008;
+constexpr int64_t kBf16 = 2;
+
+const std::vector<std::pair<int64_t, int64_t>> kLinearShapes = {
+    {kHidden, kHidden}, // attention projections
+    {kMlp, kHidden}, // MLP up and gate
+    {kHidden, kMlp}, // MLP down
+};
+const std::vector<int64_t> kLinearTokens = {1, 32, 1024};
+
+at::Tensor randn_bf16(at::IntArrayRef sizes) {
+  return at::randn(sizes).to(at::kBFloat16);
+}
+
+void add_rmsnorm(std::vector<BenchCase>& cases) {
+  for (int64_t tokens : {1, 32, 2048}) {
+    cases.push_back(
+        {"llm",
+         "rmsnorm",
+         format_shape({{"tokens", tokens}, {"hidden", kHidden}}),
+         at::kBFloat16,
+         (2.0 * tokens * kHidden + kHidden) * kBf16,
+         4.0 * tokens * kHidden,
+         [=]() {
+           auto input = randn_bf16({tokens, kHidden});
+           auto weight = randn_bf16({kHidden});
+           return [=]() {
+             call_op("torch_ipex::rmsnorm", {input, weight, 1e-6});
+           };
+         }});
+  }
+}
+
+void add_rotary_embedding(std::vector<BenchCase>& cases) {
+  constexpr int64_t kMaxPositions = 4096;
+  for (int64_t tokens : {1, 2048}) {
+    double numel = tokens * kHeads * kHeadSize;
+    cases.push_back(
+        {"llm",
+         "rotary_position_embedding",
+         format_shape(
+             {{"tokens", tokens}, {"heads", kHeads}, {"head", kHeadSize}}),
+         at::kBFloat16,
+         2.0 * numel * kBf16 + tokens * kHeadSize * sizeof(float),
+         3.0 * numel,
+         [=]() {
+           auto input = randn_bf16({1, tokens, kHeads, kHeadSize});
+           auto sin_cos = at::randn({kMaxPositions, kHeadSize});
+           // A decoded token sits at the end of the context.
+           auto positions =
+               at::arange(kMaxPositions - tokens, kMaxPositions, at::kLong)
+                   .view({1, tokens});
+           return [=]() {
+             call_op(
+                 "torch_ipex::rotary_position_embedding",
+                 {input,
+                  sin_cos,
+                  positions,
+                  kHeads,
+                  kHeadSize,
+                  kHeadSize / 2,
+                  kHeadSize});
+           };
+         }});
+  }
+}
+
+void add_tpp_linear(std::vector<BenchCase>& cases) {
+  if (!has_op("torch_ipex::tpp_linear")) {
+    return;
+  }
+  // Blocking of the VNNI layout [N / bn, K / bk, bk / 2, bn, 2].
+  constexpr int64_t kBlock = 64;
+  for (auto& shape : kLinearShapes) {
+    int64_t n = shape.first;
+    int64_t k = shape.second;
+    for (int64_t m : kLinearTokens) {
+      cases.push_back(
+          {"llm",
+           "tpp_linear",
+           format_shape({{"m", m}, {"n", n}, {"k", k}}),
+           at::kBFloat16,
+           (1.0 * m * k + 1.0 * n * k + 1.0 * m * n) * kBf16,
+           2.0 * m * n * k,
+           [=]() {
+             auto input = randn_bf16({m, k});
+             auto weight = randn_bf16({n, k})
+                               .view({n / kBlock, kBlock, k / kBlock,
+                                      kBlock / 2, 2})
+                               .permute({0, 2, 3, 1, 4})
+                               .contiguous();
+             return [=]() {
+               call_op("torch_ipex::tpp_linear", {input, weight, n});
+             };
+           }});
+    }
+  }
+}
+
+void add_woq_linear(std::vector<BenchCase>& cases) {
+  if (!has_op("ipex_prepack::woq_linear_pack_weight") ||
+      !has_op("torch_ipex::woq_linear")) {
+    return;
+  }
+  // INT8 weight with per-channel scales, computed in BF16 (lowp_mode 2).
+  constexpr int64_t kGroupSize = -1;
+  constexpr int64_t kLowpModeBf16 = 2;
+  constexpr int64_t kActQuantMode = 0;
+  for (auto& shape : kLinearShapes) {
+    int64_t n = shape.first;
+    int64_t k = shape.second;
+    for (int64_t m : kLinearTokens) {
+      cases.push_back(
+          {"llm",
+           "woq_linear_int8",
+           format_shape({{"m", m}, {"n", n}, {"k", k}}),
+           at::kBFloat16,
+           (1.0 * m * k + 1.0 * m * n) * kBf16 + 1.0 * n * k +
+               n * sizeof(float),
+           2.0 * m * n * k,
+           [=]() {
+             auto input = randn_bf16({m, k});
+             auto qweight = at::randint(-128, 128, {n, k}, at::kChar);
+             auto scales = at::rand({n}) * 0.01;
+             std::vector<int64_t> weight_shape = {n, k};
+             // (weight, scales, zero points, bias, compensation)
+             auto packed = call_op(
+                 "ipex_prepack::woq_linear_pack_weight",
+                 {qweight,
+                  "int8",
+                  weight_shape,
+                  scales,
+                  c10::IValue(),
+                  c10::IValue(),
+                  c10::IValue(),
+                  kGroupSize,
+                  kLowpModeBf16});
+             return [=]() {
+               call_op(
+                   "torch_ipex::woq_linear",
+                   {input,
+                    packed[0],
+                    "int8",
+                    weight_shape,
+                    packed[1],
+                    packed[2],
+                    packed[3],
+                    c10::IValue(),
+                    kGroupSize,
+                    kLowpModeBf16,
+                    kActQuantMode,
+                    packed[4]});
+             };
+           }});
+    }
+  }
+}
+
+void add_masked_mha(std::vector<BenchCase>& cases) {
+  for (int64_t batch : {1, 16}) {
+    for (int64_t context : {1024, 2048}) {
+      // The K and V caches dominate, the new token attends context + 1 keys.
+      double kv = 1.0 * batch * kHeads * (context + 1) * kHeadSize;
+      cases.push_back(
+          {"llm",
+           "masked_multihead_self_attention",
+           format_shape(
+               {{"batch", batch},
+                {"context", context},
+                {"heads", kHeads},
+                {"head", kHeadSize}}),
+           at::kBFloat16,
+           2.0 * kv * kBf16,
+           4.0 * kv,
+           [=]() {
+             const double scale = 1.0 / std::sqrt(kHeadSize);
+             // The prompt creates the caches.
+             auto prompt = randn_bf16({batch, context, kHeads, kHeadSize});
+             auto prompt_mask =
+                 at::zeros({batch, 1, context, context}, at::kBFloat16);
+             auto past = call_op(
+                 "torch_ipex::masked_multihead_self_attention",
+                 {prompt,
+                  prompt,
+                  prompt,
+                  at::zeros({1, 1, 1, 1}),
+                  at::zeros({1, 1, 1, 1}),
+                  at::zeros({1, batch}, at::kLong),
+                  at::scalar_tensor(0, at::kLong),
+                  scale,
+                  context + 1,
+                  c10::IValue(),
+                  prompt_mask,
+                  c10::IValue()});
+             auto token = randn_bf16({batch, 1, kHeads, kHeadSize});
+             auto mask = at::zeros({batch, 1, 1, context + 1}, at::kBFloat16);
+             // Every call decodes the token at position context again.
+             auto offset = at::scalar_tensor(context, at::kLong);
+             return [=]() {
+               call_op(
+                   "torch_ipex::masked_multihead_self_attention",
+                   {token,
+                    token,
+                    token,
+                    past[2],
+                    past[3],
+                    past[4],
+                    offset,
+                    scale,
+                    context + 1,
+                    c10::IValue(),
+                    mask,
+                    c10::IValue()});
+             };
+           }});
+    }
+  }
+}
+
+void add_paged_attention(std::vector<BenchCase>& cases) {
+  constexpr int64_t kBlockSize = 16;
+  for (int64_t seqs : {1, 16}) {
+    for (int64_t context : {1024, 2048}) {
+      double kv = 1.0 * seqs * kHeads * context * kHeadSize;
+      cases.push_back(
+          {"llm",
+           "single_query_cached_kv_attention",
+           format_shape(
+               {{"seqs", seqs},
+                {"context", context},
+                {"heads", kHeads},
+                {"head", kHeadSize},
+                {"block", kBlockSize}}),
+           at::kBFloat16,
+           2.0 * kv * kBf16,
+           4.0 * kv,
+           [=]() {
+             int64_t blocks_per_seq = (context + kBlockSize - 1) / kBlockSize;
+             int64_t blocks = seqs * blocks_per_seq;
+             auto query = randn_bf16({seqs, kHeads, kHeadSize});
+             auto output = at::empty_like(query);
+             // [blocks, kv heads, block size, head size]
+             auto key_cache =
+                 randn_bf16({blocks, kHeads, kBlockSize, kHeadSize});
+             auto value_cache =
+                 randn_bf16({blocks, kHeads, kBlockSize, kHeadSize});
+             auto head_mapping = at::arange(kHeads, at::kInt);
+             auto block_tables =
+                 at::arange(blocks, at::kInt).view({seqs, blocks_per_seq});
+             auto context_lens = at::full({seqs}, context, at::kInt);
+             const double scale = 1.0 / std::sqrt(kHeadSize);
+             return [=]() {
+               call_op(
+                   "torch_ipex::single_query_cached_kv_attention",
+                   {output,
+                    query,
+                    key_cache,
+                    value_cache,
+                    head_mapping,
+                    scale,
+                    block_tables,
+                    context_lens,
+                    kBlockSize,
+                    context,
+                    c10::IValue()});
+             };
+           }});
+    }
+  }
+}
+
+void add_flash_attention(std::vector<BenchCase>& cases) {
+  for (int64_t seq : {512, 2048}) {
+    double qkvo = 4.0 * seq * kHeads * kHeadSize;
+    cases.push_back(
+        {"llm",
+         "flash_attention_causal",
+         format_shape({{"seq", seq}, {"heads", kHeads}, {"head", kHeadSize}}),
+         at::kBFloat16,
+         qkvo * kBf16,
+         // Causal, half of the 4 * seq^2 * head FLOPs of each head.
+         2.0 * seq * seq * kHeadSize * kHeads,
+         [=]() {
+           auto query = randn_bf16({1, seq, kHeads, kHeadSize});
+           auto key = randn_bf16({1, seq, kHeads, kHeadSize});
+           auto value = randn_bf16({1, seq, kHeads, kHeadSize});
+           return [=]() {
+             call_op(
+                 "torch_ipex::flash_attention",
+                 {query,
+                  key,
+                  value,
+                  0.0,
+                  true,
+                  c10::IValue(),
+                  c10::IValue()});
+           };
+         }});
+  }
+}
+
+} // namespace
+
+void register_llm_cases(std::vector<BenchCase>& cases) {
+  add_rmsnorm(cases);
+  add_rotary_embedding(cases);
+  add_tpp_linear(cases);
+  add_woq_linear(cases);
+  add_masked_mha(cases);
+  add_paged_attention(cases);
+  add_flash_attention(cases);
+}
+
+} // namespace bench
+} // namespace torch_ipex
@@ -0,0 +1,235 @@
+#include "bench.h"
+
+#include <ATen/Parallel.h>
+#include "csrc/cpu/dyndisp/DispatchStub.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// Micro-benchmarks of the IPEX CPU kernels with a roofline report.
+//
+//   ipex_cpp_bench [--isa all|<level>,...] [--filter <substring>]
+//                  [--warmup <n>] [--iters <n>] [--output <file>]
+//
+// Each kernel is timed at a set of LLM and DLRM shapes and reported as one
+// JSON object per line, with its achieved GB/s and GFLOP/s and its
+// efficiency against the roofline measured on the same machine. The ISA
+// level of the DispatchStub kernels is picked once per process from
+// ATEN_CPU_CAPABILITY, so --isa runs one child process per level, each
+// with its own roofline since the ISA level also caps oneDNN.
+
+using namespace torch_ipex::bench;
+
+namespace {
+
+// Values of ATEN_CPU_CAPABILITY, indexed by CPUCapability.
+const std::vector<std::string> kIsaNames = {
+    "default",
+    "avx2",
+    "avx2_vnni",
+    "avx512",
+    "avx512_vnni",
+    "avx512_bf16",
+    "amx",
+    "avx512_fp16"};
+
+struct Options {
+  std::vector<std::string> isa;
+  std::string filter;
+  int64_t warmup = 3;
+  int64_t iters = 20;
+  std::string output;
+  // Set for the child processes, which append to the output.
+  bool append = false;
+};
+
+Options parse_options(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    TORCH_CHECK(i + 1 < argc || arg == "--append", "missing value of ", arg);
+    if (arg == "--isa") {
+      std::stringstream levels(argv[++i]);
+      std::string level;
+      while (std::getline(levels, level, ',')) {
+        options.isa.push_back(level);
+      }
+    } else if (arg == "--filter") {
+      options.filter = argv[++i];
+    } else if (arg == "--warmup") {
+      options.warmup = std::stoll(argv[++i]);
+    } else if (arg == "--iters") {
+      options.iters = std::stoll(argv[++i]);
+    } else if (arg == "--output") {
+      options.output = argv[++i];
+    } else if (arg == "--append") {
+      options.append = true;
+    } else {
+      TORCH_CHECK(false, "unknown argument ", arg);
+    }
+  }
+  TORCH_CHECK(options.iters > 0, "--iters must be positive");
+  return options;
+}
+
+// Levels supported by both the CPU and the binary, in increasing order.
+std::vector<std::string> expand_isa(const std::vector<std::string>& isa) {
+  auto highest = std::min(
+      torch_ipex::cpu::_get_highest_cpu_support_isa_level(),
+      torch_ipex::cpu::_get_highest_binary_support_isa_level());
+  std::vector<std::string> levels;
+  for (size_t i = 0; i <= (size_t)highest; i++) {
+    if (isa.size() == 1 && isa[0] == "all") {
+      levels.push_back(kIsaNames[i]);
+    } else if (std::find(isa.begin(), isa.end(), kIsaNames[i]) != isa.end()) {
+      levels.push_back(kIsaNames[i]);
+    }
+  }
+  for (auto& level : isa) {
+    if (level != "all" &&
+        std::find(levels.begin(), levels.end(), level) == levels.end()) {
+      fprintf(stderr, "skipping unsupported ISA level %s\n", level.c_str());
+    }
+  }
+  return levels;
+}
+
+// Runs this benchmark again with ATEN_CPU_CAPABILITY=level.
+int run_child(const std::string& level, char** argv, int argc) {
+  std::vector<std::string> args;
+  for (int i = 0; i < argc; i++) {
+    if (std::strcmp(argv[i], "--isa") == 0) {
+      i++;
+      continue;
+    }
+    args.push_back(argv[i]);
+  }
+  args.push_back("--append");
+  std::vector<char*> child_argv;
+  for (auto& arg : args) {
+    child_argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  child_argv.push_back(nullptr);
+
+  fflush(nullptr);
+  pid_t pid = fork();
+  TORCH_CHECK(pid >= 0, "fork failed: ", std::strerror(errno));
+  if (pid == 0) {
+    setenv("ATEN_CPU_CAPABILITY", level.c_str(), 1);
+    execv("/proc/self/exe", child_argv.data());
+    _exit(127);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+double median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+int run_benchmarks(const Options& options, FILE* out) {
+  const char* isa = torch_ipex::cpu::CPUCapabilityToString(
+      torch_ipex::cpu::get_cpu_capability());
+  int64_t threads = at::get_num_threads();
+
+  Roofline roofline = measure_roofline();
+  JsonLine()
+      .add("record", "roofline")
+      .add("isa", isa)
+      .add("threads", threads)
+      .add("stream_gbps", roofline.stream_gbps)
+      .add("fp32_gflops", roofline.fp32_gflops)
+      .add("bf16_gflops", roofline.bf16_gflops)
+      .write(out);
+
+  std::vector<BenchCase> cases;
+  register_llm_cases(cases);
+  register_dlrm_cases(cases);
+
+  int failures = 0;
+  for (auto& bench_case : cases) {
+    std::string name = bench_case.suite + "/" + bench_case.kernel;
+    if (name.find(options.filter) == std::string::npos) {
+      continue;
+    }
+    JsonLine line;
+    line.add("record", "kernel")
+        .add("isa", isa)
+        .add("threads", threads)
+        .add("suite", bench_case.suite)
+        .add("kernel", bench_case.kernel)
+        .add("shape", bench_case.shape)
+        .add("dtype", c10::toString(bench_case.dtype));
+    try {
+      auto times =
+          time_calls(bench_case.setup(), options.warmup, options.iters);
+      double seconds = median(times);
+      double peak_gflops = roofline.peak_gflops(bench_case.dtype);
+      double memory_seconds = bench_case.bytes / (roofline.stream_gbps * 1e9);
+      double compute_seconds = bench_case.flops / (peak_gflops * 1e9);
+      double gflops = bench_case.flops / seconds / 1e9;
+      line.add("median_us", seconds * 1e6)
+          .add("min_us", *std::min_element(times.begin(), times.end()) * 1e6)
+          .add("gbps", bench_case.bytes / seconds / 1e9)
+          .add("gflops", gflops)
+          .add("intensity", bench_case.flops / bench_case.bytes)
+          .add(
+              "bound",
+              memory_seconds >= compute_seconds ? "memory" : "compute")
+          // Time at the roofline over the time measured.
+          .add(
+              "efficiency",
+              std::max(memory_seconds, compute_seconds) / seconds);
+      fprintf(
+          stderr,
+          "%-12s %-40s %-48s %10.1f us %8.1f GB/s %9.1f GFLOP/s\n",
+          isa,
+          name.c_str(),
+          bench_case.shape.c_str(),
+          seconds * 1e6,
+          bench_case.bytes / seconds / 1e9,
+          gflops);
+    } catch (const std::exception& e) {
+      failures++;
+      std::string message = e.what();
+      line.add("error", message.substr(0, message.find('\n')));
+      fprintf(stderr, "%s %s failed: %s\n", isa, name.c_str(), e.what());
+    }
+    line.write(out);
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options = parse_options(argc, argv);
+
+  FILE* out = stdout;
+  if (!options.output.empty()) {
+    out = fopen(options.output.c_str(), options.append ? "a" : "w");
+    TORCH_CHECK(out != nullptr, "cannot open ", options.output);
+  }
+  if (options.isa.empty()) {
+    return run_benchmarks(options, out);
+  }
+
+  // The children write to the output themselves.
+  if (out != stdout) {
+    fclose(out);
+  }
+  int status = 0;
+  for (auto& level : expand_isa(options.isa)) {
+    status |= run_child(level, argv, argc);
+  }
+  return status;
+}
@@ -0,0 +1,71 @@
+"""Compares two runs of ipex_cpp_bench and fails on regressions.
+
+python compare.py baseline.jsonl current.jsonl --threshold 0.05
+
+A kernel regresses when its median time grows by more than the threshold at
+the same ISA level, shape and dtype. Kernels failing in the current run also
+fail the comparison, kernels missing from either run are reported only.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            record = json.loads(line)
+            if record["record"] != "kernel":
+                continue
+            key = (
+                record["isa"],
+                record["suite"],
+                record["kernel"],
+                record["dtype"],
+                record["shape"],
+            )
+            results[key] = record
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.05)
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    failed = False
+    for key in sorted(baseline.keys() | current.keys()):
+        name = " ".join(key)
+        if key not in current:
+            print(f"missing  {name}")
+            continue
+        if "error" in current[key]:
+            print(f"error    {name}: {current[key]['error']}")
+            failed = True
+            continue
+        if key not in baseline or "error" in baseline[key]:
+            print(f"new      {name}")
+            continue
+        ratio = current[key]["median_us"] / baseline[key]["median_us"]
+        status = "ok"
+        if ratio > 1 + args.threshold:
+            status = "slower"
+            failed = True
+        elif ratio < 1 - args.threshold:
+            status = "faster"
+        print(
+            f"{status:8} {name}: {baseline[key]['median_us']:.1f} us -> "
+            f"{current[key]['median_us']:.1f} us ({ratio:.3f}x), "
+            f"efficiency {current[key]['efficiency']:.2f}"
+        )
+    sys.exit(1 if failed else 0)
+
+
+if __name__ == "__main__":
+    main()
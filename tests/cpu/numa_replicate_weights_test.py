@@ -0,0 +1,32 @@
+import torch
+import intel_extension_for_pytorch as ipex
+
+# This script is called and tested by test_runtime_api_jit.py with
+# IPEX_NUMA_REPLICATE_WEIGHTS=1. The prepacked conv and linear weights are
+# then read from a copy per NUMA node, which must not change the results of
+# the streams of a MultiStreamModule.
+
+
+class ConvLinear(torch.nn.Module):
+    def __init__(self):
+        super(ConvLinear, self).__init__()
+        self.conv = torch.nn.Conv2d(64, 128, (3, 3), stride=(2, 2), padding=(1, 1))
+        self.linear = torch.nn.Linear(512, 32)
+
+    def forward(self, x):
+        x1 = self.conv(x)
+        y = torch.flatten(x1, start_dim=1)
+        return self.linear(y)
+
+
+model = ipex.optimize(ConvLinear().eval(), dtype=torch.float)
+x = torch.rand(16, 64, 4, 4)
+with torch.no_grad():
+    y = model(x)
+    trace_model = torch.jit.freeze(torch.jit.trace(model, x))
+    cpu_pool = ipex.cpu.runtime.CPUPool()
+    multi_stream_model = ipex.cpu.runtime.MultiStreamModule(
+        trace_model, num_streams=len(cpu_pool.core_ids), cpu_pool=cpu_pool
+    )
+    for _ in range(3):
+        torch.testing.assert_close(multi_stream_model(x), y)
@@ -375,6 +375,52 @@ class TestIpexOps(JitLlgaTestCase):
                     graph, "ipex::qmerged_embeddingbag_cat", 1
                 )
 
+    def test_mergedembinteraction_int8(self):
+        class M(torch.nn.Module):
+            def __init__(self, NUM_TABLE, NUM_DIM):
+                super(M, self).__init__()
+                emblist = torch.nn.ModuleList()
+                for _ in range(NUM_TABLE):
+                    emblist.append(torch.nn.EmbeddingBag(1000, NUM_DIM, mode="sum"))
+                self.merged_emb = ipex.nn.modules.MergedEmbeddingBagWithInteraction.from_embeddingbag_list(
+                    emblist
+                )
+
+            def forward(self, indices, offsets, dense):
+                return self.merged_emb(indices, offsets, dense)
+
+        def fake_quant(tensor):
+            scale = max(tensor.abs().max().item() / 127.5, 1e-7)
+            qtensor = torch.quantize_per_tensor(tensor, scale, 0, torch.qint8)
+            return qtensor.dequantize()
+
+        with torch.no_grad():
+            NUM_TABLE = 5
+            BATCH_SIZE = 16
+            for emb_dim in [128, 36]:
+                indices = tuple(
+                    [torch.randint(1000, (BATCH_SIZE * 2,)) for _ in range(NUM_TABLE)]
+                )
+                offsets = tuple(
+                    [torch.arange(0, BATCH_SIZE * 2, 2) for _ in range(NUM_TABLE)]
+                )
+                dense = torch.randn(BATCH_SIZE, emb_dim)
+                m = M(NUM_TABLE, emb_dim).eval()
+                _m = copy.deepcopy(m)
+                for w in _m.merged_emb.weights:
+                    w.data = fake_quant(w)
+                y = fake_quant(_m(indices, offsets, fake_quant(dense)))
+                graph = self.checkQuantizeTrace(
+                    m,
+                    [indices, offsets, dense],
+                    qconfig=static_qconfig[1],
+                    rtol=2e-1,
+                    expect_result=y,
+                )
+                self.assertGraphContainsExactly(
+                    graph, "ipex::qmerged_embeddingbag_interaction", 1
+                )
+
     def test_interaction_int8(self):
         class M(nn.Module):
             def __init__(self):
@@ -392,6 +438,38 @@ class TestIpexOps(JitLlgaTestCase):
         graph = self.checkQuantizeTrace(m, inputs, atol=1e-2, qconfig=static_qconfig[1])
         self.assertGraphContainsExactly(graph, "ipex::qinteraction", 1)
 
+    def test_interaction_int8_shapes(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.f = ipex.nn.functional.interaction
+
+            def forward(self, *xs):
+                return self.f(*[x.relu() for x in xs])
+
+        def fake_quant(tensor):
+            scale = max(tensor.abs().max().item() / 127.5, 1e-7)
+            qtensor = torch.quantize_per_tensor(tensor, scale, 0, torch.qint8)
+            return qtensor.dequantize()
+
+        # The int8 kernel is not limited to 27 features of 128 anymore.
+        for feature_size, sparse_num in itertools.product([36, 127], [3, 8]):
+            inputs = [
+                torch.randn([64, feature_size]) * 0.1 for _ in range(sparse_num + 1)
+            ]
+            y = fake_quant(
+                ipex.nn.functional.interaction(*[fake_quant(x.relu()) for x in inputs])
+            )
+            graph = self.checkQuantizeTrace(
+                M(),
+                inputs,
+                atol=1e-2,
+                rtol=2e-1,
+                qconfig=static_qconfig[1],
+                expect_result=y,
+            )
+            self.assertGraphContainsExactly(graph, "ipex::qinteraction", 1)
+
     # Besides its primary objective, this UT also implicitly tests if mayRevertDtypeAttributeInsertion
     # in csrc/jit/codegen/onednn/prepare_binary.cpp works well.
     def test_add_int8(self):
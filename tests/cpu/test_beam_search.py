@@ -0,0 +1,159 @@
+import unittest
+import itertools
+import sys
+import subprocess
+from types import SimpleNamespace
+from unittest import mock
+import torch
+import intel_extension_for_pytorch as ipex  # noqa F401
+from common_utils import TestCase
+
+try:
+    import transformers  # noqa F401
+except ImportError:
+    subprocess.check_call(
+        [sys.executable, "-m", "pip", "install", "transformers==4.45.0"]
+    )
+import transformers
+from packaging import version
+from transformers.generation.beam_search import BeamSearchScorer
+from transformers.generation.stopping_criteria import (
+    MaxLengthCriteria,
+    StoppingCriteriaList,
+)
+from intel_extension_for_pytorch.transformers.generation.beam_search import (
+    _NativeBeamSearch,
+)
+
+
+class BeamSearchStepTester(TestCase):
+    def _scorer(self, batch_size, num_beams, length_penalty, early_stopping):
+        return BeamSearchScorer(
+            batch_size=batch_size,
+            num_beams=num_beams,
+            device="cpu",
+            length_penalty=length_penalty,
+            do_early_stopping=early_stopping,
+            max_length=12,
+        )
+
+    def _finalize(self, scorer, input_ids, beam_scores, eos_token_id):
+        return scorer.finalize(
+            input_ids,
+            beam_scores,
+            None,
+            None,
+            pad_token_id=0,
+            eos_token_id=eos_token_id,
+            max_length=12,
+        )
+
+    @unittest.skipIf(
+        version.parse(transformers.__version__) < version.parse("4.36.0"),
+        "the native step follows the length normalization of transformers>=4.36",
+    )
+    def test_beam_search_step(self):
+        vocab = 50
+        # A single eos token, at most one candidate per beam ends it.
+        eos_token_id = [3]
+        for (
+            batch_size,
+            num_beams,
+            length_penalty,
+            early_stopping,
+        ) in itertools.product(
+            [1, 3],
+            [2, 4],
+            [1.0, -0.5],
+            [True, False, "never"],
+        ):
+            torch.manual_seed(0)
+            batch_beam = batch_size * num_beams
+            input_ids = torch.randint(8, vocab, (batch_beam, 4))
+            ref_scorer = self._scorer(
+                batch_size, num_beams, length_penalty, early_stopping
+            )
+            scorer = self._scorer(batch_size, num_beams, length_penalty, early_stopping)
+            native = _NativeBeamSearch(scorer, input_ids, 12, 0, eos_token_id)
+            ref_ids = input_ids
+            ref_beam_scores = torch.zeros(batch_size, num_beams)
+            ref_beam_scores[:, 1:] = -1e9
+            ref_beam_scores = ref_beam_scores.view(-1)
+            beam_scores = ref_beam_scores.clone()
+            while ref_ids.shape[-1] < 12 and not ref_scorer.is_done:
+                logits = torch.randn(batch_beam, vocab)
+                # eos often enough to finish hypotheses
+                logits[:, eos_token_id] += 1.5
+                scores = logits.log_softmax(dim=-1)
+
+                next_scores = (scores + ref_beam_scores[:, None]).view(batch_size, -1)
+                next_scores, next_tokens = torch.topk(
+                    next_scores, 2 * num_beams, dim=1, largest=True, sorted=True
+                )
+                outputs = ref_scorer.process(
+                    ref_ids,
+                    next_scores,
+                    next_tokens % vocab,
+                    next_tokens // vocab,
+                    pad_token_id=0,
+                    eos_token_id=eos_token_id,
+                )
+                ref_beam_scores = outputs["next_beam_scores"]
+                ref_idx = outputs["next_beam_indices"]
+                ref_ids = torch.cat(
+                    [ref_ids[ref_idx, :], outputs["next_beam_tokens"][:, None]],
+                    dim=-1,
+                )
+
+                _, beam_idx = native.step(scores, beam_scores)
+                self.assertEqual(beam_idx, ref_idx)
+                self.assertEqual(beam_scores, ref_beam_scores)
+                self.assertEqual(native.input_ids, ref_ids)
+                self.assertEqual(scorer._done, ref_scorer._done)
+
+            native.update_scorer(scorer)
+            ref = self._finalize(ref_scorer, ref_ids, ref_beam_scores, eos_token_id)
+            out = self._finalize(scorer, native.input_ids, beam_scores, eos_token_id)
+            self.assertEqual(out["sequences"], ref["sequences"])
+            self.assertEqual(out["sequence_scores"], ref["sequence_scores"])
+
+    def test_buffers(self):
+        for dtype in [torch.float, torch.bfloat16, torch.half]:
+            scorer = self._scorer(1, 2, 1.0, False)
+            input_ids = torch.tensor([[5, 6], [8, 9]])
+            native = _NativeBeamSearch(scorer, input_ids, 12, 0, [1])
+            scores = torch.full((2, 4), -10.0)
+            scores[1, 1] = -0.5
+            scores[1, 2] = -1.0
+            scores[1, 3] = -2.0
+            beam_scores = torch.zeros(2)
+            next_tokens, beam_idx = native.step(scores.to(dtype), beam_scores)
+            # The sequences are reordered from one buffer to the other, the
+            # eos candidate finishes a hypothesis.
+            self.assertEqual(next_tokens, torch.tensor([2, 3]))
+            self.assertEqual(beam_idx, torch.tensor([1, 1]))
+            self.assertEqual(beam_scores, torch.tensor([-1.0, -2.0]))
+            self.assertEqual(native.input_ids, torch.tensor([[8, 9, 2], [8, 9, 3]]))
+            self.assertEqual(native.hyp_lens, torch.tensor([[2, 0]]))
+            self.assertEqual(native.hyp_tokens[0, 0, :2], torch.tensor([8, 9]))
+            self.assertEqual(native.hyp_scores[0, 0].item(), -0.5 / 3)
+
+    @unittest.skipIf(
+        version.parse(transformers.__version__) < version.parse("4.36.0"),
+        "the scorer of transformers<4.36 is not supported by the native step",
+    )
+    def test_create_transformers_version(self):
+        model = SimpleNamespace(dtype=torch.float)
+        stopping_criteria = StoppingCriteriaList([MaxLengthCriteria(12)])
+        input_ids = torch.tensor([[5, 6], [8, 9]])
+        for trans_version, native in [("4.35.2", False), ("4.36.0", True)]:
+            scorer = self._scorer(1, 2, 1.0, False)
+            with mock.patch.object(transformers, "__version__", trans_version):
+                native_beam_search = _NativeBeamSearch.create(
+                    model, scorer, input_ids, stopping_criteria, 0, [1], False
+                )
+            self.assertEqual(native_beam_search is not None, native)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
@@ -1,5 +1,8 @@
 import unittest
+import glob
 import os
+import subprocess
+import sys
 import torch
 import intel_extension_for_pytorch as ipex
 
@@ -120,7 +123,7 @@ class CCLTester(unittest.TestCase):
         ipex.enable_onednn_fusion(False)  # just to workaround the flake8
         dtypes = [torch.float32, torch.float16, torch.bfloat16]
         tensor_sizes = [4096, 4096 * 32, 8 * 1024 * 5120 * 4 * 2]
-        # Less than 8 * 1024 * 5120 * 4 use SHM, otherwise use ccl allreduce
+        # Tensors larger than the SHM buffer are reduced through it in chunks
         # The above dispatch rule is transparent to users
         for dtype in dtypes:
             for tensor_size in tensor_sizes:
@@ -139,6 +142,43 @@ class CCLTester(unittest.TestCase):
         self.assertEqual(mpi_world_size, ipex.cpu.comm.get_world_size())
         self.assertEqual(mpi_rank, ipex.cpu.comm.get_rank())
 
+    @unittest.skipIf(not (has_ccl and world_size > 1), "oneccl is not built")
+    def test_all_reduce_add_many_blocks(self):
+        # More blocks of 5120 elements than the 4096 ones a round of the SHM
+        # reduction has states for, so it takes several rounds.
+        mpi_world_size = ipex.cpu.comm.get_world_size()
+        mpi_rank = ipex.cpu.comm.get_rank()
+        tensor_size = 4096 * 5120 + 3 * 5120 + 7
+        base = torch.arange(tensor_size) % 16
+        expected = base * mpi_world_size + mpi_world_size * (mpi_world_size - 1) // 2
+        for dtype in [torch.float32, torch.bfloat16]:
+            input_tensor = (base + mpi_rank).to(dtype)
+            ipex.cpu.comm.allreduce_add(input_tensor)
+            self.assertTrue(torch.equal(input_tensor, expected.to(dtype)))
+            ipex.cpu.comm.barrier()
+
+    @unittest.skipIf(not (has_ccl and world_size > 1), "oneccl is not built")
+    def test_all_reduce_add_async(self):
+        mpi_world_size = int(os.environ.get("PMI_SIZE", -1))
+        mpi_rank = int(os.environ.get("PMI_RANK", -1))
+        for dtype in [torch.float32, torch.float16, torch.bfloat16]:
+            inputs = [
+                torch.tensor([mpi_rank + 1.0 + i]).to(dtype).repeat(4096)
+                for i in range(4)
+            ]
+            handles = [ipex.cpu.comm.allreduce_add_async(t) for t in inputs]
+            # a blocking collective issued in between keeps the rank order
+            sync_input = torch.tensor([mpi_rank + 1.0]).to(dtype).repeat(4096)
+            ipex.cpu.comm.allreduce_add(sync_input)
+            for i, handle in enumerate(handles):
+                handle.wait()
+                self.assertTrue(handle.is_completed())
+                expected = mpi_world_size * (mpi_world_size + 1) / 2
+                expected += mpi_world_size * i
+                target = torch.tensor([float(expected)]).to(dtype).repeat(4096)
+                self.assertTrue(torch.allclose(inputs[i], target))
+            ipex.cpu.comm.barrier()
+
     @unittest.skipIf(not (has_ccl and world_size > 1), "oneccl is not built")
     def test_allgather(self):
         mpi_world_size = int(os.environ.get("PMI_SIZE", -1))
@@ -159,6 +199,110 @@ class CCLTester(unittest.TestCase):
                 output = ipex.cpu.comm.allgather(input, col_per_rank, mpi_world_size)
                 torch.allclose(expected_output, output)
 
+    @unittest.skipIf(not (has_ccl and world_size > 1), "oneccl is not built")
+    def test_allgather_out(self):
+        mpi_world_size = int(os.environ.get("PMI_SIZE", -1))
+        mpi_rank = int(os.environ.get("PMI_RANK", -1))
+        cols_per_rank = [0]
+        for i in range(mpi_world_size):
+            cols_per_rank.append(cols_per_rank[-1] + 3 + i)
+        for dtype in [torch.float32, torch.float16, torch.bfloat16]:
+            cols = cols_per_rank[mpi_rank + 1] - cols_per_rank[mpi_rank]
+            input = torch.arange(4 * cols).view(2, 2, cols).to(dtype) + mpi_rank
+            expected_output = torch.cat(
+                [
+                    torch.arange(
+                        4 * (cols_per_rank[i + 1] - cols_per_rank[i])
+                    ).view(2, 2, -1)
+                    + i
+                    for i in range(mpi_world_size)
+                ],
+                dim=-1,
+            ).to(dtype)
+            out = torch.empty(2, 2, cols_per_rank[-1], dtype=dtype)
+            for _ in range(2):
+                out.zero_()
+                output = ipex.cpu.comm.allgather(
+                    input, cols_per_rank, mpi_world_size, out=out
+                )
+                self.assertEqual(output.data_ptr(), out.data_ptr())
+                self.assertTrue(torch.equal(expected_output, out))
+
+    @unittest.skipIf(not (has_ccl and world_size > 1), "oneccl is not built")
+    def test_all_reduce_add_then_allgather(self):
+        # No barrier in between: a rank may start the allgather while the
+        # others still read the result of the allreduce from SHM.
+        mpi_world_size = ipex.cpu.comm.get_world_size()
+        mpi_rank = ipex.cpu.comm.get_rank()
+        cols_per_rank = list(range(0, 1024 * (mpi_world_size + 1), 1024))
+        base = torch.arange(4 * 1024 * 1024) % 16
+        for i in range(4):
+            input_tensor = (base + mpi_rank + i).float()
+            ipex.cpu.comm.allreduce_add(input_tensor)
+            gather_input = torch.full((64, 1024), float(mpi_rank + i))
+            output = ipex.cpu.comm.allgather(
+                gather_input, cols_per_rank, mpi_world_size
+            )
+            expected = (base + i) * mpi_world_size
+            expected += mpi_world_size * (mpi_world_size - 1) // 2
+            self.assertTrue(torch.equal(input_tensor, expected.float()))
+            for r in range(mpi_world_size):
+                window = output[:, cols_per_rank[r] : cols_per_rank[r + 1]]
+                self.assertTrue(torch.all(window == r + i))
+
+    @unittest.skipIf(
+        not (has_ccl and world_size > 1 and "PMI_SIZE" not in os.environ),
+        "only test when launched by torchrun",
+    )
+    def test_all_reduce_add_with_store(self):
+        # Bootstrapped through the torchrun store by the get_world_size call at
+        # the top of this file, the first collective of the process.
+        store_world_size = int(os.environ["WORLD_SIZE"])
+        store_rank = int(os.environ["RANK"])
+        self.assertEqual(store_world_size, ipex.cpu.comm.get_world_size())
+        self.assertEqual(store_rank, ipex.cpu.comm.get_rank())
+        for dtype in [torch.float32, torch.bfloat16]:
+            for tensor_size in [4096, 8 * 1024 * 5120 * 4 * 2]:
+                input_tensor = (
+                    torch.tensor([store_rank + 1.0]).to(dtype).repeat(tensor_size)
+                )
+                expected = store_world_size * (store_world_size + 1) / 2
+                target = torch.tensor([float(expected)]).to(dtype).repeat(tensor_size)
+                ipex.cpu.comm.allreduce_add(input_tensor)
+                self.assertTrue(torch.allclose(input_tensor, target))
+                ipex.cpu.comm.barrier()
+        # The SHM segment of the node of rank 0, named after its pid, is
+        # unlinked once all the local ranks mapped it.
+        if store_rank == 0:
+            self.assertEqual(glob.glob(f"/dev/shm/ipex_shm_buffer_{os.getpid()}_*"), [])
+
+    @unittest.skipIf(
+        not (has_ccl and world_size > 1 and "PMI_SIZE" not in os.environ),
+        "only test when launched by torchrun",
+    )
+    def test_all_reduce_add_first_with_store(self):
+        # A fresh process of every rank whose first collective is
+        # allreduce_add, on its own rendezvous port.
+        script = "\n".join(
+            [
+                "import os, torch",
+                "import intel_extension_for_pytorch as ipex",
+                "rank = int(os.environ['RANK'])",
+                "world_size = int(os.environ['WORLD_SIZE'])",
+                "input = torch.tensor([rank + 1.0]).repeat(4096)",
+                "ipex.cpu.comm.allreduce_add(input)",
+                "expected = world_size * (world_size + 1) / 2",
+                "assert torch.equal(input, torch.tensor([expected]).repeat(4096))",
+                "assert ipex.cpu.comm.get_world_size() == world_size",
+                "assert ipex.cpu.comm.get_rank() == rank",
+            ]
+        )
+        env = dict(os.environ)
+        env["MASTER_PORT"] = str(int(os.environ["MASTER_PORT"]) + 1)
+        result = subprocess.run([sys.executable, "-c", script], env=env)
+        self.assertEqual(result.returncode, 0)
+        ipex.cpu.comm.barrier()
+
 
 if __name__ == "__main__":
     test = unittest.main()
@@ -0,0 +1,101 @@
+import torch
+import intel_extension_for_pytorch as ipex  # noqa F401
+from common_utils import TestCase
+import unittest
+import itertools
+
+
+class FusedSampleTester(TestCase):
+    def _sample(self, logits, input_ids, seeds=None, **kwargs):
+        params = {
+            "temperature": 1.0,
+            "repetition_penalty": 1.0,
+            "presence_penalty": 0.0,
+            "top_k": 0,
+            "top_p": 1.0,
+        }
+        params.update(kwargs)
+        return torch.ops.torch_ipex.fused_sample(
+            logits, input_ids, seeds=seeds, **params
+        )
+
+    def test_greedy(self):
+        for dtype, vocab in itertools.product(
+            [torch.float, torch.bfloat16, torch.half], [100, 32000, 50257]
+        ):
+            logits = torch.randn(5, vocab).to(dtype)
+            input_ids = torch.randint(0, vocab, (5, 7))
+            ref = logits.float().argmax(dim=-1)
+            self.assertEqual(self._sample(logits, input_ids, temperature=0.0), ref)
+            self.assertEqual(self._sample(logits, input_ids, top_k=1), ref)
+            self.assertEqual(self._sample(logits, input_ids, top_p=1e-6), ref)
+
+    def test_repetition_penalty(self):
+        logits = torch.tensor([[2.0, 1.9, -1.0, -1.1]])
+        input_ids = torch.tensor([[0, 2]])
+        # 2.0 / 2 < 1.9, -1.0 * 2 < -1.1
+        out = self._sample(logits, input_ids, top_k=1, repetition_penalty=2.0)
+        self.assertEqual(out, torch.tensor([1]))
+        out = self._sample(logits, input_ids, top_k=1, presence_penalty=0.5)
+        self.assertEqual(out, torch.tensor([1]))
+
+    def test_seeds(self):
+        logits = torch.randn(4, 32000)
+        input_ids = torch.randint(0, 32000, (4, 3))
+        seeds = torch.tensor([1, 2, 3, 4])
+        out = self._sample(logits, input_ids, seeds, top_k=50, top_p=0.9)
+        # The draw of a row does not depend on the other rows of the batch.
+        for row in range(4):
+            self.assertEqual(
+                self._sample(
+                    logits[row : row + 1],
+                    input_ids[row : row + 1],
+                    seeds[row : row + 1],
+                    top_k=50,
+                    top_p=0.9,
+                ),
+                out[row : row + 1],
+            )
+
+    def test_distribution(self):
+        vocab = 64
+        num_samples = 4000
+        logits = torch.randn(1, vocab) * 4
+        input_ids = torch.zeros(1, 1, dtype=torch.long)
+        for top_k, top_p in [(0, 1.0), (10, 1.0), (0, 0.8), (20, 0.7)]:
+            scores = logits.clone()
+            if top_k > 0:
+                kth = scores.topk(top_k).values[:, -1:]
+                scores[scores < kth] = -float("inf")
+            if top_p < 1.0:
+                sorted_scores, sorted_idx = scores.sort(descending=False)
+                cum = sorted_scores.softmax(dim=-1).cumsum(dim=-1)
+                sorted_remove = cum <= 1 - top_p
+                remove = sorted_remove.scatter(1, sorted_idx, sorted_remove)
+                scores = scores.masked_fill(remove, -float("inf"))
+            ref = scores.softmax(dim=-1)[0]
+            seeds = torch.arange(num_samples)
+            out = self._sample(
+                logits.expand(num_samples, vocab),
+                input_ids.expand(num_samples, 1),
+                seeds,
+                top_k=top_k,
+                top_p=top_p,
+            )
+            self.assertTrue(bool((ref[out] > 0).all()))
+            # Pearson chi-square goodness of fit, the tokens expected less
+            # than 5 times are pooled into one bin.
+            observed = torch.bincount(out, minlength=vocab).double()
+            expected = ref.double() * num_samples
+            rare = expected < 5
+            observed = torch.cat([observed[~rare], observed[rare].sum().view(1)])
+            expected = torch.cat([expected[~rare], expected[rare].sum().view(1)])
+            observed, expected = observed[expected > 0], expected[expected > 0]
+            chi2 = ((observed - expected) ** 2 / expected).sum().item()
+            df = expected.numel() - 1
+            # About 6 standard deviations above the mean of the distribution.
+            self.assertLess(chi2, df + 6 * (2 * df) ** 0.5 + 10)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
@@ -0,0 +1,86 @@
+import torch
+import intel_extension_for_pytorch as ipex  # noqa F401
+from intel_extension_for_pytorch.quantization._GPTQ.gptq.gptq import GPTQ
+from common_utils import TestCase
+import unittest
+import itertools
+
+
+class GPTQSolverTester(TestCase):
+    def _quantize(self, layer, inputs, native, bits, sym, mse, **kwargs):
+        gptq = GPTQ(layer, layer.weight.data)
+        gptq.use_native_solver = native
+        gptq.quantizer.configure(bits, True, sym, mse)
+        for inp in inputs:
+            gptq.add_batch(inp, None)
+        scale, zero, Q = gptq.fasterquant(layer.weight.data.clone(), **kwargs)
+        return scale, zero, Q, gptq.perm
+
+    def _assert_close(self, x, y):
+        # The native solver sums the errors in another order, a few weights
+        # may round to the neighbouring level.
+        mismatch = ((x.float() - y.float()).abs() > 1e-4).float().mean()
+        self.assertLess(mismatch.item(), 0.01)
+
+    def test_gptq_solver(self):
+        for (
+            dtype,
+            bits,
+            groupsize,
+            sym,
+            act_order,
+            static_groups,
+            mse,
+        ) in itertools.product(
+            [torch.float, torch.bfloat16],
+            [4, 8],
+            [-1, 32, 48],
+            [False, True],
+            [False, True],
+            [False, True],
+            [False, True],
+        ):
+            if static_groups and groupsize == -1:
+                continue
+            layer = torch.nn.Linear(160, 96).to(dtype)
+            inputs = [torch.randn(2, 16, 160).to(dtype) for _ in range(4)]
+            # A dead input channel
+            for inp in inputs:
+                inp[..., 7] = 0
+            kwargs = {
+                "blocksize": 64,
+                "percdamp": 0.01,
+                "groupsize": groupsize,
+                "act_order": act_order,
+                "static_groups": static_groups,
+            }
+            scale, zero, Q, perm = self._quantize(
+                layer, inputs, True, bits, sym, mse, **kwargs
+            )
+            ref_scale, ref_zero, ref_Q, ref_perm = self._quantize(
+                layer, inputs, False, bits, sym, mse, **kwargs
+            )
+            self.assertEqual(Q.dtype, dtype)
+            self.assertEqual(scale.shape, ref_scale.shape)
+            self._assert_close(scale, ref_scale)
+            self._assert_close(zero, ref_zero)
+            self._assert_close(Q, ref_Q)
+            if act_order:
+                self.assertEqual(perm, ref_perm)
+
+    def test_gptq_solver_conv1d(self):
+        from transformers.pytorch_utils import Conv1D
+
+        layer = Conv1D(64, 128)
+        inputs = [torch.randn(1, 8, 128) for _ in range(2)]
+        scale, zero, Q, _ = self._quantize(layer, inputs, True, 4, False, False)
+        ref_scale, ref_zero, ref_Q, _ = self._quantize(
+            layer, inputs, False, 4, False, False
+        )
+        self.assertEqual(Q.shape, layer.weight.shape)
+        self._assert_close(scale, ref_scale)
+        self._assert_close(Q, ref_Q)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
@@ -0,0 +1,114 @@
+import unittest
+import itertools
+import torch
+import intel_extension_for_pytorch as ipex
+from torch._inductor.utils import run_and_get_code
+from common_utils import TestCase
+
+
+class LlamaRMSNorm(torch.nn.Module):
+    def __init__(self, hidden_size, eps=1e-6):
+        super().__init__()
+        self.weight = torch.nn.Parameter(torch.rand(hidden_size))
+        self.variance_epsilon = eps
+
+    def forward(self, hidden_states):
+        input_dtype = hidden_states.dtype
+        hidden_states = hidden_states.to(torch.float32)
+        variance = hidden_states.pow(2).mean(-1, keepdim=True)
+        hidden_states = hidden_states * torch.rsqrt(variance + self.variance_epsilon)
+        return self.weight * hidden_states.to(input_dtype)
+
+
+class LlamaFinalNorm(torch.nn.Module):
+    def __init__(self, hidden_size):
+        super().__init__()
+        self.norm = LlamaRMSNorm(hidden_size)
+
+    def forward(self, hidden_states, residual):
+        return self.norm(residual + hidden_states)
+
+
+class BertOutput(torch.nn.Module):
+    def __init__(self, hidden_size):
+        super().__init__()
+        self.dense = torch.nn.Linear(hidden_size, hidden_size)
+        self.LayerNorm = torch.nn.LayerNorm(hidden_size, eps=1e-12)
+
+    def forward(self, hidden_states, input_tensor):
+        hidden_states = self.dense(hidden_states)
+        return self.LayerNorm(hidden_states + input_tensor)
+
+
+class TestInductorFusion(TestCase):
+    def _compile(self, model, inputs):
+        torch._dynamo.reset()
+        ipex._set_compiler_backend("inductor")
+        with torch.no_grad():
+            ref = model(*inputs)
+            compiled = torch.compile(model, backend="ipex")
+            out, (code,) = run_and_get_code(compiled, *inputs)
+        self.assertEqual(out.dtype, ref.dtype)
+        return out, ref, code
+
+    def _test_fusion(self, model, inputs, op):
+        out, ref, code = self._compile(model, inputs)
+        prec = 2e-2 if out.dtype == torch.bfloat16 else 1e-4
+        self.assertEqual(out, ref, prec=prec)
+        self.assertIn(f"torch_ipex.{op}", code)
+
+    def test_rmsnorm(self):
+        for dtype, shape in itertools.product(
+            [torch.float32, torch.bfloat16], [(2, 7, 64), (5, 64)]
+        ):
+            model = LlamaRMSNorm(64).eval().to(dtype)
+            x = torch.randn(shape).to(dtype)
+            self._test_fusion(model, (x,), "rmsnorm")
+
+    def test_add_layernorm(self):
+        for dtype, shape in itertools.product(
+            [torch.float32, torch.bfloat16], [(2, 7, 64), (5, 64)]
+        ):
+            model = BertOutput(64).eval().to(dtype)
+            x = torch.randn(shape).to(dtype)
+            residual = torch.randn(shape).to(dtype)
+            self._test_fusion(model, (x, residual), "add_layernorm")
+
+    def test_add_rmsnorm(self):
+        for dtype, shape in itertools.product(
+            [torch.float32, torch.bfloat16], [(2, 7, 64), (5, 64)]
+        ):
+            model = LlamaFinalNorm(64).eval().to(dtype)
+            x = torch.randn(shape).to(dtype)
+            residual = torch.randn(shape).to(dtype)
+            out, ref, code = self._compile(model, (x, residual))
+            prec = 2e-2 if dtype == torch.bfloat16 else 1e-4
+            self.assertEqual(out, ref, prec=prec)
+            self.assertIn("torch_ipex.add_rmsnorm", code)
+            self.assertNotIn("torch_ipex.rmsnorm(", code)
+
+    def test_linear_eltwise(self):
+        # The oneDNN linear is used for bfloat16, and for float with the auto
+        # kernel selection.
+        for dtype, eltwise, bias in itertools.product(
+            [torch.float32, torch.bfloat16],
+            [torch.nn.ReLU(), torch.nn.Sigmoid()],
+            [True, False],
+        ):
+            model = torch.nn.Sequential(torch.nn.Linear(64, 32, bias=bias), eltwise)
+            model = ipex.optimize(model.eval(), dtype=dtype, auto_kernel_selection=True)
+            x = torch.randn(2, 7, 64).to(dtype)
+            self._test_fusion(model, (x,), "ipex_linear_eltwise")
+
+    def test_rmsnorm_float_weight(self):
+        # A float weight promotes the result to float, which the IPEX kernel
+        # does not, the pattern is left to Inductor.
+        model = LlamaRMSNorm(64).eval()
+        x = torch.randn(2, 7, 64).to(torch.bfloat16)
+        out, ref, code = self._compile(model, (x,))
+        self.assertEqual(out, ref, prec=1e-4)
+        self.assertNotIn("torch_ipex.rmsnorm", code)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
@@ -26,8 +26,12 @@ class TestInteractionCases(TestCase):
             return R
 
         dtypes = [torch.float32, torch.bfloat16]
-        feature_sizes = [127, 128]
-        for dtype, feature_size in itertools.product(dtypes, feature_sizes):
+        feature_sizes = [127, 128, 36]
+        # 26 is the sparse feature count of the MLPerf DLRM
+        sparse_nums = [26, 8]
+        for dtype, feature_size, sparse_num in itertools.product(
+            dtypes, feature_sizes, sparse_nums
+        ):
             x1 = (
                 torch.randn([2048, feature_size])
                 .to(dtype)
@@ -38,7 +42,7 @@ class TestInteractionCases(TestCase):
             x2 = x1.clone().detach().requires_grad_()
             ly1 = []
             ly2 = []
-            for i in range(0, 26):
+            for i in range(0, sparse_num):
                 V = (
                     torch.randn([2048, feature_size])
                     .to(dtype)
@@ -78,7 +82,7 @@ class TestInteractionCases(TestCase):
             A.sum().backward()
             B.sum().backward()
             torch.testing.assert_allclose(x1.grad, x2.grad, rtol=rtol, atol=atol)
-            for i in range(0, 26):
+            for i in range(0, sparse_num):
                 torch.testing.assert_allclose(
                     ly1[i].grad, ly2[i].grad, rtol=rtol, atol=atol
                 )
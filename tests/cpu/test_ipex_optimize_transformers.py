@@ -8,6 +8,7 @@ import os
 import copy
 import re
 import tempfile
+from unittest import mock
 from intel_extension_for_pytorch.quantization import prepare, convert
 from collections import namedtuple
 import itertools
@@ -307,6 +308,35 @@ class OptimizeTransformersTester(TestCase):
                 )
                 self.assertEqual(y[0], y_ref[0], prec=tol)
 
+    def test_weight_only_quant_shared_weights_dir(self):
+        from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+            SHARED_WEIGHTS_DIR_ENV,
+        )
+
+        config = AutoConfig.from_pretrained(
+            f"{curpath}/hf_configs/gptj", return_dict=False
+        )
+        m = transformers.models.gptj.modeling_gptj.GPTJForCausalLM(config).eval()
+        qconfig_mapping = ipex.quantization.get_weight_only_quant_qconfig_mapping()
+        example_inputs = _get_gptj_example_inputs()
+        outputs = []
+        with tempfile.TemporaryDirectory() as tmp, mock.patch.dict(
+            os.environ, {SHARED_WEIGHTS_DIR_ENV: tmp}
+        ):
+            # The first instance packs the weights, the second one maps them
+            for _ in range(2):
+                model = ipex.llm.optimize(
+                    copy.deepcopy(m),
+                    dtype=torch.float,
+                    quantization_config=qconfig_mapping,
+                    deployment_mode=True,
+                )
+                with torch.no_grad():
+                    outputs.append(model(*example_inputs)[0])
+            packed = [f for f in os.listdir(tmp) if f.endswith(".ipexpack")]
+            self.assertEqual(len(packed), 1)
+        self.assertEqual(outputs[0], outputs[1])
+
     def test_static_quant_flow(self):
         config = AutoConfig.from_pretrained(
             f"{curpath}/hf_configs/gptj", return_dict=False
@@ -5,6 +5,7 @@ import sys
 import subprocess
 import os
 import copy
+from unittest import mock
 from intel_extension_for_pytorch.transformers import (
     shard_mha_weights,
     shard_mlp_weights,
@@ -207,6 +208,112 @@ class TensorParallelTester(TestCase):
         self.assertTrue(tp_model.lm_head, TensorParallelLMhead)
         self.tensor_parallel_with_optimize_transformers(model)
 
+    def test_tensor_parallel_lm_head_topk_generation(self):
+        config = AutoConfig.from_pretrained(
+            f"{curpath}/hf_configs/llama", return_dict=False
+        )
+        torch.manual_seed(0)
+        model = transformers.models.llama.modeling_llama.LlamaForCausalLM(config).eval()
+        shard_policy = os.environ.get("LM_HEAD_SHARD_POLICY")
+        os.environ["LM_HEAD_SHARD_POLICY"] = "col"
+        try:
+            ipex_model = ipex.llm.optimize(
+                model, dtype=torch.float, deployment_mode=False
+            )
+        finally:
+            if shard_policy is None:
+                del os.environ["LM_HEAD_SHARD_POLICY"]
+            else:
+                os.environ["LM_HEAD_SHARD_POLICY"] = shard_policy
+        self.assertTrue(ipex_model.lm_head.fused_topk)
+        input_ids = torch.randint(2, config.vocab_size, (2, 8))
+        attention_mask = torch.ones_like(input_ids)
+        for num_beams in [1, 4]:
+            generate_kwargs = {
+                "attention_mask": attention_mask,
+                "do_sample": False,
+                "num_beams": num_beams,
+                "max_new_tokens": 8,
+            }
+            with torch.no_grad(), mock.patch.object(
+                TensorParallelLMhead,
+                "topk",
+                autospec=True,
+                side_effect=TensorParallelLMhead.topk,
+            ) as topk:
+                output = ipex_model.generate(input_ids, **generate_kwargs)
+            self.assertTrue(topk.called)
+            # Returning the scores needs the gathered logits.
+            with torch.no_grad():
+                ref = ipex_model.generate(
+                    input_ids,
+                    output_scores=True,
+                    return_dict_in_generate=True,
+                    **generate_kwargs,
+                ).sequences
+            self.assertEqual(output, ref)
+
+
+class LMHeadTopkTester(TestCase):
+    def _optimize(self, deployment_mode):
+        config = AutoConfig.from_pretrained(
+            f"{curpath}/hf_configs/llama", return_dict=False
+        )
+        torch.manual_seed(0)
+        model = transformers.models.llama.modeling_llama.LlamaForCausalLM(config).eval()
+        ref_model = copy.deepcopy(model)
+        # Optimize the model as a single rank one, also when the tests are
+        # run by several ranks.
+        with mock.patch.object(ipex_comm, "get_world_size", return_value=1), mock.patch(
+            "intel_extension_for_pytorch.transformers.optimize.distributed", False
+        ):
+            ipex_model = ipex.llm.optimize(
+                model, dtype=torch.float, deployment_mode=deployment_mode
+            )
+        return config, ref_model, ipex_model
+
+    def test_lm_head_topk_single_rank(self):
+        config, ref_model, ipex_model = self._optimize(deployment_mode=False)
+        self.assertTrue(isinstance(ipex_model.lm_head, TensorParallelLMhead))
+        self.assertTrue(ipex_model.lm_head.fused_topk)
+        hidden = torch.randn(2, 3, config.hidden_size)
+        with torch.no_grad():
+            logits = ref_model.lm_head(hidden)
+            self.assertEqual(ipex_model.lm_head(hidden), logits)
+            values, indices = ipex_model.lm_head.topk(hidden, k=4)
+        ref_values, ref_indices = logits.topk(4, dim=-1)
+        self.assertEqual(values, ref_values)
+        self.assertEqual(indices, ref_indices)
+        input_ids = torch.randint(2, config.vocab_size, (2, 8))
+        generate_kwargs = {
+            "attention_mask": torch.ones_like(input_ids),
+            "do_sample": False,
+            "num_beams": 1,
+            "max_new_tokens": 8,
+        }
+        with torch.no_grad(), mock.patch.object(
+            TensorParallelLMhead,
+            "topk",
+            autospec=True,
+            side_effect=TensorParallelLMhead.topk,
+        ) as topk:
+            output = ipex_model.generate(input_ids, **generate_kwargs)
+        self.assertTrue(topk.called)
+        with torch.no_grad():
+            ref = ipex_model.generate(
+                input_ids,
+                output_scores=True,
+                return_dict_in_generate=True,
+                **generate_kwargs,
+            ).sequences
+        self.assertEqual(output, ref)
+
+    def test_lm_head_topk_deployment_mode(self):
+        # The traced model keeps the gathered logits, so its LM head is
+        # neither wrapped nor kept in the plain layout.
+        _, _, ipex_model = self._optimize(deployment_mode=True)
+        self.assertFalse(isinstance(ipex_model.lm_head, TensorParallelLMhead))
+
 
 if __name__ == "__main__":
     test = unittest.main()
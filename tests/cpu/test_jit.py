@@ -1402,6 +1402,20 @@ class AddLayerNorm_v2(torch.nn.Module):
         )
 
 
+class GroupNormAct(torch.nn.Module):
+    def __init__(self, channels, act, add):
+        super(GroupNormAct, self).__init__()
+        self.norm = torch.nn.GroupNorm(32, channels, eps=1e-6)
+        self.act = act
+        self.add = add
+
+    def forward(self, x, y):
+        x = self.act(self.norm(x))
+        if self.add:
+            x = x + y
+        return x
+
+
 class ConcatBnRelu(torch.nn.Module):
     def __init__(self, dim, cat_dim, in_channels, **kwargs):
         super(ConcatBnRelu, self).__init__()
@@ -2206,6 +2220,46 @@ class Tester(TestCase):
                 torch._C._jit_set_texpr_fuser_enabled(pre_te_enable_status)
                 self.assertTrue(any(n.kind() == node for n in trace_graph.nodes()))
 
+    def test_group_norm_act(self):
+        for act, add, channels_last, dtype in itertools.product(
+            [
+                torch.nn.SiLU(),
+                torch.nn.GELU(),
+                torch.nn.GELU(approximate="tanh"),
+                torch.nn.Identity(),
+            ],
+            [True, False],
+            [True, False],
+            [torch.float, torch.bfloat16],
+        ):
+            if isinstance(act, torch.nn.Identity) and not add:
+                continue
+            model = GroupNormAct(64, act, add).eval().to(dtype)
+            x = torch.randn(2, 64, 16, 16).to(dtype)
+            y = torch.randn(2, 64, 16, 16).to(dtype)
+            if channels_last:
+                model = model.to(memory_format=torch.channels_last)
+                x = x.to(memory_format=torch.channels_last)
+                y = y.to(memory_format=torch.channels_last)
+            with torch.no_grad():
+                ori_res = model(x, y)
+                jit_model = torch.jit.freeze(torch.jit.trace(model, (x, y)))
+                jit_model(x, y)
+                trace_graph = jit_model.graph_for(x, y)
+                jit_res = jit_model(x, y)
+            prec = 2e-2 if dtype == torch.bfloat16 else 1e-5
+            self.assertEqual(jit_res, ori_res, prec=prec)
+            self.assertTrue(
+                any(n.kind() == "ipex::group_norm_act" for n in trace_graph.nodes())
+            )
+            # A broadcast residual falls back to a separate add
+            if add:
+                y_bcast = torch.randn(1, 64, 1, 1).to(dtype)
+                with torch.no_grad():
+                    self.assertEqual(
+                        jit_model(x, y_bcast), model(x, y_bcast), prec=prec
+                    )
+
     def test_concat_bn_relu(self):
         batch_size = 3
         image_size = 16
@@ -1067,6 +1067,42 @@ class TestAPI(JitLlgaTestCase):
         # set the value back to the default one
         ipex._C._jit_set_llga_weight_cache_enabled(weight_cache_enabled_default_value)
 
+    @llga_fp32_bf16_test_env
+    def test_shape_buckets(self):
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.linear = nn.Linear(32, 64)
+
+            def forward(self, x):
+                return F.gelu(self.linear(x))
+
+        m = M().eval()
+        x = torch.randn(2, 48, 32)
+        graph, traced = self.checkTrace(m, [x])
+        self.assertGraphContainsExactly(graph, LLGA_FUSION_GROUP, 1)
+
+        self.assertEqual(ipex._C._jit_llga_shape_buckets(), [])
+        ipex._C._jit_set_llga_shape_buckets([128, 64])
+        ipex._C._jit_reset_llga_shape_bucket_stats()
+        try:
+            self.assertEqual(ipex._C._jit_llga_shape_buckets(), [64, 128])
+            seq_lens = [7, 13, 33, 64, 65, 100]
+            with torch.no_grad():
+                for seq_len in seq_lens:
+                    x = torch.randn(2, seq_len, 32)
+                    self.assertEqual(traced(x), m(x))
+            stats = ipex._C._jit_llga_shape_bucket_stats()
+            self.assertEqual(stats["bucketed_runs"], len(seq_lens))
+            self.assertEqual(stats["distinct_shapes"], len(seq_lens))
+            # one compilation per bucket
+            self.assertEqual(stats["compilations"], 2)
+            self.assertEqual(stats["compilations_saved"], len(seq_lens) - 2)
+            self.assertGreater(stats["padding_elements"], 0)
+        finally:
+            ipex._C._jit_set_llga_shape_buckets([])
+            ipex._C._jit_reset_llga_shape_bucket_stats()
+
 
 class TestDebugLog(JitLlgaTestCase):
     def test_fusion_group_name(self):
@@ -0,0 +1,46 @@
+import torch
+import intel_extension_for_pytorch as ipex  # noqa F401
+from common_utils import TestCase
+import unittest
+import itertools
+
+
+class LMHeadTopKTester(TestCase):
+    def _ref(self, hidden, weight, bias, k, log_probs):
+        logits = torch.nn.functional.linear(hidden.float(), weight.float(), bias)
+        if log_probs:
+            logits = torch.log_softmax(logits, dim=-1)
+        return logits.topk(k, dim=-1)
+
+    def test_lm_head_topk(self):
+        for dtype, batch, k, with_bias, log_probs in itertools.product(
+            [torch.float, torch.bfloat16, torch.half],
+            [1, 3, 8],
+            [1, 4, 40],
+            [False, True],
+            [False, True],
+        ):
+            hidden = torch.randn(batch, 136).to(dtype)
+            weight = torch.randn(5003, 136).to(dtype)
+            bias = torch.randn(5003) if with_bias else None
+            values, indices, lse = torch.ops.torch_ipex.lm_head_topk(
+                hidden, weight, bias, k, log_probs
+            )
+            if log_probs:
+                values = values - lse.unsqueeze(-1)
+            ref_values, ref_indices = self._ref(hidden, weight, bias, k, log_probs)
+            self.assertEqual(values, ref_values, prec=1e-3)
+            self.assertEqual(indices, ref_indices)
+
+    def test_lm_head_argmax(self):
+        hidden = torch.randn(4, 64)
+        weight = torch.randn(32000, 64)
+        _, indices, _ = torch.ops.torch_ipex.lm_head_topk(
+            hidden, weight, None, 1, False
+        )
+        ref = torch.argmax(hidden @ weight.t(), dim=-1, keepdim=True)
+        self.assertEqual(indices, ref)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
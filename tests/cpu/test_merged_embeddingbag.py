@@ -6,6 +6,8 @@ from bench.custom_op_bench.merged_embeddingbag import (
     MergedEmb,
     EmbeddingBagListCatDense,
     MergedEmbCatDense,
+    EmbeddingBagListInteractionDense,
+    MergedEmbInteractionDense,
     MergedEmbSGD,
     MergedEmbAdaGrad,
 )
@@ -160,6 +162,43 @@ class TestMergedEmbedding(TestCase):
                             dense = torch.randn(B, NUM_DIM, dtype=dtype)
                             self._test_inference(m, ref_m, (indices, offsets, dense))
 
+    def test_interaction_inference(self):
+        B = 1029
+        NUM_TABLE = 26
+        indices = [
+            torch.randint(1000, (B * self.multi_hot[i],)) for i in range(NUM_TABLE)
+        ]
+        offsets = [
+            torch.arange(0, B * self.multi_hot[i], self.multi_hot[i])
+            for i in range(NUM_TABLE)
+        ]
+        for dtype in [torch.float32, torch.bfloat16]:
+            for NUM_DIM in [128, 36]:
+                emb_list = EmbeddingBagList(NUM_TABLE, NUM_DIM, dtype)
+                ref_m = EmbeddingBagListInteractionDense(emb_list)
+                m = MergedEmbInteractionDense(emb_list)
+                dense = torch.randn(B, NUM_DIM, dtype=dtype)
+                m.eval()
+                ref_m.eval()
+                with torch.no_grad():
+                    out = m(indices, offsets, dense)
+                    ref_out = ref_m(indices, offsets, dense)
+                    jit_m = torch.jit.freeze(
+                        torch.jit.trace(m, (indices, offsets, dense))
+                    )
+                    jit_m(indices, offsets, dense)
+                    jit_out = jit_m(indices, offsets, dense)
+                # Both round the pooled embeddings to bf16 before the
+                # interaction, but the reference pools them with another
+                # kernel, so a pooled value may round to a neighbouring bf16
+                # one and the interaction products amplify that difference.
+                if dtype == torch.bfloat16:
+                    rtol, atol = 0.05, 0.5
+                else:
+                    rtol, atol = 1e-4, 1e-3
+                self.assertEqual(out, ref_out, rtol=rtol, atol=atol)
+                self.assertEqual(jit_out, out)
+
     def test_training(self):
         B = 1029
         NUM_TABLE = 26
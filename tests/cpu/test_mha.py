@@ -6,6 +6,7 @@ import torch.nn.functional as F
 import intel_extension_for_pytorch as ipex
 import math
 import copy
+import itertools
 from common_utils import TestCase
 
 
@@ -931,6 +932,44 @@ class TransFreeMHATester(TestCase):
             for i in range(7):
                 self.assertEqual(fake_mha_ref[i], fake_mha_jit[i], prec=1e-5)
 
+    def test_bert_mha_varlen(self):
+        seq_lens = [5, 33, 1, 130, 600]
+        cu_seqlens = torch.tensor([0] + seq_lens).cumsum(0)
+        for dtype, (num_head, head_size) in itertools.product(
+            [torch.float, torch.bfloat16, torch.half], [(4, 64), (3, 17)]
+        ):
+            hidden = num_head * head_size
+            qkv = torch.randn(sum(seq_lens), 3 * hidden).to(dtype)
+            scale = 1 / math.sqrt(head_size)
+            out = torch.ops.torch_ipex.bert_mha_varlen(
+                qkv, cu_seqlens, num_head, head_size, scale
+            )
+            self.assertEqual(out.shape, (sum(seq_lens), num_head, head_size))
+            self.assertEqual(out.dtype, dtype)
+            # Each sequence attends to its own tokens only
+            offsets = cu_seqlens.tolist()
+            for start, end in zip(offsets[:-1], offsets[1:]):
+                q, k, v = (
+                    qkv[start:end]
+                    .float()
+                    .view(end - start, 3, num_head, head_size)
+                    .permute(1, 2, 0, 3)
+                    .unbind(0)
+                )
+                ref = F.scaled_dot_product_attention(q, k, v, scale=scale)
+                self.assertEqual(
+                    out[start:end].float(),
+                    ref.transpose(0, 1),
+                    prec=1e-4 if dtype == torch.float else 2e-2,
+                )
+
+    def test_bert_mha_varlen_invalid_cu_seqlens(self):
+        qkv = torch.randn(10, 3 * 64)
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.ops.torch_ipex.bert_mha_varlen(
+                qkv, torch.tensor([0, 6, 4, 10]), 1, 64, 0.125
+            )
+
 
 if __name__ == "__main__":
     test = unittest.main()
@@ -1,4 +1,5 @@
 import itertools
+import os
 import tempfile
 import torch
 import torch.nn as nn
@@ -11,6 +12,7 @@ from torch.ao.quantization import (
 )
 import copy
 import unittest
+from unittest import mock
 import numpy
 from common_utils import TestCase
 
@@ -563,6 +565,152 @@ class TestDefaultRecipe(JitLlgaTestCase):
                 assert num_mul == 1 if share_weight_observers else 3
                 q_model(x)
 
+    def test_smooth_quant_observe(self):
+        from intel_extension_for_pytorch.quantization._smooth_quant import (
+            PerICMinMaxObserver,
+        )
+
+        for dtype, shape in itertools.product(
+            [torch.float, torch.bfloat16, torch.half], [(2, 7, 4100), (3, 17)]
+        ):
+            obs = PerICMinMaxObserver(ch_axis=-1)
+            ref_obs = PerChannelMinMaxObserver(ch_axis=-1)
+            for _ in range(3):
+                x = torch.randn(shape).to(dtype)
+                obs(x)
+                ref_obs(x)
+            self.assertEqual(obs.min_val, ref_obs.min_val)
+            self.assertEqual(obs.max_val, ref_obs.max_val)
+        # Weight, IC on dim 1
+        w = torch.randn(32, 64)
+        obs = PerICMinMaxObserver(ch_axis=1)
+        ref_obs = PerChannelMinMaxObserver(ch_axis=1)
+        obs(w)
+        ref_obs(w)
+        self.assertEqual(obs.min_val, ref_obs.min_val)
+        self.assertEqual(obs.max_val, ref_obs.max_val)
+
+    def test_smooth_quant_alpha_search(self):
+        def ref_error(x_min, x_max, w_min, w_max, alpha):
+            x_abs = torch.max(x_min.abs(), x_max.abs()).double() + 1e-6
+            w_abs = torch.max(w_min.abs(), w_max.abs()).double() + 1e-6
+            s = x_abs.pow(alpha) / w_abs.pow(1 - alpha)
+            range_x = (x_max / s).max().clamp(min=0) - (x_min / s).min().clamp(max=0)
+            range_w = 2 * (w_abs * s).max()
+            return (
+                range_x**2 * (w_abs * s).pow(2).sum()
+                + range_w**2 * (x_abs / s).pow(2).sum()
+            )
+
+        torch.manual_seed(0)
+        grid = [round(0.05 * i, 2) for i in range(21)]
+        for _ in range(5):
+            x_max = torch.rand(64) * torch.randint(1, 50, (64,))
+            x_min = -torch.rand(64) * torch.randint(1, 50, (64,))
+            w_max = torch.rand(64)
+            w_min = -torch.rand(64)
+            act_factors, wei_factors, alpha = (
+                torch.ops.torch_ipex.smooth_quant_scaling_factors(
+                    x_min, x_max, w_min, w_max, grid
+                )
+            )
+            errors = [ref_error(x_min, x_max, w_min, w_max, a) for a in grid]
+            self.assertEqual(alpha, grid[min(range(21), key=lambda i: errors[i])])
+            x_abs = torch.max(x_min.abs(), x_max.abs()) + 1e-6
+            w_abs = torch.max(w_min.abs(), w_max.abs()) + 1e-6
+            ref = torch.pow(x_abs, alpha) / torch.pow(w_abs, 1 - alpha)
+            self.assertEqual(wei_factors, ref)
+            self.assertEqual(act_factors, 1 / ref)
+
+        # Activation and weight select the same alpha per layer
+        class Mod(nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.fc1 = nn.Linear(8, 8)
+                self.fc2 = nn.Linear(8, 4)
+
+            def forward(self, x):
+                return self.fc2(torch.relu(self.fc1(x)))
+
+        m = Mod().eval()
+        x = torch.randn(4, 8)
+        x[:, 0] *= 30
+        qconfig_mapping = ipex.quantization.get_smooth_quant_qconfig_mapping(
+            alpha="auto"
+        )
+        prepared_model = ipex.quantization.prepare(
+            m, qconfig_mapping, example_inputs=x, inplace=False
+        )
+        prepared_model(x)
+        sq_observers = ipex.quantization._smooth_quant
+        act_obs = [
+            obs
+            for obs in prepared_model.modules()
+            if isinstance(obs, sq_observers.SmoothQuantActivationObserver)
+            and obs.smooth_quant_enabled
+        ]
+        wei_obs = [
+            obs
+            for obs in prepared_model.modules()
+            if isinstance(obs, sq_observers.SmoothQuantWeightObserver)
+            and obs.smooth_quant_enabled
+        ]
+        self.assertEqual(len(act_obs), 2)
+        self.assertEqual(len(wei_obs), 2)
+        # The observers are released by convert
+        q_model = ipex.quantization.convert(prepared_model, inplace=True)
+        with torch.no_grad():
+            q_model = torch.jit.trace(q_model, x)
+            q_model = torch.jit.freeze(q_model)
+            q_model(x)
+        for obs in act_obs + wei_obs:
+            self.assertIn(obs.alpha, grid)
+        self.assertEqual(
+            sorted(obs.alpha for obs in act_obs),
+            sorted(obs.alpha for obs in wei_obs),
+        )
+
+    def test_smooth_quant_save_load_qconf_summary_auto_alpha(self):
+        class Mod(nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.fc1 = nn.Linear(8, 8)
+                self.fc2 = nn.Linear(8, 4)
+
+            def forward(self, x):
+                return self.fc2(torch.relu(self.fc1(x)))
+
+        m = Mod().eval()
+        x = torch.randn(4, 8)
+        x[:, 0] *= 30
+        qconfig_mapping = ipex.quantization.get_smooth_quant_qconfig_mapping(
+            alpha="auto"
+        )
+        prepared_model = ipex.quantization.prepare(
+            m, qconfig_mapping, example_inputs=x, inplace=False
+        )
+        prepared_model(x)
+        with tempfile.NamedTemporaryFile() as fp:
+            prepared_model.save_qconf_summary(qconf_summary=fp.name)
+            # The default per IC observers are restored by name
+            prepared_model_2 = ipex.quantization.prepare(
+                m, qconfig_mapping, example_inputs=x, inplace=False
+            )
+            prepared_model_2.load_qconf_summary(qconf_summary=fp.name)
+        sq_observers = ipex.quantization._smooth_quant
+        for model in [prepared_model, prepared_model_2]:
+            for obs in model.modules():
+                if isinstance(obs, sq_observers.SmoothQuantActivationObserver):
+                    self.assertIsInstance(obs.ic_obs, sq_observers.PerICMinMaxObserver)
+        outputs = []
+        for model in [prepared_model, prepared_model_2]:
+            q_model = ipex.quantization.convert(model)
+            with torch.no_grad():
+                q_model = torch.jit.trace(q_model, x)
+                q_model = torch.jit.freeze(q_model)
+                outputs.append(q_model(x))
+        self.assertEqual(outputs[0], outputs[1])
+
     def test_smooth_quant_autotune(self):
         class DemoModel(torch.nn.Module):
             def __init__(self):
@@ -921,6 +1069,179 @@ class WeightOnlyQuantizationTester(TestCase):
         for shape, use_bias, w_dtype in cases:
             test(shape, use_bias, w_dtype)
 
+    def test_weight_only_quantization_packed_checkpoint(self):
+        from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+            packed_woq_checkpoint,
+        )
+
+        class M(nn.Module):
+            def __init__(self, input_channel, output_channel, has_bias):
+                super(M, self).__init__()
+                self.linear = torch.nn.Linear(input_channel, output_channel, has_bias)
+                self.linear2 = torch.nn.Linear(output_channel, input_channel, has_bias)
+
+            def forward(self, x):
+                return self.linear2(self.linear(x))
+
+        def test(feature, has_bias, w_dtype, lowp_mode, group_size):
+            model = M(feature[1], feature[2], has_bias).eval()
+            example_inputs = torch.rand(feature[0], feature[1])
+            qconfig = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+                weight_dtype=w_dtype,
+                lowp_mode=lowp_mode,
+                group_size=group_size,
+            )
+
+            def quantize():
+                prepared_model = prepare(
+                    model, qconfig, example_inputs=example_inputs, inplace=False
+                )
+                return convert(prepared_model)
+
+            with torch.no_grad(), tempfile.TemporaryDirectory() as tmp:
+                path = os.path.join(tmp, "model.ipexpack")
+                # The first conversion saves the packed weights
+                with packed_woq_checkpoint(path):
+                    converted_model = quantize()
+                self.assertTrue(os.path.exists(path))
+                output_ref = converted_model(example_inputs)
+                # The second one loads them
+                with packed_woq_checkpoint(path):
+                    loaded_model = quantize()
+                for name in ["linear", "linear2"]:
+                    ref = getattr(converted_model, name)
+                    loaded = getattr(loaded_model, name)
+                    self.assertTrue(torch.equal(ref.weight, loaded.weight))
+                    self.assertEqual(ref.extra_repr(), loaded.extra_repr())
+                torch.testing.assert_close(output_ref, loaded_model(example_inputs))
+                # A different model does not load
+                model.linear2 = torch.nn.Linear(feature[2], feature[1] + 1, has_bias)
+                with self.assertRaises(RuntimeError):
+                    with packed_woq_checkpoint(path):
+                        quantize()
+                # A failed write leaves no temporary file behind
+                os.remove(path)
+                with mock.patch.object(os, "replace", side_effect=OSError):
+                    with self.assertRaises(OSError):
+                        with packed_woq_checkpoint(path):
+                            quantize()
+                self.assertEqual(os.listdir(tmp), ["model.ipexpack.lock"])
+
+        shape_list = [
+            [3, 31, 31],
+            [4, 256, 128],
+        ]
+        use_bias_list = [True, False]
+        w_dtype_list = [WoqWeightDtype.INT8, WoqWeightDtype.INT4]
+        lowp_mode_list = [WoqLowpMode.NONE, WoqLowpMode.BF16]
+        group_size_list = [-1, 32]
+        cases = itertools.product(
+            shape_list, use_bias_list, w_dtype_list, lowp_mode_list, group_size_list
+        )
+        for shape, use_bias, w_dtype, lowp_mode, group_size in cases:
+            test(shape, use_bias, w_dtype, lowp_mode, group_size)
+
+    def test_weight_only_quantization_shared_weights_path(self):
+        from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+            SHARED_WEIGHTS_DIR_ENV,
+            shared_weights_path,
+        )
+
+        with mock.patch.dict(os.environ):
+            os.environ.pop(SHARED_WEIGHTS_DIR_ENV, None)
+            self.assertIsNone(shared_weights_path("model"))
+        with tempfile.TemporaryDirectory() as tmp, mock.patch.dict(
+            os.environ, {SHARED_WEIGHTS_DIR_ENV: tmp}
+        ):
+            path = shared_weights_path("model", {"dtype": "torch.bfloat16"})
+            self.assertEqual(os.path.dirname(path), tmp)
+            self.assertEqual(
+                path, shared_weights_path("model", {"dtype": "torch.bfloat16"})
+            )
+            # Another config has its own file
+            self.assertNotEqual(
+                path, shared_weights_path("model", {"dtype": "torch.float32"})
+            )
+
+    def test_weight_only_quantization_state_dict_digest(self):
+        from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+            state_dict_digest,
+        )
+
+        state_dict = {
+            "qweight": torch.randint(
+                -(2**31), 2**31 - 1, (512, 256), dtype=torch.int32
+            ),
+            "scales": torch.randn(4, 256, dtype=torch.half),
+        }
+        digest = state_dict_digest(state_dict)
+        self.assertEqual(digest, state_dict_digest(dict(state_dict)))
+        for name in state_dict:
+            other = dict(state_dict)
+            other[name] = torch.randn_like(state_dict[name].float()).to(
+                state_dict[name].dtype
+            )
+            self.assertNotEqual(digest, state_dict_digest(other))
+        other = dict(state_dict, scales=state_dict["scales"].view(2, 512))
+        self.assertNotEqual(digest, state_dict_digest(other))
+        # Only the metadata of the tensors without data
+        meta = {k: v.to("meta") for k, v in state_dict.items()}
+        self.assertNotEqual(digest, state_dict_digest(meta))
+
+    def test_weight_only_quantization_packed_checkpoint_lowp(self):
+        from intel_extension_for_pytorch.nn.utils._packed_checkpoint import (
+            packed_woq_checkpoint,
+        )
+        from intel_extension_for_pytorch.utils import weight_only_quantization
+
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.linear = torch.nn.Linear(256, 128)
+
+            def forward(self, x):
+                return self.linear(x)
+
+        # GPTQ format: int4 packed in int32 along IC for the weight, along OC
+        # for the zero points.
+        group_size = 32
+        state_dict = {
+            "linear.qweight": torch.randint(
+                -(2**31), 2**31 - 1, (256 // 8, 128), dtype=torch.int32
+            ),
+            "linear.scales": torch.rand(256 // group_size, 128).half() / 100,
+            "linear.qzeros": torch.randint(
+                -(2**31), 2**31 - 1, (256 // group_size, 128 // 8), dtype=torch.int32
+            ),
+        }
+        qconfig = ipex.quantization.get_weight_only_quant_qconfig_mapping(
+            weight_dtype=WoqWeightDtype.INT4, lowp_mode=WoqLowpMode.BF16
+        )
+        model = M().eval()
+        example_inputs = torch.rand(3, 256)
+
+        def convert_lowp():
+            return weight_only_quantization._convert_woq_with_low_precision_checkpoint(
+                model, qconfig, state_dict, "gptq", inplace=False
+            )
+
+        with torch.no_grad(), tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "model.ipexpack")
+            with packed_woq_checkpoint(path):
+                converted_model = convert_lowp()
+            output_ref = converted_model(example_inputs)
+            # The load does not read nor unpack the low precision weights
+            with mock.patch.object(
+                weight_only_quantization,
+                "_get_linear_parameters",
+                side_effect=AssertionError("low precision weights unpacked"),
+            ), packed_woq_checkpoint(path):
+                loaded_model = convert_lowp()
+            self.assertTrue(
+                torch.equal(converted_model.linear.weight, loaded_model.linear.weight)
+            )
+            torch.testing.assert_close(output_ref, loaded_model(example_inputs))
+
     def test_weight_only_quantization_int4_weight(self):
         class M(nn.Module):
             def __init__(self, input_channel, output_channel, has_bias):
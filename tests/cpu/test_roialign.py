@@ -211,6 +211,28 @@ class RoIAlignTester(TestCase):
                 torch.allclose(gt_x.grad.to(x4.dtype), x4.grad, rtol=1e-5, atol=1e-5)
             )
 
+    def test_roialign_backward_parallel(self):
+        # Overlapping ROIs of both images, with enough sampling points to be
+        # pre-calculated in several chunks, and a channel count which is not
+        # a multiple of the vector size.
+        torch.manual_seed(0)
+        x = torch.rand(2, 19, 64, 64, dtype=torch.double)
+        boxes = torch.rand(100, 4, dtype=torch.double) * 32
+        boxes[:, 2:] += 32
+        rois = torch.cat([torch.randint(0, 2, (100, 1)).to(torch.double), boxes], dim=1)
+        grad_y = torch.rand(100, 19, 7, 7, dtype=torch.double)
+        num_threads = torch.get_num_threads()
+        for memory_format in [torch.contiguous_format, torch.channels_last]:
+            grads = []
+            for threads in [1, num_threads]:
+                torch.set_num_threads(threads)
+                x1 = x.clone().to(memory_format=memory_format).requires_grad_()
+                fn(x1, rois, 7, 7, spatial_scale=1, sampling_ratio=-1).backward(grad_y)
+                grads.append(x1.grad)
+            torch.set_num_threads(num_threads)
+            # Each thread accumulates the ROIs in the serial order
+            self.assertTrue(torch.equal(grads[0], grads[1]))
+
     @skipIfNoTorchVision
     def test_torchvision_roialign(self):
         pool_size = 5
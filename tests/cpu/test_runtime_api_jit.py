@@ -1,3 +1,5 @@
+import os
+import subprocess
 import unittest
 import torch
 import intel_extension_for_pytorch as ipex
@@ -961,5 +963,71 @@ class TestMultiStreamBenchmarkModule(JitTestCase):
         multi_stream_model(x)
 
 
+class TestBatchScheduler(JitTestCase):
+    @unittest.skipIf(
+        not ipex.cpu.runtime.is_runtime_ext_enabled(),
+        "Skip when IPEX Runtime extension is not enabled",
+    )
+    @runtime_thread_affinity_test_env
+    def test_batch_scheduler(self):
+        model = SimpleNet()
+        model.eval()
+        x = torch.rand(16, 64, 3, 3)
+        with torch.no_grad():
+            trace_model = torch.jit.trace(model, x)
+            y = trace_model(x)
+
+        cpu_pool = ipex.cpu.runtime.CPUPool(node_id=0)
+        scheduler = ipex.cpu.runtime.BatchScheduler(
+            trace_model,
+            num_streams=2,
+            cpu_pool=cpu_pool,
+            max_batch_size=4,
+            max_delay_ms=60000,
+        )
+        # Requests of batch size 1 and 2 are coalesced, and every request
+        # gets its own rows back. The requests fill batches of exactly
+        # max_batch_size, so every batch is closed by its size and never by
+        # max_delay_ms, and the batches do not depend on the submit timing.
+        sizes = [1, 2, 1, 1, 3, 1, 2, 1, 4]
+        futures = []
+        start = 0
+        for size in sizes:
+            futures.append((start, size, scheduler.submit(x[start : start + size])))
+            start += size
+        for start, size, future in futures:
+            self.assertEqual(y[start : start + size], future.get())
+
+        # The latency is recorded after the result is set, stop() joins the
+        # streams so that the stats are complete.
+        scheduler.stop()
+        stats = scheduler.stats()
+        self.assertEqual(stats["num_requests"], len(sizes))
+        self.assertEqual(stats["num_batches"], 4)
+        self.assertEqual(sum(stats["latency_us"]), len(sizes))
+        # Bucket 3 counts the batch sizes in [4, 8).
+        self.assertEqual(stats["batch_size"][3], 4)
+        self.assertEqual(sum(stats["batch_size"]), stats["num_batches"])
+        with self.assertRaises(RuntimeError):
+            scheduler.submit(x[:1])
+
+
+class TestNumaReplicateWeights(JitTestCase):
+    @unittest.skipIf(
+        not ipex.cpu.runtime.is_runtime_ext_enabled(),
+        "Skip when IPEX Runtime extension is not enabled",
+    )
+    def test_multi_stream_module_numa_replicate_weights(self):
+        loc = os.path.dirname(os.path.abspath(__file__))
+        env = dict(os.environ, IPEX_NUMA_REPLICATE_WEIGHTS="1")
+        result = subprocess.run(
+            ["python", "-u", "{}/numa_replicate_weights_test.py".format(loc)],
+            env=env,
+            stdout=subprocess.PIPE,
+            stderr=subprocess.STDOUT,
+        )
+        self.assertEqual(result.returncode, 0, result.stdout.decode("utf-8"))
+
+
 if __name__ == "__main__":
     test = unittest.main()
@@ -0,0 +1,85 @@
+import json
+import os
+import tempfile
+import threading
+import unittest
+import torch
+import intel_extension_for_pytorch as ipex
+from common_utils import TestCase
+
+
+class TelemetryTester(TestCase):
+    def setUp(self):
+        ipex.cpu.telemetry.reset()
+        ipex.cpu.telemetry.enable(sample_period=1)
+
+    def tearDown(self):
+        ipex.cpu.telemetry.disable()
+        ipex.cpu.telemetry.reset()
+
+    def _stats(self, kernel):
+        return [s for s in ipex.cpu.telemetry.snapshot() if s["kernel"] == kernel]
+
+    def test_dispatch_stub(self):
+        x = torch.randn(8, 64)
+        weight = torch.randn(64)
+        for _ in range(3):
+            torch.ops.torch_ipex.rmsnorm(x, weight, 1e-6)
+        stats = self._stats("rmsnorm_kernel_stub")
+        self.assertEqual(len(stats), 1)
+        self.assertEqual(stats[0]["calls"], 3)
+        # The size of the first tensor argument picks the bucket.
+        self.assertEqual(stats[0]["bucket"], 9)
+        self.assertEqual(stats[0]["bytes"], 3 * (x.nbytes + weight.nbytes))
+        self.assertTrue(stats[0]["total_ns"] >= stats[0]["max_ns"] > 0)
+
+    def test_prepacked_linear(self):
+        model = ipex.optimize(torch.nn.Linear(64, 32).eval(), dtype=torch.float)
+        with torch.no_grad():
+            model(torch.randn(5, 64))
+            model(torch.randn(100, 64))
+        stats = self._stats("ipex_prepack::linear")
+        self.assertEqual(sorted(s["bucket"] for s in stats), [3, 7])
+        for s in stats:
+            rows = 5 if s["bucket"] == 3 else 100
+            self.assertEqual(s["calls"], 1)
+            self.assertEqual(s["flops"], 2 * rows * 64 * 32)
+
+    def test_exited_threads(self):
+        def run():
+            torch.ops.torch_ipex.rmsnorm(torch.randn(8, 64), torch.randn(64), 1e-6)
+
+        threads = [threading.Thread(target=run) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        # Folded into the process wide counters when the threads exited.
+        stats = self._stats("rmsnorm_kernel_stub")
+        self.assertEqual(len(stats), 1)
+        self.assertEqual(stats[0]["calls"], 4)
+        ipex.cpu.telemetry.reset()
+        self.assertEqual(self._stats("rmsnorm_kernel_stub"), [])
+
+    def test_disabled(self):
+        ipex.cpu.telemetry.disable()
+        torch.ops.torch_ipex.rmsnorm(torch.randn(8, 64), torch.randn(64), 1e-6)
+        self.assertEqual(self._stats("rmsnorm_kernel_stub"), [])
+
+    def test_dump(self):
+        torch.ops.torch_ipex.rmsnorm(torch.randn(8, 64), torch.randn(64), 1e-6)
+        with tempfile.TemporaryDirectory() as tmp:
+            stats_path = os.path.join(tmp, "stats.json")
+            trace_path = os.path.join(tmp, "trace.json")
+            ipex.cpu.telemetry.dump_json(stats_path)
+            ipex.cpu.telemetry.dump_chrome_trace(trace_path)
+            with open(stats_path) as f:
+                kernels = [s["kernel"] for s in json.load(f)["kernels"]]
+            with open(trace_path) as f:
+                names = [e["name"] for e in json.load(f)["traceEvents"]]
+        self.assertIn("rmsnorm_kernel_stub", kernels)
+        self.assertIn("rmsnorm_kernel_stub", names)
+
+
+if __name__ == "__main__":
+    test = unittest.main()
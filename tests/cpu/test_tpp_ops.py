@@ -1,4 +1,6 @@
 import unittest
+from unittest import mock
+import itertools
 import torch
 import random
 import numpy
@@ -136,6 +138,56 @@ class TPPOPsTester(TestCase):
         self.assertEqual(hf_res, tpp_res, prec=0.0002)
         self._test_backward(hf_res, tpp_res, hf_self_att, tpp_self_att, prec=0.005)
 
+    def _run_tpp_self_attention(self, self_att, hidden_states, flash):
+        fused_bert = ipex.cpu.tpp.fused_bert
+        self_att.zero_grad()
+        hidden_states = hidden_states.clone().requires_grad_()
+        msk, att_mask, seq_offsets, seq_sqr_offsets = fused_bert.generate_mask(
+            self.attention_mask
+        )
+        with mock.patch.object(fused_bert, "flash_attention", flash):
+            # The same dropout mask for both
+            torch_ipex_cpp.xsmm_manual_seed(12345)
+            res = self_att(
+                fused_bert.UnpadInput.apply(hidden_states, msk),
+                att_mask,
+                seq_offsets=seq_offsets,
+                seq_sqr_offsets=seq_sqr_offsets,
+            )[0].unblocked_tensor()
+            res.float().sum().backward()
+        grads = [hidden_states.grad] + [
+            param.grad.clone() for param in self_att.parameters()
+        ]
+        return res.detach(), grads
+
+    def test_tpp_bert_self_attention_flash(self):
+        fused_bert = ipex.cpu.tpp.fused_bert
+
+        def assert_close(ref, res, prec):
+            ref, res = ref.float(), res.float()
+            scale = max(ref.abs().max().item(), 1.0)
+            self.assertTrue((ref - res).abs().max().item() <= prec * scale)
+
+        for use_bf16, unpad, p in itertools.product(
+            [False, True], [False, True], [0.0, 0.1]
+        ):
+            self.config.attention_probs_dropout_prob = p
+            with mock.patch.multiple(fused_bert, layer_use_bf16=use_bf16, unpad=unpad):
+                self_att = fused_bert.BertSelfAttention(self.config).train()
+                hidden_states = torch.randn(
+                    self.batch, self.max_seq_len, self.config.hidden_size
+                )
+                ref, ref_grads = self._run_tpp_self_attention(
+                    self_att, hidden_states, flash=False
+                )
+                res, res_grads = self._run_tpp_self_attention(
+                    self_att, hidden_states, flash=True
+                )
+            prec = 0.02 if use_bf16 else 0.0005
+            assert_close(ref, res, prec)
+            for ref_grad, res_grad in zip(ref_grads, res_grads):
+                assert_close(ref_grad, res_grad, prec)
+
     def test_tpp_bert_output(self):
         hf_self_out = transformers.models.bert.modeling_bert.BertSelfOutput(self.config)
         tpp_self_out = ipex.cpu.tpp.fused_bert.BertSelfOutput(self.config)
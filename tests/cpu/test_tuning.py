@@ -0,0 +1,140 @@
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+import torch
+import intel_extension_for_pytorch as ipex  # noqa F401
+from intel_extension_for_pytorch.cpu import tuning
+from common_utils import TestCase
+
+
+class TuningTester(TestCase):
+    def setUp(self):
+        tuning.clear()
+
+    def tearDown(self):
+        tuning.disable_autotune()
+        tuning.clear()
+
+    def _entries(self, kernel):
+        return [e for e in tuning.entries() if e["kernel"].startswith(kernel)]
+
+    def test_save_load(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "tuning.json")
+            tuning.save(path)
+            with open(path) as f:
+                db = json.load(f)
+            db["entries"] = [
+                {
+                    "kernel": "tpp_gemm",
+                    "dtype": "BFloat16",
+                    "m_bucket": 7,
+                    "n": 4096,
+                    "k": 4096,
+                    "params": {"large_cache_opt": 1, "ncb": 32, "loop_scheme": 1},
+                }
+            ]
+            with open(path, "w") as f:
+                json.dump(db, f)
+            self.assertTrue(tuning.load(path))
+            self.assertEqual(tuning.entries(), db["entries"])
+            tuning.clear()
+            tuning.save(path)
+            with open(path) as f:
+                self.assertEqual(json.load(f)["entries"], [])
+
+    def test_load_other_machine(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "tuning.json")
+            tuning.save(path)
+            with open(path) as f:
+                db = json.load(f)
+            db["threads"] += 1
+            db["entries"] = [
+                {
+                    "kernel": "tpp_gemm",
+                    "dtype": "Float",
+                    "m_bucket": 7,
+                    "n": 64,
+                    "k": 64,
+                    "params": {"large_cache_opt": 0},
+                }
+            ]
+            with open(path, "w") as f:
+                json.dump(db, f)
+            with self.assertWarns(UserWarning):
+                self.assertFalse(tuning.load(path))
+            self.assertEqual(tuning.entries(), [])
+
+    def test_autotune_tpp_linear(self):
+        x = torch.randn(256, 256)
+        model = tuning._tpp_linear(128, 256, torch.float)
+        with torch.no_grad():
+            ref = model(x)
+            self.assertEqual(self._entries("tpp_gemm"), [])
+            tuning.enable_autotune()
+            out = model(x)
+        self.assertEqual(out, ref)
+        entries = self._entries("tpp_gemm")
+        self.assertEqual(len(entries), 1)
+        self.assertEqual(entries[0]["n"], 128)
+        self.assertEqual(entries[0]["k"], 256)
+        # 256 rows are in bucket 8
+        self.assertEqual(entries[0]["m_bucket"], 8)
+        # The tuned parameters are used
+        with torch.no_grad():
+            self.assertEqual(model(x), ref)
+
+    def test_autotune_woq_linear(self):
+        x = torch.randn(128, 256)
+        model = tuning._woq_linear(128, 256, torch.float)
+        with torch.no_grad():
+            ref = model(x)
+            self.assertEqual(self._entries("woq_gemm"), [])
+            tuning.enable_autotune()
+            out = model(x)
+        self.assertEqual(out, ref)
+        entries = self._entries("woq_gemm")
+        self.assertEqual(len(entries), 1)
+        self.assertEqual((entries[0]["n"], entries[0]["k"]), (128, 256))
+        self.assertEqual(entries[0]["m_bucket"], 7)
+        self.assertIn("block_m", entries[0]["params"])
+
+    def test_autotune_persists(self):
+        # A process autotuning with IPEX_TUNING_DB saves its picks at exit,
+        # the next one loads and uses them without tuning again.
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "tuning.json")
+            env = dict(os.environ, IPEX_TUNING_DB=path, IPEX_AUTOTUNE="1")
+            script = "\n".join(
+                [
+                    "import torch",
+                    "from intel_extension_for_pytorch.cpu import tuning",
+                    "with torch.no_grad():",
+                    "    tuning._tpp_linear(128, 256, torch.float)(torch.randn(256, 256))",
+                    "    tuning._woq_linear(128, 256, torch.float)(torch.randn(128, 256))",
+                ]
+            )
+            subprocess.check_call([sys.executable, "-c", script], env=env)
+            with open(path) as f:
+                saved = json.load(f)["entries"]
+            kernels = sorted(e["kernel"].split("_")[0] for e in saved)
+            self.assertEqual(kernels, ["tpp", "woq"])
+            self.assertTrue(tuning.load(path))
+            self.assertEqual(tuning.entries(), saved)
+        # The loaded picks are used, nothing is tuned
+        with torch.no_grad():
+            tuning._tpp_linear(128, 256, torch.float)(torch.randn(256, 256))
+        self.assertEqual(tuning.entries(), saved)
+
+    def test_tune(self):
+        tuning.tune([(128, 128, 256)], torch.float, kernels=("tpp",))
+        self.assertEqual(len(self._entries("tpp_gemm")), 1)
+        self.assertFalse(tuning.is_autotune_enabled())
+
+
+if __name__ == "__main__":
+    test = unittest.main()